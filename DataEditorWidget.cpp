@@ -1,12 +1,12 @@
 #include "dataeditorwidget.h"
 #include "ui_dataeditorwidget.h"
 #include "pressurederivativecalculator.h"
+#include "derivedcolumns.h"
 #include <QDebug>
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QFile>
 #include <QTextStream>
-#include <QStandardItemModel>
 #include <QHeaderView>
 #include <QStyledItemDelegate>
 #include <QPainter>
@@ -29,7 +29,10 @@
 #include <QTextDocument>
 #include <QTextDocumentWriter>
 #include <QMimeData>
+#include <QThread>
+#include <QtConcurrent>
 #include <QScrollBar>
+#include <QFontMetrics>
 #include <QSet>
 #include <QList>
 #include <QFormLayout>
@@ -51,6 +54,7 @@
 #include <QTextEdit>
 #include <QPlainTextEdit>
 #include <cmath>
+#include <limits>
 #include <algorithm>
 
 // Qt6兼容性处理
@@ -69,12 +73,12 @@
 // 撤销重做命令实现
 // ============================================================================
 
-DataEditCommand::DataEditCommand(QStandardItemModel* model, QUndoCommand* parent)
+DataEditCommand::DataEditCommand(DataTableModel* model, QUndoCommand* parent)
     : QUndoCommand(parent), m_model(model)
 {
 }
 
-CellEditCommand::CellEditCommand(QStandardItemModel* model, int row, int column,
+CellEditCommand::CellEditCommand(DataTableModel* model, int row, int column,
                                  const QString& oldValue, const QString& newValue,
                                  QUndoCommand* parent)
     : DataEditCommand(model, parent), m_row(row), m_column(column),
@@ -86,99 +90,24 @@ CellEditCommand::CellEditCommand(QStandardItemModel* model, int row, int column,
 void CellEditCommand::undo()
 {
     if (m_model && m_row < m_model->rowCount() && m_column < m_model->columnCount()) {
-        QStandardItem* item = m_model->item(m_row, m_column);
-        if (!item) {
-            item = new QStandardItem();
-            m_model->setItem(m_row, m_column, item);
-        }
-        item->setText(m_oldValue);
+        m_model->setText(m_row, m_column, m_oldValue);
     }
 }
 
 void DataEditorWidget::loadDataWithConfig(const QString& filePath, const QString& fileType, const DataLoadConfigDialog::LoadConfig& config)
 {
     qDebug() << "开始加载文件:" << filePath << "类型:" << fileType << "起始行:" << config.startRow;
-
-    QFileInfo fileInfo(filePath);
-    if (!fileInfo.exists() || !fileInfo.isReadable()) {
-        showStyledMessageBox("文件加载失败",
-                             QString("文件不存在或无法读取: %1").arg(filePath),
-                             QMessageBox::Warning);
-        return;
-    }
-
-    // 显示进度对话框
-    showAnimatedProgress("加载数据文件", "正在读取文件数据，请稍候...");
-
-    clearData();
-
-    m_currentFilePath = filePath;
-    m_currentFileType = fileType;
-    ui->filePathLineEdit->setText(filePath);
-
-    bool loadSuccess = false;
-    QString errorMessage;
-
-    updateProgress(20, "正在分析文件格式...");
-
-    QString lowerType = fileType.toLower();
-    if (lowerType == "txt" || lowerType == "csv") {
-        loadSuccess = loadCsvFileWithConfig(filePath, config, errorMessage);
-    } else {
-        // 其他类型使用默认方法
-        if (lowerType == "excel") {
-            loadSuccess = loadExcelFileOptimized(filePath, errorMessage);
-        } else if (lowerType == "json") {
-            loadSuccess = loadJsonFile(filePath, errorMessage);
-        } else {
-            errorMessage = QString("不支持的文件类型: %1").arg(fileType);
-        }
-    }
-
-    hideAnimatedProgress();
-
-    if (loadSuccess) {
-        updateStatus(QString("文件加载成功 - %1行 × %2列")
-                         .arg(m_dataModel->rowCount())
-                         .arg(m_dataModel->columnCount()), "success");
-
-        setButtonsEnabled(true);
-        m_dataModified = false;
-
-        applyColumnStyles();
-        optimizeColumnWidths();
-        optimizeTableDisplay();
-
-        // 弹出列定义对话框
-        QTimer::singleShot(500, this, &DataEditorWidget::onDefineColumns);
-
-        emitDataChanged();
-
-        qDebug() << "文件加载成功，数据行数:" << m_dataModel->rowCount()
-                 << "列数:" << m_dataModel->columnCount();
-    } else {
-        updateStatus("文件加载失败", "error");
-        showStyledMessageBox("文件加载失败",
-                             QString("无法加载文件: %1").arg(filePath),
-                             QMessageBox::Critical,
-                             errorMessage);
-        qDebug() << "文件加载失败:" << errorMessage;
-    }
+    startFileLoad(filePath, fileType, &config);
 }
 
 void CellEditCommand::redo()
 {
     if (m_model && m_row < m_model->rowCount() && m_column < m_model->columnCount()) {
-        QStandardItem* item = m_model->item(m_row, m_column);
-        if (!item) {
-            item = new QStandardItem();
-            m_model->setItem(m_row, m_column, item);
-        }
-        item->setText(m_newValue);
+        m_model->setText(m_row, m_column, m_newValue);
     }
 }
 
-RowEditCommand::RowEditCommand(QStandardItemModel* model, Operation op, int row,
+RowEditCommand::RowEditCommand(DataTableModel* model, Operation op, int row,
                                const QStringList& rowData, QUndoCommand* parent)
     : DataEditCommand(model, parent), m_operation(op), m_row(row), m_rowData(rowData)
 {
@@ -195,10 +124,14 @@ void RowEditCommand::undo()
             m_model->removeRow(m_row);
         }
     } else {
-        m_model->insertRow(m_row);
-        for (int col = 0; col < m_rowData.size(); ++col) {
-            QStandardItem* item = new QStandardItem(m_rowData[col]);
-            m_model->setItem(m_row, col, item);
+        if (!m_rowSlice.isEmpty()) {
+            // 按列类型原样恢复，避免经显示文本往返丢失精度
+            m_model->insertRowSlice(m_row, m_rowSlice);
+        } else {
+            m_model->insertRow(m_row);
+            for (int col = 0; col < m_rowData.size() && col < m_model->columnCount(); ++col) {
+                m_model->setText(m_row, col, m_rowData[col]);
+            }
         }
     }
 }
@@ -209,23 +142,15 @@ void RowEditCommand::redo()
 
     if (m_operation == Insert) {
         m_model->insertRow(m_row);
-        for (int col = 0; col < m_model->columnCount(); ++col) {
-            QStandardItem* item = new QStandardItem("");
-            m_model->setItem(m_row, col, item);
-        }
     } else {
         if (m_row < m_model->rowCount()) {
-            m_rowData.clear();
-            for (int col = 0; col < m_model->columnCount(); ++col) {
-                QStandardItem* item = m_model->item(m_row, col);
-                m_rowData.append(item ? item->text() : "");
-            }
+            m_rowSlice = m_model->rowSlice(m_row, 1);
             m_model->removeRow(m_row);
         }
     }
 }
 
-ColumnEditCommand::ColumnEditCommand(QStandardItemModel* model, Operation op, int column,
+ColumnEditCommand::ColumnEditCommand(DataTableModel* model, Operation op, int column,
                                      const QString& headerName, const QStringList& columnData,
                                      QUndoCommand* parent)
     : DataEditCommand(model, parent), m_operation(op), m_column(column),
@@ -244,14 +169,13 @@ void ColumnEditCommand::undo()
             m_model->removeColumn(m_column);
         }
     } else {
-        m_model->insertColumn(m_column);
-        QStandardItem* headerItem = new QStandardItem(m_headerName);
-        m_model->setHorizontalHeaderItem(m_column, headerItem);
-
-        for (int row = 0; row < m_columnData.size(); ++row) {
-            QStandardItem* item = new QStandardItem(m_columnData[row]);
-            m_model->setItem(row, m_column, item);
+        // 恢复删除前的类型化列（保留数值/时间存储与显示格式）
+        DataColumn column = m_columnSnapshot;
+        if (column.size() == 0 && !m_columnData.isEmpty()) {
+            column = DataTableModel::buildColumn(m_headerName, m_columnData);
         }
+        column.header = m_headerName;
+        m_model->insertColumnData(m_column, column);
     }
 }
 
@@ -261,29 +185,118 @@ void ColumnEditCommand::redo()
 
     if (m_operation == Insert) {
         m_model->insertColumn(m_column);
-        QStandardItem* headerItem = new QStandardItem(m_headerName);
-        m_model->setHorizontalHeaderItem(m_column, headerItem);
-
-        for (int row = 0; row < m_model->rowCount(); ++row) {
-            QStandardItem* item = new QStandardItem("");
-            m_model->setItem(row, m_column, item);
-        }
+        m_model->setHeaderText(m_column, m_headerName);
     } else {
         if (m_column < m_model->columnCount()) {
-            QStandardItem* headerItem = m_model->horizontalHeaderItem(m_column);
-            m_headerName = headerItem ? headerItem->text() : QString("列%1").arg(m_column + 1);
-
-            m_columnData.clear();
-            for (int row = 0; row < m_model->rowCount(); ++row) {
-                QStandardItem* item = m_model->item(row, m_column);
-                m_columnData.append(item ? item->text() : "");
-            }
-
+            m_headerName = m_model->headerText(m_column);
+            m_columnSnapshot = m_model->column(m_column);
             m_model->removeColumn(m_column);
         }
     }
 }
 
+RowRangeDeleteCommand::RowRangeDeleteCommand(DataTableModel* model, const RowRanges& ranges,
+                                             const QString& text, QUndoCommand* parent)
+    : DataEditCommand(model, parent), m_ranges(ranges)
+{
+    setText(text);
+}
+
+void RowRangeDeleteCommand::undo()
+{
+    if (!m_model || m_removed.isEmpty()) return;
+
+    m_model->restoreRows(m_ranges, m_removed);
+    m_removed.clear();
+}
+
+void RowRangeDeleteCommand::redo()
+{
+    if (!m_model) return;
+
+    m_removed = m_model->takeRows(m_ranges);
+}
+
+ColumnCellsCommand::ColumnCellsCommand(DataTableModel* model, int column, const QVector<int>& rows,
+                                       const DataColumn& newValues, const QString& text,
+                                       QUndoCommand* parent)
+    : DataEditCommand(model, parent), m_column(column), m_rows(rows),
+    m_newValues(newValues), m_typeChanged(false)
+{
+    setText(text);
+}
+
+void ColumnCellsCommand::undo()
+{
+    if (!m_model || m_column >= m_model->columnCount()) return;
+
+    if (m_typeChanged) {
+        m_model->replaceColumn(m_column, m_columnBefore);
+    } else {
+        m_model->setCellSlice(m_column, m_rows, m_oldValues);
+    }
+}
+
+void ColumnCellsCommand::redo()
+{
+    if (!m_model || m_column >= m_model->columnCount()) return;
+
+    // 类型一致时只记录被改写的值；否则写入会按文本进行并可能转换列类型，需保存整列
+    const DataColumn& current = m_model->column(m_column);
+    m_typeChanged = current.storage != m_newValues.storage
+                    || (current.storage == ColumnStorage::Timestamp
+                        && current.timestampFormat != m_newValues.timestampFormat);
+    m_columnBefore = m_typeChanged ? current : DataColumn();
+    m_oldValues = m_typeChanged ? DataColumn() : m_model->cellSlice(m_column, m_rows);
+
+    m_model->setCellSlice(m_column, m_rows, m_newValues);
+}
+
+ColumnSnapshotCommand::ColumnSnapshotCommand(DataTableModel* model, int column, const DataColumn& after,
+                                             const QString& text, QUndoCommand* parent)
+    : DataEditCommand(model, parent), m_column(column), m_after(after)
+{
+    setText(text);
+}
+
+void ColumnSnapshotCommand::undo()
+{
+    if (!m_model || m_column >= m_model->columnCount()) return;
+
+    m_model->replaceColumn(m_column, m_before);
+}
+
+void ColumnSnapshotCommand::redo()
+{
+    if (!m_model || m_column >= m_model->columnCount()) return;
+
+    m_before = m_model->column(m_column);
+    m_model->replaceColumn(m_column, m_after);
+}
+
+TableSnapshotCommand::TableSnapshotCommand(DataTableModel* model, const QVector<DataColumn>& after,
+                                           int afterRows, const QString& text, QUndoCommand* parent)
+    : DataEditCommand(model, parent), m_beforeRows(0), m_after(after), m_afterRows(afterRows)
+{
+    setText(text);
+}
+
+void TableSnapshotCommand::undo()
+{
+    if (!m_model) return;
+
+    m_model->setTableData(m_before, m_beforeRows);
+}
+
+void TableSnapshotCommand::redo()
+{
+    if (!m_model) return;
+
+    m_before = m_model->tableColumns();
+    m_beforeRows = m_model->rowCount();
+    m_model->setTableData(m_after, m_afterRows);
+}
+
 // ============================================================================
 // 列定义对话框实现 - 优化版本
 // ============================================================================
@@ -962,7 +975,7 @@ void TimeConversionDialog::setupUI()
 
     // 输出单位选择
     m_outputUnitCombo = new QComboBox;
-    m_outputUnitCombo->addItems({"s", "m", "h"});
+    m_outputUnitCombo->addItems({"s", "m", "h", "日期时间"});
     m_outputUnitCombo->setCurrentText("s");
     formLayout->addRow("输出单位:", m_outputUnitCombo);
 
@@ -1027,6 +1040,8 @@ void TimeConversionDialog::onPreviewClicked()
         unitText = "分钟";
     } else if (unit == "h") {
         unitText = "小时";
+    } else {
+        unitText = "日期时间（时间戳列）";
     }
 
     QString preview;
@@ -1075,6 +1090,13 @@ QString TimeConversionDialog::previewConversion(const QString& sampleDateInput,
     static QString baseDate = "2006-07-18";
     static QString baseTime = "10:25:10";
 
+    if (unit == "日期时间") {
+        // 生成时间戳列：日期与时刻合并为一个值
+        return QString("日期: %1, 时刻: %2 => %3")
+            .arg(sampleDateInput, sampleTimeInput,
+                 m_dateTimeRadio->isChecked() ? sampleDateInput + " " + sampleTimeInput : QString("需要源列含日期"));
+    }
+
     if (m_dateTimeRadio->isChecked()) {
         // 日期+时刻模式
         if (sampleDateInput == baseDate && sampleTimeInput == baseTime) {
@@ -1155,7 +1177,8 @@ TimeConversionConfig TimeConversionDialog::getConversionConfig() const
         config.sourceTimeColumnIndex = m_sourceColumnCombo->currentIndex();
     }
 
-    config.outputUnit = m_outputUnitCombo->currentText();
+    config.outputUnit = m_outputUnitCombo->currentIndex() == 3 ? QString("datetime")
+                                                               : m_outputUnitCombo->currentText();
     config.newColumnName = m_newColumnNameEdit->text().trimmed();
 
     if (config.newColumnName.isEmpty()) {
@@ -1453,7 +1476,7 @@ void DataCleaningDialog::setupUI()
 {
     setWindowTitle("数据清理选项");
     setModal(true);
-    resize(380, 280);
+    resize(420, 420);
 
     QVBoxLayout* mainLayout = new QVBoxLayout(this);
 
@@ -1474,29 +1497,66 @@ void DataCleaningDialog::setupUI()
     QHBoxLayout* fillLayout = new QHBoxLayout;
     fillLayout->addWidget(new QLabel("填充方法:"));
     m_fillMethodCombo = new QComboBox;
-    m_fillMethodCombo->addItems({"零值", "线性插值", "平均值", "前值填充"});
+    m_fillMethodCombo->addItems({"零值", "线性插值", "时间加权插值", "平均值", "前值填充"});
     m_fillMethodCombo->setCurrentIndex(1);
     fillLayout->addWidget(m_fillMethodCombo);
+    fillLayout->addWidget(new QLabel("最大空缺:"));
+    m_maxGapSpin = new QSpinBox;
+    m_maxGapSpin->setRange(0, 100000);
+    m_maxGapSpin->setValue(0);
+    m_maxGapSpin->setSpecialValueText("不限");
+    m_maxGapSpin->setSuffix(" 行");
+    fillLayout->addWidget(m_maxGapSpin);
     mainLayout->addLayout(fillLayout);
 
-    m_removeOutliersCheck = new QCheckBox("删除异常值");
+    m_removeOutliersCheck = new QCheckBox("清除异常值（滚动中位数）");
     mainLayout->addWidget(m_removeOutliersCheck);
 
     QHBoxLayout* outlierLayout = new QHBoxLayout;
-    outlierLayout->addWidget(new QLabel("异常值阈值:"));
+    outlierLayout->addWidget(new QLabel("阈值:"));
     m_outlierThresholdSpin = new QSpinBox;
-    m_outlierThresholdSpin->setRange(1, 5);
-    m_outlierThresholdSpin->setValue(2);
-    m_outlierThresholdSpin->setSuffix(" 倍标准差");
+    m_outlierThresholdSpin->setRange(1, 10);
+    m_outlierThresholdSpin->setValue(3);
+    m_outlierThresholdSpin->setSuffix(" 倍稳健标准差");
     outlierLayout->addWidget(m_outlierThresholdSpin);
+    outlierLayout->addWidget(new QLabel("窗口:"));
+    m_outlierWindowSpin = new QSpinBox;
+    m_outlierWindowSpin->setRange(5, 1001);
+    m_outlierWindowSpin->setSingleStep(2);
+    m_outlierWindowSpin->setValue(11);
+    m_outlierWindowSpin->setSuffix(" 点");
+    outlierLayout->addWidget(m_outlierWindowSpin);
     mainLayout->addLayout(outlierLayout);
 
+    QHBoxLayout* resampleLayout = new QHBoxLayout;
+    m_resampleCheck = new QCheckBox("按时间列重采样，间隔:");
+    resampleLayout->addWidget(m_resampleCheck);
+    m_resampleIntervalSpin = new QDoubleSpinBox;
+    m_resampleIntervalSpin->setRange(0.001, 86400.0);
+    m_resampleIntervalSpin->setDecimals(3);
+    m_resampleIntervalSpin->setValue(60.0);
+    m_resampleIntervalSpin->setToolTip("时间戳列以秒为单位，数值时间列使用该列自身的单位");
+    resampleLayout->addWidget(m_resampleIntervalSpin);
+    mainLayout->addLayout(resampleLayout);
+
     m_standardizeFormatCheck = new QCheckBox("标准化数据格式");
     mainLayout->addWidget(m_standardizeFormatCheck);
 
+    m_previewLabel = new QLabel;
+    m_previewLabel->setWordWrap(true);
+    m_previewLabel->setStyleSheet("QLabel { color: #555; background: #f5f5f5; padding: 6px; }");
+    m_previewLabel->setVisible(false);
+    mainLayout->addWidget(m_previewLabel);
+
     mainLayout->addStretch();
 
     QHBoxLayout* buttonLayout = new QHBoxLayout;
+
+    QPushButton* previewBtn = new QPushButton("预览");
+    previewBtn->setToolTip("统计各步骤将影响的行数和单元格数，不修改数据");
+    connect(previewBtn, &QPushButton::clicked, this, &DataCleaningDialog::previewRequested);
+    buttonLayout->addWidget(previewBtn);
+
     buttonLayout->addStretch();
 
     QPushButton* okBtn = new QPushButton("执行清理");
@@ -1519,14 +1579,24 @@ DataCleaningDialog::CleaningOptions DataCleaningDialog::getCleaningOptions() con
     options.fillMissingValues = m_fillMissingValuesCheck->isChecked();
     options.removeOutliers = m_removeOutliersCheck->isChecked();
     options.standardizeFormat = m_standardizeFormatCheck->isChecked();
+    options.resample = m_resampleCheck->isChecked();
 
-    QStringList fillMethods = {"zero", "interpolation", "average", "forward"};
+    QStringList fillMethods = {"zero", "interpolation", "time", "average", "forward"};
     options.fillMethod = fillMethods[m_fillMethodCombo->currentIndex()];
+    options.maxGap = m_maxGapSpin->value();
     options.outlierThreshold = m_outlierThresholdSpin->value();
+    options.outlierWindow = m_outlierWindowSpin->value();
+    options.resampleInterval = m_resampleIntervalSpin->value();
 
     return options;
 }
 
+void DataCleaningDialog::setPreviewText(const QString& text)
+{
+    m_previewLabel->setText(text);
+    m_previewLabel->setVisible(!text.isEmpty());
+}
+
 // 动画进度对话框简化实现
 AnimatedProgressDialog::AnimatedProgressDialog(const QString& title, const QString& message, QWidget* parent)
     : QDialog(parent)
@@ -1538,6 +1608,7 @@ AnimatedProgressDialog::AnimatedProgressDialog(const QString& title, const QStri
 
     setupUI();
     setMessage(message);
+    setCancelable(false);
 }
 
 void AnimatedProgressDialog::setupUI()
@@ -1566,6 +1637,15 @@ void AnimatedProgressDialog::setupUI()
     m_progressBar->setMinimum(0);
     m_progressBar->setMaximum(100);
     mainLayout->addWidget(m_progressBar);
+
+    m_cancelButton = new QPushButton("取消");
+    m_cancelButton->setFixedWidth(72);
+    connect(m_cancelButton, &QPushButton::clicked, this, [this]() {
+        m_cancelButton->setEnabled(false);
+        setMessage("正在取消...");
+        emit cancelRequested();
+    });
+    mainLayout->addWidget(m_cancelButton, 0, Qt::AlignRight);
 }
 
 void AnimatedProgressDialog::setupAnimation() {}
@@ -1585,6 +1665,13 @@ void AnimatedProgressDialog::setMaximum(int maximum)
     m_progressBar->setMaximum(maximum);
 }
 
+void AnimatedProgressDialog::setCancelable(bool cancelable)
+{
+    m_cancelButton->setVisible(cancelable);
+    m_cancelButton->setEnabled(cancelable);
+    setFixedSize(320, cancelable ? 136 : 100);
+}
+
 void AnimatedProgressDialog::closeEvent(QCloseEvent* event)
 {
     event->ignore();
@@ -1599,6 +1686,7 @@ DataEditorWidget::DataEditorWidget(QWidget *parent) :
     ui(new Ui::DataEditorWidget),
     m_dataModel(nullptr),
     m_proxyModel(nullptr),
+    m_statisticsCache(nullptr),
     m_undoStack(nullptr),
     m_dataModified(false),
     m_searchTimer(nullptr),
@@ -1612,7 +1700,16 @@ DataEditorWidget::DataEditorWidget(QWidget *parent) :
     m_addColumnLeftAction(nullptr),
     m_addColumnRightAction(nullptr),
     m_deleteColumnsAction(nullptr),
-    m_pressureDerivativeCalculator(nullptr)
+    m_pressureDerivativeCalculator(nullptr),
+    m_deconvolutionCalculator(nullptr),
+    m_flowPeriodDetector(nullptr),
+    m_csvLoader(nullptr),
+    m_xlsxFile(nullptr),
+    m_dataCleaner(nullptr),
+    m_loading(false),
+    m_loadCancelled(false),
+    m_loadPreviewRows(2000),
+    m_loadedRowCount(0)
 {
     ui->setupUi(this);
     init();
@@ -1620,7 +1717,16 @@ DataEditorWidget::DataEditorWidget(QWidget *parent) :
 
 DataEditorWidget::~DataEditorWidget()
 {
+    // 等待后台加载线程退出，它仍在使用本对象的解析器
+    if (m_loadWatcher.isRunning()) {
+        cancelFileLoad();
+        m_loadWatcher.waitForFinished();
+    }
+
     delete ui;
+    if (m_statisticsCache) {
+        delete m_statisticsCache;
+    }
     if (m_dataModel) {
         delete m_dataModel;
     }
@@ -1639,6 +1745,21 @@ DataEditorWidget::~DataEditorWidget()
     if (m_pressureDerivativeCalculator) {
         delete m_pressureDerivativeCalculator;
     }
+    if (m_deconvolutionCalculator) {
+        delete m_deconvolutionCalculator;
+    }
+    if (m_flowPeriodDetector) {
+        delete m_flowPeriodDetector;
+    }
+    if (m_csvLoader) {
+        delete m_csvLoader;
+    }
+    if (m_xlsxFile) {
+        delete m_xlsxFile;
+    }
+    if (m_dataCleaner) {
+        delete m_dataCleaner;
+    }
 }
 
 void DataEditorWidget::init()
@@ -1648,6 +1769,12 @@ void DataEditorWidget::init()
     setupConnections();
     setupContextMenu();
     setupPressureDerivativeCalculator();
+    setupDeconvolutionCalculator();
+    setupFlowPeriodDetector();
+    setupCsvLoader();
+    setupXlsxFile();
+    setupBackgroundLoading();
+    setupDataCleaner();
 
     // 初始化搜索定时器
     m_searchTimer = new QTimer(this);
@@ -1664,7 +1791,8 @@ void DataEditorWidget::init()
 void DataEditorWidget::setupModels()
 {
     // 创建数据模型
-    m_dataModel = new QStandardItemModel(this);
+    m_dataModel = new DataTableModel(this);
+    m_statisticsCache = new ColumnStatisticsCache(m_dataModel, this);
 
     // 创建代理模型用于搜索和筛选
     m_proxyModel = new QSortFilterProxyModel(this);
@@ -1731,6 +1859,8 @@ void DataEditorWidget::setupConnections()
     connect(ui->btnTimeConvert, &QPushButton::clicked, this, &DataEditorWidget::onTimeConvert);
     connect(ui->btnPressureDropCalc, &QPushButton::clicked, this, &DataEditorWidget::onPressureDropCalc);
     connect(ui->btnPressureDerivativeCalc, &QPushButton::clicked, this, &DataEditorWidget::onPressureDerivativeCalc);
+    connect(ui->btnDeconvolution, &QPushButton::clicked, this, &DataEditorWidget::onDeconvolution);
+    connect(ui->btnFlowPeriods, &QPushButton::clicked, this, &DataEditorWidget::onFlowPeriodDetect);
     connect(ui->btnDataClean, &QPushButton::clicked, this, &DataEditorWidget::onDataClean);
     connect(ui->btnDataStatistics, &QPushButton::clicked, this, &DataEditorWidget::onDataStatistics);
 
@@ -1738,8 +1868,7 @@ void DataEditorWidget::setupConnections()
     connect(ui->searchLineEdit, &QLineEdit::textChanged, this, &DataEditorWidget::onSearchTextChanged);
 
     // 模型数据变化
-    connect(m_dataModel, &QStandardItemModel::itemChanged, this, &DataEditorWidget::onCellDataChanged);
-    connect(m_dataModel, &QStandardItemModel::dataChanged, this, &DataEditorWidget::onModelDataChanged);
+    connect(m_dataModel, &DataTableModel::dataChanged, this, &DataEditorWidget::onModelDataChanged);
 
     // 右键菜单连接
     connect(ui->dataTableView, &QTableView::customContextMenuRequested,
@@ -1890,6 +2019,7 @@ TimeConversionResult DataEditorWidget::convertTimeColumn(const TimeConversionCon
         }
 
         // 创建新列名，包含单位信息
+        const bool outputDateTime = (config.outputUnit == "datetime");
         QString unitText;
         if (config.outputUnit == "s") {
             unitText = "s";
@@ -1899,9 +2029,12 @@ TimeConversionResult DataEditorWidget::convertTimeColumn(const TimeConversionCon
             unitText = "h";
         }
 
-        QString newColumnName = QString("%1\\%2").arg(config.newColumnName).arg(unitText);
+        QString newColumnName = outputDateTime ? config.newColumnName
+                                               : QString("%1\\%2").arg(config.newColumnName).arg(unitText);
 
+        const int rowCount = m_dataModel->rowCount();
         int newColumnIndex;
+        QVector<int> sources;
 
         if (config.useDateAndTime) {
             // 日期+时刻模式
@@ -1913,91 +2046,9 @@ TimeConversionResult DataEditorWidget::convertTimeColumn(const TimeConversionCon
 
             // 在时刻列后面插入新列
             newColumnIndex = qMax(config.dateColumnIndex, config.timeColumnIndex) + 1;
-            m_dataModel->insertColumn(newColumnIndex);
-
-            // 设置列标题
-            QStandardItem* headerItem = new QStandardItem(newColumnName);
-            m_dataModel->setHorizontalHeaderItem(newColumnIndex, headerItem);
-
-            // 获取基准日期和时刻（第一行的数据）
-            QDate baseDate;
-            QTime baseTime;
-            bool baseSet = false;
-
-            // 找到第一个有效的日期和时刻
-            for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-                QStandardItem* dateItem = m_dataModel->item(row, config.dateColumnIndex);
-                QStandardItem* timeItem = m_dataModel->item(row, config.timeColumnIndex);
-
-                if (dateItem && timeItem) {
-                    QString dateStr = dateItem->text().trimmed();
-                    QString timeStr = timeItem->text().trimmed();
-
-                    QDate parsedDate = parseDateString(dateStr);
-                    QTime parsedTime = parseTimeString(timeStr);
-
-                    if (parsedDate.isValid() && parsedTime.isValid()) {
-                        baseDate = parsedDate;
-                        baseTime = parsedTime;
-                        baseSet = true;
-                        break;
-                    }
-                }
-            }
-
-            if (!baseSet) {
-                result.errorMessage = "未找到有效的日期和时刻数据";
-                if (newColumnIndex < m_dataModel->columnCount()) {
-                    m_dataModel->removeColumn(newColumnIndex);
-                }
-                return result;
-            }
-
-            // 计算每行的相对时间
-            for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-                QString convertedValue;
-
-                QStandardItem* dateItem = m_dataModel->item(row, config.dateColumnIndex);
-                QStandardItem* timeItem = m_dataModel->item(row, config.timeColumnIndex);
-
-                if (dateItem && timeItem) {
-                    QString dateStr = dateItem->text().trimmed();
-                    QString timeStr = timeItem->text().trimmed();
-
-                    QDate currentDate = parseDateString(dateStr);
-                    QTime currentTime = parseTimeString(timeStr);
-
-                    if (currentDate.isValid() && currentTime.isValid()) {
-                        if (row == 0) {
-                            // 第一行时间为0
-                            convertedValue = "0.000";
-                        } else {
-                            // 计算时间差：(当前日期-基准日期)*24 + (当前时刻-基准时刻)
-                            QDateTime baseDateTime = combineDateAndTime(baseDate, baseTime);
-                            QDateTime currentDateTime = combineDateAndTime(currentDate, currentTime);
-
-                            double timeDiff = calculateDateTimeDifference(baseDateTime, currentDateTime, config.outputUnit);
-                            convertedValue = QString::number(timeDiff, 'f', 3);
-                        }
-                        result.processedRows++;
-                    } else {
-                        // 无效数据设为空
-                        convertedValue = "";
-                    }
-                } else {
-                    convertedValue = "";
-                }
-
-                // 创建新的数据项
-                QStandardItem* newItem = new QStandardItem(convertedValue);
-                if (newItem) {
-                    newItem->setForeground(QBrush(QColor("#2c3e50")));
-                    m_dataModel->setItem(row, newColumnIndex, newItem);
-                }
-            }
-
+            sources << config.dateColumnIndex << config.timeColumnIndex;
         } else {
-            // 仅时间模式（原有逻辑）
+            // 仅时间模式
             if (config.sourceTimeColumnIndex < 0 || config.sourceTimeColumnIndex >= m_dataModel->columnCount()) {
                 result.errorMessage = "源时间列索引无效";
                 return result;
@@ -2005,84 +2056,61 @@ TimeConversionResult DataEditorWidget::convertTimeColumn(const TimeConversionCon
 
             // 在源列后面插入新列
             newColumnIndex = config.sourceTimeColumnIndex + 1;
-            m_dataModel->insertColumn(newColumnIndex);
-
-            // 设置列标题
-            QStandardItem* headerItem = new QStandardItem(newColumnName);
-            m_dataModel->setHorizontalHeaderItem(newColumnIndex, headerItem);
-
-            // 获取源列的所有时间数据
-            QList<QTime> timeValues;
-            QTime baseTime; // 基准时间（第一行的时间）
-            bool baseTimeSet = false;
+            sources << config.sourceTimeColumnIndex;
+        }
 
-            // 首先解析所有时间数据
-            for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-                QStandardItem* sourceItem = m_dataModel->item(row, config.sourceTimeColumnIndex);
-                if (sourceItem) {
-                    QString timeStr = sourceItem->text().trimmed();
-                    QTime parsedTime = parseTimeString(timeStr);
-
-                    if (parsedTime.isValid()) {
-                        timeValues.append(parsedTime);
-
-                        // 设置基准时间（第一个有效时间）
-                        if (!baseTimeSet) {
-                            baseTime = parsedTime;
-                            baseTimeSet = true;
-                        }
-                    } else {
-                        timeValues.append(QTime()); // 添加无效时间占位
-                    }
-                } else {
-                    timeValues.append(QTime()); // 添加无效时间占位
-                }
-            }
+        // 每行的绝对毫秒值（日历日编码）；无法解析的行 valid 为 0
+        updateProgress(30, "正在解析时间列...");
+        QVector<qint64> msecs;
+        QVector<char> valid;
+        bool hasDate = false;
+        if (!ElapsedTimeFormula::absoluteMsecs(m_dataModel, sources, msecs, valid, hasDate, result.errorMessage)) {
+            return result;
+        }
 
-            if (!baseTimeSet) {
-                result.errorMessage = "未找到有效的时间数据";
-                // 删除已创建的列
-                if (newColumnIndex < m_dataModel->columnCount()) {
-                    m_dataModel->removeColumn(newColumnIndex);
-                }
+        updateProgress(80, "正在生成时间列...");
+        DataColumn column;
+        if (outputDateTime) {
+            // 直接生成时间戳列（毫秒精度；有毫秒部分时显示到毫秒）
+            if (!hasDate) {
+                result.errorMessage = "源数据不含日期，无法生成日期时间列";
                 return result;
             }
+            bool hasMilliseconds = false;
+            for (int row = 0; row < rowCount && !hasMilliseconds; ++row) {
+                hasMilliseconds = valid[row] && msecs[row] % 1000 != 0;
+            }
 
-            // 计算相对时间并填充新列
-            for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-                QString convertedValue;
-
-                if (row < timeValues.size() && timeValues[row].isValid()) {
-                    if (row == 0) {
-                        // 第一行时间为0
-                        convertedValue = "0.000";
-                    } else {
-                        // 计算与基准时间的差值
-                        double timeDiff = calculateTimeDifference(baseTime, timeValues[row], config.outputUnit);
-                        convertedValue = QString::number(timeDiff, 'f', 3);
-                    }
+            column.header = newColumnName;
+            column.storage = ColumnStorage::Timestamp;
+            column.timestamps = msecs;
+            column.timestampFormat = hasMilliseconds ? "yyyy-MM-dd hh:mm:ss.zzz" : "yyyy-MM-dd hh:mm:ss";
+            for (int row = 0; row < rowCount; ++row) {
+                if (valid[row]) {
                     result.processedRows++;
                 } else {
-                    // 无效时间设为空
-                    convertedValue = "";
-                }
-
-                // 创建新的数据项
-                QStandardItem* newItem = new QStandardItem(convertedValue);
-                if (newItem) {
-                    newItem->setForeground(QBrush(QColor("#2c3e50")));
-                    m_dataModel->setItem(row, newColumnIndex, newItem);
+                    column.setValid(row, false);
                 }
             }
+        } else {
+            // 经过时间为派生列：源列改动后自动重算（源列索引按插入后的位置给出）
+            QVector<double> convertedValues = ElapsedTimeFormula::elapsedValues(msecs, valid, config.outputUnit);
+            result.processedRows = int(valid.count(1));
+            column = DataTableModel::makeNumericColumn(newColumnName, convertedValues, 'f', 3);
+            column.formula = QSharedPointer<const ColumnFormula>(
+                new ElapsedTimeFormula(sources, config.outputUnit));
+            column.formulaVersion = m_dataModel->dataVersion();
         }
+        column.foreground = QColor("#2c3e50");
+        m_dataModel->insertColumnData(newColumnIndex, column);
 
         // 安全地添加列定义
         try {
             ColumnDefinition newColumnDef;
             newColumnDef.name = newColumnName;
-            newColumnDef.type = WellTestColumnType::Time;
-            newColumnDef.unit = unitText;
-            newColumnDef.description = "相对时间";
+            newColumnDef.type = outputDateTime ? WellTestColumnType::Date : WellTestColumnType::Time;
+            newColumnDef.unit = outputDateTime ? "yyyy-MM-dd hh:mm:ss" : unitText;
+            newColumnDef.description = outputDateTime ? "日期时间" : "相对时间";
             newColumnDef.isRequired = false;
             newColumnDef.minValue = 0;
             newColumnDef.maxValue = 999999;
@@ -2384,59 +2412,15 @@ PressureDropResult DataEditorWidget::calculatePressureDrop()
 
     // 在压力列后面插入新列
     int newColumnIndex = pressureColumn + 1;
-    m_dataModel->insertColumn(newColumnIndex);
-
-    // 设置列标题
-    QStandardItem* headerItem = new QStandardItem(dropColumnName);
-    m_dataModel->setHorizontalHeaderItem(newColumnIndex, headerItem);
-
-    // 计算压降数据
-    int rowCount = m_dataModel->rowCount();
-    QList<double> pressureValues;
-
-    // 收集所有压力数据
-    for (int row = 0; row < rowCount; ++row) {
-        QStandardItem* pressureItem = m_dataModel->item(row, pressureColumn);
-        if (pressureItem) {
-            QString pressureText = pressureItem->text().trimmed();
-            if (isValidPressureData(pressureText)) {
-                bool ok;
-                double pressure = pressureText.toDouble(&ok);
-                if (ok) {
-                    pressureValues.append(pressure);
-                } else {
-                    pressureValues.append(0.0);
-                }
-            } else {
-                pressureValues.append(0.0);
-            }
-        } else {
-            pressureValues.append(0.0);
-        }
-    }
-
-    // 计算压降值 - 修正的计算逻辑：每个时刻相对于初始时刻的压降
-    double initialPressure = pressureValues.isEmpty() ? 0.0 : pressureValues[0]; // 获取初始压力
-
-    for (int row = 0; row < rowCount; ++row) {
-        double pressureDrop = 0.0;
-
-        if (row == 0) {
-            // 第1行（初始时刻）的压降为0
-            pressureDrop = 0.0;
-        } else {
-            // 其他行的压降 = 初始时刻压力 - 当前时刻压力
-            pressureDrop = initialPressure - pressureValues[row];
-        }
 
-        // 创建新的数据项
-        QString dropValueText = QString::number(pressureDrop, 'f', 3);
-        QStandardItem* dropItem = new QStandardItem(dropValueText);
-        dropItem->setForeground(QBrush(QColor("#2c3e50")));
-        m_dataModel->setItem(row, newColumnIndex, dropItem);
-
-        result.processedRows++;
-    }
+    // 压降为派生列：每个时刻相对于初始时刻的压降，压力列改动后自动重算
+    PressureDropFormula* formula = new PressureDropFormula(pressureColumn);
+    DataColumn dropColumn = DataTableModel::makeNumericColumn(dropColumnName, formula->evaluate(m_dataModel), 'f', 3);
+    dropColumn.foreground = QColor("#2c3e50");
+    dropColumn.formula = QSharedPointer<const ColumnFormula>(formula);
+    dropColumn.formulaVersion = m_dataModel->dataVersion();
+    m_dataModel->insertColumnData(newColumnIndex, dropColumn);
+    result.processedRows = m_dataModel->rowCount();
 
     // 添加列定义
     ColumnDefinition newColumnDef;
@@ -2479,12 +2463,14 @@ int DataEditorWidget::findPressureColumn() const
         }
     }
 
-    // 如果没有定义的压力列，尝试从列名推断
+    // 如果没有定义的压力列，尝试从列名推断（跳过没有数值的列，如"压力单位"文本列）
     for (int col = 0; col < m_dataModel->columnCount(); ++col) {
         QString headerText = m_dataModel->headerData(col, Qt::Horizontal).toString().toLower();
         if (headerText.contains("pressure") || headerText.contains("压力") ||
             headerText.contains("压强") || headerText == "p") {
-            return col;
+            if (m_statisticsCache->summary(col).numericCount > 0) {
+                return col;
+            }
         }
     }
 
@@ -2508,6 +2494,43 @@ int DataEditorWidget::findTimeColumn() const
     for (int col = 0; col < m_dataModel->columnCount(); ++col) {
         QString headerText = m_dataModel->headerData(col, Qt::Horizontal).toString().toLower();
         if (headerText.contains("time") || headerText.contains("时间") || headerText == "t") {
+            if (m_statisticsCache->summary(col).validCount > 0) {
+                return col;
+            }
+        }
+    }
+
+    // 列名无法识别时，取第一个无空值、单调递增的数值/时间戳列
+    for (int col = 0; col < m_dataModel->columnCount(); ++col) {
+        if (m_dataModel->columnStorage(col) == ColumnStorage::Text) continue;
+
+        ColumnSummary summary = m_statisticsCache->summary(col);
+        if (summary.rowCount > 1 && summary.numericCount == summary.rowCount &&
+            summary.ascending && summary.maximum > summary.minimum) {
+            return col;
+        }
+    }
+
+    return -1;
+}
+
+int DataEditorWidget::findRateColumn() const
+{
+    if (!m_dataModel) {
+        return -1;
+    }
+
+    // 优先查找已定义为流量的列
+    for (int i = 0; i < m_columnDefinitions.size() && i < m_dataModel->columnCount(); ++i) {
+        if (m_columnDefinitions[i].type == WellTestColumnType::FlowRate) {
+            return i;
+        }
+    }
+
+    // 如果没有定义的流量列，尝试从列名推断
+    for (int col = 0; col < m_dataModel->columnCount(); ++col) {
+        QString headerText = m_dataModel->headerData(col, Qt::Horizontal).toString().toLower();
+        if (headerText.contains("rate") || headerText.contains("流量") || headerText.contains("产量")) {
             return col;
         }
     }
@@ -2541,7 +2564,7 @@ bool DataEditorWidget::isValidPressureData(const QString& data) const
 
 void DataEditorWidget::onTableContextMenuRequested(const QPoint& pos)
 {
-    if (!m_dataModel || !m_contextMenu) {
+    if (!m_dataModel || !m_contextMenu || m_loading) {
         return;
     }
 
@@ -2629,20 +2652,9 @@ void DataEditorWidget::onDeleteSelectedRows()
     msgBox.setDefaultButton(QMessageBox::No);
 
     if (msgBox.exec() == QMessageBox::Yes) {
-        m_undoStack->beginMacro("删除多行");
-
-        for (int row : selectedRows) {
-            QStringList rowData;
-            for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-                QStandardItem* item = m_dataModel->item(row, col);
-                rowData.append(item ? item->text() : "");
-            }
-
-            RowEditCommand* command = new RowEditCommand(m_dataModel, RowEditCommand::Delete, row, rowData);
-            m_undoStack->push(command);
-        }
-
-        m_undoStack->endMacro();
+        // 按连续区间一次删除，撤销时一次恢复
+        RowRanges ranges = DataTableModel::toRowRanges(selectedRows);
+        m_undoStack->push(new RowRangeDeleteCommand(m_dataModel, ranges, "删除多行"));
 
         m_dataModified = true;
         updateStatus(QString("已删除 %1 行").arg(selectedRows.size()), "success");
@@ -2732,16 +2744,9 @@ void DataEditorWidget::onDeleteSelectedColumns()
         m_undoStack->beginMacro("删除多列");
 
         for (int col : selectedColumns) {
-            QStandardItem* headerItem = m_dataModel->horizontalHeaderItem(col);
-            QString headerName = headerItem ? headerItem->text() : QString("列%1").arg(col + 1);
-
-            QStringList columnData;
-            for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-                QStandardItem* item = m_dataModel->item(row, col);
-                columnData.append(item ? item->text() : "");
-            }
-
-            ColumnEditCommand* command = new ColumnEditCommand(m_dataModel, ColumnEditCommand::Delete, col, headerName, columnData);
+            // 删除命令在 redo() 中保存整列快照，无需预先逐格取文本
+            QString headerName = m_dataModel->headerText(col);
+            ColumnEditCommand* command = new ColumnEditCommand(m_dataModel, ColumnEditCommand::Delete, col, headerName);
             m_undoStack->push(command);
         }
 
@@ -2784,6 +2789,10 @@ int DataEditorWidget::getColumnFromPosition(const QPoint& pos) const
 
 void DataEditorWidget::onOpenFile()
 {
+    if (m_loading) {
+        return;
+    }
+
     if (m_dataModified && !checkDataModifiedAndPrompt()) {
         return;
     }
@@ -2827,74 +2836,12 @@ void DataEditorWidget::onOpenFile()
 void DataEditorWidget::loadData(const QString& filePath, const QString& fileType)
 {
     qDebug() << "开始加载文件:" << filePath << "类型:" << fileType;
+    startFileLoad(filePath, fileType, nullptr);
+}
 
-    QFileInfo fileInfo(filePath);
-    if (!fileInfo.exists() || !fileInfo.isReadable()) {
-        showStyledMessageBox("文件加载失败",
-                             QString("文件不存在或无法读取: %1").arg(filePath),
-                             QMessageBox::Warning);
-        return;
-    }
-
-    // 显示进度对话框
-    showAnimatedProgress("加载数据文件", "正在读取文件数据，请稍候...");
-
-    clearData();
-
-    m_currentFilePath = filePath;
-    m_currentFileType = fileType;
-    ui->filePathLineEdit->setText(filePath);
-
-    bool loadSuccess = false;
-    QString errorMessage;
-
-    updateProgress(20, "正在分析文件格式...");
-
-    QString lowerType = fileType.toLower();
-    if (lowerType == "excel") {
-        loadSuccess = loadExcelFileOptimized(filePath, errorMessage);
-    } else if (lowerType == "txt" || lowerType == "csv") {
-        loadSuccess = loadCsvFile(filePath, errorMessage);
-    } else if (lowerType == "json") {
-        loadSuccess = loadJsonFile(filePath, errorMessage);
-    } else {
-        errorMessage = QString("不支持的文件类型: %1").arg(fileType);
-    }
-
-    hideAnimatedProgress();
-
-    if (loadSuccess) {
-        updateStatus(QString("文件加载成功 - %1行 × %2列")
-                         .arg(m_dataModel->rowCount())
-                         .arg(m_dataModel->columnCount()), "success");
-
-        setButtonsEnabled(true);
-        m_dataModified = false;
-
-        applyColumnStyles();
-        optimizeColumnWidths();
-        optimizeTableDisplay();
-
-        // 弹出列定义对话框
-        QTimer::singleShot(500, this, &DataEditorWidget::onDefineColumns);
-
-        emitDataChanged();
-
-        qDebug() << "文件加载成功，数据行数:" << m_dataModel->rowCount()
-                 << "列数:" << m_dataModel->columnCount();
-    } else {
-        updateStatus("文件加载失败", "error");
-        showStyledMessageBox("文件加载失败",
-                             QString("无法加载文件: %1").arg(filePath),
-                             QMessageBox::Critical,
-                             errorMessage);
-        qDebug() << "文件加载失败:" << errorMessage;
-    }
-}
-
-// ============================================================================
-// 优化的文件加载方法
-// ============================================================================
+// ============================================================================
+// 优化的文件加载方法
+// ============================================================================
 
 bool DataEditorWidget::quickDetectFileFormat(const QString& filePath)
 {
@@ -3047,128 +2994,37 @@ bool DataEditorWidget::quickDetectFileFormat(const QString& filePath)
 
 bool DataEditorWidget::loadCsvFileWithConfig(const QString& filePath, const DataLoadConfigDialog::LoadConfig& config, QString& errorMessage)
 {
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        errorMessage = QString("无法打开文件: %1").arg(file.errorString());
-        return false;
-    }
-
-    QStringList lines;
-    QString usedEncoding = config.encoding;
-
-    QTextStream in(&file);
-
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-    if (config.encoding != "UTF-8") {
-        QTextCodec* codec = QTextCodec::codecForName(config.encoding.toLocal8Bit());
-        if (codec) {
-            in.setCodec(codec);
-        }
-    }
-#else
-    if (config.encoding == "GBK" || config.encoding == "GB2312") {
-        in.setEncoding(QStringConverter::System);
-    }
-#endif
-
-    // 读取所有行
-    while (!in.atEnd() && lines.size() < m_maxDisplayRows) {
-        QString line = in.readLine();
-        lines.append(line);
-    }
-
-    file.close();
-
-    if (lines.isEmpty()) {
-        errorMessage = "文件为空或无法读取";
-        return false;
-    }
-
-    updateProgress(70, "正在解析数据格式...");
-
-    // 检查起始行是否有效
-    if (config.startRow > lines.size()) {
-        errorMessage = QString("起始行 %1 超出文件总行数 %2").arg(config.startRow).arg(lines.size());
+    if (config.separator.size() != 1) {
+        errorMessage = QString("不支持的分隔符: %1").arg(config.separator);
         return false;
     }
 
-    if (lines.size() >= m_maxDisplayRows) {
-        m_largeFileMode = true;
-        qDebug() << "启用大文件模式，限制显示行数为" << m_maxDisplayRows;
-    }
+    updateProgress(50, "正在并行解析数据...");
 
-    // 确定表头
-    QStringList headers;
-    int dataStartIndex = config.startRow - 1; // 转换为0基索引
-
-    if (config.hasHeader && dataStartIndex < lines.size()) {
-        // 使用指定行作为表头
-        QStringList headerFields = splitCSVLine(lines[dataStartIndex], config.separator);
-        for (const QString& field : headerFields) {
-            QString header = field.trimmed();
-            if (header.isEmpty()) {
-                header = QString("列%1").arg(headers.size() + 1);
-            }
-            headers.append(header);
-        }
-        dataStartIndex++; // 数据从表头的下一行开始
-    } else {
-        // 没有表头，使用第一行数据确定列数
-        if (dataStartIndex < lines.size()) {
-            QStringList firstDataFields = splitCSVLine(lines[dataStartIndex], config.separator);
-            for (int i = 0; i < firstDataFields.size(); ++i) {
-                headers.append(QString("列%1").arg(i + 1));
-            }
-        }
-    }
+    // 内存映射 + 多线程解析，全文件加载（不再按 m_maxDisplayRows 截断）
+    CsvImportConfig importConfig;
+    importConfig.startRow = qMax(1, config.startRow);
+    importConfig.hasHeader = config.hasHeader;
+    importConfig.encoding = config.encoding;
+    importConfig.separator = config.separator.at(0).toLatin1();
+    importConfig.previewRows = isLoadThread() ? m_loadPreviewRows : 0;
 
-    if (headers.isEmpty()) {
-        errorMessage = "无法确定数据列结构";
+    CsvImportResult imported = m_csvLoader->load(filePath, importConfig);
+    if (!imported.success) {
+        errorMessage = imported.errorMessage;
         return false;
     }
 
-    m_dataModel->setColumnCount(headers.size());
-    m_dataModel->setHorizontalHeaderLabels(headers);
-
-    updateProgress(80, "正在加载数据...");
-
-    // 加载数据行
-    int rowIndex = 0;
-    for (int i = dataStartIndex; i < lines.size(); ++i) {
-        QStringList lineFields = splitCSVLine(lines[i], config.separator);
-
-        // 调整字段数量以匹配列数
-        while (lineFields.size() < headers.size()) {
-            lineFields.append("");
-        }
-        if (lineFields.size() > headers.size()) {
-            lineFields = lineFields.mid(0, headers.size());
-        }
-
-        // 插入新行
-        m_dataModel->insertRow(rowIndex);
-
-        // 填充数据
-        for (int col = 0; col < lineFields.size(); ++col) {
-            QString cellData = lineFields[col].trimmed();
-            QStandardItem* item = new QStandardItem(cellData);
-            item->setForeground(QBrush(QColor("#2c3e50")));
-            m_dataModel->setItem(rowIndex, col, item);
-        }
-        rowIndex++;
-
-        if (i % 100 == 0) {
-            updateProgress(80 + (i * 15 / lines.size()),
-                           QString("已加载 %1 行").arg(rowIndex));
-            QApplication::processEvents(); // 让界面保持响应
-        }
+    for (DataColumn& column : imported.columns) {
+        column.foreground = QColor("#2c3e50");
     }
+    setLoadedTable(imported.columns, imported.rowCount);
 
     updateProgress(100, "数据加载完成");
 
-    qDebug() << "成功加载" << m_dataModel->rowCount() << "行数据，"
-             << m_dataModel->columnCount() << "列，使用编码:" << usedEncoding
-             << "，起始行:" << config.startRow;
+    qDebug() << "成功加载" << imported.rowCount << "行数据，"
+             << imported.columns.size() << "列，使用编码:" << config.encoding
+             << "，起始行:" << config.startRow << "，分块数:" << imported.chunkCount;
 
     return true;
 }
@@ -3215,6 +3071,15 @@ bool DataEditorWidget::loadExcelFileOptimized(const QString& filePath, QString&
 
     updateProgress(30, "检测文件格式...");
 
+    // xlsx（ZIP 容器）使用内置读取器，不依赖 Excel COM
+    if (XlsxFile::isXlsxFile(filePath)) {
+        if (loadXlsxFile(filePath, errorMessage)) {
+            return true;
+        }
+        qDebug() << "内置 xlsx 读取失败:" << errorMessage;
+        return false;
+    }
+
     // 首先快速检测是否为CSV格式的Excel文件
     if (quickDetectFileFormat(filePath)) {
         updateProgress(50, "检测到CSV格式，使用快速读取...");
@@ -3229,15 +3094,7 @@ bool DataEditorWidget::loadExcelFileOptimized(const QString& filePath, QString&
         }
     }
 
-    updateProgress(60, "尝试COM组件读取...");
-
-#ifdef Q_OS_WIN
-    if (loadExcelWithCOM(filePath, errorMessage)) {
-        return true;
-    }
-    qDebug() << "COM方式失败，尝试通用方式:" << errorMessage;
-#endif
-
+    // COM 组件只能在主线程使用，由 onFileLoadFinished 在内置方式失败后尝试
     updateProgress(80, "使用通用方式读取...");
     return loadExcelAsCSV(filePath, errorMessage);
 }
@@ -3261,6 +3118,10 @@ bool DataEditorWidget::loadCsvFile(const QString& filePath, QString& errorMessag
     otherSeparators.removeOne(bestSeparator);
 
     for (const QString& separator : otherSeparators) {
+        if (m_loadCancelled) {
+            errorMessage = "加载已取消";
+            return false;
+        }
         updateProgress(60 + otherSeparators.indexOf(separator) * 10,
                        QString("尝试分隔符 '%1'...").arg(separator));
 
@@ -3276,167 +3137,87 @@ bool DataEditorWidget::loadCsvFile(const QString& filePath, QString& errorMessag
 
 bool DataEditorWidget::loadCSVFile(const QString& filePath, const QString& separator, QString& errorMessage)
 {
+    if (separator.size() != 1) {
+        errorMessage = QString("不支持的分隔符: %1").arg(separator);
+        return false;
+    }
+
+    // 快速验证数据一致性（只检查前5个非空行）
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
         errorMessage = QString("无法打开文件: %1").arg(file.errorString());
         return false;
     }
 
-    QStringList lines;
-    QString usedEncoding = "UTF-8";
-
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-    QStringList encodings = {"UTF-8", "GBK"};
-
-    for (const QString& encoding : encodings) {
-        file.seek(0);
-        QTextStream in(&file);
-
-        if (encoding != "UTF-8") {
-            QTextCodec* codec = QTextCodec::codecForName(encoding.toLocal8Bit());
-            if (codec) {
-                in.setCodec(codec);
-            }
-        }
-
-        lines.clear();
-        while (!in.atEnd() && lines.size() < m_maxDisplayRows) {
-            QString line = in.readLine().trimmed();
-            if (!line.isEmpty()) {
-                lines.append(line);
-            }
-        }
-
-        if (!lines.isEmpty()) {
-            usedEncoding = encoding;
-            break;
-        }
-    }
-#else
-    QTextStream in(&file);
-    while (!in.atEnd() && lines.size() < m_maxDisplayRows) {
-        QString line = in.readLine().trimmed();
+    QStringList sampleLines;
+    while (!file.atEnd() && sampleLines.size() < 5) {
+        QString line = QString::fromUtf8(file.readLine()).trimmed();
         if (!line.isEmpty()) {
-            lines.append(line);
-        }
-    }
-
-    if (lines.isEmpty()) {
-        file.seek(0);
-        QTextStream in2(&file);
-        in2.setEncoding(QStringConverter::Latin1);
-
-        while (!in2.atEnd() && lines.size() < m_maxDisplayRows) {
-            QString line = in2.readLine().trimmed();
-            if (!line.isEmpty()) {
-                lines.append(line);
-            }
+            sampleLines.append(line);
         }
-        usedEncoding = "Latin-1";
     }
-#endif
-
     file.close();
 
-    if (lines.isEmpty()) {
+    if (sampleLines.isEmpty()) {
         errorMessage = "文件为空或无法读取";
         return false;
     }
 
-    updateProgress(70, "正在解析数据格式...");
-
-    if (lines.size() >= m_maxDisplayRows) {
-        m_largeFileMode = true;
-        qDebug() << "启用大文件模式，限制显示行数为" << m_maxDisplayRows;
-    }
-
-    QString firstLine = lines.first();
-    QStringList fields = splitCSVLine(firstLine, separator);
-
-    if (fields.size() < 2) {
+    int expectedFields = splitCSVLine(sampleLines.first(), separator).size();
+    if (expectedFields < 2) {
         return false;
     }
 
-    // 快速验证数据一致性（只检查前5行）
-    int expectedFields = fields.size();
     int validLines = 0;
-
-    for (int i = 0; i < qMin(5, lines.size()); ++i) {
-        QStringList lineFields = splitCSVLine(lines[i], separator);
-        if (lineFields.size() == expectedFields) {
+    for (const QString& line : sampleLines) {
+        if (splitCSVLine(line, separator).size() == expectedFields) {
             validLines++;
         }
     }
-
-    if (validLines < qMin(5, lines.size()) * 0.6) {
+    if (validLines < sampleLines.size() * 0.6) {
         return false;
     }
 
     updateProgress(80, "正在加载数据...");
 
-    QStringList headers = fields;
-    for (int i = 0; i < headers.size(); ++i) {
-        headers[i] = headers[i].trimmed();
-        if (headers[i].isEmpty()) {
-            headers[i] = QString("列%1").arg(i + 1);
-        }
-    }
-
-    m_dataModel->setColumnCount(headers.size());
-    m_dataModel->setHorizontalHeaderLabels(headers);
+    // 全文件并行导入（首行存在非数值字段时视为表头）
+    CsvImportConfig importConfig;
+    importConfig.separator = separator.at(0).toLatin1();
+    importConfig.autoDetectHeader = true;
+    importConfig.previewRows = isLoadThread() ? m_loadPreviewRows : 0;
 
-    // 检查第一行是否为表头
-    bool firstRowIsHeader = false;
-    for (const QString& field : fields) {
-        bool isNumber;
-        field.toDouble(&isNumber);
-        if (!isNumber && !field.isEmpty()) {
-            firstRowIsHeader = true;
-            break;
-        }
+    CsvImportResult imported = m_csvLoader->load(filePath, importConfig);
+    if (!imported.success) {
+        errorMessage = imported.errorMessage;
+        return false;
     }
 
-    int dataStartRow = firstRowIsHeader ? 1 : 0;
-    int rowIndex = 0;
-
-    // 批量插入行以提高性能
-    int totalDataRows = lines.size() - dataStartRow;
-    m_dataModel->setRowCount(totalDataRows);
-
-    for (int i = dataStartRow; i < lines.size(); ++i) {
-        QStringList lineFields = splitCSVLine(lines[i], separator);
-
-        while (lineFields.size() < headers.size()) {
-            lineFields.append("");
-        }
-
-        if (lineFields.size() > headers.size()) {
-            lineFields = lineFields.mid(0, headers.size());
-        }
-
-        for (int col = 0; col < lineFields.size(); ++col) {
-            QString cellData = lineFields[col].trimmed();
-            QStandardItem* item = new QStandardItem(cellData);
-            item->setForeground(QBrush(QColor("#2c3e50")));
-            m_dataModel->setItem(rowIndex, col, item);
-        }
-        rowIndex++;
-
-        if (i % 500 == 0) {
-            updateProgress(80 + (i * 15 / lines.size()),
-                           QString("已加载 %1/%2 行").arg(i).arg(lines.size()));
-            QApplication::processEvents(); // 让界面保持响应
-        }
+    for (DataColumn& column : imported.columns) {
+        column.foreground = QColor("#2c3e50");
     }
+    setLoadedTable(imported.columns, imported.rowCount);
 
     updateProgress(100, "数据加载完成");
 
-    qDebug() << "成功加载" << m_dataModel->rowCount() << "行数据，"
-             << m_dataModel->columnCount() << "列，使用编码:" << usedEncoding;
+    qDebug() << "成功加载" << imported.rowCount << "行数据，"
+             << imported.columns.size() << "列，分块数:" << imported.chunkCount;
 
     return true;
 }
 
+void DataEditorWidget::setModelFromTextColumns(const QStringList& headers, QVector<QVector<QString>>& cells, int rowCount)
+{
+    // 逐列推断数值/时间戳/文本存储，整表一次性写入模型
+    QVector<DataColumn> columns;
+    columns.reserve(headers.size());
+    for (int col = 0; col < headers.size(); ++col) {
+        columns.append(DataTableModel::buildColumn(headers[col], cells[col]));
+        columns.last().foreground = QColor("#2c3e50");
+        cells[col] = QVector<QString>();  // 及时释放文本
+    }
+    setLoadedTable(columns, rowCount);
+}
+
 QStringList DataEditorWidget::splitCSVLine(const QString& line, const QString& separator)
 {
     QStringList result;
@@ -3471,6 +3252,10 @@ bool DataEditorWidget::loadExcelAsCSV(const QString& filePath, QString& errorMes
     QStringList separators = {",", "\t", ";", "|"};
 
     for (const QString& separator : separators) {
+        if (m_loadCancelled) {
+            errorMessage = "加载已取消";
+            return false;
+        }
         if (loadCSVFile(filePath, separator, errorMessage)) {
             qDebug() << "使用分隔符'" << separator << "'成功读取文件";
             return true;
@@ -3510,23 +3295,17 @@ bool DataEditorWidget::loadJsonFile(const QString& filePath, QString& errorMessa
         QJsonObject firstObj = array.first().toObject();
         QStringList headers = firstObj.keys();
 
-        m_dataModel->setColumnCount(headers.size());
-        m_dataModel->setHorizontalHeaderLabels(headers);
-
+        QVector<QVector<QString>> cells(headers.size());
         for (int i = 0; i < array.size(); ++i) {
             QJsonObject obj = array[i].toObject();
-            m_dataModel->insertRow(i);
 
             for (int col = 0; col < headers.size(); ++col) {
                 QString key = headers[col];
-                QString value = obj[key].toString();
-
-                QStandardItem* item = new QStandardItem(value);
-                item->setForeground(QBrush(QColor("#2c3e50")));
-                m_dataModel->setItem(i, col, item);
+                cells[col].append(obj[key].toString());
             }
         }
 
+        setModelFromTextColumns(headers, cells, array.size());
         return true;
     }
 
@@ -3579,9 +3358,6 @@ bool DataEditorWidget::loadExcelWithCOM(const QString& filePath, QString& errorM
             return false;
         }
 
-        m_dataModel->setRowCount(rowCount > 1 ? rowCount-1 : 0);
-        m_dataModel->setColumnCount(columnCount);
-
         // 设置表头
         QStringList headers;
         for (int col = 1; col <= columnCount; ++col) {
@@ -3592,18 +3368,16 @@ bool DataEditorWidget::loadExcelWithCOM(const QString& filePath, QString& errorM
             }
             headers.append(headerText);
         }
-        m_dataModel->setHorizontalHeaderLabels(headers);
 
         // 读取数据
+        QVector<QVector<QString>> cells(columnCount);
         for (int row = 2; row <= rowCount; ++row) {
             for (int col = 1; col <= columnCount; ++col) {
                 QAxObject* cell = worksheet->querySubObject("Cells(int,int)", row, col);
-                QString value = cell ? cell->property("Value").toString() : "";
-                QStandardItem* item = new QStandardItem(value);
-                item->setForeground(QBrush(QColor("#2c3e50")));
-                m_dataModel->setItem(row-2, col-1, item);
+                cells[col-1].append(cell ? cell->property("Value").toString() : "");
             }
         }
+        setModelFromTextColumns(headers, cells, rowCount > 1 ? rowCount-1 : 0);
 
         workbook->dynamicCall("Close()");
         excel.dynamicCall("Quit()");
@@ -3752,62 +3526,50 @@ void DataEditorWidget::onDataClean()
     }
 
     DataCleaningDialog dialog(this);
-    if (dialog.exec() == QDialog::Accepted) {
-        DataCleaningDialog::CleaningOptions options = dialog.getCleaningOptions();
 
-        showAnimatedProgress("数据清理", "正在清理数据...");
+    // 预览：在模型副本上模拟各步骤，只显示影响范围
+    connect(&dialog, &DataCleaningDialog::previewRequested, this, [this, &dialog]() {
+        DataCleaningResult preview = m_dataCleaner->plan(m_dataModel, cleaningConfig(dialog.getCleaningOptions()));
+        dialog.setPreviewText(preview.success ? preview.summary() : preview.errorMessage);
+    });
 
-        int cleanedCount = 0;
-
-        if (options.removeEmptyRows) {
-            removeEmptyRows();
-            cleanedCount++;
-            updateProgress(20, "删除空行...");
-        }
-
-        if (options.removeEmptyColumns) {
-            removeEmptyColumns();
-            cleanedCount++;
-            updateProgress(40, "删除空列...");
-        }
-
-        if (options.removeDuplicates) {
-            removeDuplicates();
-            cleanedCount++;
-            updateProgress(60, "删除重复行...");
-        }
-
-        if (options.fillMissingValues) {
-            fillMissingValues(options.fillMethod);
-            cleanedCount++;
-            updateProgress(80, "填充缺失值...");
-        }
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
 
-        if (options.removeOutliers) {
-            removeOutliers(options.outlierThreshold);
-            cleanedCount++;
-            updateProgress(90, "删除异常值...");
-        }
+    DataCleaningDialog::CleaningOptions options = dialog.getCleaningOptions();
+    DataCleaningConfig config = cleaningConfig(options);
+    bool anyStep = config.removeEmptyRows || config.removeEmptyColumns || config.removeDuplicates ||
+                   config.removeOutliers || config.fillMissingValues || config.resample ||
+                   options.standardizeFormat;
+    if (!anyStep) {
+        showStyledMessageBox("数据清理", "未选择任何清理操作", QMessageBox::Information);
+        return;
+    }
 
-        if (options.standardizeFormat) {
-            standardizeDataFormat();
-            cleanedCount++;
-            updateProgress(100, "标准化格式...");
-        }
+    showAnimatedProgress("数据清理", "正在清理数据...");
 
+    DataCleaningResult result = m_dataCleaner->plan(m_dataModel, config);
+    if (!result.success) {
         hideAnimatedProgress();
+        showStyledMessageBox("数据清理", "数据清理失败：" + result.errorMessage, QMessageBox::Warning);
+        return;
+    }
 
-        if (cleanedCount > 0) {
-            updateStatus("数据清理完成", "success");
-            m_dataModified = true;
-            emitDataChanged();
-            showStyledMessageBox("数据清理",
-                                 QString("数据清理完成，执行了 %1 项清理操作").arg(cleanedCount),
-                                 QMessageBox::Information);
-        } else {
-            showStyledMessageBox("数据清理", "未选择任何清理操作", QMessageBox::Information);
-        }
+    // 整个清理过程作为一步撤销
+    m_undoStack->beginMacro("数据清理");
+    applyCleaningResult(result);
+    if (options.standardizeFormat) {
+        updateProgress(95, "标准化格式...");
+        standardizeDataFormat();
     }
+    m_undoStack->endMacro();
+    hideAnimatedProgress();
+
+    updateStatus("数据清理完成", "success");
+    m_dataModified = true;
+    emitDataChanged();
+    showStyledMessageBox("数据清理", "数据清理完成\n\n" + result.summary(), QMessageBox::Information);
 }
 
 void DataEditorWidget::onDataStatistics()
@@ -3819,7 +3581,7 @@ void DataEditorWidget::onDataStatistics()
 
     showAnimatedProgress("数据统计", "正在计算统计信息...");
 
-    QList<DataStatistics> statistics = calculateAllStatistics();
+    QList<DataStatistics> statistics = calculateAllStatistics(true);
 
     hideAnimatedProgress();
 
@@ -3892,7 +3654,7 @@ void DataEditorWidget::clearDataFilter()
 // 核心数据处理功能实现（简化版本）
 // ============================================================================
 
-DataStatistics DataEditorWidget::calculateColumnStatistics(int column) const
+DataStatistics DataEditorWidget::calculateColumnStatistics(int column, bool exact) const
 {
     DataStatistics stats;
 
@@ -3907,75 +3669,39 @@ DataStatistics DataEditorWidget::calculateColumnStatistics(int column) const
         stats.unit = m_columnDefinitions[column].unit;
     }
 
-    stats.dataCount = m_dataModel->rowCount();
-    stats.validCount = 0;
-    stats.invalidCount = 0;
-
-    QList<double> numericValues;
-    QStringList textValues;
+    // 摘要由缓存增量维护，未改动的列直接返回
+    ColumnSummary summary = m_statisticsCache->summary(column);
 
-    for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-        QStandardItem* item = m_dataModel->item(row, column);
-        QString value = item ? item->text().trimmed() : "";
-
-        if (value.isEmpty()) {
-            stats.invalidCount++;
-            continue;
-        }
-
-        bool isNumeric;
-        double numValue = value.toDouble(&isNumeric);
-
-        if (isNumeric) {
-            numericValues.append(numValue);
-            stats.validCount++;
-        } else {
-            textValues.append(value);
-            stats.validCount++;
-        }
-    }
+    stats.dataCount = summary.rowCount;
+    stats.validCount = summary.validCount;
+    stats.invalidCount = summary.rowCount - summary.validCount;
+    stats.minimum = 0;
+    stats.maximum = 0;
+    stats.average = 0;
+    stats.median = 0;
+    stats.standardDeviation = 0;
 
-    if (numericValues.size() > textValues.size()) {
+    if (m_dataModel->columnStorage(column) == ColumnStorage::Timestamp) {
+        stats.dataType = "时间型";
+    } else if (summary.numericCount > summary.validCount - summary.numericCount) {
         stats.dataType = "数值型";
 
-        if (!numericValues.isEmpty()) {
-            std::sort(numericValues.begin(), numericValues.end());
-
-            stats.minimum = numericValues.first();
-            stats.maximum = numericValues.last();
-
-            double sum = 0;
-            for (double val : numericValues) {
-                sum += val;
-            }
-            stats.average = sum / numericValues.size();
-
-            int size = numericValues.size();
-            if (size % 2 == 0) {
-                stats.median = (numericValues[size/2 - 1] + numericValues[size/2]) / 2.0;
-            } else {
-                stats.median = numericValues[size/2];
-            }
-
-            double variance = 0;
-            for (double val : numericValues) {
-                variance += std::pow(val - stats.average, 2);
-            }
-            stats.standardDeviation = std::sqrt(variance / numericValues.size());
+        if (summary.numericCount > 0) {
+            stats.minimum = summary.minimum;
+            stats.maximum = summary.maximum;
+            stats.average = summary.mean;
+            stats.median = exact ? m_statisticsCache->exactQuantile(column, 0.5)
+                                 : summary.approximateQuantile(0.5);
+            stats.standardDeviation = std::sqrt(summary.variance());
         }
     } else {
         stats.dataType = "文本型";
-        stats.minimum = 0;
-        stats.maximum = 0;
-        stats.average = 0;
-        stats.median = 0;
-        stats.standardDeviation = 0;
     }
 
     return stats;
 }
 
-QList<DataStatistics> DataEditorWidget::calculateAllStatistics() const
+QList<DataStatistics> DataEditorWidget::calculateAllStatistics(bool exact) const
 {
     QList<DataStatistics> allStats;
 
@@ -3984,291 +3710,142 @@ QList<DataStatistics> DataEditorWidget::calculateAllStatistics() const
     }
 
     for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-        allStats.append(calculateColumnStatistics(col));
+        allStats.append(calculateColumnStatistics(col, exact));
     }
 
     return allStats;
 }
 
 // ============================================================================
-// 简化的数据清理功能
+// 数据清理
 // ============================================================================
 
-void DataEditorWidget::removeEmptyRows()
+void DataEditorWidget::setupDataCleaner()
 {
-    if (!m_dataModel) return;
-
-    QList<int> emptyRows;
-
-    for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-        bool isEmpty = true;
-        for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-            QStandardItem* item = m_dataModel->item(row, col);
-            if (item && !item->text().trimmed().isEmpty()) {
-                isEmpty = false;
-                break;
-            }
-        }
-        if (isEmpty) {
-            emptyRows.append(row);
-        }
-    }
+    m_dataCleaner = new DataCleaner(this);
 
-    if (!emptyRows.isEmpty()) {
-        std::sort(emptyRows.begin(), emptyRows.end(), std::greater<int>());
-
-        m_undoStack->beginMacro("删除空行");
-        for (int row : emptyRows) {
-            QStringList rowData;
-            for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-                QStandardItem* item = m_dataModel->item(row, col);
-                rowData.append(item ? item->text() : "");
-            }
+    connect(m_dataCleaner, &DataCleaner::progressUpdated,
+            this, [this](int progress, const QString& message) {
+                updateProgress(progress, message);
+            });
+}
 
-            RowEditCommand* command = new RowEditCommand(m_dataModel, RowEditCommand::Delete, row, rowData);
-            m_undoStack->push(command);
-        }
-        m_undoStack->endMacro();
+DataCleaningConfig DataEditorWidget::cleaningConfig(const DataCleaningDialog::CleaningOptions& options) const
+{
+    DataCleaningConfig config;
+    config.removeEmptyRows = options.removeEmptyRows;
+    config.removeEmptyColumns = options.removeEmptyColumns;
+    config.removeDuplicates = options.removeDuplicates;
+    config.removeOutliers = options.removeOutliers;
+    config.outlierWindow = options.outlierWindow;
+    config.outlierThreshold = options.outlierThreshold;
+    config.fillMissingValues = options.fillMissingValues;
+    config.maxGap = options.maxGap;
+    config.resample = options.resample;
+    config.resampleInterval = options.resampleInterval;
+    config.timeColumnIndex = findTimeColumn();
+
+    if (options.fillMethod == "zero") {
+        config.fillMethod = FillMethod::Zero;
+    } else if (options.fillMethod == "time") {
+        config.fillMethod = FillMethod::TimeWeighted;
+    } else if (options.fillMethod == "average") {
+        config.fillMethod = FillMethod::Average;
+    } else if (options.fillMethod == "forward") {
+        config.fillMethod = FillMethod::Forward;
+    } else {
+        config.fillMethod = FillMethod::Linear;
     }
+    return config;
 }
 
-void DataEditorWidget::removeEmptyColumns()
+void DataEditorWidget::applyCleaningResult(const DataCleaningResult& result)
 {
     if (!m_dataModel) return;
 
-    QList<int> emptyColumns;
+    // 各步骤按计算顺序作为子命令执行，行号/列号与 plan() 中的中间表一致
+    QUndoCommand* cleanCommand = new QUndoCommand("数据清理");
 
-    for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-        bool isEmpty = true;
-        for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-            QStandardItem* item = m_dataModel->item(row, col);
-            if (item && !item->text().trimmed().isEmpty()) {
-                isEmpty = false;
-                break;
-            }
-        }
-        if (isEmpty) {
-            emptyColumns.append(col);
-        }
-    }
+    for (const CleaningStepResult& step : result.steps) {
+        if (step.isEmpty()) continue;
 
-    if (!emptyColumns.isEmpty()) {
-        std::sort(emptyColumns.begin(), emptyColumns.end(), std::greater<int>());
+        // 删除列：从后往前，列号不受前面删除的影响
+        for (int i = step.removedColumns.size() - 1; i >= 0; --i) {
+            int col = step.removedColumns[i];
+            new ColumnEditCommand(m_dataModel, ColumnEditCommand::Delete, col,
+                                  m_dataModel->headerText(col), QStringList(), cleanCommand);
+        }
 
-        m_undoStack->beginMacro("删除空列");
-        for (int col : emptyColumns) {
-            QStandardItem* headerItem = m_dataModel->horizontalHeaderItem(col);
-            QString headerName = headerItem ? headerItem->text() : QString("列%1").arg(col + 1);
+        if (!step.removedRows.isEmpty()) {
+            new RowRangeDeleteCommand(m_dataModel, step.removedRows, step.name, cleanCommand);
+        }
 
-            QStringList columnData;
-            for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-                QStandardItem* item = m_dataModel->item(row, col);
-                columnData.append(item ? item->text() : "");
-            }
+        for (const CleaningCellChange& change : step.cellChanges) {
+            new ColumnCellsCommand(m_dataModel, change.column, change.rows, change.values,
+                                   step.name, cleanCommand);
+        }
 
-            ColumnEditCommand* command = new ColumnEditCommand(m_dataModel, ColumnEditCommand::Delete, col, headerName, columnData);
-            m_undoStack->push(command);
+        if (step.replacesTable) {
+            new TableSnapshotCommand(m_dataModel, step.table, step.tableRowCount, step.name, cleanCommand);
         }
-        m_undoStack->endMacro();
+    }
+
+    if (cleanCommand->childCount() > 0) {
+        m_undoStack->push(cleanCommand);
+    } else {
+        delete cleanCommand;
     }
 }
 
-void DataEditorWidget::removeDuplicates()
+void DataEditorWidget::standardizeDataFormat()
 {
     if (!m_dataModel) return;
 
-    QSet<QString> uniqueRows;
-    QList<int> duplicateRows;
+    QUndoCommand* formatCommand = new QUndoCommand("标准化格式");
 
-    for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-        QStringList rowData;
-        for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-            QStandardItem* item = m_dataModel->item(row, col);
-            rowData.append(item ? item->text().trimmed() : "");
-        }
+    for (int col = 0; col < m_dataModel->columnCount() && col < m_columnDefinitions.size(); ++col) {
+        // 根据列定义标准化格式
+        const ColumnDefinition& def = m_columnDefinitions[col];
 
-        QString rowSignature = rowData.join("|");
-        if (uniqueRows.contains(rowSignature)) {
-            duplicateRows.append(row);
-        } else {
-            uniqueRows.insert(rowSignature);
+        // 数值类型标准化
+        if (def.type != WellTestColumnType::Pressure &&
+            def.type != WellTestColumnType::Temperature &&
+            def.type != WellTestColumnType::FlowRate &&
+            def.type != WellTestColumnType::Time) {
+            continue;
         }
-    }
-
-    if (!duplicateRows.isEmpty()) {
-        std::sort(duplicateRows.begin(), duplicateRows.end(), std::greater<int>());
-
-        m_undoStack->beginMacro("删除重复行");
-        for (int row : duplicateRows) {
-            QStringList rowData;
-            for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-                QStandardItem* item = m_dataModel->item(row, col);
-                rowData.append(item ? item->text() : "");
-            }
-
-            RowEditCommand* command = new RowEditCommand(m_dataModel, RowEditCommand::Delete, row, rowData);
-            m_undoStack->push(command);
-        }
-        m_undoStack->endMacro();
-    }
-}
-
-void DataEditorWidget::fillMissingValues(const QString& method)
-{
-    if (!m_dataModel) return;
 
-    for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-        QList<double> numericValues;
-        QList<int> validIndices;
-
-        // 收集有效的数值
-        for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-            QStandardItem* item = m_dataModel->item(row, col);
-            if (item) {
-                bool ok;
-                double value = item->text().toDouble(&ok);
+        // 变换后的整列作为快照命令写入；数值列只改显示格式，数组与原列共享
+        DataColumn column = m_dataModel->column(col);
+        if (column.storage == ColumnStorage::Numeric) {
+            column.numberFormat = 'f';
+            column.precision = def.decimalPlaces;
+        } else if (column.storage == ColumnStorage::Text) {
+            bool changed = false;
+            for (int row = 0; row < m_dataModel->rowCount(); ++row) {
+                bool ok = false;
+                double value = m_dataModel->value(row, col, &ok);
                 if (ok) {
-                    numericValues.append(value);
-                    validIndices.append(row);
-                }
-            }
-        }
-
-        if (numericValues.isEmpty()) continue;
-
-        // 填充缺失值
-        for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-            QStandardItem* item = m_dataModel->item(row, col);
-            if (!item || item->text().trimmed().isEmpty()) {
-                QString fillValue;
-
-                if (method == "zero") {
-                    fillValue = "0";
-                } else if (method == "average") {
-                    double sum = 0;
-                    for (double val : numericValues) {
-                        sum += val;
-                    }
-                    fillValue = QString::number(sum / numericValues.size(), 'f', 3);
-                } else if (method == "interpolation") {
-                    // 简单的线性插值
-                    if (!validIndices.isEmpty()) {
-                        fillValue = QString::number(numericValues.first(), 'f', 3);
+                    QString formatted = QString::number(value, 'f', def.decimalPlaces);
+                    if (formatted != column.texts[row]) {
+                        column.texts[row] = formatted;
+                        changed = true;
                     }
-                } else if (method == "forward") {
-                    // 前值填充
-                    for (int prevRow = row - 1; prevRow >= 0; --prevRow) {
-                        QStandardItem* prevItem = m_dataModel->item(prevRow, col);
-                        if (prevItem && !prevItem->text().trimmed().isEmpty()) {
-                            fillValue = prevItem->text();
-                            break;
-                        }
-                    }
-                }
-
-                if (!fillValue.isEmpty()) {
-                    if (!item) {
-                        item = new QStandardItem(fillValue);
-                        m_dataModel->setItem(row, col, item);
-                    } else {
-                        item->setText(fillValue);
-                    }
-                    item->setForeground(QBrush(QColor("#6c757d"))); // 标记为填充值
                 }
             }
+            if (!changed) continue;
+        } else {
+            continue;
         }
-    }
-}
-
-void DataEditorWidget::removeOutliers(double threshold)
-{
-    if (!m_dataModel) return;
-
-    for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-        QList<double> values;
-        QList<int> validRows;
-
-        // 收集数值数据
-        for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-            QStandardItem* item = m_dataModel->item(row, col);
-            if (item) {
-                bool ok;
-                double value = item->text().toDouble(&ok);
-                if (ok) {
-                    values.append(value);
-                    validRows.append(row);
-                }
-            }
-        }
-
-        if (values.size() < 3) continue; // 数据太少，跳过
-
-        // 计算平均值和标准差
-        double sum = 0;
-        for (double val : values) {
-            sum += val;
-        }
-        double mean = sum / values.size();
-
-        double variance = 0;
-        for (double val : values) {
-            variance += std::pow(val - mean, 2);
-        }
-        double stdDev = std::sqrt(variance / values.size());
-
-        // 标记异常值
-        QList<int> outlierRows;
-        for (int i = 0; i < values.size(); ++i) {
-            if (std::abs(values[i] - mean) > threshold * stdDev) {
-                outlierRows.append(validRows[i]);
-            }
-        }
-
-        // 删除异常值（从后往前删除）
-        if (!outlierRows.isEmpty()) {
-            std::sort(outlierRows.begin(), outlierRows.end(), std::greater<int>());
 
-            for (int row : outlierRows) {
-                QStandardItem* item = m_dataModel->item(row, col);
-                if (item) {
-                    item->setText(""); // 清空异常值
-                }
-            }
-        }
+        new ColumnSnapshotCommand(m_dataModel, col, column,
+                                  QString("标准化格式 %1").arg(m_dataModel->headerText(col)), formatCommand);
     }
-}
-
-void DataEditorWidget::standardizeDataFormat()
-{
-    if (!m_dataModel) return;
 
-    for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-        for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-            QStandardItem* item = m_dataModel->item(row, col);
-            if (!item) continue;
-
-            QString text = item->text().trimmed();
-            if (text.isEmpty()) continue;
-
-            // 根据列定义标准化格式
-            if (col < m_columnDefinitions.size()) {
-                const ColumnDefinition& def = m_columnDefinitions[col];
-
-                // 数值类型标准化
-                if (def.type == WellTestColumnType::Pressure ||
-                    def.type == WellTestColumnType::Temperature ||
-                    def.type == WellTestColumnType::FlowRate ||
-                    def.type == WellTestColumnType::Time) {
-
-                    bool ok;
-                    double value = text.toDouble(&ok);
-                    if (ok) {
-                        QString formatted = QString::number(value, 'f', def.decimalPlaces);
-                        item->setText(formatted);
-                    }
-                }
-            }
-        }
+    if (formatCommand->childCount() > 0) {
+        m_undoStack->push(formatCommand);
+    } else {
+        delete formatCommand;
     }
 }
 
@@ -4278,9 +3855,18 @@ void DataEditorWidget::standardizeDataFormat()
 
 bool DataEditorWidget::saveExcelFile(const QString& filePath)
 {
-    // 简化版本：保存为CSV格式
+    if (filePath.endsWith(".xlsx", Qt::CaseInsensitive)) {
+        QString errorMessage;
+        if (!m_xlsxFile->save(filePath, m_dataModel, errorMessage)) {
+            qDebug() << "保存 xlsx 失败:" << errorMessage;
+            return false;
+        }
+        return true;
+    }
+
+    // 旧版 .xls 二进制格式不支持写出，另存为CSV格式
     QString csvPath = filePath;
-    if (filePath.endsWith(".xlsx", Qt::CaseInsensitive) || filePath.endsWith(".xls", Qt::CaseInsensitive)) {
+    if (filePath.endsWith(".xls", Qt::CaseInsensitive)) {
         csvPath = filePath + ".csv";
     }
     return saveCsvFile(csvPath);
@@ -4316,8 +3902,7 @@ bool DataEditorWidget::saveCsvFile(const QString& filePath)
     for (int row = 0; row < m_dataModel->rowCount(); ++row) {
         QStringList fields;
         for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-            QStandardItem* item = m_dataModel->item(row, col);
-            QString text = item ? item->text() : "";
+            QString text = m_dataModel->text(row, col);
 
             if (text.contains(',') || text.contains('"') || text.contains('\n')) {
                 text = '"' + text.replace('"', "\"\"") + '"';
@@ -4348,8 +3933,7 @@ bool DataEditorWidget::saveJsonFile(const QString& filePath)
         QJsonObject jsonObject;
 
         for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-            QStandardItem* item = m_dataModel->item(row, col);
-            QString value = item ? item->text() : "";
+            QString value = m_dataModel->text(row, col);
 
             bool isNumber;
             double numValue = value.toDouble(&isNumber);
@@ -4423,8 +4007,7 @@ bool DataEditorWidget::exportToPdf(const QString& filePath)
     for (int row = 0; row < maxRows; ++row) {
         htmlContent += "<tr>";
         for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-            QStandardItem* item = m_dataModel->item(row, col);
-            QString text = item ? item->text() : "";
+            QString text = m_dataModel->text(row, col);
             htmlContent += QString("<td>%1</td>").arg(text.toHtmlEscaped());
         }
         htmlContent += "</tr>";
@@ -4518,8 +4101,7 @@ bool DataEditorWidget::exportToHtml(const QString& filePath)
     for (int row = 0; row < m_dataModel->rowCount(); ++row) {
         out << "<tr>\n";
         for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-            QStandardItem* item = m_dataModel->item(row, col);
-            QString text = item ? item->text() : "";
+            QString text = m_dataModel->text(row, col);
             out << QString("<td>%1</td>\n").arg(text.toHtmlEscaped());
         }
         out << "</tr>\n";
@@ -4559,8 +4141,7 @@ ValidationResult DataEditorWidget::validateData() const
         bool isEmpty = true;
 
         for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-            QStandardItem* item = m_dataModel->item(row, col);
-            QString value = item ? item->text().trimmed() : "";
+            QString value = m_dataModel->text(row, col).trimmed();
 
             if (!value.isEmpty()) {
                 isEmpty = false;
@@ -4600,8 +4181,7 @@ bool DataEditorWidget::validateColumnData(int columnIndex, const ColumnDefinitio
     int emptyCount = 0;
 
     for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-        QStandardItem* item = m_dataModel->item(row, columnIndex);
-        QString value = item ? item->text().trimmed() : "";
+        QString value = m_dataModel->text(row, columnIndex).trimmed();
 
         if (value.isEmpty()) {
             emptyCount++;
@@ -4679,8 +4259,7 @@ QStringList DataEditorWidget::detectDataType(int column) const
     QSet<QString> types;
 
     for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-        QStandardItem* item = m_dataModel->item(row, column);
-        QString value = item ? item->text().trimmed() : "";
+        QString value = m_dataModel->text(row, column).trimmed();
 
         if (value.isEmpty()) {
             continue;
@@ -4737,29 +4316,29 @@ void DataEditorWidget::applyColumnDefinition(int columnIndex, const ColumnDefini
         return;
     }
 
-    // 应用数据格式
-    for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-        QStandardItem* item = m_dataModel->item(row, columnIndex);
-        if (!item) continue;
+    // 根据类型格式化数值
+    if (definition.type == WellTestColumnType::Pressure ||
+        definition.type == WellTestColumnType::Temperature ||
+        definition.type == WellTestColumnType::FlowRate ||
+        definition.type == WellTestColumnType::Time) {
 
-        // 根据类型格式化数值
-        if (definition.type == WellTestColumnType::Pressure ||
-            definition.type == WellTestColumnType::Temperature ||
-            definition.type == WellTestColumnType::FlowRate ||
-            definition.type == WellTestColumnType::Time) {
-
-            bool ok;
-            double value = item->text().toDouble(&ok);
-            if (ok) {
-                QString formatted = QString::number(value, 'f', definition.decimalPlaces);
-                item->setText(formatted);
+        if (m_dataModel->columnStorage(columnIndex) == ColumnStorage::Numeric) {
+            // 数值列只改显示格式，存储的 double 保持全精度
+            m_dataModel->setColumnNumberFormat(columnIndex, 'f', definition.decimalPlaces);
+        } else {
+            for (int row = 0; row < m_dataModel->rowCount(); ++row) {
+                bool ok = false;
+                double value = m_dataModel->value(row, columnIndex, &ok);
+                if (ok) {
+                    m_dataModel->setText(row, columnIndex, QString::number(value, 'f', definition.decimalPlaces));
+                }
             }
         }
+    }
 
-        // 设置颜色标记
-        if (definition.isRequired) {
-            item->setBackground(QBrush(QColor("#fff3cd"))); // 淡黄色背景表示必需
-        }
+    // 设置颜色标记
+    if (definition.isRequired) {
+        m_dataModel->setColumnBackground(columnIndex, QColor("#fff3cd")); // 淡黄色背景表示必需
     }
 }
 
@@ -4803,18 +4382,6 @@ bool DataEditorWidget::canRedo() const
 // 数据模型变化处理
 // ============================================================================
 
-void DataEditorWidget::onCellDataChanged(QStandardItem* item)
-{
-    if (!item || !m_undoStack) {
-        return;
-    }
-
-    m_dataModified = true;
-    updateStatus("数据已修改", "warning");
-    updateDataInfo();
-    emitDataChanged();
-}
-
 void DataEditorWidget::onModelDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight)
 {
     Q_UNUSED(topLeft)
@@ -4878,19 +4445,26 @@ void DataEditorWidget::setButtonsEnabled(bool enabled)
     ui->btnTimeConvert->setEnabled(enabled);
     ui->btnPressureDropCalc->setEnabled(enabled);
     ui->btnPressureDerivativeCalc->setEnabled(enabled);
+    ui->btnDeconvolution->setEnabled(enabled);
+    ui->btnFlowPeriods->setEnabled(enabled);
     ui->btnDataClean->setEnabled(enabled);
     ui->btnDataStatistics->setEnabled(enabled);
 }
 
-void DataEditorWidget::showAnimatedProgress(const QString& title, const QString& message)
+void DataEditorWidget::showAnimatedProgress(const QString& title, const QString& message, bool cancelable)
 {
     if (!m_progressDialog) {
         m_progressDialog = new AnimatedProgressDialog(title, message, this);
+        connect(m_progressDialog, &AnimatedProgressDialog::cancelRequested,
+                this, &DataEditorWidget::cancelFileLoad);
     } else {
         m_progressDialog->setWindowTitle(title);
         m_progressDialog->setMessage(message);
     }
 
+    // 可取消的任务在后台运行，对话框不阻塞主窗口（可浏览已显示的预览数据）
+    m_progressDialog->setCancelable(cancelable);
+    m_progressDialog->setModal(!cancelable);
     m_progressDialog->show();
     QApplication::processEvents();
 }
@@ -4904,12 +4478,23 @@ void DataEditorWidget::hideAnimatedProgress()
 
 void DataEditorWidget::updateProgress(int value, const QString& message)
 {
+    // 后台加载线程的进度排队到主线程显示
+    if (isLoadThread()) {
+        QMetaObject::invokeMethod(this, [this, value, message]() {
+            updateProgress(value, message);
+        }, Qt::QueuedConnection);
+        return;
+    }
+
     if (m_progressDialog) {
         m_progressDialog->setProgress(value);
         if (!message.isEmpty()) {
             m_progressDialog->setMessage(message);
         }
-        QApplication::processEvents();
+        // 后台加载期间事件循环照常运行，不能在此重入
+        if (!m_loading) {
+            QApplication::processEvents();
+        }
     }
 }
 
@@ -4947,13 +4532,8 @@ void DataEditorWidget::applyColumnStyles()
 
     QColor textColor("#2c3e50");
 
-    for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-        for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-            QStandardItem* item = m_dataModel->item(row, col);
-            if (item) {
-                item->setForeground(QBrush(textColor));
-            }
-        }
+    for (int col = 0; col < m_dataModel->columnCount(); ++col) {
+        m_dataModel->setColumnForeground(col, textColor);
     }
 }
 
@@ -4963,32 +4543,34 @@ void DataEditorWidget::optimizeColumnWidths()
         return;
     }
 
-    try {
-        ui->dataTableView->resizeColumnsToContents();
+    QHeaderView* header = ui->dataTableView->horizontalHeader();
+    if (!header) {
+        return;
+    }
 
-        QHeaderView* header = ui->dataTableView->horizontalHeader();
-        if (!header) {
-            return;
-        }
+    header->setDefaultSectionSize(100); // 设置默认列宽
+    header->setMinimumSectionSize(60);   // 设置最小列宽
 
-        header->setDefaultSectionSize(100); // 设置默认列宽
-        header->setMinimumSectionSize(60);   // 设置最小列宽
+    // 按等间隔抽样行估算列宽，不再对全部行调用 resizeColumnsToContents()，
+    // 千万行数据时耗时与行数无关
+    const int sampleRows = 200;
+    const int padding = 16;
+    int rowCount = m_dataModel->rowCount();
+    int step = qMax(1, rowCount / sampleRows);
 
-        for (int i = 0; i < header->count(); ++i) {
-            try {
-                int width = header->sectionSize(i);
-                if (width > 200) {
-                    header->resizeSection(i, 200);  // 设置最大列宽
-                } else if (width < 80) {
-                    header->resizeSection(i, 80);   // 设置最小列宽
-                }
-            } catch (...) {
-                qDebug() << "调整第" << i << "列宽度时出错";
-                continue;
-            }
+    QFontMetrics cellMetrics(ui->dataTableView->font());
+    QFontMetrics headerMetrics(header->font());
+
+    for (int col = 0; col < m_dataModel->columnCount(); ++col) {
+        int width = headerMetrics.horizontalAdvance(m_dataModel->headerText(col));
+        for (int row = 0; row < rowCount; row += step) {
+            width = qMax(width, cellMetrics.horizontalAdvance(m_dataModel->text(row, col)));
         }
-    } catch (...) {
-        qDebug() << "优化列宽时发生异常";
+        if (rowCount > 0) {
+            width = qMax(width, cellMetrics.horizontalAdvance(m_dataModel->text(rowCount - 1, col)));
+        }
+
+        header->resizeSection(col, qBound(80, width + padding, 200));  // 列宽限制在 80~200
     }
 }
 
@@ -5004,6 +4586,9 @@ void DataEditorWidget::optimizeTableDisplay()
     verticalHeader->setDefaultSectionSize(24);  // 设置默认行高
     verticalHeader->setMinimumSectionSize(20);   // 设置最小行高
 
+    // 大数据量时固定行高：视图按统一行高定位可见行，滚动时只格式化视口内的单元格
+    verticalHeader->setSectionResizeMode(m_largeFileMode ? QHeaderView::Fixed : QHeaderView::Interactive);
+
     // 设置列宽
     horizontalHeader->setDefaultSectionSize(100); // 设置默认列宽
     horizontalHeader->setMinimumSectionSize(60); // 设置最小列宽
@@ -5237,18 +4822,31 @@ void DataEditorWidget::onPressureDerivativeCalc()
     }
 
     // 获取压力单位
-    QStandardItem* pressureHeader = m_dataModel->horizontalHeaderItem(config.pressureColumnIndex);
-    if (pressureHeader) {
-        QString headerText = pressureHeader->text();
-        if (headerText.contains("MPa")) {
-            config.pressureUnit = "MPa";
-        } else if (headerText.contains("kPa")) {
-            config.pressureUnit = "kPa";
-        } else if (headerText.contains("psi")) {
-            config.pressureUnit = "psi";
-        } else {
-            config.pressureUnit = "MPa";
+    QString pressureHeader = m_dataModel->headerText(config.pressureColumnIndex);
+    if (pressureHeader.contains("MPa")) {
+        config.pressureUnit = "MPa";
+    } else if (pressureHeader.contains("kPa")) {
+        config.pressureUnit = "kPa";
+    } else if (pressureHeader.contains("psi")) {
+        config.pressureUnit = "psi";
+    } else {
+        config.pressureUnit = "MPa";
+    }
+
+    // 存在流量列时，可对等效时间或叠加时间求导（变流量后的压力恢复）
+    int rateColumn = findRateColumn();
+    if (rateColumn >= 0) {
+        QStringList axes;
+        axes << PressureDerivativeCalculator::timeAxisName(DerivativeTimeAxis::ElapsedTime)
+             << PressureDerivativeCalculator::timeAxisName(DerivativeTimeAxis::AgarwalEquivalent)
+             << PressureDerivativeCalculator::timeAxisName(DerivativeTimeAxis::Superposition);
+        bool ok = false;
+        QString choice = QInputDialog::getItem(this, "压力导数计算", "导数时间轴：", axes, 0, false, &ok);
+        if (!ok) {
+            return;
         }
+        config.timeAxis = static_cast<DerivativeTimeAxis>(axes.indexOf(choice));
+        config.rateColumnIndex = rateColumn;
     }
 
     // 显示计算进度
@@ -5322,3 +4920,427 @@ PressureDerivativeConfig DataEditorWidget::getDefaultPressureDerivativeConfig()
 
     return config;
 }
+
+// ============================================================================
+// 反褶积计算功能实现
+// ============================================================================
+
+// 设置反褶积计算器
+void DataEditorWidget::setupDeconvolutionCalculator()
+{
+    m_deconvolutionCalculator = new DeconvolutionCalculator(this);
+
+    connect(m_deconvolutionCalculator, &DeconvolutionCalculator::progressUpdated,
+            this, [this](int progress, const QString& message) {
+                if (m_progressDialog) {
+                    m_progressDialog->setProgress(progress);
+                    m_progressDialog->setMessage(message);
+                    QApplication::processEvents();
+                }
+            });
+
+    connect(m_deconvolutionCalculator, &DeconvolutionCalculator::calculationCompleted,
+            this, [this](const DeconvolutionResult& result) {
+                emit deconvolutionCalculated(result);
+            });
+}
+
+// 反褶积计算槽函数
+void DataEditorWidget::onDeconvolution()
+{
+    if (!hasData()) {
+        showStyledMessageBox("反褶积", "请先加载数据文件", QMessageBox::Information);
+        return;
+    }
+
+    DeconvolutionConfig config = m_deconvolutionCalculator->autoDetectColumns(m_dataModel);
+
+    // 列定义优先于标题关键字
+    int rateColumn = findRateColumn();
+    if (rateColumn >= 0) config.rateColumnIndex = rateColumn;
+    int pressureColumn = findPressureColumn();
+    if (pressureColumn >= 0) config.pressureColumnIndex = pressureColumn;
+    int timeColumn = findTimeColumn();
+    if (timeColumn >= 0) config.timeColumnIndex = timeColumn;
+
+    if (config.timeColumnIndex == -1 || config.pressureColumnIndex == -1) {
+        showStyledMessageBox("反褶积", "未找到时间列或压力列，请先定义数据列", QMessageBox::Warning);
+        return;
+    }
+    if (config.rateColumnIndex == -1) {
+        showStyledMessageBox("反褶积", "未找到流量列，反褶积需要完整的流量历史", QMessageBox::Warning);
+        return;
+    }
+
+    config.pressureUnit = getPressureUnit();
+    if (config.pressureUnit.isEmpty()) {
+        config.pressureUnit = "MPa";
+    }
+
+    showAnimatedProgress("反褶积", "正在进行压力-流量反褶积...");
+    DeconvolutionResult result = m_deconvolutionCalculator->calculateDeconvolution(m_dataModel, config);
+    hideAnimatedProgress();
+
+    if (result.success) {
+        updateStatus(QString("反褶积完成 - 响应曲线 %1 点").arg(result.responseTime.size()), "success");
+
+        // 响应曲线与原始数据行不对应，不写入表格，按需作为观测数据新建拟合分析
+        QMessageBox msgBox;
+        msgBox.setWindowTitle("反褶积完成");
+        msgBox.setText(QString("反褶积计算成功完成！\n"
+                               "压力点数：%1\n"
+                               "流量台阶：%2\n"
+                               "参考流量：%3\n"
+                               "原始地层压力：%4 %5\n"
+                               "拟合均方根误差：%6 %5\n"
+                               "迭代次数：%7\n\n"
+                               "是否以反褶积响应新建拟合分析？")
+                           .arg(result.processedRows)
+                           .arg(result.rateSteps)
+                           .arg(result.referenceRate, 0, 'g', 6)
+                           .arg(result.initialPressure, 0, 'f', 4)
+                           .arg(config.pressureUnit)
+                           .arg(result.rmsError, 0, 'g', 4)
+                           .arg(result.iterations));
+        msgBox.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
+        msgBox.setDefaultButton(QMessageBox::Yes);
+
+        if (msgBox.exec() == QMessageBox::Yes) {
+            emit analysisDataExtracted("反褶积响应", result.responseTime,
+                                       result.responsePressure, result.responseDerivative);
+        }
+    } else {
+        updateStatus("反褶积计算失败", "error");
+        showStyledMessageBox("反褶积计算失败", result.errorMessage, QMessageBox::Warning);
+    }
+}
+
+// 使用配置进行反褶积计算
+DeconvolutionResult DataEditorWidget::calculateDeconvolutionWithConfig(const DeconvolutionConfig& config)
+{
+    if (!m_deconvolutionCalculator) {
+        DeconvolutionResult result;
+        result.errorMessage = "反褶积计算器未初始化";
+        return result;
+    }
+
+    return m_deconvolutionCalculator->calculateDeconvolution(m_dataModel, config);
+}
+
+// ============================================================================
+// 流动段识别功能实现
+// ============================================================================
+
+// 设置流动段识别器
+void DataEditorWidget::setupFlowPeriodDetector()
+{
+    m_flowPeriodDetector = new FlowPeriodDetector(this);
+
+    connect(m_flowPeriodDetector, &FlowPeriodDetector::progressUpdated,
+            this, [this](int progress, const QString& message) {
+                if (m_progressDialog) {
+                    m_progressDialog->setProgress(progress);
+                    m_progressDialog->setMessage(message);
+                    QApplication::processEvents();
+                }
+            });
+}
+
+// ============================================================================
+// CSV/TXT 快速导入
+// ============================================================================
+
+void DataEditorWidget::setupCsvLoader()
+{
+    m_csvLoader = new CsvFastLoader(this);
+
+    connect(m_csvLoader, &CsvFastLoader::progressUpdated,
+            this, [this](int progress, const QString& message) {
+                updateProgress(progress, message);
+            });
+    connect(m_csvLoader, &CsvFastLoader::previewReady,
+            this, &DataEditorWidget::showLoadPreview);
+}
+
+// ============================================================================
+// XLSX 读写
+// ============================================================================
+
+void DataEditorWidget::setupXlsxFile()
+{
+    m_xlsxFile = new XlsxFile(this);
+
+    connect(m_xlsxFile, &XlsxFile::progressUpdated,
+            this, [this](int progress, const QString& message) {
+                updateProgress(progress, message);
+            });
+    connect(m_xlsxFile, &XlsxFile::previewReady,
+            this, &DataEditorWidget::showLoadPreview);
+}
+
+bool DataEditorWidget::loadXlsxFile(const QString& filePath, QString& errorMessage)
+{
+    XlsxImportConfig importConfig;
+    importConfig.previewRows = isLoadThread() ? m_loadPreviewRows : 0;
+    XlsxImportResult imported = m_xlsxFile->load(filePath, importConfig);
+    if (!imported.success) {
+        errorMessage = imported.errorMessage;
+        return false;
+    }
+
+    for (DataColumn& column : imported.columns) {
+        column.foreground = QColor("#2c3e50");
+    }
+    setLoadedTable(imported.columns, imported.rowCount);
+
+    updateProgress(100, "数据加载完成");
+
+    qDebug() << "成功读取工作表" << imported.sheetName << "：" << imported.rowCount << "行，"
+             << imported.columns.size() << "列，共享字符串" << imported.sharedStringCount << "个";
+    return true;
+}
+
+// ============================================================================
+// 后台文件加载
+// ============================================================================
+
+void DataEditorWidget::setupBackgroundLoading()
+{
+    connect(&m_loadWatcher, &QFutureWatcher<bool>::finished,
+            this, &DataEditorWidget::onFileLoadFinished);
+}
+
+bool DataEditorWidget::isLoadThread() const
+{
+    return QThread::currentThread() != thread();
+}
+
+void DataEditorWidget::startFileLoad(const QString& filePath, const QString& fileType,
+                                     const DataLoadConfigDialog::LoadConfig* config)
+{
+    if (m_loading) {
+        updateStatus("正在加载其他文件，请稍候", "warning");
+        return;
+    }
+
+    QFileInfo fileInfo(filePath);
+    if (!fileInfo.exists() || !fileInfo.isReadable()) {
+        showStyledMessageBox("文件加载失败",
+                             QString("文件不存在或无法读取: %1").arg(filePath),
+                             QMessageBox::Warning);
+        return;
+    }
+
+    // 显示可取消的进度对话框
+    showAnimatedProgress("加载数据文件", "正在读取文件数据，请稍候...", true);
+
+    clearData();
+
+    m_currentFilePath = filePath;
+    m_currentFileType = fileType;
+    ui->filePathLineEdit->setText(filePath);
+
+    // 加载期间表格只读，编辑类按钮禁用
+    // 取消标志只在这里清除一次；加载过程中（含各次分隔符重试）到达的取消都不会丢失
+    m_loading = true;
+    m_loadCancelled = false;
+    m_csvLoader->resetCancel();
+    m_xlsxFile->resetCancel();
+    m_loadedColumns.clear();
+    m_loadedRowCount = 0;
+    m_loadError.clear();
+    m_savedEditTriggers = ui->dataTableView->editTriggers();
+    ui->dataTableView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    ui->btnOpenFile->setEnabled(false);
+    setButtonsEnabled(false);
+
+    updateProgress(20, "正在分析文件格式...");
+
+    QString lowerType = fileType.toLower();
+    bool useConfig = (config != nullptr);
+    DataLoadConfigDialog::LoadConfig loadConfig = config ? *config : DataLoadConfigDialog::LoadConfig();
+
+    m_loadWatcher.setFuture(QtConcurrent::run([this, filePath, fileType, lowerType, useConfig, loadConfig]() {
+        bool loadSuccess = false;
+        QString errorMessage;
+
+        if (lowerType == "txt" || lowerType == "csv") {
+            loadSuccess = useConfig ? loadCsvFileWithConfig(filePath, loadConfig, errorMessage)
+                                    : loadCsvFile(filePath, errorMessage);
+        } else if (lowerType == "excel") {
+            loadSuccess = loadExcelFileOptimized(filePath, errorMessage);
+        } else if (lowerType == "json") {
+            loadSuccess = loadJsonFile(filePath, errorMessage);
+        } else {
+            errorMessage = QString("不支持的文件类型: %1").arg(fileType);
+        }
+
+        m_loadError = errorMessage;
+        return loadSuccess && !m_loadCancelled;
+    }));
+}
+
+void DataEditorWidget::cancelFileLoad()
+{
+    if (!m_loading) {
+        return;
+    }
+
+    m_loadCancelled = true;
+    m_csvLoader->cancel();
+    m_xlsxFile->cancel();
+}
+
+void DataEditorWidget::showLoadPreview(const QVector<DataColumn>& columns, int rowCount)
+{
+    // 只接受当前加载任务的预览；取消或已完成后到达的预览直接丢弃
+    if (!m_loading || m_loadCancelled) {
+        return;
+    }
+
+    QVector<DataColumn> preview = columns;
+    for (DataColumn& column : preview) {
+        column.foreground = QColor("#2c3e50");
+    }
+    m_dataModel->setTableData(preview, rowCount);
+    optimizeColumnWidths();
+
+    updateStatus(QString("已显示前 %1 行，正在加载其余数据...").arg(rowCount), "info");
+}
+
+void DataEditorWidget::setLoadedTable(const QVector<DataColumn>& columns, int rowCount)
+{
+    // 工作线程中只暂存结果，由 onFileLoadFinished 在主线程写入模型
+    if (isLoadThread()) {
+        m_loadedColumns = columns;
+        m_loadedRowCount = rowCount;
+        return;
+    }
+    m_dataModel->setTableData(columns, rowCount);
+}
+
+void DataEditorWidget::onFileLoadFinished()
+{
+    bool loadSuccess = m_loadWatcher.result();
+    QString errorMessage = m_loadError;
+
+    m_loading = false;
+    ui->dataTableView->setEditTriggers(m_savedEditTriggers);
+    ui->btnOpenFile->setEnabled(true);
+
+    if (m_loadCancelled) {
+        hideAnimatedProgress();
+        m_loadedColumns.clear();
+        clearData();
+        updateStatus("已取消加载", "warning");
+        qDebug() << "文件加载已取消";
+        return;
+    }
+
+    if (loadSuccess) {
+        // 列结构与预览一致时只追加其余行，保留视图的滚动位置与选择
+        if (!m_dataModel->extendTableData(m_loadedColumns, m_loadedRowCount)) {
+            m_dataModel->setTableData(m_loadedColumns, m_loadedRowCount);
+        }
+        m_loadedColumns.clear();
+    }
+#ifdef Q_OS_WIN
+    else if (m_currentFileType.toLower() == "excel") {
+        // 内置读取失败时回退到 Excel COM 组件（仅限主线程）
+        updateProgress(60, "尝试COM组件读取...");
+        loadSuccess = loadExcelWithCOM(m_currentFilePath, errorMessage);
+    }
+#endif
+
+    hideAnimatedProgress();
+
+    if (loadSuccess) {
+        m_largeFileMode = m_dataModel->rowCount() > m_maxDisplayRows;
+
+        updateStatus(QString("文件加载成功 - %1行 × %2列")
+                         .arg(m_dataModel->rowCount())
+                         .arg(m_dataModel->columnCount()), "success");
+
+        setButtonsEnabled(true);
+        m_dataModified = false;
+
+        applyColumnStyles();
+        optimizeColumnWidths();
+        optimizeTableDisplay();
+
+        // 弹出列定义对话框
+        QTimer::singleShot(500, this, &DataEditorWidget::onDefineColumns);
+
+        emitDataChanged();
+
+        qDebug() << "文件加载成功，数据行数:" << m_dataModel->rowCount()
+                 << "列数:" << m_dataModel->columnCount();
+    } else {
+        m_dataModel->clear();
+        updateStatus("文件加载失败", "error");
+        showStyledMessageBox("文件加载失败",
+                             QString("无法加载文件: %1").arg(m_currentFilePath),
+                             QMessageBox::Critical,
+                             errorMessage);
+        qDebug() << "文件加载失败:" << errorMessage;
+    }
+}
+
+// 流动段识别槽函数
+void DataEditorWidget::onFlowPeriodDetect()
+{
+    if (!hasData()) {
+        showStyledMessageBox("流动段识别", "请先加载数据文件", QMessageBox::Information);
+        return;
+    }
+
+    FlowPeriodDetectionConfig config;
+    config.timeColumnIndex = findTimeColumn();
+    config.pressureColumnIndex = findPressureColumn();
+    config.rateColumnIndex = findRateColumn();
+
+    if (config.timeColumnIndex == -1 || config.pressureColumnIndex == -1) {
+        showStyledMessageBox("流动段识别", "未找到时间列或压力列，请先定义数据列", QMessageBox::Warning);
+        return;
+    }
+
+    // 时间戳列由识别器换算为小时
+    QString timeUnit = "h";
+    if (m_dataModel->columnStorage(config.timeColumnIndex) != ColumnStorage::Timestamp &&
+        config.timeColumnIndex < m_columnDefinitions.size() &&
+        !m_columnDefinitions[config.timeColumnIndex].unit.isEmpty()) {
+        timeUnit = m_columnDefinitions[config.timeColumnIndex].unit;
+    }
+    QString pressureUnit = getPressureUnit();
+    if (pressureUnit.isEmpty()) {
+        pressureUnit = "MPa";
+    }
+
+    showAnimatedProgress("流动段识别", "正在识别开井/关井流动段...");
+    FlowPeriodDetectionResult detection = m_flowPeriodDetector->detect(m_dataModel, config);
+    hideAnimatedProgress();
+
+    if (!detection.success) {
+        updateStatus("流动段识别失败", "error");
+        showStyledMessageBox("流动段识别失败", detection.errorMessage, QMessageBox::Warning);
+        return;
+    }
+
+    updateStatus(QString("流动段识别完成 - 共 %1 段").arg(detection.periods.size()), "success");
+
+    FlowPeriodDialog dialog(detection, timeUnit, pressureUnit, this);
+    connect(&dialog, &FlowPeriodDialog::extractRequested, this, [this, &detection](int periodIndex) {
+        QVector<double> deltaTime, deltaPressure, derivative;
+        if (!FlowPeriodDetector::extractPeriod(detection, periodIndex, deltaTime, deltaPressure, derivative)) {
+            showStyledMessageBox("提取流动段", "该流动段有效数据点不足，无法用于拟合", QMessageBox::Warning);
+            return;
+        }
+
+        const FlowPeriod& period = detection.periods[periodIndex];
+        QString name = QString("流动段%1-%2").arg(periodIndex + 1)
+                           .arg(FlowPeriodDetector::periodTypeName(period.type));
+        emit analysisDataExtracted(name, deltaTime, deltaPressure, derivative);
+        updateStatus(QString("已提取%1（%2 个点）到拟合").arg(name).arg(deltaTime.size()), "success");
+    });
+    dialog.exec();
+}
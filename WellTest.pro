@@ -23,7 +23,21 @@ win32: LIBS += -lm
 
 # Input
 HEADERS += dataeditorwidget.h \
+           autosaveservice.h \
            chartsetting1.h \
+           columnstatistics.h \
+           csvfastloader.h \
+           curveindex.h \
+           curvelod.h \
+           curverenderer.h \
+           datacleaner.h \
+           datatablemodel.h \
+           datetimeparser.h \
+           deconvolutioncalculator.h \
+           derivedcolumns.h \
+           flowperioddetector.h \
+           flowregimeidentifier.h \
+           fitlivechannel.h \
            fittingobserveddata.h \
            fittingpage.h \
            fittingparameterchart.h \
@@ -33,7 +47,12 @@ HEADERS += dataeditorwidget.h \
            modelwidget01-06.h \
            mousezoom.h \
            newprojectdialog.h \
+           plotengine.h \
+           plotlayercache.h \
            plottingwidget.h \
+           projectdatastore.h \
+           projectsaveengine.h \
+           sampledgraph.h \
            mainwindow.h \
            monitorbtn.h \
            monitostatew.h \
@@ -42,7 +61,9 @@ HEADERS += dataeditorwidget.h \
            settingswidget.h \
            qcustomplot.h \
            wt_fittingwidget.h \
-           wt_projectwidget.h
+           wt_projectwidget.h \
+           xlsxfile.h \
+           ziparchive.h
 
 FORMS += dataeditorwidget.ui \
          fittingpage.ui \
@@ -59,8 +80,22 @@ FORMS += dataeditorwidget.ui \
          wt_projectwidget.ui
 
 SOURCES += \
+           autosaveservice.cpp \
            chartsetting1.cpp \
+           columnstatistics.cpp \
+           csvfastloader.cpp \
+           curveindex.cpp \
+           curvelod.cpp \
+           curverenderer.cpp \
+           datacleaner.cpp \
            dataeditorwidget.cpp \
+           datatablemodel.cpp \
+           datetimeparser.cpp \
+           deconvolutioncalculator.cpp \
+           derivedcolumns.cpp \
+           flowperioddetector.cpp \
+           flowregimeidentifier.cpp \
+           fitlivechannel.cpp \
            fittingobserveddata.cpp \
            fittingpage.cpp \
            fittingparameterchart.cpp \
@@ -70,8 +105,13 @@ SOURCES += \
            modelwidget01-06.cpp \
            mousezoom.cpp \
            newprojectdialog.cpp \
+           plotengine.cpp \
+           plotlayercache.cpp \
            plottingwidget.cpp \
            plotwindow.cpp \
+           projectdatastore.cpp \
+           projectsaveengine.cpp \
+           sampledgraph.cpp \
            main.cpp \
            mainwindow.cpp \
            monitorbtn.cpp \
@@ -81,7 +121,9 @@ SOURCES += \
            settingswidget.cpp \
            qcustomplot.cpp \
            wt_fittingwidget.cpp \
-           wt_projectwidget.cpp
+           wt_projectwidget.cpp \
+           xlsxfile.cpp \
+           ziparchive.cpp
 
 RESOURCES += resource.qrc
 
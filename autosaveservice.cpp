@@ -0,0 +1,230 @@
+#include "autosaveservice.h"
+#include "projectdatastore.h"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QSet>
+#include <QtConcurrent>
+#include <QtEndian>
+#include <cstring>
+
+// ============================================================================
+// 内部辅助函数
+// ============================================================================
+
+namespace {
+
+const char kBackupMagic[4] = {'W', 'T', 'A', 'S'};
+const quint32 kBackupVersion = 1;
+const char kBackupSuffix[] = ".wtbak";
+
+QString toBase64(const QVector<double>& values)
+{
+    QByteArray bytes(values.size() * 8, Qt::Uninitialized);
+    for (int i = 0; i < values.size(); ++i) {
+        qToLittleEndian<double>(values[i], bytes.data() + i * 8);
+    }
+    return QString::fromLatin1(bytes.toBase64());
+}
+
+template <typename T>
+QString integersToBase64(const QVector<T>& values)
+{
+    QByteArray bytes(values.size() * int(sizeof(T)), Qt::Uninitialized);
+    for (int i = 0; i < values.size(); ++i) {
+        qToLittleEndian<T>(values[i], bytes.data() + i * int(sizeof(T)));
+    }
+    return QString::fromLatin1(bytes.toBase64());
+}
+
+QString storageName(ColumnStorage storage)
+{
+    switch (storage) {
+    case ColumnStorage::Timestamp: return QStringLiteral("timestamp");
+    case ColumnStorage::Text:      return QStringLiteral("text");
+    default:                       return QStringLiteral("numeric");
+    }
+}
+
+QJsonObject columnToJson(const DataColumn& column)
+{
+    QJsonObject obj;
+    obj["header"] = column.header;
+    obj["storage"] = storageName(column.storage);
+    obj["numberFormat"] = QString(QChar(column.numberFormat));
+    obj["precision"] = column.precision;
+    if (column.foreground.isValid()) obj["foreground"] = column.foreground.name(QColor::HexArgb);
+    if (column.background.isValid()) obj["background"] = column.background.name(QColor::HexArgb);
+
+    switch (column.storage) {
+    case ColumnStorage::Numeric:
+        obj["numbers"] = toBase64(column.numbers);
+        break;
+    case ColumnStorage::Timestamp:
+        obj["timestamps"] = integersToBase64(column.timestamps);
+        obj["timestampFormat"] = column.timestampFormat;
+        break;
+    case ColumnStorage::Text: {
+        QJsonArray texts;
+        for (const QString& text : column.texts) texts.append(text);
+        obj["texts"] = texts;
+        break;
+    }
+    }
+    if (!column.validity.isEmpty()) {
+        obj["validity"] = integersToBase64(column.validity);
+    }
+    return obj;
+}
+
+} // namespace
+
+// ============================================================================
+// AutoSaveService
+// ============================================================================
+
+AutoSaveService::AutoSaveService(QObject* parent)
+    : QObject(parent)
+{
+    connect(&m_timer, &QTimer::timeout, this, &AutoSaveService::autoSaveDue);
+    connect(&m_watcher, &QFutureWatcher<QPair<bool, QString>>::finished,
+            this, &AutoSaveService::onBackupFinished);
+    setConfig(m_config);
+}
+
+AutoSaveService::~AutoSaveService()
+{
+    waitForFinished();
+}
+
+void AutoSaveService::setConfig(const AutoSaveConfig& config)
+{
+    m_config = config;
+    if (m_config.intervalMinutes > 0) {
+        // 间隔未变时不重启计时，避免反复应用设置推迟自动保存
+        int interval = m_config.intervalMinutes * 60 * 1000;
+        if (!m_timer.isActive() || m_timer.interval() != interval) m_timer.start(interval);
+    } else {
+        m_timer.stop();
+    }
+}
+
+bool AutoSaveService::writeBackup(const AutoSaveSnapshot& snapshot)
+{
+    if (!m_config.backupEnabled || m_config.backupPath.isEmpty()) return false;
+    if (m_watcher.isRunning()) {
+        qDebug() << "上一次自动备份尚未完成，跳过本次备份";
+        return false;
+    }
+
+    const AutoSaveConfig config = m_config;
+    m_watcher.setFuture(QtConcurrent::run([snapshot, config]() {
+        QString fileName, error;
+        if (!writeBackupFile(snapshot, config, fileName, error)) {
+            return qMakePair(false, error);
+        }
+        return qMakePair(true, fileName);
+    }));
+    return true;
+}
+
+void AutoSaveService::waitForFinished()
+{
+    m_watcher.waitForFinished();
+}
+
+void AutoSaveService::onBackupFinished()
+{
+    QPair<bool, QString> result = m_watcher.result();
+    if (!result.first) {
+        qDebug() << "自动备份失败:" << result.second;
+    }
+    emit backupFinished(result.first, result.second);
+}
+
+// ============================================================================
+// 备份文件写入（后台线程）
+// ============================================================================
+
+bool AutoSaveService::writeBackupFile(const AutoSaveSnapshot& snapshot, const AutoSaveConfig& config,
+                                      QString& fileName, QString& errorMessage)
+{
+    QDir dir(config.backupPath);
+    if (!dir.exists() && !dir.mkpath(".")) {
+        errorMessage = QString("无法创建备份目录: %1").arg(config.backupPath);
+        return false;
+    }
+
+    // 1. 序列化：项目文档 + 引用的数组 + 编辑器数据
+    QJsonObject root;
+    root["version"] = int(kBackupVersion);
+    root["savedAt"] = snapshot.takenAt.toString(Qt::ISODateWithMs);
+    root["projectFile"] = snapshot.projectFile;
+    root["project"] = snapshot.project;
+
+    if (snapshot.dataStore) {
+        QSet<QString> referenced;
+        ProjectDataStore::collectReferences(snapshot.project, referenced);
+        QJsonObject blobs;
+        for (const QString& hash : referenced) {
+            QJsonObject ref;
+            ref["blob"] = hash;
+            // 缺失的数组不能写成空数组：这样的备份无法恢复，却会被当作成功
+            bool ok = false;
+            QVector<double> values = snapshot.dataStore->getArray(ref, &ok);
+            if (!ok) {
+                errorMessage = QString("项目数据中缺少数组 %1，已放弃本次备份").arg(hash);
+                return false;
+            }
+            blobs[hash] = toBase64(values);
+        }
+        root["blobs"] = blobs;
+    }
+
+    QJsonArray datasets;
+    if (!snapshot.editorColumns.isEmpty()) {
+        QJsonArray columns;
+        for (const DataColumn& column : snapshot.editorColumns) {
+            columns.append(columnToJson(column));
+        }
+        QJsonObject dataset;
+        dataset["file"] = snapshot.editorFile;
+        dataset["columns"] = columns;
+        datasets.append(dataset);
+    }
+    root["datasets"] = datasets;
+
+    // 2. 压缩后整体写入（临时文件 + 原子重命名）
+    QByteArray header(8, '\0');
+    std::memcpy(header.data(), kBackupMagic, 4);
+    qToLittleEndian<quint32>(kBackupVersion, header.data() + 4);
+    QByteArray payload = qCompress(QJsonDocument(root).toJson(QJsonDocument::Compact));
+
+    const QString prefix = QFileInfo(snapshot.projectFile).completeBaseName() + "_autosave_";
+    fileName = dir.filePath(prefix + snapshot.takenAt.toString("yyyyMMdd_HHmmss") + kBackupSuffix);
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        errorMessage = QString("无法写入备份文件: %1").arg(file.errorString());
+        return false;
+    }
+    file.write(header);
+    file.write(payload);
+    if (!file.commit()) {
+        errorMessage = QString("写入备份文件失败: %1").arg(file.errorString());
+        return false;
+    }
+
+    // 3. 轮换：文件名含时间，按名称排序即按时间排序，删除最旧的
+    QStringList backups = dir.entryList(QStringList() << prefix + "*" + kBackupSuffix,
+                                        QDir::Files, QDir::Name);
+    for (int i = 0; i < backups.size() - qMax(1, config.maxBackups); ++i) {
+        if (!dir.remove(backups[i])) {
+            qDebug() << "无法删除旧备份:" << backups[i];
+        }
+    }
+    return true;
+}
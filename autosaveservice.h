@@ -0,0 +1,96 @@
+#ifndef AUTOSAVESERVICE_H
+#define AUTOSAVESERVICE_H
+
+#include <QDateTime>
+#include <QFutureWatcher>
+#include <QJsonObject>
+#include <QObject>
+#include <QPair>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+#include "datatablemodel.h"
+
+class ProjectDataStore;
+
+// 自动保存时取出的项目状态快照（全部为隐式共享的值，取快照不复制数组）
+struct AutoSaveSnapshot {
+    QString projectFile;                // 项目文件路径
+    QJsonObject project;                // 项目文档（拟合节为各页签的当前状态）
+    const ProjectDataStore* dataStore;  // 解析文档中的数组引用
+    QString editorFile;                 // 数据编辑器当前文件
+    QVector<DataColumn> editorColumns;  // 数据编辑器当前表格
+    QDateTime takenAt;
+
+    AutoSaveSnapshot() : dataStore(nullptr) {}
+};
+
+// 自动保存与备份设置
+struct AutoSaveConfig {
+    int intervalMinutes;    // 自动保存间隔（分钟，<= 0 表示关闭）
+    bool backupEnabled;     // 是否写入备份
+    int maxBackups;         // 每个项目保留的备份数
+    QString backupPath;     // 备份目录
+
+    AutoSaveConfig() :
+        intervalMinutes(10),
+        backupEnabled(true),
+        maxBackups(10) {}
+};
+
+/**
+ * @brief 自动保存服务
+ *
+ * 按设置的间隔发出 autoSaveDue()，由主窗口在界面线程取快照（只复制隐式共享的
+ * JSON 与列数组）后交给 writeBackup()。备份在后台线程序列化、压缩，经 QSaveFile
+ * 写入备份目录 <项目名>_autosave_<时间>.wtbak，并按时间只保留最近 maxBackups 个。
+ * 上一次备份尚未写完时跳过本次，长时间工作也不会堆积任务或阻塞界面。
+ *
+ * 备份文件格式：8 字节文件头（"WTAS" + 版本）+ qCompress 压缩的紧凑 JSON：
+ * {"version", "savedAt", "projectFile", "project", "blobs": {哈希: base64 float64},
+ *  "datasets": [{"file", "columns": [...]}]}。项目引用的数组一并写入，备份可独立恢复。
+ */
+class AutoSaveService : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AutoSaveService(QObject* parent = nullptr);
+    ~AutoSaveService();
+
+    void setConfig(const AutoSaveConfig& config);
+    AutoSaveConfig config() const { return m_config; }
+
+    // 上一次备份是否仍在写入
+    bool isBusy() const { return m_watcher.isRunning(); }
+
+    /**
+     * @brief 在后台写入一份备份（备份关闭或上一次尚未完成时忽略）
+     * @return 是否已提交
+     */
+    bool writeBackup(const AutoSaveSnapshot& snapshot);
+
+    // 等待正在写入的备份完成
+    void waitForFinished();
+
+    // 同步写入备份文件并轮换旧备份（在后台线程调用）
+    static bool writeBackupFile(const AutoSaveSnapshot& snapshot, const AutoSaveConfig& config,
+                                QString& fileName, QString& errorMessage);
+
+signals:
+    // 到达自动保存时间
+    void autoSaveDue();
+
+    // 备份写入结束
+    void backupFinished(bool success, const QString& message);
+
+private slots:
+    void onBackupFinished();
+
+private:
+    AutoSaveConfig m_config;
+    QTimer m_timer;
+    QFutureWatcher<QPair<bool, QString>> m_watcher;    // (是否成功, 备份文件或错误信息)
+};
+
+#endif // AUTOSAVESERVICE_H
@@ -0,0 +1,374 @@
+#include "columnstatistics.h"
+#include <QStringView>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// ============================================================================
+// ColumnSummary
+// ============================================================================
+
+double ColumnSummary::variance() const
+{
+    return numericCount > 0 ? m2 / numericCount : 0.0;
+}
+
+double ColumnSummary::approximateQuantile(double q) const
+{
+    if (quantiles.isEmpty()) return std::numeric_limits<double>::quiet_NaN();
+
+    // 第 i 个草图点位于秩 (i + 0.5) / n 处
+    int n = quantiles.size();
+    double position = qBound(0.0, q * n - 0.5, double(n - 1));
+    int lower = int(position);
+    if (lower >= n - 1) return quantiles.last();
+    double fraction = position - lower;
+    return quantiles[lower] + (quantiles[lower + 1] - quantiles[lower]) * fraction;
+}
+
+// ============================================================================
+// ColumnStatisticsCache
+// ============================================================================
+
+ColumnStatisticsCache::ColumnStatisticsCache(DataTableModel* model, QObject *parent)
+    : QObject(parent),
+    m_model(model),
+    m_blockSize(65536),
+    m_sketchSize(64)
+{
+    if (!m_model) return;
+
+    connect(m_model, &QAbstractItemModel::dataChanged, this, &ColumnStatisticsCache::onDataChanged);
+    connect(m_model, &QAbstractItemModel::rowsInserted, this, &ColumnStatisticsCache::onRowsChanged);
+    connect(m_model, &QAbstractItemModel::rowsRemoved, this, &ColumnStatisticsCache::onRowsChanged);
+    connect(m_model, &QAbstractItemModel::columnsInserted, this, &ColumnStatisticsCache::onColumnsInserted);
+    connect(m_model, &QAbstractItemModel::columnsRemoved, this, &ColumnStatisticsCache::onColumnsRemoved);
+    connect(m_model, &QAbstractItemModel::modelReset, this, &ColumnStatisticsCache::invalidate);
+}
+
+ColumnStatisticsCache::~ColumnStatisticsCache()
+{
+}
+
+ColumnSummary ColumnStatisticsCache::summary(int column)
+{
+    if (!m_model || column < 0 || column >= m_model->columnCount()) {
+        return ColumnSummary();
+    }
+
+    syncColumnCount();
+    ColumnEntry& entry = m_columns[column];
+    const DataColumn& data = m_model->column(column);
+
+    // 列类型变化（如数值列写入文本后转为文本列）时整列重算
+    if (entry.storage != data.storage) {
+        entry = ColumnEntry();
+        entry.storage = data.storage;
+    }
+
+    int rows = m_model->rowCount();
+    int blockCount = (rows + m_blockSize - 1) / m_blockSize;
+    if (entry.blocks.size() != blockCount) {
+        entry.blocks.clear();
+        entry.dirty.clear();
+        resizeBlocks(entry, 0);
+    }
+
+    if (entry.mergedValid) {
+        return entry.merged;
+    }
+
+    // 并行重算脏块
+    QVector<int> dirtyBlocks;
+    for (int block = 0; block < blockCount; ++block) {
+        if (entry.dirty[block]) dirtyBlocks.append(block);
+    }
+
+    ColumnSummary* blocks = entry.blocks.data();
+    const int blockSize = m_blockSize;
+    const int sketchSize = m_sketchSize;
+    QtConcurrent::blockingMap(dirtyBlocks, [&](int& block) {
+        int begin = block * blockSize;
+        int end = qMin(rows, begin + blockSize);
+        blocks[block] = summarize(data, begin, end, sketchSize);
+    });
+
+    entry.dirty.fill(false);
+    entry.merged = merge(entry.blocks, m_sketchSize);
+    entry.mergedValid = true;
+    return entry.merged;
+}
+
+double ColumnStatisticsCache::exactQuantile(int column, double q)
+{
+    ColumnSummary columnSummary = summary(column);
+    if (columnSummary.numericCount == 0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    ColumnEntry& entry = m_columns[column];
+    for (const QPair<double, double>& cached : entry.exactQuantiles) {
+        if (cached.first == q) return cached.second;
+    }
+
+    QVector<double> values = numericValues(m_model->column(column), 0, m_model->rowCount());
+    int n = values.size();
+    double position = qBound(0.0, q, 1.0) * (n - 1);
+    int lower = int(position);
+    double fraction = position - lower;
+
+    std::nth_element(values.begin(), values.begin() + lower, values.end());
+    double result = values[lower];
+    if (fraction > 0.0 && lower + 1 < n) {
+        // nth_element 之后 lower 右侧均不小于它，右侧最小值即下一个顺序统计量
+        double upper = *std::min_element(values.begin() + lower + 1, values.end());
+        result += (upper - result) * fraction;
+    }
+
+    entry.exactQuantiles.append(qMakePair(q, result));
+    return result;
+}
+
+void ColumnStatisticsCache::invalidate()
+{
+    m_columns.clear();
+}
+
+// ============================================================================
+// 模型改动跟踪
+// ============================================================================
+
+void ColumnStatisticsCache::onDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight,
+                                          const QList<int>& roles)
+{
+    if (!topLeft.isValid() || !bottomRight.isValid()) return;
+
+    // 只改颜色等外观的通知不影响统计
+    if (!roles.isEmpty() && !roles.contains(Qt::DisplayRole) && !roles.contains(Qt::EditRole)) return;
+
+    syncColumnCount();
+    int lastColumn = qMin(bottomRight.column(), m_columns.size() - 1);
+    for (int col = topLeft.column(); col <= lastColumn; ++col) {
+        markDirty(m_columns[col], topLeft.row(), bottomRight.row());
+    }
+}
+
+void ColumnStatisticsCache::onRowsChanged(const QModelIndex& parent, int first, int last)
+{
+    Q_UNUSED(parent)
+    Q_UNUSED(last)
+
+    // 插入/删除位置之后的行整体移动，只有这些块需要重算
+    syncColumnCount();
+    for (ColumnEntry& entry : m_columns) {
+        resizeBlocks(entry, first);
+    }
+}
+
+void ColumnStatisticsCache::onColumnsInserted(const QModelIndex& parent, int first, int last)
+{
+    Q_UNUSED(parent)
+
+    if (first > m_columns.size()) {
+        m_columns.clear();
+        return;
+    }
+    m_columns.insert(first, last - first + 1, ColumnEntry());
+}
+
+void ColumnStatisticsCache::onColumnsRemoved(const QModelIndex& parent, int first, int last)
+{
+    Q_UNUSED(parent)
+
+    if (last >= m_columns.size()) {
+        m_columns.clear();
+        return;
+    }
+    m_columns.remove(first, last - first + 1);
+}
+
+void ColumnStatisticsCache::syncColumnCount()
+{
+    int columns = m_model ? m_model->columnCount() : 0;
+    if (m_columns.size() != columns) {
+        m_columns.clear();
+        m_columns.resize(columns);
+        for (int col = 0; col < columns; ++col) {
+            m_columns[col].storage = m_model->columnStorage(col);
+        }
+    }
+}
+
+void ColumnStatisticsCache::resizeBlocks(ColumnEntry& entry, int fromRow)
+{
+    int rows = m_model ? m_model->rowCount() : 0;
+    int blockCount = (rows + m_blockSize - 1) / m_blockSize;
+    int firstDirty = qMin(entry.blocks.size(), qMax(0, fromRow / m_blockSize));
+    entry.blocks.resize(blockCount);
+    entry.dirty.resize(blockCount);
+    for (int block = firstDirty; block < blockCount; ++block) {
+        entry.dirty[block] = true;
+    }
+    entry.mergedValid = false;
+    entry.exactQuantiles.clear();
+}
+
+void ColumnStatisticsCache::markDirty(ColumnEntry& entry, int firstRow, int lastRow)
+{
+    int firstBlock = qMax(0, firstRow / m_blockSize);
+    int lastBlock = qMin(entry.dirty.size() - 1, lastRow / m_blockSize);
+    for (int block = firstBlock; block <= lastBlock; ++block) {
+        entry.dirty[block] = true;
+    }
+    entry.mergedValid = false;
+    entry.exactQuantiles.clear();
+}
+
+// ============================================================================
+// 静态工具接口
+// ============================================================================
+
+QVector<double> ColumnStatisticsCache::numericValues(const DataColumn& column, int begin, int end)
+{
+    QVector<double> values;
+    values.reserve(end - begin);
+
+    switch (column.storage) {
+    case ColumnStorage::Numeric:
+        for (int row = begin; row < end; ++row) {
+            double value = column.numbers[row];
+            if (!std::isnan(value) && column.isValid(row)) values.append(value);
+        }
+        break;
+    case ColumnStorage::Timestamp:
+        for (int row = begin; row < end; ++row) {
+            if (column.isValid(row)) values.append(double(column.timestamps[row]));
+        }
+        break;
+    case ColumnStorage::Text:
+        for (int row = begin; row < end; ++row) {
+            QStringView text = QStringView(column.texts[row]).trimmed();
+            if (text.isEmpty()) continue;
+            bool ok = false;
+            double value = text.toDouble(&ok);
+            if (ok) values.append(value);
+        }
+        break;
+    }
+    return values;
+}
+
+ColumnSummary ColumnStatisticsCache::summarize(const DataColumn& column, int begin, int end, int sketchSize)
+{
+    ColumnSummary summary;
+    summary.rowCount = end - begin;
+
+    QVector<double> values = numericValues(column, begin, end);
+    int n = values.size();
+    summary.numericCount = n;
+
+    if (column.storage == ColumnStorage::Text) {
+        for (int row = begin; row < end; ++row) {
+            if (!QStringView(column.texts[row]).trimmed().isEmpty()) summary.validCount++;
+        }
+    } else {
+        summary.validCount = n;
+    }
+
+    if (n == 0) return summary;
+
+    summary.first = values.first();
+    summary.last = values.last();
+    summary.minimum = values.first();
+    summary.maximum = values.first();
+
+    // Welford 单遍均值/离均差平方和
+    double previous = values.first();
+    for (int i = 0; i < n; ++i) {
+        double value = values[i];
+        double delta = value - summary.mean;
+        summary.mean += delta / (i + 1);
+        summary.m2 += delta * (value - summary.mean);
+        summary.sum += value;
+        summary.minimum = qMin(summary.minimum, value);
+        summary.maximum = qMax(summary.maximum, value);
+        if (value < previous) summary.ascending = false;
+        previous = value;
+    }
+
+    // 草图：排序后按等秩间隔取点
+    std::sort(values.begin(), values.end());
+    int points = qMin(sketchSize, n);
+    summary.quantiles.resize(points);
+    for (int i = 0; i < points; ++i) {
+        int index = int((i + 0.5) * n / points);
+        summary.quantiles[i] = values[qMin(index, n - 1)];
+    }
+    return summary;
+}
+
+ColumnSummary ColumnStatisticsCache::merge(const QVector<ColumnSummary>& parts, int sketchSize)
+{
+    ColumnSummary result;
+    QVector<QPair<double, double>> weighted;   // (草图值, 代表的值个数)
+
+    for (const ColumnSummary& part : parts) {
+        result.rowCount += part.rowCount;
+        result.validCount += part.validCount;
+        if (part.numericCount == 0) continue;
+
+        if (result.numericCount == 0) {
+            result.numericCount = part.numericCount;
+            result.minimum = part.minimum;
+            result.maximum = part.maximum;
+            result.sum = part.sum;
+            result.mean = part.mean;
+            result.m2 = part.m2;
+            result.first = part.first;
+            result.last = part.last;
+            result.ascending = part.ascending;
+        } else {
+            // Chan 并行方差合并
+            double na = result.numericCount;
+            double nb = part.numericCount;
+            double n = na + nb;
+            double delta = part.mean - result.mean;
+            result.mean += delta * nb / n;
+            result.m2 += part.m2 + delta * delta * na * nb / n;
+            result.numericCount += part.numericCount;
+            result.sum += part.sum;
+            result.minimum = qMin(result.minimum, part.minimum);
+            result.maximum = qMax(result.maximum, part.maximum);
+            result.ascending = result.ascending && part.ascending && result.last <= part.first;
+            result.last = part.last;
+        }
+
+        double weight = double(part.numericCount) / part.quantiles.size();
+        for (double value : part.quantiles) {
+            weighted.append(qMakePair(value, weight));
+        }
+    }
+
+    if (weighted.isEmpty()) return result;
+
+    // 合并草图：按值排序后在累计权重上等秩取点
+    std::sort(weighted.begin(), weighted.end(),
+              [](const QPair<double, double>& a, const QPair<double, double>& b) { return a.first < b.first; });
+
+    int points = qMin(sketchSize, result.numericCount);
+    result.quantiles.resize(points);
+    double total = result.numericCount;
+    double cumulative = 0.0;
+    int next = 0;
+    for (const QPair<double, double>& item : weighted) {
+        cumulative += item.second;
+        while (next < points && (next + 0.5) * total / points <= cumulative) {
+            result.quantiles[next++] = item.first;
+        }
+    }
+    while (next < points) {
+        result.quantiles[next++] = weighted.last().first;
+    }
+    return result;
+}
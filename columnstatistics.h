@@ -0,0 +1,119 @@
+#ifndef COLUMNSTATISTICS_H
+#define COLUMNSTATISTICS_H
+
+#include <QObject>
+#include <QModelIndex>
+#include <QVector>
+#include "datatablemodel.h"
+
+/**
+ * @brief 列（或列中一段行）的可合并统计摘要
+ *
+ * 方差以"离均差平方和"保存并按 Chan 公式合并，避免时间戳等大数值
+ * 直接累加平方和造成的精度损失。分位数草图为等秩间隔取出的若干个
+ * 顺序统计量，每个点代表 numericCount / quantiles.size() 个值，可按权重合并。
+ */
+struct ColumnSummary {
+    int rowCount;
+    int validCount;         // 非空单元格数
+    int numericCount;       // 可作为数值统计的单元格数
+    double minimum;
+    double maximum;
+    double sum;
+    double mean;
+    double m2;              // 离均差平方和
+    double first;           // 按行序的首个/末个数值
+    double last;
+    bool ascending;         // 数值按行序单调不减
+    QVector<double> quantiles;
+
+    ColumnSummary() :
+        rowCount(0),
+        validCount(0),
+        numericCount(0),
+        minimum(0.0),
+        maximum(0.0),
+        sum(0.0),
+        mean(0.0),
+        m2(0.0),
+        first(0.0),
+        last(0.0),
+        ascending(true) {}
+
+    double variance() const;                    // 总体方差
+    double approximateQuantile(double q) const; // 由草图插值，q ∈ [0, 1]
+};
+
+/**
+ * @brief 数据表各列统计的增量缓存
+ *
+ * 每列按固定行数分块保存摘要，通过模型信号跟踪改动：单元格编辑只把所在块
+ * 标脏，插入/删除行只重算改动位置之后的块，列增删只调整对应列。
+ * summary() 先并行重算脏块，再合并各块得到整列结果；数据不变时直接返回缓存。
+ * 精确分位数由 exactQuantile() 按需用 nth_element 计算，结果缓存到下一次改动。
+ */
+class ColumnStatisticsCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ColumnStatisticsCache(DataTableModel* model, QObject *parent = nullptr);
+    ~ColumnStatisticsCache();
+
+    /**
+     * @brief 整列摘要（只重算脏块）
+     */
+    ColumnSummary summary(int column);
+
+    /**
+     * @brief 精确分位数（线性时间，q=0.5 时偶数个值取中间两值的平均）
+     */
+    double exactQuantile(int column, double q);
+
+    /**
+     * @brief 丢弃全部缓存
+     */
+    void invalidate();
+
+    // =========================================================================
+    // 静态工具接口
+    // =========================================================================
+
+    // 统计列中 [begin, end) 行
+    static ColumnSummary summarize(const DataColumn& column, int begin, int end, int sketchSize);
+
+    // 按行序合并若干段的摘要
+    static ColumnSummary merge(const QVector<ColumnSummary>& parts, int sketchSize);
+
+    // 取列中可统计的数值（数值列去空，时间戳列为毫秒，文本列为可解析的数字）
+    static QVector<double> numericValues(const DataColumn& column, int begin, int end);
+
+private slots:
+    void onDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QList<int>& roles);
+    void onRowsChanged(const QModelIndex& parent, int first, int last);
+    void onColumnsInserted(const QModelIndex& parent, int first, int last);
+    void onColumnsRemoved(const QModelIndex& parent, int first, int last);
+
+private:
+    struct ColumnEntry {
+        ColumnStorage storage;
+        QVector<ColumnSummary> blocks;
+        QVector<bool> dirty;
+        bool mergedValid;
+        ColumnSummary merged;
+        QVector<QPair<double, double>> exactQuantiles;  // (q, 值)，改动时清空
+
+        ColumnEntry() : storage(ColumnStorage::Numeric), mergedValid(false) {}
+    };
+
+    DataTableModel* m_model;
+    QVector<ColumnEntry> m_columns;
+    int m_blockSize;
+    int m_sketchSize;
+
+    void syncColumnCount();
+    void resizeBlocks(ColumnEntry& entry, int fromRow);
+    void markDirty(ColumnEntry& entry, int firstRow, int lastRow);
+};
+
+#endif // COLUMNSTATISTICS_H
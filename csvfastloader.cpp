@@ -0,0 +1,531 @@
+#include "csvfastloader.h"
+#include <QFile>
+#include <QThread>
+#include <QtConcurrent>
+#include <QFuture>
+#include <QDebug>
+#include <charconv>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <string>
+
+// ============================================================================
+// 内部辅助函数
+// ============================================================================
+
+namespace {
+
+const double kNaN = std::numeric_limits<double>::quiet_NaN();
+const qint64 kMinChunkBytes = 1 << 20;  // 每块至少 1 MB，避免小文件过度切分
+
+struct FieldSpan {
+    const char* begin;
+    const char* end;
+    bool quoted;
+};
+
+// 一个按换行对齐的解析块
+struct ChunkRange {
+    const char* begin;
+    const char* end;
+    int rowOffset;  // 本块第一行在结果中的行号
+    int rowCount;   // 本块非空行数
+};
+
+// 单块数值解析的列状态
+struct ChunkColumnState {
+    bool numeric;
+    int digits;  // -2: 尚未确定；-1: 小数位不一致或含科学计数法
+
+    ChunkColumnState() : numeric(true), digits(-2) {}
+};
+
+inline bool isBlankChar(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char* findLineEnd(const char* p, const char* end)
+{
+    const void* nl = std::memchr(p, '\n', static_cast<size_t>(end - p));
+    return nl ? static_cast<const char*>(nl) : end;
+}
+
+inline bool isBlankLine(const char* begin, const char* end)
+{
+    for (const char* p = begin; p < end; ++p) {
+        if (!isBlankChar(*p)) return false;
+    }
+    return true;
+}
+
+inline void trimSpan(const char*& begin, const char*& end)
+{
+    while (begin < end && isBlankChar(*begin)) ++begin;
+    while (end > begin && isBlankChar(end[-1])) --end;
+}
+
+// 引号感知的字段切分，返回字段总数（超过 maxFields 的字段只计数不记录）
+int splitFields(const char* begin, const char* end, char separator, FieldSpan* spans, int maxFields)
+{
+    bool collapseSpaces = (separator == ' ');
+    if (collapseSpaces) {
+        trimSpan(begin, end);
+    }
+
+    int count = 0;
+    const char* fieldStart = begin;
+    bool inQuotes = false;
+    bool quoted = false;
+
+    for (const char* p = begin; ; ++p) {
+        if (p == end || (!inQuotes && *p == separator)) {
+            if (count < maxFields) {
+                const char* fb = fieldStart;
+                const char* fe = p;
+                trimSpan(fb, fe);
+                spans[count] = { fb, fe, quoted };
+            }
+            ++count;
+            if (p == end) break;
+
+            if (collapseSpaces) {
+                while (p + 1 < end && p[1] == ' ') ++p;
+            }
+            fieldStart = p + 1;
+            quoted = false;
+        } else if (*p == '"') {
+            inQuotes = !inQuotes;
+            quoted = true;
+        }
+    }
+    return count;
+}
+
+// 去除引号后的字段内容
+std::string unquote(const FieldSpan& span)
+{
+    std::string text;
+    text.reserve(static_cast<size_t>(span.end - span.begin));
+    for (const char* p = span.begin; p < span.end; ++p) {
+        if (*p != '"') text.push_back(*p);
+    }
+    size_t first = 0;
+    while (first < text.size() && isBlankChar(text[first])) ++first;
+    size_t last = text.size();
+    while (last > first && isBlankChar(text[last - 1])) --last;
+    return text.substr(first, last - first);
+}
+
+// 数值文本的小数位数（科学计数法返回 -1）
+int fractionDigits(const char* begin, const char* end)
+{
+    const char* dot = nullptr;
+    for (const char* p = begin; p < end; ++p) {
+        if (*p == 'e' || *p == 'E') return -1;
+        if (*p == '.') dot = p;
+    }
+    return dot ? static_cast<int>(end - dot - 1) : 0;
+}
+
+inline QString decodeText(const char* begin, const char* end, bool localEncoding)
+{
+    int length = static_cast<int>(end - begin);
+    return localEncoding ? QString::fromLocal8Bit(begin, length) : QString::fromUtf8(begin, length);
+}
+
+QString decodeField(const FieldSpan& span, bool localEncoding)
+{
+    if (!span.quoted) {
+        return decodeText(span.begin, span.end, localEncoding);
+    }
+    std::string text = unquote(span);
+    return decodeText(text.data(), text.data() + text.size(), localEncoding);
+}
+
+// 统计块内非空行数
+int countRows(const char* begin, const char* end)
+{
+    int rows = 0;
+    for (const char* p = begin; p < end; ) {
+        const char* lineEnd = findLineEnd(p, end);
+        if (!isBlankLine(p, lineEnd)) ++rows;
+        p = lineEnd + 1;
+    }
+    return rows;
+}
+
+// 预览范围的结束位置：跳过 lines 行之后
+const char* skipLines(const char* p, const char* end, int lines)
+{
+    for (int line = 0; line < lines && p < end; ++line) {
+        p = findLineEnd(p, end) + 1;
+    }
+    return qMin(p, end);
+}
+
+// 第二遍：把数值直接写入预分配列
+QVector<ChunkColumnState> parseNumericChunk(const ChunkRange& chunk, char separator,
+                                            const QVector<double*>& columnData)
+{
+    int columnCount = columnData.size();
+    QVector<ChunkColumnState> states(columnCount);
+    std::vector<FieldSpan> spans(static_cast<size_t>(columnCount));
+
+    int row = chunk.rowOffset;
+    for (const char* p = chunk.begin; p < chunk.end; ) {
+        const char* lineEnd = findLineEnd(p, chunk.end);
+        if (!isBlankLine(p, lineEnd)) {
+            int fieldCount = qMin(splitFields(p, lineEnd, separator, spans.data(), columnCount), columnCount);
+            for (int col = 0; col < fieldCount; ++col) {
+                ChunkColumnState& state = states[col];
+                if (!state.numeric) continue;
+
+                const FieldSpan& span = spans[static_cast<size_t>(col)];
+                double value = 0.0;
+                bool ok;
+                int digits;
+                if (span.quoted) {
+                    std::string text = unquote(span);
+                    if (text.empty()) continue;
+                    ok = CsvFastLoader::parseNumber(text.data(), text.data() + text.size(), value);
+                    digits = fractionDigits(text.data(), text.data() + text.size());
+                } else {
+                    if (span.begin == span.end) continue;
+                    ok = CsvFastLoader::parseNumber(span.begin, span.end, value);
+                    digits = fractionDigits(span.begin, span.end);
+                }
+
+                if (!ok) {
+                    state.numeric = false;
+                    continue;
+                }
+                columnData[col][row] = value;
+
+                if (state.digits == -2) {
+                    state.digits = digits;
+                } else if (state.digits != digits) {
+                    state.digits = -1;
+                }
+            }
+            ++row;
+        }
+        p = lineEnd + 1;
+    }
+    return states;
+}
+
+// 第三遍：只为非数值列提取文本
+void extractTextChunk(const ChunkRange& chunk, char separator, int columnCount,
+                      const QVector<int>& textColumns, const QVector<QString*>& textData,
+                      bool localEncoding)
+{
+    std::vector<FieldSpan> spans(static_cast<size_t>(columnCount));
+
+    int row = chunk.rowOffset;
+    for (const char* p = chunk.begin; p < chunk.end; ) {
+        const char* lineEnd = findLineEnd(p, chunk.end);
+        if (!isBlankLine(p, lineEnd)) {
+            int fieldCount = qMin(splitFields(p, lineEnd, separator, spans.data(), columnCount), columnCount);
+            for (int i = 0; i < textColumns.size(); ++i) {
+                int col = textColumns[i];
+                if (col < fieldCount) {
+                    textData[i][row] = decodeField(spans[static_cast<size_t>(col)], localEncoding);
+                }
+            }
+            ++row;
+        }
+        p = lineEnd + 1;
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// CsvFastLoader
+// ============================================================================
+
+CsvFastLoader::CsvFastLoader(QObject *parent)
+    : QObject(parent),
+      m_cancelRequested(false)
+{
+}
+
+CsvFastLoader::~CsvFastLoader()
+{
+}
+
+void CsvFastLoader::cancel()
+{
+    m_cancelRequested = true;
+}
+
+void CsvFastLoader::resetCancel()
+{
+    m_cancelRequested = false;
+}
+
+CsvImportResult CsvFastLoader::load(const QString& filePath, const CsvImportConfig& config)
+{
+    CsvImportResult result;
+    if (m_cancelRequested) {
+        result.errorMessage = "加载已取消";
+        return result;
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        result.errorMessage = QString("无法打开文件: %1").arg(file.errorString());
+        return result;
+    }
+
+    qint64 size = file.size();
+    if (size <= 0) {
+        result.errorMessage = "文件为空或无法读取";
+        return result;
+    }
+
+    emit progressUpdated(10, "正在映射文件...");
+
+    // 优先内存映射；不支持映射的设备（如管道）退化为整体读入
+    uchar* mapped = file.map(0, size);
+    QByteArray buffer;
+    const char* data = reinterpret_cast<const char*>(mapped);
+    if (!mapped) {
+        buffer = file.readAll();
+        data = buffer.constData();
+        size = buffer.size();
+    }
+
+    // 先解析文件开头的少量行供界面提前显示（耗时可忽略）
+    if (config.previewRows > 0) {
+        int lines = qMax(0, config.startRow - 1) + 1 + config.previewRows;
+        const char* previewEnd = skipLines(data, data + size, lines);
+        if (previewEnd < data + size) {
+            CsvImportResult preview = parse(data, previewEnd - data, config, &m_cancelRequested);
+            if (preview.success && preview.rowCount > 0) {
+                emit previewReady(preview.columns, preview.rowCount);
+            }
+        }
+    }
+
+    emit progressUpdated(30, QString("正在并行解析 %1 MB 数据...").arg(size / (1024.0 * 1024.0), 0, 'f', 1));
+
+    result = parse(data, size, config, &m_cancelRequested);
+
+    if (mapped) {
+        file.unmap(mapped);
+    }
+    file.close();
+
+    if (result.success) {
+        emit progressUpdated(95, QString("已解析 %1 行 × %2 列").arg(result.rowCount).arg(result.columns.size()));
+    }
+    return result;
+}
+
+CsvImportResult CsvFastLoader::parse(const char* data, qint64 size, const CsvImportConfig& config,
+                                     const std::atomic<bool>* cancelled)
+{
+    CsvImportResult result;
+    const char* end = data + size;
+    const char* p = data;
+    bool localEncoding = (config.encoding == "GBK" || config.encoding == "GB2312");
+
+    // 跳过 UTF-8 BOM
+    if (size >= 3 && static_cast<uchar>(p[0]) == 0xEF && static_cast<uchar>(p[1]) == 0xBB
+        && static_cast<uchar>(p[2]) == 0xBF) {
+        p += 3;
+    }
+
+    // 跳过起始行之前的内容
+    for (int line = 1; line < config.startRow && p < end; ++line) {
+        p = findLineEnd(p, end) + 1;
+    }
+    if (p >= end) {
+        result.errorMessage = QString("起始行 %1 超出文件总行数").arg(config.startRow);
+        return result;
+    }
+
+    // ---- 表头 ----
+    const char* firstLineEnd = findLineEnd(p, end);
+    int firstFieldCount = splitFields(p, firstLineEnd, config.separator, nullptr, 0);
+    std::vector<FieldSpan> firstSpans(static_cast<size_t>(firstFieldCount));
+    splitFields(p, firstLineEnd, config.separator, firstSpans.data(), firstFieldCount);
+
+    bool hasHeader = config.hasHeader;
+    if (config.autoDetectHeader) {
+        hasHeader = false;
+        for (const FieldSpan& span : firstSpans) {
+            std::string text = unquote(span);
+            double value;
+            if (!text.empty() && !parseNumber(text.data(), text.data() + text.size(), value)) {
+                hasHeader = true;
+                break;
+            }
+        }
+    }
+
+    for (int col = 0; col < firstFieldCount; ++col) {
+        QString header = hasHeader ? decodeField(firstSpans[static_cast<size_t>(col)], localEncoding) : QString();
+        if (header.isEmpty()) {
+            header = QString("列%1").arg(col + 1);
+        }
+        result.headers.append(header);
+    }
+    if (hasHeader) {
+        p = (firstLineEnd < end) ? firstLineEnd + 1 : end;
+    }
+
+    int columnCount = result.headers.size();
+    if (columnCount == 0) {
+        result.errorMessage = "无法确定数据列结构";
+        return result;
+    }
+
+    // ---- 按换行对齐切块 ----
+    qint64 bodySize = end - p;
+    int threads = config.threadCount > 0 ? config.threadCount : QThread::idealThreadCount();
+    int chunkCount = static_cast<int>(qBound<qint64>(1, bodySize / kMinChunkBytes, qMax(1, threads) * 4));
+
+    QVector<ChunkRange> chunks;
+    const char* chunkBegin = p;
+    for (int c = 0; c < chunkCount && chunkBegin < end; ++c) {
+        const char* chunkEnd = (c == chunkCount - 1) ? end : p + bodySize * (c + 1) / chunkCount;
+        if (chunkEnd < chunkBegin) chunkEnd = chunkBegin;
+        if (chunkEnd < end) {
+            chunkEnd = findLineEnd(chunkEnd, end);
+            if (chunkEnd < end) ++chunkEnd;
+        }
+        chunks.append({ chunkBegin, chunkEnd, 0, 0 });
+        chunkBegin = chunkEnd;
+    }
+
+    // ---- 第一遍：并行统计行数 ----
+    {
+        QVector<QFuture<int>> futures;
+        for (const ChunkRange& chunk : chunks) {
+            futures.append(QtConcurrent::run([chunk]() { return countRows(chunk.begin, chunk.end); }));
+        }
+        qint64 total = 0;
+        for (int c = 0; c < chunks.size(); ++c) {
+            chunks[c].rowOffset = static_cast<int>(total);
+            chunks[c].rowCount = futures[c].result();
+            total += chunks[c].rowCount;
+        }
+        if (total > std::numeric_limits<int>::max()) {
+            result.errorMessage = "数据行数超出支持范围";
+            return result;
+        }
+        result.rowCount = static_cast<int>(total);
+    }
+    if (cancelled && *cancelled) {
+        result.errorMessage = "加载已取消";
+        return result;
+    }
+
+    // ---- 第二遍：并行解析数值，直接写入预分配列 ----
+    QVector<QVector<double>> numbers(columnCount);
+    QVector<double*> columnData(columnCount);
+    for (int col = 0; col < columnCount; ++col) {
+        numbers[col] = QVector<double>(result.rowCount, kNaN);
+        columnData[col] = numbers[col].data();
+    }
+
+    QVector<ChunkColumnState> merged(columnCount);
+    {
+        QVector<QFuture<QVector<ChunkColumnState>>> futures;
+        char separator = config.separator;
+        for (const ChunkRange& chunk : chunks) {
+            futures.append(QtConcurrent::run([chunk, separator, &columnData]() {
+                return parseNumericChunk(chunk, separator, columnData);
+            }));
+        }
+        for (QFuture<QVector<ChunkColumnState>>& future : futures) {
+            QVector<ChunkColumnState> states = future.result();
+            for (int col = 0; col < columnCount; ++col) {
+                ChunkColumnState& total = merged[col];
+                total.numeric = total.numeric && states[col].numeric;
+                if (states[col].digits == -2) continue;
+                if (total.digits == -2) {
+                    total.digits = states[col].digits;
+                } else if (total.digits != states[col].digits) {
+                    total.digits = -1;
+                }
+            }
+        }
+    }
+
+    if (cancelled && *cancelled) {
+        result.errorMessage = "加载已取消";
+        return result;
+    }
+
+    // ---- 第三遍：仅对非数值列提取文本 ----
+    QVector<int> textColumns;
+    for (int col = 0; col < columnCount; ++col) {
+        if (!merged[col].numeric) textColumns.append(col);
+    }
+
+    QVector<QVector<QString>> texts(textColumns.size());
+    if (!textColumns.isEmpty()) {
+        QVector<QString*> textData(textColumns.size());
+        for (int i = 0; i < textColumns.size(); ++i) {
+            numbers[textColumns[i]] = QVector<double>();  // 释放无用的数值缓冲
+            texts[i] = QVector<QString>(result.rowCount);
+            textData[i] = texts[i].data();
+        }
+
+        QVector<QFuture<void>> futures;
+        char separator = config.separator;
+        for (const ChunkRange& chunk : chunks) {
+            futures.append(QtConcurrent::run([chunk, separator, columnCount, &textColumns, &textData, localEncoding]() {
+                extractTextChunk(chunk, separator, columnCount, textColumns, textData, localEncoding);
+            }));
+        }
+        for (QFuture<void>& future : futures) {
+            future.waitForFinished();
+        }
+    }
+
+    // ---- 组装类型化列 ----
+    result.columns.reserve(columnCount);
+    int textIndex = 0;
+    for (int col = 0; col < columnCount; ++col) {
+        if (merged[col].numeric) {
+            const ChunkColumnState& state = merged[col];
+            char format = (state.digits >= 0) ? 'f' : 'g';
+            int precision = (state.digits >= 0) ? state.digits : 15;
+            QVector<double> values;
+            values.swap(numbers[col]);  // 交出所有权，避免共享导致的复制
+            result.columns.append(DataTableModel::makeNumericColumn(result.headers[col], values,
+                                                                    format, precision));
+        } else {
+            result.columns.append(DataTableModel::buildColumn(result.headers[col], texts[textIndex]));
+            texts[textIndex] = QVector<QString>();
+            ++textIndex;
+        }
+    }
+
+    result.bytesParsed = size;
+    result.chunkCount = chunks.size();
+    result.success = true;
+    return result;
+}
+
+bool CsvFastLoader::parseNumber(const char* begin, const char* end, double& value)
+{
+    if (begin < end && *begin == '+') ++begin;
+    if (begin >= end) return false;
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    std::from_chars_result parsed = std::from_chars(begin, end, value);
+    return parsed.ec == std::errc() && parsed.ptr == end && std::isfinite(value);
+#else
+    // 标准库缺少浮点 from_chars 时退化为与区域无关的 QByteArray 解析
+    bool ok = false;
+    value = QByteArray::fromRawData(begin, static_cast<int>(end - begin)).toDouble(&ok);
+    return ok && std::isfinite(value);
+#endif
+}
@@ -0,0 +1,110 @@
+#ifndef CSVFASTLOADER_H
+#define CSVFASTLOADER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+#include "datatablemodel.h"
+
+// CSV/TXT 快速导入配置
+struct CsvImportConfig {
+    int startRow;           // 开始读取的行号（从1开始）
+    bool hasHeader;         // 起始行是否为表头
+    bool autoDetectHeader;  // 自动判断表头（起始行存在非数值字段即视为表头）
+    QString encoding;       // 文本编码（GBK/GB2312 按系统编码解码，其余按 UTF-8）
+    char separator;         // 单字节分隔符；空格分隔时连续空格视为一个分隔符
+    int threadCount;        // 解析线程数（0 表示按 CPU 核数）
+    int previewRows;        // >0 时先解析前若干行并发出 previewReady（0 表示不预览）
+
+    CsvImportConfig() :
+        startRow(1),
+        hasHeader(true),
+        autoDetectHeader(false),
+        encoding("UTF-8"),
+        separator(','),
+        threadCount(0),
+        previewRows(0) {}
+};
+
+// CSV/TXT 快速导入结果
+struct CsvImportResult {
+    bool success;
+    QString errorMessage;
+    QStringList headers;
+    QVector<DataColumn> columns;
+    int rowCount;
+    qint64 bytesParsed;
+    int chunkCount;
+
+    CsvImportResult() :
+        success(false),
+        rowCount(0),
+        bytesParsed(0),
+        chunkCount(0) {}
+};
+
+/**
+ * @brief 内存映射 + 多线程 CSV/TXT 导入器
+ *
+ * 文件整体映射到内存后按换行对齐切分为若干块并行解析：第一遍统计各块行数以确定
+ * 写入偏移，第二遍用 from_chars 直接把数值写入预分配的 double 列；仅当某列出现
+ * 非数值字段时才对该列做第三遍文本提取（再交给 DataTableModel::buildColumn 推断
+ * 时间戳/文本）。全文件加载，不做行数截断。
+ *
+ * 与原逐行读取的语义保持一致：引号内的分隔符不切分、引号本身去除、字段两端去空白、
+ * 字段不足补空、多余截断；不支持引号内换行。
+ */
+class CsvFastLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CsvFastLoader(QObject *parent = nullptr);
+    ~CsvFastLoader();
+
+    /**
+     * @brief 导入文件（优先内存映射，映射失败时整体读入）
+     */
+    CsvImportResult load(const QString& filePath, const CsvImportConfig& config);
+
+    /**
+     * @brief 请求中止 load()（可从任意线程调用，在解析阶段之间生效）
+     *
+     * 取消状态保持到 resetCancel()：在 load() 开始前到达的取消同样有效。
+     */
+    void cancel();
+
+    // 清除取消请求（由调用方在启动新的加载任务前调用）
+    void resetCancel();
+
+    // =========================================================================
+    // 静态核心算法接口
+    // =========================================================================
+
+    /**
+     * @brief 解析内存中的 CSV 文本
+     * @param data 文本起始地址（可含 UTF-8 BOM）
+     * @param size 字节数
+     * @param cancelled 非空时在各遍之间检查，置位则返回失败
+     */
+    static CsvImportResult parse(const char* data, qint64 size, const CsvImportConfig& config,
+                                 const std::atomic<bool>* cancelled = nullptr);
+
+    /**
+     * @brief 解析单个数值字段（不依赖区域设置）
+     */
+    static bool parseNumber(const char* begin, const char* end, double& value);
+
+signals:
+    void progressUpdated(int progress, const QString& message);
+
+    // 预览数据（前 previewRows 行）已解析，完整解析仍在进行
+    void previewReady(const QVector<DataColumn>& columns, int rowCount);
+
+private:
+    std::atomic<bool> m_cancelRequested;
+};
+
+#endif // CSVFASTLOADER_H
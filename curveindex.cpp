@@ -0,0 +1,254 @@
+#include "curveindex.h"
+#include "plotlayercache.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+const int kBlockSize = 16;              // 叶子块点数
+const int kMaxCacheEntries = 16;
+
+const double kInfinity = std::numeric_limits<double>::infinity();
+
+// 点到区间的距离（区间内为 0）
+double gap(double value, double a, double b)
+{
+    if (a > b) std::swap(a, b);
+    if (value < a) return a - value;
+    if (value > b) return value - b;
+    return 0.0;
+}
+
+} // namespace
+
+// ============================================================================
+// CurveRangeIndex
+// ============================================================================
+
+CurveRangeIndex::CurveRangeIndex(const QVector<double>& x, const QVector<double>& y)
+    : m_leafCount(1)
+{
+    const int n = qMin(x.size(), y.size());
+
+    bool sorted = true;
+    for (int i = 0; i < n; ++i) {
+        if (!qIsFinite(x[i]) || (i > 0 && x[i] < x[i - 1])) {
+            sorted = false;
+            break;
+        }
+    }
+
+    if (sorted) {
+        // 有序数据共享原数组，不复制
+        m_x = x.size() == n ? x : x.mid(0, n);
+        m_y = y.size() == n ? y : y.mid(0, n);
+    } else {
+        m_order.reserve(n);
+        for (int i = 0; i < n; ++i) {
+            if (qIsFinite(x[i])) m_order.append(i);
+        }
+        std::stable_sort(m_order.begin(), m_order.end(), [&x](int a, int b) { return x[a] < x[b]; });
+        m_x.reserve(m_order.size());
+        m_y.reserve(m_order.size());
+        for (int i : m_order) {
+            m_x.append(x[i]);
+            m_y.append(y[i]);
+        }
+    }
+
+    // 叶子：每块的 Y 范围
+    const int count = m_x.size();
+    const int blocks = (count + kBlockSize - 1) / kBlockSize;
+    while (m_leafCount < blocks) m_leafCount <<= 1;
+
+    const Node empty = {kInfinity, -kInfinity, kInfinity};
+    m_nodes = QVector<Node>(2 * m_leafCount, empty);
+    const double* ys = m_y.constData();
+    for (int b = 0; b < blocks; ++b) {
+        Node& leaf = m_nodes[m_leafCount + b];
+        const int last = qMin(count, (b + 1) * kBlockSize);
+        for (int i = b * kBlockSize; i < last; ++i) {
+            const double value = ys[i];
+            if (!qIsFinite(value)) continue;
+            leaf.minY = qMin(leaf.minY, value);
+            leaf.maxY = qMax(leaf.maxY, value);
+            if (value > 0) leaf.minPositiveY = qMin(leaf.minPositiveY, value);
+        }
+    }
+
+    // 自底向上合并
+    for (int i = m_leafCount - 1; i >= 1; --i) {
+        const Node& left = m_nodes[2 * i];
+        const Node& right = m_nodes[2 * i + 1];
+        Node& node = m_nodes[i];
+        node.minY = qMin(left.minY, right.minY);
+        node.maxY = qMax(left.maxY, right.maxY);
+        node.minPositiveY = qMin(left.minPositiveY, right.minPositiveY);
+    }
+}
+
+int CurveRangeIndex::lowerBound(double x) const
+{
+    return int(std::lower_bound(m_x.constBegin(), m_x.constEnd(), x) - m_x.constBegin());
+}
+
+int CurveRangeIndex::upperBound(double x) const
+{
+    return int(std::upper_bound(m_x.constBegin(), m_x.constEnd(), x) - m_x.constBegin());
+}
+
+bool CurveRangeIndex::rangeY(int first, int last, bool yLog, double& minY, double& maxY) const
+{
+    Node acc = {kInfinity, -kInfinity, kInfinity};
+    auto addPoint = [&acc](double value) {
+        if (!qIsFinite(value)) return;
+        acc.minY = qMin(acc.minY, value);
+        acc.maxY = qMax(acc.maxY, value);
+        if (value > 0) acc.minPositiveY = qMin(acc.minPositiveY, value);
+    };
+    auto addNode = [&acc](const Node& node) {
+        acc.minY = qMin(acc.minY, node.minY);
+        acc.maxY = qMax(acc.maxY, node.maxY);
+        acc.minPositiveY = qMin(acc.minPositiveY, node.minPositiveY);
+    };
+
+    const double* ys = m_y.constData();
+    const int blockFirst = (first + kBlockSize - 1) / kBlockSize;
+    const int blockLast = last / kBlockSize;
+    if (blockFirst >= blockLast) {
+        for (int i = first; i < last; ++i) addPoint(ys[i]);
+    } else {
+        // 两端不满一块的点逐个处理，中间整块走线段树
+        for (int i = first; i < blockFirst * kBlockSize; ++i) addPoint(ys[i]);
+        for (int i = blockLast * kBlockSize; i < last; ++i) addPoint(ys[i]);
+        for (int l = blockFirst + m_leafCount, r = blockLast + m_leafCount; l < r; l >>= 1, r >>= 1) {
+            if (l & 1) addNode(m_nodes[l++]);
+            if (r & 1) addNode(m_nodes[--r]);
+        }
+    }
+
+    if (yLog) {
+        if (acc.minPositiveY == kInfinity) return false;
+        minY = acc.minPositiveY;
+        maxY = acc.maxY;
+        return true;
+    }
+    if (acc.minY > acc.maxY) return false;
+    minY = acc.minY;
+    maxY = acc.maxY;
+    return true;
+}
+
+bool CurveRangeIndex::bounds(bool xLog, bool yLog, double& minX, double& maxX, double& minY, double& maxY) const
+{
+    const int first = xLog ? upperBound(0.0) : 0;
+    const int last = size();
+    if (first >= last || !rangeY(first, last, yLog, minY, maxY)) return false;
+
+    // X 边界取两端第一个 Y 有效的点
+    auto valid = [this, yLog](int i) {
+        const double value = m_y[i];
+        return qIsFinite(value) && (!yLog || value > 0);
+    };
+    int lo = first;
+    while (!valid(lo)) ++lo;
+    int hi = last - 1;
+    while (!valid(hi)) --hi;
+    minX = m_x[lo];
+    maxX = m_x[hi];
+    return true;
+}
+
+bool CurveRangeIndex::yRange(double xMin, double xMax, bool yLog, double& minY, double& maxY) const
+{
+    const int first = lowerBound(xMin);
+    const int last = upperBound(xMax);
+    if (first >= last) return false;
+    return rangeY(first, last, yLog, minY, maxY);
+}
+
+int CurveRangeIndex::nearest(const PlotMapping& mapping, const QPointF& pixel, double& distance) const
+{
+    if (isEmpty() || !(distance > 0)) return -1;
+
+    // 半径内的 X 窗口
+    double xa = mapping.unmapX(pixel.x() - distance);
+    double xb = mapping.unmapX(pixel.x() + distance);
+    if (xa > xb) std::swap(xa, xb);
+    int first = lowerBound(xa);
+    const int last = upperBound(xb);
+    if (mapping.xLog()) first = qMax(first, upperBound(0.0));
+    if (first >= last) return -1;
+
+    int bestIndex = -1;
+    nearestIn(1, 0, m_leafCount, first, last, mapping, pixel, distance, bestIndex);
+    if (bestIndex < 0) return -1;
+    return m_order.isEmpty() ? bestIndex : m_order[bestIndex];
+}
+
+void CurveRangeIndex::nearestIn(int node, int blockFirst, int blockLast, int first, int last,
+                                const PlotMapping& mapping, const QPointF& pixel, double& best, int& bestIndex) const
+{
+    const int nodeFirst = qMax(first, blockFirst * kBlockSize);
+    const int nodeLast = qMin(last, blockLast * kBlockSize);
+    if (nodeFirst >= nodeLast) return;
+
+    // 节点包围盒（像素）到目标点的距离是子树内所有点距离的下界
+    const Node& box = m_nodes[node];
+    const double low = mapping.yLog() ? box.minPositiveY : box.minY;
+    if (low > box.maxY) return;
+    const double dx = gap(pixel.x(), mapping.mapX(m_x[nodeFirst]), mapping.mapX(m_x[nodeLast - 1]));
+    const double dy = gap(pixel.y(), mapping.mapY(low), mapping.mapY(box.maxY));
+    if (std::hypot(dx, dy) >= best) return;
+
+    if (node >= m_leafCount) {
+        for (int i = nodeFirst; i < nodeLast; ++i) {
+            if (!mapping.accepts(m_x[i], m_y[i])) continue;
+            const QPointF point = mapping.map(m_x[i], m_y[i]);
+            const double d = std::hypot(point.x() - pixel.x(), point.y() - pixel.y());
+            if (d < best) {
+                best = d;
+                bestIndex = i;
+            }
+        }
+        return;
+    }
+
+    // 先走目标点所在一侧，尽早收紧剪枝距离
+    const int blockMid = (blockFirst + blockLast) / 2;
+    const int split = qBound(nodeFirst, blockMid * kBlockSize, nodeLast - 1);
+    if (pixel.x() < mapping.mapX(m_x[split])) {
+        nearestIn(2 * node, blockFirst, blockMid, first, last, mapping, pixel, best, bestIndex);
+        nearestIn(2 * node + 1, blockMid, blockLast, first, last, mapping, pixel, best, bestIndex);
+    } else {
+        nearestIn(2 * node + 1, blockMid, blockLast, first, last, mapping, pixel, best, bestIndex);
+        nearestIn(2 * node, blockFirst, blockMid, first, last, mapping, pixel, best, bestIndex);
+    }
+}
+
+// ============================================================================
+// CurveIndexCache
+// ============================================================================
+
+QSharedPointer<const CurveRangeIndex> CurveIndexCache::index(const QVector<double>& x, const QVector<double>& y)
+{
+    const quint64 key = PlotLayerKey().add(x).add(y).value();
+
+    for (int i = 0; i < m_entries.size(); ++i) {
+        if (m_entries[i].key == key) {
+            Entry hit = m_entries[i];
+            m_entries.remove(i);
+            m_entries.append(hit);
+            return hit.index;
+        }
+    }
+
+    Entry entry;
+    entry.key = key;
+    entry.index = QSharedPointer<const CurveRangeIndex>(new CurveRangeIndex(x, y));
+
+    if (m_entries.size() >= kMaxCacheEntries) m_entries.removeFirst();
+    m_entries.append(entry);
+    return entry.index;
+}
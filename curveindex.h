@@ -0,0 +1,88 @@
+#ifndef CURVEINDEX_H
+#define CURVEINDEX_H
+
+#include <QPointF>
+#include <QSharedPointer>
+#include <QVector>
+#include "plotengine.h"
+
+/**
+ * @brief 曲线的区间查询索引
+ *
+ * 点按 X 升序排列（数据本来有序且全为有限值时直接共享原数组，否则复制并排序，
+ * 同时记录原下标）。每 16 个点为一块，块之上建 min/max 线段树，节点记录 Y 最小值、
+ * 最大值和最小正值，同一份索引可同时服务线性轴与对数轴：
+ *  - 任意 X 区间内的 Y 范围：两次二分 + O(log n) 次节点合并；
+ *  - 最近点拾取：先按拾取半径二分出 X 窗口，再沿线段树下降，
+ *    节点包围盒映射到像素后与目标点的距离不小于当前最优时整棵子树剪掉。
+ */
+class CurveRangeIndex
+{
+public:
+    CurveRangeIndex(const QVector<double>& x, const QVector<double>& y);
+
+    int size() const { return m_x.size(); }
+    bool isEmpty() const { return m_x.isEmpty(); }
+
+    /**
+     * @brief 整条曲线的数据边界（跳过非有限值，对数轴跳过非正值）
+     * @return 是否存在有效数据点
+     */
+    bool bounds(bool xLog, bool yLog, double& minX, double& maxX, double& minY, double& maxY) const;
+
+    /**
+     * @brief X ∈ [xMin, xMax] 内数据点的 Y 范围
+     * @return 区间内是否存在有效数据点
+     */
+    bool yRange(double xMin, double xMax, bool yLog, double& minY, double& maxY) const;
+
+    /**
+     * @brief 距像素点最近的可绘制数据点
+     * @param distance 传入搜索半径（像素），找到时改为该点的像素距离；
+     *                 多条曲线依次查询时传入当前最优值即可继续剪枝
+     * @return 原数组下标，半径内没有时为 -1
+     */
+    int nearest(const PlotMapping& mapping, const QPointF& pixel, double& distance) const;
+
+private:
+    struct Node {
+        double minY;
+        double maxY;
+        double minPositiveY;
+    };
+
+    QVector<double> m_x;                // X 升序
+    QVector<double> m_y;
+    QVector<int> m_order;               // 排序后下标 → 原下标（为空表示未重排）
+    QVector<Node> m_nodes;              // 线段树，叶子从 m_leafCount 开始
+    int m_leafCount;
+
+    int lowerBound(double x) const;     // 首个 X >= x 的下标
+    int upperBound(double x) const;     // 首个 X > x 的下标
+    bool rangeY(int first, int last, bool yLog, double& minY, double& maxY) const;
+    void nearestIn(int node, int blockFirst, int blockLast, int first, int last,
+                   const PlotMapping& mapping, const QPointF& pixel, double& best, int& bestIndex) const;
+};
+
+/**
+ * @brief 按曲线数据缓存区间索引
+ *
+ * 以数组地址、长度和抽样值识别数据（同 PlotLayerKey）；数据替换后自动重建。
+ * 索引持有数组的隐式共享拷贝，缓存期间原数组不会被复用地址。
+ */
+class CurveIndexCache
+{
+public:
+    QSharedPointer<const CurveRangeIndex> index(const QVector<double>& x, const QVector<double>& y);
+    void clear() { m_entries.clear(); }
+
+private:
+    struct Entry {
+        quint64 key;
+        QSharedPointer<const CurveRangeIndex> index;
+    };
+
+    QVector<Entry> m_entries;           // 最近使用的在末尾
+};
+
+#endif // CURVEINDEX_H
@@ -0,0 +1,309 @@
+#include "curvelod.h"
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const int kMinTopBlocks = 64;           // 最高层至少保留的块数
+const int kMaxCacheEntries = 32;
+const int kFingerprintSamples = 16;
+
+// 数组的抽样指纹：原地修改数据后（地址不变）也能察觉
+quint64 fingerprint(const QVector<double>& x, const QVector<double>& y)
+{
+    quint64 hash = 1469598103934665603ULL;
+    const int n = qMin(x.size(), y.size());
+    if (n == 0) return hash;
+    for (int s = 0; s < kFingerprintSamples; ++s) {
+        int i = int(qint64(n - 1) * s / (kFingerprintSamples - 1));
+        for (double value : {x[i], y[i]}) {
+            quint64 bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            hash = (hash ^ bits) * 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+
+/**
+ * 按像素列归约金字塔块：每列保留首点、最小点、最大点、末点。
+ * 块跨越一个像素以上时（如对数轴稀疏端）拆到下一层，保证每块只落在一列内。
+ */
+class ColumnReducer
+{
+public:
+    ColumnReducer(const CurveLodPyramid& pyramid, const PlotMapping& mapping, QVector<QPointF>& points)
+        : m_pyramid(pyramid), m_mapping(mapping), m_points(points),
+          m_column(0), m_first(-1), m_last(-1), m_min(-1), m_max(-1) {}
+
+    void visit(int level, int block)
+    {
+        const int n = m_pyramid.x.size();
+        const int first = block * m_pyramid.blockSize(level);
+        if (first >= n) return;
+        const int last = qMin(n, first + m_pyramid.blockSize(level)) - 1;
+
+        const double span = m_mapping.mapX(m_pyramid.x[last]) - m_mapping.mapX(m_pyramid.x[first]);
+        if (span < 1.0) {
+            add(first, last, m_pyramid.minIndex[level][block], m_pyramid.maxIndex[level][block]);
+        } else if (level > 0) {
+            visit(level - 1, 2 * block);
+            visit(level - 1, 2 * block + 1);
+        } else {
+            for (int i = first; i <= last; ++i) add(i, i, i, i);
+        }
+    }
+
+    void flush()
+    {
+        if (m_first < 0) return;
+        int order[4] = {m_first, m_min, m_max, m_last};
+        std::sort(order, order + 4);
+        int previous = -1;
+        for (int idx : order) {
+            if (idx == previous) continue;
+            m_points.append(m_mapping.map(m_pyramid.x[idx], m_pyramid.y[idx]));
+            previous = idx;
+        }
+        m_first = -1;
+    }
+
+private:
+    const CurveLodPyramid& m_pyramid;
+    const PlotMapping& m_mapping;
+    QVector<QPointF>& m_points;
+    int m_column;
+    int m_first, m_last, m_min, m_max;
+
+    void add(int first, int last, int minIdx, int maxIdx)
+    {
+        const QVector<double>& ys = m_pyramid.y;
+        const int column = int(std::floor(m_mapping.mapX(m_pyramid.x[first])));
+        if (m_first < 0 || column != m_column) {
+            flush();
+            m_column = column;
+            m_first = first;
+            m_min = minIdx;
+            m_max = maxIdx;
+        } else {
+            if (ys[minIdx] < ys[m_min]) m_min = minIdx;
+            if (ys[maxIdx] > ys[m_max]) m_max = maxIdx;
+        }
+        m_last = last;
+    }
+};
+
+} // namespace
+
+// ============================================================================
+// CurveLodCache
+// ============================================================================
+
+QSharedPointer<const CurveLodPyramid> CurveLodCache::pyramid(const QVector<double>& x, const QVector<double>& y,
+                                                             const PlotMapping& mapping)
+{
+    const int size = qMin(x.size(), y.size());
+    const quint64 print = fingerprint(x, y);
+
+    for (int i = 0; i < m_entries.size(); ++i) {
+        const Entry& entry = m_entries[i];
+        if (entry.xData == x.constData() && entry.yData == y.constData() && entry.size == size
+            && entry.fingerprint == print && entry.xLog == mapping.xLog() && entry.yLog == mapping.yLog()) {
+            Entry hit = entry;
+            m_entries.remove(i);
+            m_entries.append(hit);
+            return hit.pyramid;
+        }
+    }
+
+    Entry entry;
+    entry.xData = x.constData();
+    entry.yData = y.constData();
+    entry.size = size;
+    entry.fingerprint = print;
+    entry.xLog = mapping.xLog();
+    entry.yLog = mapping.yLog();
+    entry.pyramid = CurveLod::build(x, y, mapping);
+
+    if (m_entries.size() >= kMaxCacheEntries) m_entries.removeFirst();
+    m_entries.append(entry);
+    return entry.pyramid;
+}
+
+// ============================================================================
+// CurveLod
+// ============================================================================
+
+QSharedPointer<CurveLodPyramid> CurveLod::build(const QVector<double>& x, const QVector<double>& y,
+                                                const PlotMapping& mapping)
+{
+    QSharedPointer<CurveLodPyramid> pyramid(new CurveLodPyramid);
+    const int size = qMin(x.size(), y.size());
+    pyramid->x.reserve(size);
+    pyramid->y.reserve(size);
+
+    for (int i = 0; i < size; ++i) {
+        if (!mapping.accepts(x[i], y[i])) continue;
+        if (!pyramid->x.isEmpty() && x[i] < pyramid->x.last()) pyramid->monotonic = false;
+        pyramid->x.append(x[i]);
+        pyramid->y.append(y[i]);
+    }
+    if (!pyramid->monotonic) return pyramid;
+
+    const QVector<double>& ys = pyramid->y;
+    const int n = ys.size();
+
+    // 第 0 层：两点一块
+    QVector<int> mins((n + 1) / 2), maxs((n + 1) / 2);
+    for (int b = 0; b < mins.size(); ++b) {
+        int first = 2 * b;
+        int second = qMin(first + 1, n - 1);
+        mins[b] = ys[second] < ys[first] ? second : first;
+        maxs[b] = ys[second] > ys[first] ? second : first;
+    }
+
+    // 逐层两两合并，直到块数足够少
+    while (mins.size() >= kMinTopBlocks) {
+        pyramid->minIndex.append(mins);
+        pyramid->maxIndex.append(maxs);
+
+        const QVector<int>& lowerMins = pyramid->minIndex.last();
+        const QVector<int>& lowerMaxs = pyramid->maxIndex.last();
+        const int blocks = (lowerMins.size() + 1) / 2;
+        mins = QVector<int>(blocks);
+        maxs = QVector<int>(blocks);
+        for (int b = 0; b < blocks; ++b) {
+            int left = 2 * b;
+            int right = qMin(left + 1, lowerMins.size() - 1);
+            mins[b] = ys[lowerMins[right]] < ys[lowerMins[left]] ? lowerMins[right] : lowerMins[left];
+            maxs[b] = ys[lowerMaxs[right]] > ys[lowerMaxs[left]] ? lowerMaxs[right] : lowerMaxs[left];
+        }
+    }
+    pyramid->minIndex.append(mins);
+    pyramid->maxIndex.append(maxs);
+    return pyramid;
+}
+
+QVector<QPointF> CurveLod::polyline(const CurveLodPyramid& pyramid, const PlotMapping& mapping, double margin)
+{
+    QVector<QPointF> points;
+    const QVector<double>& xs = pyramid.x;
+    const QVector<double>& ys = pyramid.y;
+    const int n = xs.size();
+    if (n == 0) return points;
+
+    // X 不单调时无法按列归约：逐点映射
+    if (!pyramid.monotonic) {
+        mapping.mapPoints(xs.constData(), ys.constData(), n, points);
+        return points;
+    }
+
+    // 可见范围（两侧各多取一点，使折线延伸到绘图区边缘）
+    const double left = mapping.area().left() - margin;
+    const double right = mapping.area().right() + margin;
+    auto begin = xs.constBegin();
+    int lo = int(std::partition_point(begin, xs.constEnd(),
+                                      [&](double x) { return mapping.mapX(x) < left; }) - begin);
+    int hi = int(std::partition_point(begin + lo, xs.constEnd(),
+                                      [&](double x) { return mapping.mapX(x) <= right; }) - begin);
+    lo = qMax(0, lo - 1);
+    hi = qMin(n, hi + 1);
+
+    const int count = hi - lo;
+    const double columns = qMax(1.0, right - left);
+    if (count <= 4 * columns || pyramid.minIndex.isEmpty()) {
+        mapping.mapPoints(xs.constData() + lo, ys.constData() + lo, count, points);
+        return points;
+    }
+
+    // 起始层：每块平均不超过半个像素列的点数
+    int level = 0;
+    while (level + 1 < pyramid.minIndex.size()
+           && pyramid.blockSize(level + 1) * 2.0 * columns <= count) {
+        ++level;
+    }
+
+    ColumnReducer reducer(pyramid, mapping, points);
+    points.reserve(int(columns) * 4 + 8);
+    const int blockSize = pyramid.blockSize(level);
+    for (int b = lo / blockSize; b * blockSize < hi; ++b) {
+        reducer.visit(level, b);
+    }
+    reducer.flush();
+    return points;
+}
+
+void CurveLod::draw(QPainter& painter, const CurveLodPyramid& pyramid, const PlotMapping& mapping,
+                    const QPen& pen, const QColor& markerColor, int pointSize)
+{
+    QVector<QPointF> points = polyline(pyramid, mapping);
+    painter.setPen(pen);
+
+    if (points.size() > 1) {
+        painter.setClipRect(mapping.area().adjusted(-5, -5, 5, 5));
+        painter.drawPolyline(points.constData(), points.size());
+        painter.setClipping(false);
+    }
+
+    painter.setBrush(markerColor);
+    drawMarkers(painter, points, mapping.area(), pointSize);
+}
+
+void CurveLod::drawStep(QPainter& painter, const QVector<double>& x, const QVector<double>& y,
+                        const PlotMapping& mapping, const QPen& pen, const QColor& markerColor,
+                        int pointSize)
+{
+    const int dataSize = qMin(x.size(), y.size());
+    if (dataSize == 0) return;
+
+    painter.setPen(pen);
+    painter.setClipRect(mapping.area().adjusted(-5, -5, 5, 5));
+
+    for (int i = 0; i + 1 < dataSize; i += 2) {
+        if (!mapping.accepts(x[i], y[i]) || !mapping.accepts(x[i + 1], y[i + 1])) continue;
+
+        QPointF segmentStart = mapping.map(x[i], y[i]);
+        QPointF segmentEnd = mapping.map(x[i + 1], y[i + 1]);
+        painter.drawLine(segmentStart, segmentEnd);
+
+        // 与下一段起点之间的竖线
+        if (i + 3 < dataSize && mapping.accepts(x[i + 2], y[i + 2])) {
+            QPointF nextSegmentStart = mapping.map(x[i + 2], y[i + 2]);
+            painter.drawLine(segmentEnd, QPointF(segmentEnd.x(), nextSegmentStart.y()));
+        }
+    }
+
+    painter.setClipping(false);
+
+    QVector<QPointF> starts;
+    starts.reserve(dataSize / 2 + 1);
+    for (int i = 0; i < dataSize; i += 2) {
+        if (mapping.accepts(x[i], y[i])) starts.append(mapping.map(x[i], y[i]));
+    }
+    painter.setBrush(markerColor);
+    drawMarkers(painter, starts, mapping.area(), pointSize);
+}
+
+void CurveLod::drawMarkers(QPainter& painter, const QVector<QPointF>& points, const QRect& area, int pointSize)
+{
+    const int radius = pointSize / 2;
+    const int cell = qMax(1, pointSize);
+    const int gridWidth = int(area.width()) / cell + 1;
+    const int gridHeight = int(area.height()) / cell + 1;
+    QVector<char> occupied(gridWidth * gridHeight, 0);
+
+    for (const QPointF& point : points) {
+        QPoint pixel = point.toPoint();
+        if (!area.contains(pixel)) continue;
+
+        int gx = qBound(0, int((pixel.x() - area.left()) / cell), gridWidth - 1);
+        int gy = qBound(0, int((pixel.y() - area.top()) / cell), gridHeight - 1);
+        char& slot = occupied[gy * gridWidth + gx];
+        if (slot) continue;
+        slot = 1;
+
+        painter.drawEllipse(point, radius, radius);
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef CURVELOD_H
+#define CURVELOD_H
+
+#include <QColor>
+#include <QPainter>
+#include <QPen>
+#include <QPointF>
+#include <QSharedPointer>
+#include <QVector>
+#include "plotengine.h"
+
+/**
+ * @brief 曲线的多分辨率 min/max 金字塔
+ *
+ * 只保留可绘制的点（按映射的对数轴要求过滤）。第 k 层把连续的 2^(k+1) 个点
+ * 合为一块，记录块内 y 最小与最大点的下标，由下一层两两合并得到，总构建代价 O(n)。
+ * X 单调不减时才能按像素列抽稀，否则绘制时退回逐点映射。
+ */
+struct CurveLodPyramid {
+    QVector<double> x;                  // 可绘制点（保持原顺序）
+    QVector<double> y;
+    QVector<QVector<int>> minIndex;     // [层][块] → y 最小点下标
+    QVector<QVector<int>> maxIndex;     // [层][块] → y 最大点下标
+    bool monotonic;                     // X 是否单调不减
+
+    CurveLodPyramid() : monotonic(true) {}
+
+    int blockSize(int level) const { return 2 << level; }
+};
+
+/**
+ * @brief 按曲线数据缓存金字塔
+ *
+ * 以数组地址、长度、抽样指纹和坐标轴类型识别数据；数据替换或修改后自动重建。
+ */
+class CurveLodCache
+{
+public:
+    QSharedPointer<const CurveLodPyramid> pyramid(const QVector<double>& x, const QVector<double>& y,
+                                                  const PlotMapping& mapping);
+    void clear() { m_entries.clear(); }
+
+private:
+    struct Entry {
+        const double* xData;
+        const double* yData;
+        int size;
+        quint64 fingerprint;
+        bool xLog;
+        bool yLog;
+        QSharedPointer<const CurveLodPyramid> pyramid;
+    };
+
+    QVector<Entry> m_entries;           // 最近使用的在末尾
+};
+
+/**
+ * @brief 细节层次（LOD）曲线绘制
+ *
+ * 可见范围按 X 二分查找；点数超过像素列数的数倍时，选用块宽不超过半个像素列的
+ * 金字塔层，把每个像素列归约为首点、最小点、最大点、末点（按原顺序），
+ * 包络与逐点绘制一致，绘制代价只与绘图区宽度有关。折线一次 drawPolyline 画出；
+ * 数据点标记按点径划分网格，每格只画一个（重叠的标记本来就看不出差别）。
+ */
+class CurveLod
+{
+public:
+    static QSharedPointer<CurveLodPyramid> build(const QVector<double>& x, const QVector<double>& y,
+                                                 const PlotMapping& mapping);
+
+    // 可见范围内抽稀后的像素折线（margin 为绘图区左右额外包含的像素）
+    static QVector<QPointF> polyline(const CurveLodPyramid& pyramid, const PlotMapping& mapping,
+                                     double margin = 50.0);
+
+    // 折线 + 数据点标记
+    static void draw(QPainter& painter, const CurveLodPyramid& pyramid, const PlotMapping& mapping,
+                     const QPen& pen, const QColor& markerColor, int pointSize);
+
+    // 阶梯曲线：数据按 (起点, 终点) 成对给出水平段，段间以竖线相连，标记画在各段起点
+    static void drawStep(QPainter& painter, const QVector<double>& x, const QVector<double>& y,
+                         const PlotMapping& mapping, const QPen& pen, const QColor& markerColor,
+                         int pointSize);
+
+    // 按网格抽稀后绘制数据点标记（只画绘图区内的点）
+    static void drawMarkers(QPainter& painter, const QVector<QPointF>& points, const QRect& area,
+                            int pointSize);
+};
+
+#endif // CURVELOD_H
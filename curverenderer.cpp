@@ -0,0 +1,187 @@
+#include "curverenderer.h"
+#include "plotlayercache.h"
+#include "plottingwidget.h"
+#include <QTransform>
+#include <QtConcurrent>
+
+// 一次渲染的全部输入（曲线为隐式共享的拷贝，取出时不复制数组）
+struct CurveRenderJob {
+    QVector<CurveData> curves;
+    PlotMapping mapping;
+    QSize size;
+    qreal devicePixelRatio;
+    quint64 key;
+
+    CurveRenderJob() : devicePixelRatio(1.0), key(0) {}
+};
+
+// ============================================================================
+// 内部辅助函数
+// ============================================================================
+
+namespace {
+
+const qint64 kSyncPointLimit = 200000;  // 可见曲线总点数不超过时在界面线程渲染
+
+// 同一数据区间在旧帧与新视图中的像素位置 → 单轴仿射变换
+bool axisTransform(double from0, double from1, double to0, double to1, double& scale, double& offset)
+{
+    if (qAbs(from1 - from0) < 1e-9) return false;
+    scale = (to1 - to0) / (from1 - from0);
+    offset = to0 - scale * from0;
+    return qIsFinite(scale) && qIsFinite(offset);
+}
+
+// 旧帧像素 → 新视图像素（坐标轴类型变化时无法变换）
+bool frameTransform(const PlotMapping& from, const PlotMapping& to, QTransform& transform)
+{
+    if (from.xLogActive() != to.xLogActive() || from.yLogActive() != to.yLogActive()) return false;
+
+    double sx, dx, sy, dy;
+    if (!axisTransform(from.mapX(from.xMin()), from.mapX(from.xMax()),
+                       to.mapX(from.xMin()), to.mapX(from.xMax()), sx, dx)) return false;
+    if (!axisTransform(from.mapY(from.yMin()), from.mapY(from.yMax()),
+                       to.mapY(from.yMin()), to.mapY(from.yMax()), sy, dy)) return false;
+
+    transform = QTransform(sx, 0, 0, sy, dx, dy);
+    return true;
+}
+
+quint64 renderKey(const QVector<CurveData>& curves, const PlotMapping& mapping,
+                  const QSize& size, qreal devicePixelRatio)
+{
+    PlotLayerKey key;
+    key.add(mapping.area());
+    key.add(mapping.xMin()).add(mapping.xMax()).add(mapping.yMin()).add(mapping.yMax());
+    key.add(mapping.xLog()).add(mapping.yLog());
+    key.add(size.width()).add(size.height()).add(double(devicePixelRatio));
+    key.add(curves.size());
+    for (const CurveData& curve : curves) key.add(curve);
+    return key.value();
+}
+
+} // namespace
+
+// ============================================================================
+// CurveRenderer
+// ============================================================================
+
+CurveRenderer::CurveRenderer(QObject* parent)
+    : QObject(parent),
+      m_latestKey(0),
+      m_runningKey(0)
+{
+    connect(&m_watcher, &QFutureWatcher<CurveFrame>::finished, this, &CurveRenderer::onRenderFinished);
+}
+
+CurveRenderer::~CurveRenderer()
+{
+    // 后台任务使用 m_workerCache，必须先结束
+    m_watcher.waitForFinished();
+}
+
+void CurveRenderer::paint(QPainter& painter, const QVector<CurveData>& curves, const PlotMapping& mapping,
+                          const QSize& size, qreal devicePixelRatio)
+{
+    m_latestKey = renderKey(curves, mapping, size, devicePixelRatio);
+    if (m_frame.key == m_latestKey && !m_frame.image.isNull()) {
+        painter.drawImage(0, 0, m_frame.image);
+        return;
+    }
+
+    QSharedPointer<CurveRenderJob> job(new CurveRenderJob);
+    job->curves = curves;
+    job->mapping = mapping;
+    job->size = size;
+    job->devicePixelRatio = devicePixelRatio;
+    job->key = m_latestKey;
+
+    qint64 points = 0;
+    for (const CurveData& curve : curves) {
+        if (curve.visible) points += qMin(curve.xData.size(), curve.yData.size());
+    }
+
+    // 数据量小：同步渲染
+    if (points <= kSyncPointLimit) {
+        m_frame = render(*job, m_syncCache);
+        painter.drawImage(0, 0, m_frame.image);
+        return;
+    }
+
+    // 数据量大：后台渲染，先显示变换后的旧帧
+    if (!m_watcher.isRunning()) {
+        start(job);
+    } else if (m_runningKey != m_latestKey) {
+        m_pending = job;
+    } else {
+        m_pending.reset();
+    }
+    drawStaleFrame(painter, mapping);
+}
+
+void CurveRenderer::start(const QSharedPointer<CurveRenderJob>& job)
+{
+    m_runningKey = job->key;
+    m_watcher.setFuture(QtConcurrent::run([this, job]() {
+        return render(*job, m_workerCache);
+    }));
+}
+
+void CurveRenderer::onRenderFinished()
+{
+    CurveFrame frame = m_watcher.result();
+
+    // 期间已同步渲染出最新帧时丢弃
+    const bool accepted = m_frame.key != m_latestKey;
+    if (accepted) m_frame = frame;
+
+    if (m_pending) {
+        QSharedPointer<CurveRenderJob> job = m_pending;
+        m_pending.reset();
+        if (job->key != frame.key) start(job);
+    }
+
+    if (accepted) emit frameReady();
+}
+
+void CurveRenderer::drawStaleFrame(QPainter& painter, const PlotMapping& mapping)
+{
+    if (m_frame.image.isNull()) return;
+
+    QTransform transform;
+    if (!frameTransform(m_frame.mapping, mapping, transform)) return;
+
+    painter.save();
+    painter.setClipRect(mapping.area().adjusted(-5, -5, 5, 5));
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
+    painter.setTransform(transform, true);
+    painter.drawImage(0, 0, m_frame.image);
+    painter.restore();
+}
+
+CurveFrame CurveRenderer::render(const CurveRenderJob& job, CurveLodCache& cache)
+{
+    CurveFrame frame;
+    frame.mapping = job.mapping;
+    frame.key = job.key;
+    frame.image = QImage(job.size * job.devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+    if (frame.image.isNull()) return frame;
+    frame.image.setDevicePixelRatio(job.devicePixelRatio);
+    frame.image.fill(Qt::transparent);
+
+    QPainter painter(&frame.image);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+
+    for (const CurveData& curve : job.curves) {
+        if (!curve.visible || curve.xData.isEmpty() || curve.yData.isEmpty()) continue;
+
+        QPen pen(curve.color, curve.lineWidth, lineStyleToQt(curve.lineStyle));
+        if (curve.drawType == CurveType::Step) {
+            CurveLod::drawStep(painter, curve.xData, curve.yData, job.mapping, pen, curve.color, curve.pointSize);
+        } else {
+            QSharedPointer<const CurveLodPyramid> pyramid = cache.pyramid(curve.xData, curve.yData, job.mapping);
+            CurveLod::draw(painter, *pyramid, job.mapping, pen, curve.color, curve.pointSize);
+        }
+    }
+    return frame;
+}
@@ -0,0 +1,72 @@
+#ifndef CURVERENDERER_H
+#define CURVERENDERER_H
+
+#include <QFutureWatcher>
+#include <QImage>
+#include <QObject>
+#include <QPainter>
+#include <QSharedPointer>
+#include <QSize>
+#include <QVector>
+#include "curvelod.h"
+
+struct CurveData;
+struct CurveRenderJob;
+
+// 一帧曲线层位图及其渲染时的视图变换
+struct CurveFrame {
+    QImage image;           // 按设备像素比分配，透明背景
+    PlotMapping mapping;    // 渲染时的坐标映射
+    quint64 key;            // 渲染输入指纹
+
+    CurveFrame() : key(0) {}
+};
+
+/**
+ * @brief 曲线层渲染器
+ *
+ * 曲线折线计算（LOD 抽稀）与光栅化都在 QImage 上完成。可见点数不多时在界面线程
+ * 同步渲染，与直接绘制无异；点数超过阈值时提交到后台线程，界面线程
+ * 只贴图：视图已变化（缩放、平移）的旧帧按新旧映射的仿射关系变换后先行显示，
+ * 新帧完成后发出 frameReady() 触发重绘。后台同时只渲染一帧，期间的请求只保留最新的。
+ */
+class CurveRenderer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CurveRenderer(QObject* parent = nullptr);
+    ~CurveRenderer();
+
+    /**
+     * @brief 在 painter 上绘制曲线层
+     * @param size 逻辑像素尺寸（绘图控件大小）
+     */
+    void paint(QPainter& painter, const QVector<CurveData>& curves, const PlotMapping& mapping,
+               const QSize& size, qreal devicePixelRatio);
+
+    // 后台是否正在渲染
+    bool isRendering() const { return m_watcher.isRunning(); }
+
+signals:
+    // 后台渲染的新帧已就绪，需要重绘
+    void frameReady();
+
+private slots:
+    void onRenderFinished();
+
+private:
+    CurveFrame m_frame;                         // 最近一帧
+    quint64 m_latestKey;                        // 最近一次请求的指纹
+    quint64 m_runningKey;                       // 后台正在渲染的指纹
+    QSharedPointer<CurveRenderJob> m_pending;   // 等待后台空闲的最新请求
+    QFutureWatcher<CurveFrame> m_watcher;
+    CurveLodCache m_syncCache;                  // 界面线程使用
+    CurveLodCache m_workerCache;                // 后台线程使用（同时只有一个任务）
+
+    void start(const QSharedPointer<CurveRenderJob>& job);
+    void drawStaleFrame(QPainter& painter, const PlotMapping& mapping);
+    static CurveFrame render(const CurveRenderJob& job, CurveLodCache& cache);
+};
+
+#endif // CURVERENDERER_H
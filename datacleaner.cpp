@@ -0,0 +1,737 @@
+#include "datacleaner.h"
+#include <QFuture>
+#include <QHash>
+#include <QMultiHash>
+#include <QStringList>
+#include <QStringView>
+#include <QThread>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace {
+
+const double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+// 单个并行块的最少行数（更小的数据直接在调用线程上处理）
+const int kMinChunkRows = 65536;
+
+int resolveThreadCount(int requested)
+{
+    return requested > 0 ? requested : qMax(1, QThread::idealThreadCount());
+}
+
+// 把 [0, count) 切成若干连续块并行执行 fn(begin, end)，返回前等待全部完成
+void parallelChunks(int count, int threads, const std::function<void(int, int)>& fn)
+{
+    int chunks = qBound(1, count / kMinChunkRows, threads * 4);
+    if (chunks <= 1 || threads <= 1) {
+        fn(0, count);
+        return;
+    }
+
+    QVector<QFuture<void>> futures;
+    futures.reserve(chunks);
+    for (int c = 0; c < chunks; ++c) {
+        int begin = int(qint64(count) * c / chunks);
+        int end = int(qint64(count) * (c + 1) / chunks);
+        futures.append(QtConcurrent::run([&fn, begin, end]() { fn(begin, end); }));
+    }
+    for (QFuture<void>& future : futures) {
+        future.waitForFinished();
+    }
+}
+
+// 按列并行执行 fn(column)
+void parallelColumns(int count, int threads, const std::function<void(int)>& fn)
+{
+    if (count <= 1 || threads <= 1) {
+        for (int c = 0; c < count; ++c) fn(c);
+        return;
+    }
+
+    QVector<QFuture<void>> futures;
+    futures.reserve(count);
+    for (int c = 0; c < count; ++c) {
+        futures.append(QtConcurrent::run([&fn, c]() { fn(c); }));
+    }
+    for (QFuture<void>& future : futures) {
+        future.waitForFinished();
+    }
+}
+
+// splitmix64 终混函数
+inline quint64 mix64(quint64 x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+// 单元格的类型化哈希（数值按位模式，-0 与 +0 视为相同；文本去首尾空白）
+inline quint64 cellKey(const DataColumn& column, int row)
+{
+    if (!column.isValid(row)) return 0x6a09e667f3bcc909ULL;
+
+    switch (column.storage) {
+    case ColumnStorage::Numeric: {
+        double value = column.numbers[row];
+        if (value == 0.0) value = 0.0;
+        quint64 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return mix64(bits);
+    }
+    case ColumnStorage::Timestamp:
+        return mix64(quint64(column.timestamps[row]) ^ 0x3c6ef372fe94f82bULL);
+    case ColumnStorage::Text:
+        return mix64(quint64(qHash(QStringView(column.texts[row]).trimmed(), 0)) ^ 0xa54ff53a5f1d36f1ULL);
+    }
+    return 0;
+}
+
+inline bool sameCell(const DataColumn& column, int a, int b)
+{
+    bool validA = column.isValid(a);
+    bool validB = column.isValid(b);
+    if (validA != validB) return false;
+    if (!validA) return true;
+
+    switch (column.storage) {
+    case ColumnStorage::Numeric:
+        return column.numbers[a] == column.numbers[b];
+    case ColumnStorage::Timestamp:
+        return column.timestamps[a] == column.timestamps[b];
+    case ColumnStorage::Text:
+        return QStringView(column.texts[a]).trimmed() == QStringView(column.texts[b]).trimmed();
+    }
+    return false;
+}
+
+// 中位数（会重排 values）
+double medianOf(std::vector<double>& values)
+{
+    if (values.empty()) return kNaN;
+
+    size_t mid = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + mid, values.end());
+    double upper = values[mid];
+    if (values.size() % 2 == 1) return upper;
+
+    double lower = *std::max_element(values.begin(), values.begin() + mid);
+    return (lower + upper) / 2.0;
+}
+
+// 空缺值列（与 rows 等长，全部无效）
+DataColumn emptyValues(int count)
+{
+    DataColumn values;
+    values.numbers = QVector<double>(count, kNaN);
+    values.validity = QVector<quint64>((count + 63) / 64, 0ULL);
+    return values;
+}
+
+int rangeRowCount(const RowRanges& ranges)
+{
+    int count = 0;
+    for (const QPair<int, int>& range : ranges) {
+        count += range.second;
+    }
+    return count;
+}
+
+} // namespace
+
+// ============================================================================
+// DataCleaningResult
+// ============================================================================
+
+QString DataCleaningResult::summary() const
+{
+    QStringList lines;
+    for (const CleaningStepResult& step : steps) {
+        lines << QString("%1：%2").arg(step.name, step.detail);
+    }
+    lines << QString("清理后：%1 行 × %2 列（清理前 %3 行 × %4 列）")
+             .arg(rowsAfter).arg(columnsAfter).arg(rowsBefore).arg(columnsBefore);
+    return lines.join("\n");
+}
+
+// ============================================================================
+// DataCleaner
+// ============================================================================
+
+DataCleaner::DataCleaner(QObject *parent) : QObject(parent)
+{
+}
+
+DataCleaner::~DataCleaner()
+{
+}
+
+DataCleaningResult DataCleaner::plan(const DataTableModel* model, const DataCleaningConfig& config)
+{
+    DataCleaningResult result;
+    if (!model || model->rowCount() == 0 || model->columnCount() == 0) {
+        result.errorMessage = "没有可清理的数据";
+        return result;
+    }
+
+    int threads = resolveThreadCount(config.threadCount);
+
+    // 在内部副本上依次模拟各步骤（列数组隐式共享，只有被改写的列才会复制）
+    DataTableModel work;
+    work.setTableData(model->tableColumns(), model->rowCount());
+    int timeColumn = config.timeColumnIndex < work.columnCount() ? config.timeColumnIndex : -1;
+
+    result.rowsBefore = work.rowCount();
+    result.columnsBefore = work.columnCount();
+
+    // 删除空行
+    if (config.removeEmptyRows) {
+        emit progressUpdated(10, "正在查找空行...");
+        CleaningStepResult step;
+        step.name = "删除空行";
+        step.removedRows = findEmptyRows(work.tableColumns(), work.rowCount(), threads);
+        step.affectedRows = rangeRowCount(step.removedRows);
+        step.detail = QString("%1 行").arg(step.affectedRows);
+        if (!step.removedRows.isEmpty()) {
+            work.takeRows(step.removedRows);
+        }
+        result.steps.append(step);
+    }
+
+    // 删除空列
+    if (config.removeEmptyColumns) {
+        emit progressUpdated(20, "正在查找空列...");
+        CleaningStepResult step;
+        step.name = "删除空列";
+        step.removedColumns = findEmptyColumns(work.tableColumns(), work.rowCount());
+        step.detail = QString("%1 列").arg(step.removedColumns.size());
+        for (int i = step.removedColumns.size() - 1; i >= 0; --i) {
+            int column = step.removedColumns[i];
+            work.removeColumns(column, 1);
+            // 时间列索引随删除的列前移
+            if (column == timeColumn) {
+                timeColumn = -1;
+            } else if (column < timeColumn) {
+                --timeColumn;
+            }
+        }
+        result.steps.append(step);
+    }
+
+    // 删除重复行
+    if (config.removeDuplicates) {
+        emit progressUpdated(35, "正在查找重复行...");
+        CleaningStepResult step;
+        step.name = "删除重复行";
+        step.removedRows = findDuplicateRows(work.tableColumns(), work.rowCount(), threads);
+        step.affectedRows = rangeRowCount(step.removedRows);
+        step.detail = QString("%1 行").arg(step.affectedRows);
+        if (!step.removedRows.isEmpty()) {
+            work.takeRows(step.removedRows);
+        }
+        result.steps.append(step);
+    }
+
+    // 异常值置空（在填充之前，使清除的尖峰可以被插值补上）
+    if (config.removeOutliers) {
+        emit progressUpdated(50, "正在检测异常值...");
+        CleaningStepResult step;
+        step.name = "清除异常值";
+        QVector<char> touched(work.rowCount(), 0);
+        for (int col = 0; col < work.columnCount(); ++col) {
+            // 派生列由源列重算，不单独清理
+            if (col == timeColumn || work.columnStorage(col) != ColumnStorage::Numeric
+                || work.isComputed(col)) continue;
+
+            QVector<int> rows = findOutliers(work.column(col).numbers, config.outlierWindow,
+                                             config.outlierThreshold, threads);
+            if (rows.isEmpty()) continue;
+
+            CleaningCellChange change;
+            change.column = col;
+            change.rows = rows;
+            change.values = emptyValues(rows.size());
+            work.setCellSlice(col, rows, change.values);
+
+            for (int row : rows) touched[row] = 1;
+            step.affectedCells += rows.size();
+            step.cellChanges.append(change);
+        }
+        step.affectedRows = int(std::count(touched.cbegin(), touched.cend(), char(1)));
+        step.detail = QString("%1 个单元格（%2 行）").arg(step.affectedCells).arg(step.affectedRows);
+        result.steps.append(step);
+    }
+
+    // 填充缺失值（各列独立，按列并行）
+    if (config.fillMissingValues) {
+        emit progressUpdated(65, "正在填充缺失值...");
+        CleaningStepResult step;
+        step.name = "填充缺失值";
+
+        QVector<double> time;
+        if (config.fillMethod == FillMethod::TimeWeighted && timeColumn >= 0) {
+            time = timeValues(work.column(timeColumn));
+        }
+
+        QVector<int> targets;
+        for (int col = 0; col < work.columnCount(); ++col) {
+            if (col != timeColumn && work.columnStorage(col) == ColumnStorage::Numeric
+                && !work.isComputed(col)) {
+                targets.append(col);
+            }
+        }
+
+        QVector<CleaningCellChange> changes(targets.size());
+        CleaningCellChange* output = changes.data();
+        const QVector<DataColumn> columns = work.tableColumns();
+        parallelColumns(targets.size(), threads, [&](int index) {
+            CleaningCellChange& change = output[index];
+            QVector<double> filled;
+            change.column = targets[index];
+            change.rows = fillGaps(columns[change.column].numbers, time, config.fillMethod,
+                                   config.maxGap, filled);
+            change.values.numbers = filled;
+        });
+
+        for (const CleaningCellChange& change : changes) {
+            if (change.rows.isEmpty()) continue;
+            work.setCellSlice(change.column, change.rows, change.values);
+            step.affectedCells += change.rows.size();
+            step.cellChanges.append(change);
+        }
+        step.detail = QString("%1 个单元格").arg(step.affectedCells);
+        result.steps.append(step);
+    }
+
+    // 按时间列重采样（整表替换）
+    if (config.resample) {
+        emit progressUpdated(80, "正在重采样...");
+        CleaningStepResult step;
+        step.name = "重采样";
+
+        QString error;
+        int rows = 0;
+        QVector<DataColumn> table = resample(work.tableColumns(), work.rowCount(), timeColumn,
+                                             config.resampleInterval, rows, error);
+        if (!error.isEmpty()) {
+            result.errorMessage = error;
+            return result;
+        }
+
+        step.replacesTable = true;
+        step.affectedRows = work.rowCount();
+        step.table = table;
+        step.tableRowCount = rows;
+        step.detail = QString("%1 行 → %2 行").arg(step.affectedRows).arg(rows);
+        work.setTableData(table, rows);
+        result.steps.append(step);
+    }
+
+    result.rowsAfter = work.rowCount();
+    result.columnsAfter = work.columnCount();
+    result.success = true;
+    emit progressUpdated(100, "清理计算完成");
+    return result;
+}
+
+// ============================================================================
+// 静态核心算子
+// ============================================================================
+
+RowRanges DataCleaner::findEmptyRows(const QVector<DataColumn>& columns, int rowCount, int threads)
+{
+    QVector<char> empty(rowCount, 1);
+    char* flags = empty.data();
+
+    // 按行块并行，块内逐列扫描有效位（列内连续访问）
+    parallelChunks(rowCount, threads, [&](int begin, int end) {
+        for (const DataColumn& column : columns) {
+            for (int row = begin; row < end; ++row) {
+                if (flags[row] && column.isValid(row)) flags[row] = 0;
+            }
+        }
+    });
+
+    QList<int> rows;
+    for (int row = 0; row < rowCount; ++row) {
+        if (flags[row]) rows.append(row);
+    }
+    return DataTableModel::toRowRanges(rows);
+}
+
+QVector<int> DataCleaner::findEmptyColumns(const QVector<DataColumn>& columns, int rowCount)
+{
+    QVector<int> result;
+    for (int col = 0; col < columns.size(); ++col) {
+        const DataColumn& column = columns[col];
+        bool empty = true;
+        for (int row = 0; row < rowCount && empty; ++row) {
+            if (column.isValid(row)) empty = false;
+        }
+        if (empty) result.append(col);
+    }
+    return result;
+}
+
+RowRanges DataCleaner::findDuplicateRows(const QVector<DataColumn>& columns, int rowCount, int threads)
+{
+    // 第一遍：并行计算每行的 64 位键（按列顺序混合，列顺序不同的行键不同）
+    QVector<quint64> keys(rowCount);
+    quint64* key = keys.data();
+    parallelChunks(rowCount, threads, [&](int begin, int end) {
+        for (int row = begin; row < end; ++row) {
+            key[row] = 0xcbf29ce484222325ULL;
+        }
+        for (const DataColumn& column : columns) {
+            for (int row = begin; row < end; ++row) {
+                key[row] = mix64(key[row] + cellKey(column, row));
+            }
+        }
+    });
+
+    // 第二遍：哈希表去重，键相同时逐列比较原值
+    QMultiHash<quint64, int> seen;
+    seen.reserve(rowCount);
+    QList<int> duplicates;
+    for (int row = 0; row < rowCount; ++row) {
+        bool duplicate = false;
+        auto range = seen.equal_range(key[row]);
+        for (auto it = range.first; it != range.second && !duplicate; ++it) {
+            int other = it.value();
+            bool same = true;
+            for (const DataColumn& column : columns) {
+                if (!sameCell(column, other, row)) {
+                    same = false;
+                    break;
+                }
+            }
+            duplicate = same;
+        }
+
+        if (duplicate) {
+            duplicates.append(row);
+        } else {
+            seen.insert(key[row], row);
+        }
+    }
+    return DataTableModel::toRowRanges(duplicates);
+}
+
+QVector<int> DataCleaner::findOutliers(const QVector<double>& values, int window, double threshold,
+                                       int threads)
+{
+    const int n = values.size();
+    const int half = qMax(1, window / 2);
+    const double* v = values.constData();
+
+    // 噪声下限：相邻差分绝对值中位数对应的稳健标准差，
+    // 避免平台段（窗口内 MAD 为 0）上的微小波动被判为异常
+    std::vector<double> diffs;
+    diffs.reserve(n);
+    for (int i = 1; i < n; ++i) {
+        if (!std::isnan(v[i]) && !std::isnan(v[i - 1])) {
+            diffs.push_back(std::fabs(v[i] - v[i - 1]));
+        }
+    }
+    const double noiseFloor = diffs.empty() ? 0.0 : 1.4826 * medianOf(diffs);
+
+    QVector<char> outlier(n, 0);
+    char* flags = outlier.data();
+    parallelChunks(n, threads, [&](int begin, int end) {
+        std::vector<double> windowValues;
+        std::vector<double> deviations;
+        windowValues.reserve(2 * half + 1);
+        deviations.reserve(2 * half + 1);
+
+        for (int i = begin; i < end; ++i) {
+            if (std::isnan(v[i])) continue;
+
+            windowValues.clear();
+            int from = qMax(0, i - half);
+            int to = qMin(n - 1, i + half);
+            for (int j = from; j <= to; ++j) {
+                if (!std::isnan(v[j])) windowValues.push_back(v[j]);
+            }
+            if (windowValues.size() < 3) continue;
+
+            double median = medianOf(windowValues);
+            deviations.clear();
+            for (double value : windowValues) {
+                deviations.push_back(std::fabs(value - median));
+            }
+            double scale = qMax(1.4826 * medianOf(deviations), noiseFloor);
+
+            if (scale > 0.0 && std::fabs(v[i] - median) > threshold * scale) {
+                flags[i] = 1;
+            }
+        }
+    });
+
+    QVector<int> rows;
+    for (int i = 0; i < n; ++i) {
+        if (flags[i]) rows.append(i);
+    }
+    return rows;
+}
+
+QVector<int> DataCleaner::fillGaps(const QVector<double>& values, const QVector<double>& time,
+                                   FillMethod method, int maxGap, QVector<double>& filled)
+{
+    QVector<int> rows;
+    filled.clear();
+
+    const int n = values.size();
+    double sum = 0.0;
+    int validCount = 0;
+    for (double value : values) {
+        if (!std::isnan(value)) {
+            sum += value;
+            ++validCount;
+        }
+    }
+    if (validCount == 0 || validCount == n) return rows;
+
+    const double mean = sum / validCount;
+    const bool useTime = method == FillMethod::TimeWeighted && time.size() == n;
+
+    int i = 0;
+    while (i < n) {
+        if (!std::isnan(values[i])) {
+            ++i;
+            continue;
+        }
+
+        // 连续空缺 [start, end)
+        int start = i;
+        while (i < n && std::isnan(values[i])) ++i;
+        int end = i;
+        int length = end - start;
+        if (maxGap > 0 && length > maxGap) continue;
+
+        bool hasPrev = start > 0;
+        bool hasNext = end < n;
+
+        for (int row = start; row < end; ++row) {
+            double value = kNaN;
+            switch (method) {
+            case FillMethod::Zero:
+                value = 0.0;
+                break;
+            case FillMethod::Average:
+                value = mean;
+                break;
+            case FillMethod::Forward:
+                if (hasPrev) value = values[start - 1];
+                break;
+            case FillMethod::Linear:
+            case FillMethod::TimeWeighted:
+                if (hasPrev && hasNext) {
+                    double v0 = values[start - 1];
+                    double v1 = values[end];
+                    double weight = double(row - start + 1) / (length + 1);
+                    if (useTime) {
+                        double t0 = time[start - 1];
+                        double t1 = time[end];
+                        double t = time[row];
+                        if (std::isfinite(t0) && std::isfinite(t1) && std::isfinite(t) && t1 != t0) {
+                            weight = (t - t0) / (t1 - t0);
+                        }
+                    }
+                    value = v0 + (v1 - v0) * weight;
+                } else {
+                    // 首尾空缺取最近的有效值
+                    value = hasPrev ? values[start - 1] : values[end];
+                }
+                break;
+            }
+
+            if (!std::isnan(value)) {
+                rows.append(row);
+                filled.append(value);
+            }
+        }
+    }
+    return rows;
+}
+
+QVector<DataColumn> DataCleaner::resample(const QVector<DataColumn>& columns, int rowCount,
+                                          int timeColumn, double interval, int& resultRows,
+                                          QString& errorMessage)
+{
+    resultRows = 0;
+    if (timeColumn < 0 || timeColumn >= columns.size()) {
+        errorMessage = "重采样需要时间列";
+        return QVector<DataColumn>();
+    }
+    if (!(interval > 0.0)) {
+        errorMessage = "重采样间隔必须大于 0";
+        return QVector<DataColumn>();
+    }
+
+    const DataColumn& timeSource = columns[timeColumn];
+    QVector<double> time = timeValues(timeSource);
+    if (time.isEmpty()) {
+        errorMessage = QString("时间列 \"%1\" 不是数值或时间类型").arg(timeSource.header);
+        return QVector<DataColumn>();
+    }
+
+    double tmin = std::numeric_limits<double>::infinity();
+    for (int row = 0; row < rowCount; ++row) {
+        if (std::isfinite(time[row])) tmin = qMin(tmin, time[row]);
+    }
+    if (!std::isfinite(tmin)) {
+        errorMessage = "时间列没有有效值";
+        return QVector<DataColumn>();
+    }
+
+    // 分箱：时间无效的行丢弃；时间不单调时按箱号稳定排序
+    QVector<qint64> bins(rowCount, -1);
+    QVector<int> order;
+    order.reserve(rowCount);
+    bool sorted = true;
+    qint64 lastBin = -1;
+    for (int row = 0; row < rowCount; ++row) {
+        if (!std::isfinite(time[row])) continue;
+        qint64 bin = qint64(std::floor((time[row] - tmin) / interval));
+        bins[row] = bin;
+        if (bin < lastBin) sorted = false;
+        lastBin = bin;
+        order.append(row);
+    }
+    if (!sorted) {
+        std::stable_sort(order.begin(), order.end(),
+                         [&bins](int a, int b) { return bins[a] < bins[b]; });
+    }
+
+    QVector<int> groupStart;
+    QVector<qint64> groupBin;
+    for (int i = 0; i < order.size(); ++i) {
+        qint64 bin = bins[order[i]];
+        if (groupBin.isEmpty() || groupBin.last() != bin) {
+            groupStart.append(i);
+            groupBin.append(bin);
+        }
+    }
+    const int groups = groupStart.size();
+    groupStart.append(order.size());
+
+    QVector<DataColumn> result(columns.size());
+    DataColumn* output = result.data();
+    parallelColumns(columns.size(), QThread::idealThreadCount(), [&](int col) {
+        const DataColumn& source = columns[col];
+        DataColumn target = source;
+        target.numbers.clear();
+        target.timestamps.clear();
+        target.texts.clear();
+        target.validity.clear();
+
+        switch (source.storage) {
+        case ColumnStorage::Numeric:
+            target.numbers.resize(groups);
+            break;
+        case ColumnStorage::Timestamp:
+            target.timestamps.resize(groups);
+            break;
+        case ColumnStorage::Text:
+            target.texts.resize(groups);
+            break;
+        }
+
+        for (int g = 0; g < groups; ++g) {
+            int from = groupStart[g];
+            int to = groupStart[g + 1];
+
+            if (col == timeColumn) {
+                // 时间列取箱起点
+                double start = tmin + groupBin[g] * interval;
+                if (source.storage == ColumnStorage::Timestamp) {
+                    target.timestamps[g] = qint64(std::llround(start * 1000.0));
+                } else {
+                    target.numbers[g] = start;
+                }
+                continue;
+            }
+
+            switch (source.storage) {
+            case ColumnStorage::Numeric: {
+                // 数值列取箱内均值
+                double sum = 0.0;
+                int count = 0;
+                for (int i = from; i < to; ++i) {
+                    int row = order[i];
+                    if (source.isValid(row) && !std::isnan(source.numbers[row])) {
+                        sum += source.numbers[row];
+                        ++count;
+                    }
+                }
+                if (count > 0) {
+                    target.numbers[g] = sum / count;
+                } else {
+                    target.numbers[g] = kNaN;
+                    target.setValid(g, false);
+                }
+                break;
+            }
+            case ColumnStorage::Timestamp: {
+                // 其余列取箱内首个有效值
+                int found = -1;
+                for (int i = from; i < to && found < 0; ++i) {
+                    if (source.isValid(order[i])) found = order[i];
+                }
+                if (found >= 0) {
+                    target.timestamps[g] = source.timestamps[found];
+                } else {
+                    target.setValid(g, false);
+                }
+                break;
+            }
+            case ColumnStorage::Text:
+                for (int i = from; i < to; ++i) {
+                    if (source.isValid(order[i])) {
+                        target.texts[g] = source.texts[order[i]];
+                        break;
+                    }
+                }
+                break;
+            }
+        }
+        output[col] = target;
+    });
+
+    resultRows = groups;
+    return result;
+}
+
+QVector<double> DataCleaner::timeValues(const DataColumn& column)
+{
+    switch (column.storage) {
+    case ColumnStorage::Numeric: {
+        QVector<double> values = column.numbers;
+        if (!column.validity.isEmpty()) {
+            for (int row = 0; row < values.size(); ++row) {
+                if (!column.isValid(row)) values[row] = kNaN;
+            }
+        }
+        return values;
+    }
+    case ColumnStorage::Timestamp: {
+        QVector<double> values(column.timestamps.size());
+        for (int row = 0; row < values.size(); ++row) {
+            values[row] = column.isValid(row) ? column.timestamps[row] / 1000.0 : kNaN;
+        }
+        return values;
+    }
+    case ColumnStorage::Text:
+        break;
+    }
+    return QVector<double>();
+}
@@ -0,0 +1,185 @@
+#ifndef DATACLEANER_H
+#define DATACLEANER_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include "datatablemodel.h"
+
+// 缺失值填充方法
+enum class FillMethod {
+    Zero,           // 零值
+    Linear,         // 按行号线性插值（首尾空缺取最近值）
+    TimeWeighted,   // 按时间列加权线性插值（时间列不可用时退化为按行号）
+    Average,        // 列平均值
+    Forward         // 前值填充
+};
+
+// 数据清理配置（各步骤按 删除空行 → 删除空列 → 删除重复行 → 异常值 → 填充 → 重采样 的顺序执行）
+struct DataCleaningConfig {
+    bool removeEmptyRows;
+    bool removeEmptyColumns;
+    bool removeDuplicates;
+    bool removeOutliers;
+    int outlierWindow;          // 滚动中位数窗口（点数）
+    double outlierThreshold;    // 偏离滚动中位数超过该倍数的稳健标准差（1.4826×MAD）视为异常
+    bool fillMissingValues;
+    FillMethod fillMethod;
+    int maxGap;                 // 只填充不超过该长度的连续空缺（0 表示不限）
+    bool resample;
+    double resampleInterval;    // 重采样间隔（时间列单位；时间戳列为秒）
+    int timeColumnIndex;        // 时间列（加权插值与重采样使用，-1 表示无）
+    int threadCount;            // 并行线程数（0 表示按 CPU 核数）
+
+    DataCleaningConfig() :
+        removeEmptyRows(true),
+        removeEmptyColumns(false),
+        removeDuplicates(true),
+        removeOutliers(false),
+        outlierWindow(11),
+        outlierThreshold(3.0),
+        fillMissingValues(false),
+        fillMethod(FillMethod::Linear),
+        maxGap(0),
+        resample(false),
+        resampleInterval(60.0),
+        timeColumnIndex(-1),
+        threadCount(0) {}
+};
+
+// 列内单元格改写（行号相对该步骤开始时的表）
+struct CleaningCellChange {
+    int column;
+    QVector<int> rows;          // 升序
+    DataColumn values;          // 与 rows 等长的数值列
+
+    CleaningCellChange() : column(-1) {}
+};
+
+// 单个清理步骤的结果（预览只看统计，执行时按记录的增量写入模型）
+struct CleaningStepResult {
+    QString name;
+    QString detail;             // 影响范围说明（如"删除 12 行"）
+    int affectedRows;
+    int affectedCells;
+
+    QVector<int> removedColumns;            // 升序
+    RowRanges removedRows;
+    QVector<CleaningCellChange> cellChanges;
+    bool replacesTable;                     // 重采样：整表替换
+    QVector<DataColumn> table;
+    int tableRowCount;
+
+    CleaningStepResult() :
+        affectedRows(0),
+        affectedCells(0),
+        replacesTable(false),
+        tableRowCount(0) {}
+
+    bool isEmpty() const
+    {
+        return removedColumns.isEmpty() && removedRows.isEmpty() && cellChanges.isEmpty() && !replacesTable;
+    }
+};
+
+// 数据清理结果
+struct DataCleaningResult {
+    bool success;
+    QString errorMessage;
+    QVector<CleaningStepResult> steps;
+    int rowsBefore;
+    int rowsAfter;
+    int columnsBefore;
+    int columnsAfter;
+
+    DataCleaningResult() :
+        success(false),
+        rowsBefore(0),
+        rowsAfter(0),
+        columnsBefore(0),
+        columnsAfter(0) {}
+
+    // 各步骤影响范围的文字摘要（用于预览）
+    QString summary() const;
+};
+
+/**
+ * @brief 基于类型化列的数据清理流水线
+ *
+ * 每个步骤是一个列算子，直接在 DataColumn 的连续数组上运行，按列、按行块并行：
+ * - 空行/空列：按有效位判断，不格式化文本；
+ * - 重复行：逐行把类型化值（double 位模式、时间戳、文本哈希）合成为 64 位键，
+ *   哈希表去重，键相同时再逐列比较原值，避免误删；
+ * - 异常值：滚动中位数 + MAD（窗口内稳健标准差，以全列相邻差分的中位数为下限）；
+ * - 填充：按行号或时间列加权的线性插值、零值、平均值、前值，可限制最大空缺长度；
+ * - 重采样：按时间列等间隔分箱，数值列取箱内均值，其余列取箱内首个值。
+ *
+ * plan() 只在内部副本上模拟各步骤并记录增量（删除的行区间、改写的单元格、
+ * 删除的列或整表替换），不修改传入的模型；预览与执行共用同一结果。
+ */
+class DataCleaner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DataCleaner(QObject *parent = nullptr);
+    ~DataCleaner();
+
+    /**
+     * @brief 计算清理流水线各步骤的增量
+     */
+    DataCleaningResult plan(const DataTableModel* model, const DataCleaningConfig& config);
+
+    // =========================================================================
+    // 静态核心算子
+    // =========================================================================
+
+    /**
+     * @brief 全部单元格为空的行
+     */
+    static RowRanges findEmptyRows(const QVector<DataColumn>& columns, int rowCount, int threads);
+
+    /**
+     * @brief 全部单元格为空的列（升序）
+     */
+    static QVector<int> findEmptyColumns(const QVector<DataColumn>& columns, int rowCount);
+
+    /**
+     * @brief 与之前某行完全相同的行（保留首次出现）
+     */
+    static RowRanges findDuplicateRows(const QVector<DataColumn>& columns, int rowCount, int threads);
+
+    /**
+     * @brief 滚动中位数/MAD 异常值检测
+     * @param values 数值序列（NaN 表示空）
+     * @return 异常点行号（升序）
+     */
+    static QVector<int> findOutliers(const QVector<double>& values, int window, double threshold, int threads);
+
+    /**
+     * @brief 计算空缺填充值
+     * @param values 数值序列（NaN 表示空）
+     * @param time 时间序列（仅 TimeWeighted 使用，可为空）
+     * @param filled 输出：与返回行号等长的填充值
+     * @return 被填充的行号（升序）
+     */
+    static QVector<int> fillGaps(const QVector<double>& values, const QVector<double>& time,
+                                 FillMethod method, int maxGap, QVector<double>& filled);
+
+    /**
+     * @brief 按时间列等间隔重采样
+     */
+    static QVector<DataColumn> resample(const QVector<DataColumn>& columns, int rowCount,
+                                        int timeColumn, double interval, int& resultRows,
+                                        QString& errorMessage);
+
+    /**
+     * @brief 取时间列为 double 序列（数值列原值，时间戳列换算为秒；其余类型返回空）
+     */
+    static QVector<double> timeValues(const DataColumn& column);
+
+signals:
+    void progressUpdated(int progress, const QString& message);
+};
+
+#endif // DATACLEANER_H
@@ -4,7 +4,6 @@
 #include <QWidget>
 #include <QString>
 #include <QTableView>
-#include <QStandardItemModel>
 #include <QFile>
 #include <QInputDialog>
 #include <QMessageBox>
@@ -53,6 +52,8 @@
 #include <QTime>
 #include <QDate>
 #include <QDateTime>
+#include <QFutureWatcher>
+#include <atomic>
 
 // Qt6兼容性处理
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
@@ -62,7 +63,14 @@
 #endif
 
 // 新增：压力导数计算器头文件
+#include "datatablemodel.h"
+#include "columnstatistics.h"
 #include "pressurederivativecalculator.h"
+#include "deconvolutioncalculator.h"
+#include "flowperioddetector.h"
+#include "csvfastloader.h"
+#include "datacleaner.h"
+#include "xlsxfile.h"
 
 namespace Ui {
 class DataEditorWidget;
@@ -176,18 +184,18 @@ struct PressureDropResult {
 class DataEditCommand : public QUndoCommand
 {
 public:
-    DataEditCommand(QStandardItemModel* model, QUndoCommand* parent = nullptr);
+    DataEditCommand(DataTableModel* model, QUndoCommand* parent = nullptr);
     virtual ~DataEditCommand() = default;
 
 protected:
-    QStandardItemModel* m_model;
+    DataTableModel* m_model;
 };
 
 // 单元格编辑命令
 class CellEditCommand : public DataEditCommand
 {
 public:
-    CellEditCommand(QStandardItemModel* model, int row, int column,
+    CellEditCommand(DataTableModel* model, int row, int column,
                     const QString& oldValue, const QString& newValue,
                     QUndoCommand* parent = nullptr);
     void undo() override;
@@ -206,7 +214,7 @@ class RowEditCommand : public DataEditCommand
 public:
     enum Operation { Insert, Delete };
 
-    RowEditCommand(QStandardItemModel* model, Operation op, int row,
+    RowEditCommand(DataTableModel* model, Operation op, int row,
                    const QStringList& rowData = QStringList(),
                    QUndoCommand* parent = nullptr);
     void undo() override;
@@ -216,6 +224,7 @@ private:
     Operation m_operation;
     int m_row;
     QStringList m_rowData;
+    QVector<DataColumn> m_rowSlice;
 };
 
 // 列操作命令
@@ -224,7 +233,7 @@ class ColumnEditCommand : public DataEditCommand
 public:
     enum Operation { Insert, Delete };
 
-    ColumnEditCommand(QStandardItemModel* model, Operation op, int column,
+    ColumnEditCommand(DataTableModel* model, Operation op, int column,
                       const QString& headerName = QString(),
                       const QStringList& columnData = QStringList(),
                       QUndoCommand* parent = nullptr);
@@ -236,6 +245,71 @@ private:
     int m_column;
     QString m_headerName;
     QStringList m_columnData;
+    DataColumn m_columnSnapshot;
+};
+
+// 批量删除行命令：按行区间记录，删除的行以类型化列片段保存
+class RowRangeDeleteCommand : public DataEditCommand
+{
+public:
+    RowRangeDeleteCommand(DataTableModel* model, const RowRanges& ranges,
+                          const QString& text, QUndoCommand* parent = nullptr);
+    void undo() override;
+    void redo() override;
+
+private:
+    RowRanges m_ranges;
+    QVector<DataColumn> m_removed;
+};
+
+// 列内批量修改单元格命令：记录行号与修改前后的类型化值
+class ColumnCellsCommand : public DataEditCommand
+{
+public:
+    ColumnCellsCommand(DataTableModel* model, int column, const QVector<int>& rows,
+                       const DataColumn& newValues, const QString& text,
+                       QUndoCommand* parent = nullptr);
+    void undo() override;
+    void redo() override;
+
+private:
+    int m_column;
+    QVector<int> m_rows;
+    DataColumn m_oldValues;
+    DataColumn m_newValues;
+    DataColumn m_columnBefore;  // 写入导致列类型变化时保存的整列快照
+    bool m_typeChanged;
+};
+
+// 整列变换命令：保存变换前后的整列（数组隐式共享，未改动的部分不复制）
+class ColumnSnapshotCommand : public DataEditCommand
+{
+public:
+    ColumnSnapshotCommand(DataTableModel* model, int column, const DataColumn& after,
+                          const QString& text, QUndoCommand* parent = nullptr);
+    void undo() override;
+    void redo() override;
+
+private:
+    int m_column;
+    DataColumn m_before;
+    DataColumn m_after;
+};
+
+// 整表替换命令：保存替换前后的全部列（用于重采样等改变行结构的变换）
+class TableSnapshotCommand : public DataEditCommand
+{
+public:
+    TableSnapshotCommand(DataTableModel* model, const QVector<DataColumn>& after, int afterRows,
+                         const QString& text, QUndoCommand* parent = nullptr);
+    void undo() override;
+    void redo() override;
+
+private:
+    QVector<DataColumn> m_before;
+    int m_beforeRows;
+    QVector<DataColumn> m_after;
+    int m_afterRows;
 };
 
 // 数据读取配置对话框
@@ -362,12 +436,23 @@ public:
         bool fillMissingValues;
         bool removeOutliers;
         bool standardizeFormat;
-        QString fillMethod;  // "zero", "interpolation", "average"
-        double outlierThreshold;
+        bool resample;
+        QString fillMethod;  // "zero", "interpolation", "time", "average", "forward"
+        int maxGap;                 // 最大填充空缺长度（0 表示不限）
+        double outlierThreshold;    // 稳健标准差倍数
+        int outlierWindow;          // 滚动中位数窗口
+        double resampleInterval;    // 重采样间隔（秒或时间列单位）
     };
 
     CleaningOptions getCleaningOptions() const;
 
+public slots:
+    // 显示预览结果（由数据编辑器计算后回填）
+    void setPreviewText(const QString& text);
+
+signals:
+    void previewRequested();
+
 private:
     void setupUI();
 
@@ -377,8 +462,13 @@ private:
     QCheckBox* m_fillMissingValuesCheck;
     QCheckBox* m_removeOutliersCheck;
     QCheckBox* m_standardizeFormatCheck;
+    QCheckBox* m_resampleCheck;
     QComboBox* m_fillMethodCombo;
+    QSpinBox* m_maxGapSpin;
     QSpinBox* m_outlierThresholdSpin;
+    QSpinBox* m_outlierWindowSpin;
+    QDoubleSpinBox* m_resampleIntervalSpin;
+    QLabel* m_previewLabel;
 };
 
 // 动画进度对话框
@@ -392,6 +482,11 @@ public:
     void setProgress(int value);
     void setMessage(const QString& message);
     void setMaximum(int maximum);
+    void setCancelable(bool cancelable);
+
+signals:
+    // 用户点击取消按钮
+    void cancelRequested();
 
 protected:
     void closeEvent(QCloseEvent* event) override;
@@ -403,6 +498,7 @@ private:
     QLabel* m_iconLabel;
     QLabel* m_messageLabel;
     QProgressBar* m_progressBar;
+    QPushButton* m_cancelButton;
     QMovie* m_loadingMovie;
     QPropertyAnimation* m_fadeAnimation;
     QGraphicsOpacityEffect* m_opacityEffect;
@@ -424,14 +520,16 @@ public:
     void loadDataWithConfig(const QString& filePath, const QString& fileType, const DataLoadConfigDialog::LoadConfig& config);
 
     // 获取数据模型和文件信息的方法
-    QStandardItemModel* getDataModel() const { return m_dataModel; }
+    DataTableModel* getDataModel() const { return m_dataModel; }
     QString getCurrentFileName() const { return m_currentFilePath; }
     QString getCurrentFileType() const { return m_currentFileType; }
     bool hasData() const { return m_dataModel && m_dataModel->rowCount() > 0 && m_dataModel->columnCount() > 0; }
+    bool isLoading() const { return m_loading; }
 
     // 数据处理功能
-    DataStatistics calculateColumnStatistics(int column) const;
-    QList<DataStatistics> calculateAllStatistics() const;
+    // exact 为 true 时中位数按 nth_element 精确计算（结果缓存到数据改动），否则取自分位数草图
+    DataStatistics calculateColumnStatistics(int column, bool exact = false) const;
+    QList<DataStatistics> calculateAllStatistics(bool exact = false) const;
     ValidationResult validateData() const;
     void applyDataFilter(const QString& filterText);
     void clearDataFilter();
@@ -456,6 +554,9 @@ public:
     PressureDerivativeResult calculatePressureDerivativeWithConfig(const PressureDerivativeConfig& config);
     PressureDerivativeConfig getDefaultPressureDerivativeConfig();
 
+    // 反褶积计算功能
+    DeconvolutionResult calculateDeconvolutionWithConfig(const DeconvolutionConfig& config);
+
     // 列标题更新功能
     void updateColumnHeaders();
 
@@ -477,6 +578,13 @@ signals:
     // 新增：压力导数计算完成信号
     void pressureDerivativeCalculated(const PressureDerivativeResult& result);
 
+    // 反褶积计算完成信号
+    void deconvolutionCalculated(const DeconvolutionResult& result);
+
+    // 流动段或反褶积响应提取信号（Δt、Δp、导数，用于新建拟合分析）
+    void analysisDataExtracted(const QString& name, const QVector<double>& deltaTime,
+                               const QVector<double>& deltaPressure, const QVector<double>& derivative);
+
 private slots:
     // 文件操作槽函数
     void onOpenFile();
@@ -493,12 +601,17 @@ private slots:
     // 新增：压力导数计算槽函数
     void onPressureDerivativeCalc();
 
+    // 反褶积计算槽函数
+    void onDeconvolution();
+
+    // 流动段识别槽函数
+    void onFlowPeriodDetect();
+
     // 搜索槽函数
     void onSearchTextChanged();
     void onSearchData();
 
     // 模型数据变化槽函数
-    void onCellDataChanged(QStandardItem* item);
     void onModelDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight);
 
     // 右键菜单槽函数
@@ -514,8 +627,9 @@ private:
     Ui::DataEditorWidget *ui;
 
     // 数据模型和代理
-    QStandardItemModel* m_dataModel;
+    DataTableModel* m_dataModel;
     QSortFilterProxyModel* m_proxyModel;
+    ColumnStatisticsCache* m_statisticsCache;   // 各列统计摘要（随模型改动增量更新）
 
     // 撤销重做栈
     QUndoStack* m_undoStack;
@@ -552,6 +666,31 @@ private:
     // 新增：压力导数计算器
     PressureDerivativeCalculator* m_pressureDerivativeCalculator;
 
+    // 反褶积计算器
+    DeconvolutionCalculator* m_deconvolutionCalculator;
+
+    // 流动段识别器
+    FlowPeriodDetector* m_flowPeriodDetector;
+
+    // CSV/TXT 快速导入器
+    CsvFastLoader* m_csvLoader;
+
+    // 内置 XLSX 读写器
+    XlsxFile* m_xlsxFile;
+
+    // 数据清理流水线
+    DataCleaner* m_dataCleaner;
+
+    // 后台文件加载
+    QFutureWatcher<bool> m_loadWatcher;
+    bool m_loading;
+    std::atomic<bool> m_loadCancelled;
+    int m_loadPreviewRows;                  // 加载过程中先显示的行数
+    QVector<DataColumn> m_loadedColumns;    // 后台解析结果，完成后在主线程写入模型
+    int m_loadedRowCount;
+    QString m_loadError;
+    QAbstractItemView::EditTriggers m_savedEditTriggers;
+
     // 初始化方法
     void init();
     void setupModels();
@@ -561,6 +700,21 @@ private:
 
     // 新增：设置压力导数计算器
     void setupPressureDerivativeCalculator();
+    void setupDeconvolutionCalculator();
+    void setupFlowPeriodDetector();
+    void setupCsvLoader();
+    void setupXlsxFile();
+    void setupBackgroundLoading();
+    void setupDataCleaner();
+
+    // 后台文件加载：解析在工作线程进行，预览与最终结果回到主线程写入模型
+    void startFileLoad(const QString& filePath, const QString& fileType,
+                       const DataLoadConfigDialog::LoadConfig* config);
+    void onFileLoadFinished();
+    void cancelFileLoad();
+    void showLoadPreview(const QVector<DataColumn>& columns, int rowCount);
+    void setLoadedTable(const QVector<DataColumn>& columns, int rowCount);
+    bool isLoadThread() const;
 
     // 文件读取方法 - 优化后的方法
     bool loadExcelFile(const QString& filePath, QString& errorMessage);
@@ -569,6 +723,7 @@ private:
 
     // 优化的Excel读取方法
     bool loadExcelFileOptimized(const QString& filePath, QString& errorMessage);
+    bool loadXlsxFile(const QString& filePath, QString& errorMessage);
     bool quickDetectFileFormat(const QString& filePath);
     QString detectOptimalSeparator(const QString& filePath);
 
@@ -583,6 +738,7 @@ private:
     bool loadExcelAsCSV(const QString& filePath, QString& errorMessage);
     bool loadCSVFile(const QString& filePath, const QString& separator, QString& errorMessage);
     QStringList splitCSVLine(const QString& line, const QString& separator);
+    void setModelFromTextColumns(const QStringList& headers, QVector<QVector<QString>>& cells, int rowCount);
 
     // 文件保存方法
     bool saveExcelFile(const QString& filePath);
@@ -592,16 +748,14 @@ private:
     bool exportToHtml(const QString& filePath);
 
     // 数据处理方法
-    void removeEmptyRows();
-    void removeEmptyColumns();
-    void removeDuplicates();
-    void fillMissingValues(const QString& method = "interpolation");
-    void removeOutliers(double threshold = 2.0);
+    DataCleaningConfig cleaningConfig(const DataCleaningDialog::CleaningOptions& options) const;
+    void applyCleaningResult(const DataCleaningResult& result);
     void standardizeDataFormat();
 
     // 压降计算相关方法 - 优化的压降计算
     int findPressureColumn() const;
     int findTimeColumn() const;
+    int findRateColumn() const;
     QString getPressureUnit() const;
     bool isValidPressureData(const QString& data) const;
 
@@ -628,7 +782,7 @@ private:
     void updateStatus(const QString& message, const QString& type = "info");
     void updateDataInfo();
     void setButtonsEnabled(bool enabled);
-    void showAnimatedProgress(const QString& title, const QString& message);
+    void showAnimatedProgress(const QString& title, const QString& message, bool cancelable = false);
     void hideAnimatedProgress();
     void updateProgress(int value, const QString& message = QString());
 
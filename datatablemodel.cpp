@@ -0,0 +1,1212 @@
+#include "datatablemodel.h"
+#include <QBrush>
+#include <QDate>
+#include <QTime>
+#include <QDateTime>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// ============================================================================
+// 内部辅助函数
+// ============================================================================
+
+namespace {
+
+const double kNaN = std::numeric_limits<double>::quiet_NaN();
+const qint64 kMsecsPerDay = 86400000LL;
+
+// 自动识别的时间戳格式（解析后必须能原样格式化回去才采用）
+const char* const kTimestampFormats[] = {
+    "yyyy-MM-dd hh:mm:ss",
+    "yyyy/MM/dd hh:mm:ss",
+    "yyyy-MM-dd hh:mm:ss.zzz",
+    "yyyy/MM/dd hh:mm:ss.zzz",
+    "yyyy-MM-ddThh:mm:ss",
+    "yyyy-MM-dd hh:mm",
+    "yyyy/MM/dd hh:mm",
+    "yyyy-M-d h:mm:ss",
+    "yyyy/M/d h:mm:ss",
+    "yyyy-MM-dd",
+    "yyyy/MM/dd",
+    "yyyy-M-d",
+    "yyyy/M/d",
+    "hh:mm:ss",
+    "h:mm:ss",
+    "hh:mm:ss.zzz",
+    "hh:mm"
+};
+
+// 位图拼接：删除 [pos, pos+removeCount)，并在 pos 处插入 insertCount 个无效位
+void spliceValidity(QVector<quint64>& bits, int oldSize, int pos, int removeCount, int insertCount)
+{
+    if (bits.isEmpty()) {
+        if (insertCount == 0) return;
+        bits = QVector<quint64>((oldSize + 63) / 64, ~0ULL);
+    }
+
+    int newSize = oldSize - removeCount + insertCount;
+    QVector<quint64> result((newSize + 63) / 64, 0ULL);
+    auto bitAt = [&bits](int i) { return (bits[i >> 6] >> (i & 63)) & 1ULL; };
+
+    for (int i = 0; i < pos; ++i) {
+        if (bitAt(i)) result[i >> 6] |= (1ULL << (i & 63));
+    }
+    for (int i = pos + removeCount; i < oldSize; ++i) {
+        int target = i - removeCount + insertCount;
+        if (bitAt(i)) result[target >> 6] |= (1ULL << (target & 63));
+    }
+    bits = result;
+}
+
+// 与 source 同类型、同格式的空列
+DataColumn emptyLike(const DataColumn& source)
+{
+    DataColumn column;
+    column.storage = source.storage;
+    column.header = source.header;
+    column.timestampFormat = source.timestampFormat;
+    column.numberFormat = source.numberFormat;
+    column.precision = source.precision;
+    column.foreground = source.foreground;
+    column.background = source.background;
+    column.formula = source.formula;
+    column.formulaVersion = source.formulaVersion;
+    return column;
+}
+
+// 把 source 的 [from, to) 行追加到 target 末尾（两者存储类型一致）
+void appendRange(DataColumn& target, const DataColumn& source, int from, int to)
+{
+    if (to <= from) return;
+
+    int offset = target.size();
+    switch (source.storage) {
+    case ColumnStorage::Numeric:
+        target.numbers += source.numbers.mid(from, to - from);
+        break;
+    case ColumnStorage::Timestamp:
+        target.timestamps += source.timestamps.mid(from, to - from);
+        break;
+    case ColumnStorage::Text:
+        target.texts += source.texts.mid(from, to - from);
+        return;
+    }
+
+    if (!source.validity.isEmpty() || !target.validity.isEmpty()) {
+        if (!target.validity.isEmpty()) {
+            target.validity.resize((target.size() + 63) / 64);
+        }
+        for (int i = from; i < to; ++i) {
+            bool valid = source.isValid(i);
+            if (!valid || !target.validity.isEmpty()) target.setValid(offset + i - from, valid);
+        }
+    }
+}
+
+// 数值文本的小数位数（科学计数法返回 -1）
+int fractionDigits(const QString& text)
+{
+    if (text.contains('e', Qt::CaseInsensitive)) return -1;
+    int dot = text.indexOf('.');
+    return (dot < 0) ? 0 : text.size() - dot - 1;
+}
+
+} // namespace
+
+// ============================================================================
+// ColumnFormula
+// ============================================================================
+
+QSharedPointer<const ColumnFormula> ColumnFormula::withSources(const QVector<int>& sources) const
+{
+    ColumnFormula* copy = clone();
+    copy->m_sources = sources;
+    return QSharedPointer<const ColumnFormula>(copy);
+}
+
+// ============================================================================
+// DataColumn
+// ============================================================================
+
+int DataColumn::size() const
+{
+    switch (storage) {
+    case ColumnStorage::Numeric:
+        return numbers.size();
+    case ColumnStorage::Timestamp:
+        return timestamps.size();
+    case ColumnStorage::Text:
+    default:
+        return texts.size();
+    }
+}
+
+bool DataColumn::isValid(int row) const
+{
+    if (storage == ColumnStorage::Text) {
+        return !texts[row].isEmpty();
+    }
+    return validity.isEmpty() || ((validity[row >> 6] >> (row & 63)) & 1ULL);
+}
+
+void DataColumn::setValid(int row, bool valid)
+{
+    if (storage == ColumnStorage::Text) return;
+
+    if (valid) {
+        if (validity.isEmpty()) return;
+        validity[row >> 6] |= (1ULL << (row & 63));
+    } else {
+        if (validity.isEmpty()) {
+            validity = QVector<quint64>((size() + 63) / 64, ~0ULL);
+        }
+        validity[row >> 6] &= ~(1ULL << (row & 63));
+    }
+}
+
+// ============================================================================
+// DataTableModel
+// ============================================================================
+
+DataTableModel::DataTableModel(QObject *parent)
+    : QAbstractTableModel(parent),
+      m_rowCount(0),
+      m_dataVersion(1)
+{
+    // 数据版本跟踪：先于视图等外部监听者连接，使其收到通知时派生列已失效
+    connect(this, &QAbstractItemModel::dataChanged, this, &DataTableModel::onCellsChanged);
+    connect(this, &QAbstractItemModel::rowsInserted, this, &DataTableModel::invalidateComputedColumns);
+    connect(this, &QAbstractItemModel::rowsRemoved, this, &DataTableModel::invalidateComputedColumns);
+    connect(this, &QAbstractItemModel::modelReset, this, &DataTableModel::invalidateComputedColumns);
+}
+
+int DataTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rowCount;
+}
+
+int DataTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_columns.size();
+}
+
+QVariant DataTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rowCount || index.column() >= m_columns.size()) {
+        return QVariant();
+    }
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+        return text(index.row(), index.column());
+    case Qt::ForegroundRole: {
+        const QColor& color = m_columns[index.column()].foreground;
+        return color.isValid() ? QVariant(QBrush(color)) : QVariant();
+    }
+    case Qt::BackgroundRole: {
+        const QColor& color = m_columns[index.column()].background;
+        return color.isValid() ? QVariant(QBrush(color)) : QVariant();
+    }
+    default:
+        return QVariant();
+    }
+}
+
+bool DataTableModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (!index.isValid() || role != Qt::EditRole) return false;
+
+    QString newText = value.toString();
+    if (text(index.row(), index.column()) == newText) return false;
+
+    setText(index.row(), index.column(), newText);
+    return true;
+}
+
+QVariant DataTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role == Qt::ToolTipRole && orientation == Qt::Horizontal
+        && section >= 0 && section < m_columns.size() && m_columns[section].formula) {
+        return m_columns[section].formula->description(this);
+    }
+    if (role != Qt::DisplayRole && role != Qt::EditRole) return QVariant();
+
+    if (orientation == Qt::Horizontal) {
+        if (section < 0 || section >= m_columns.size()) return QVariant();
+        return headerText(section);
+    }
+    return section + 1;
+}
+
+bool DataTableModel::setHeaderData(int section, Qt::Orientation orientation, const QVariant &value, int role)
+{
+    if (orientation != Qt::Horizontal || (role != Qt::EditRole && role != Qt::DisplayRole)) return false;
+    if (section < 0 || section >= m_columns.size()) return false;
+
+    setHeaderText(section, value.toString());
+    return true;
+}
+
+Qt::ItemFlags DataTableModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid()) return Qt::NoItemFlags;
+    if (index.column() < m_columns.size() && m_columns[index.column()].formula) {
+        return Qt::ItemIsSelectable | Qt::ItemIsEnabled;  // 派生列只读
+    }
+    return Qt::ItemIsSelectable | Qt::ItemIsEnabled | Qt::ItemIsEditable;
+}
+
+bool DataTableModel::insertRows(int row, int count, const QModelIndex &parent)
+{
+    if (parent.isValid() || row < 0 || row > m_rowCount || count <= 0) return false;
+
+    beginInsertRows(QModelIndex(), row, row + count - 1);
+    for (DataColumn& column : m_columns) {
+        switch (column.storage) {
+        case ColumnStorage::Numeric:
+            column.numbers.insert(row, count, kNaN);
+            break;
+        case ColumnStorage::Timestamp:
+            column.timestamps.insert(row, count, 0);
+            break;
+        case ColumnStorage::Text:
+            column.texts.insert(row, count, QString());
+            break;
+        }
+        if (column.storage != ColumnStorage::Text) {
+            spliceValidity(column.validity, m_rowCount, row, 0, count);
+        }
+    }
+    m_rowCount += count;
+    endInsertRows();
+    return true;
+}
+
+bool DataTableModel::removeRows(int row, int count, const QModelIndex &parent)
+{
+    if (parent.isValid() || row < 0 || count <= 0 || row + count > m_rowCount) return false;
+
+    beginRemoveRows(QModelIndex(), row, row + count - 1);
+    for (DataColumn& column : m_columns) {
+        switch (column.storage) {
+        case ColumnStorage::Numeric:
+            column.numbers.remove(row, count);
+            break;
+        case ColumnStorage::Timestamp:
+            column.timestamps.remove(row, count);
+            break;
+        case ColumnStorage::Text:
+            column.texts.remove(row, count);
+            break;
+        }
+        if (!column.validity.isEmpty()) {
+            spliceValidity(column.validity, m_rowCount, row, count, 0);
+        }
+    }
+    m_rowCount -= count;
+    endRemoveRows();
+    return true;
+}
+
+bool DataTableModel::insertColumns(int column, int count, const QModelIndex &parent)
+{
+    if (parent.isValid() || column < 0 || column > m_columns.size() || count <= 0) return false;
+
+    beginInsertColumns(QModelIndex(), column, column + count - 1);
+    shiftFormulaSources(column, count);
+    for (int i = 0; i < count; ++i) {
+        DataColumn empty;
+        resizeColumn(empty, m_rowCount);
+        m_columns.insert(column + i, empty);
+    }
+    endInsertColumns();
+    return true;
+}
+
+bool DataTableModel::removeColumns(int column, int count, const QModelIndex &parent)
+{
+    if (parent.isValid() || column < 0 || count <= 0 || column + count > m_columns.size()) return false;
+
+    // 依赖被删除列的派生列按当前值物化
+    for (int col = 0; col < m_columns.size(); ++col) {
+        if (!m_columns[col].formula || (col >= column && col < column + count)) continue;
+        for (int source : m_columns[col].formula->sources()) {
+            if (source >= column && source < column + count) {
+                detachFormula(col);
+                break;
+            }
+        }
+    }
+
+    beginRemoveColumns(QModelIndex(), column, column + count - 1);
+    m_columns.remove(column, count);
+    shiftFormulaSources(column + count, -count);
+    endRemoveColumns();
+    return true;
+}
+
+void DataTableModel::clear()
+{
+    beginResetModel();
+    m_columns.clear();
+    m_rowCount = 0;
+    endResetModel();
+}
+
+void DataTableModel::setRowCount(int rows)
+{
+    if (rows > m_rowCount) {
+        insertRows(m_rowCount, rows - m_rowCount);
+    } else if (rows < m_rowCount) {
+        removeRows(rows, m_rowCount - rows);
+    }
+}
+
+void DataTableModel::setColumnCount(int columns)
+{
+    if (columns > m_columns.size()) {
+        insertColumns(m_columns.size(), columns - m_columns.size());
+    } else if (columns < m_columns.size()) {
+        removeColumns(columns, m_columns.size() - columns);
+    }
+}
+
+void DataTableModel::setHorizontalHeaderLabels(const QStringList &labels)
+{
+    if (labels.size() > m_columns.size()) {
+        setColumnCount(labels.size());
+    }
+    for (int i = 0; i < labels.size(); ++i) {
+        m_columns[i].header = labels[i];
+    }
+    if (!labels.isEmpty()) {
+        emit headerDataChanged(Qt::Horizontal, 0, labels.size() - 1);
+    }
+}
+
+QString DataTableModel::headerText(int column) const
+{
+    if (column < 0 || column >= m_columns.size()) return QString();
+    const QString& header = m_columns[column].header;
+    return header.isEmpty() ? QString::number(column + 1) : header;
+}
+
+void DataTableModel::setHeaderText(int column, const QString &text)
+{
+    if (column < 0 || column >= m_columns.size()) return;
+    m_columns[column].header = text;
+    emit headerDataChanged(Qt::Horizontal, column, column);
+}
+
+QString DataTableModel::text(int row, int column) const
+{
+    if (row < 0 || row >= m_rowCount || column < 0 || column >= m_columns.size()) return QString();
+    ensureComputed(column);
+    return cellText(m_columns[column], row);
+}
+
+void DataTableModel::setText(int row, int column, const QString &text)
+{
+    if (row < 0 || row >= m_rowCount || column < 0 || column >= m_columns.size()) return;
+
+    detachFormula(column);
+    DataColumn& col = m_columns[column];
+    QString trimmed = text.trimmed();
+
+    if (col.storage == ColumnStorage::Numeric) {
+        bool ok = false;
+        double v = trimmed.toDouble(&ok);
+        if (trimmed.isEmpty()) {
+            col.numbers[row] = kNaN;
+            col.setValid(row, false);
+        } else if (ok && std::isfinite(v)) {
+            col.numbers[row] = v;
+            col.setValid(row, true);
+        } else {
+            convertToText(column);
+        }
+    } else if (col.storage == ColumnStorage::Timestamp) {
+        qint64 msecs = 0;
+        if (trimmed.isEmpty()) {
+            col.timestamps[row] = 0;
+            col.setValid(row, false);
+        } else if (parseTimestamp(trimmed, col.timestampFormat, msecs)) {
+            col.timestamps[row] = msecs;
+            col.setValid(row, true);
+        } else {
+            convertToText(column);
+        }
+    }
+
+    if (col.storage == ColumnStorage::Text) {
+        col.texts[row] = text;
+    }
+
+    QModelIndex idx = index(row, column);
+    emit dataChanged(idx, idx);
+}
+
+double DataTableModel::value(int row, int column, bool *ok) const
+{
+    if (ok) *ok = false;
+    if (row < 0 || row >= m_rowCount || column < 0 || column >= m_columns.size()) return 0.0;
+
+    ensureComputed(column);
+    const DataColumn& col = m_columns[column];
+    switch (col.storage) {
+    case ColumnStorage::Numeric:
+        if (!col.isValid(row)) return 0.0;
+        if (ok) *ok = true;
+        return col.numbers[row];
+    case ColumnStorage::Text:
+        return col.texts[row].trimmed().toDouble(ok);
+    case ColumnStorage::Timestamp:
+    default:
+        return 0.0;
+    }
+}
+
+void DataTableModel::setValue(int row, int column, double value)
+{
+    if (row < 0 || row >= m_rowCount || column < 0 || column >= m_columns.size()) return;
+
+    detachFormula(column);
+    DataColumn& col = m_columns[column];
+    if (col.storage != ColumnStorage::Numeric) {
+        setText(row, column, std::isfinite(value) ? formatNumber(value, col.numberFormat, col.precision) : QString());
+        return;
+    }
+
+    col.numbers[row] = std::isfinite(value) ? value : kNaN;
+    col.setValid(row, std::isfinite(value));
+
+    QModelIndex idx = index(row, column);
+    emit dataChanged(idx, idx);
+}
+
+bool DataTableModel::isEmpty(int row, int column) const
+{
+    if (row < 0 || row >= m_rowCount || column < 0 || column >= m_columns.size()) return true;
+    ensureComputed(column);
+    return !m_columns[column].isValid(row);
+}
+
+const DataColumn &DataTableModel::column(int column) const
+{
+    ensureComputed(column);
+    return m_columns[column];
+}
+
+QVector<DataColumn> DataTableModel::tableColumns() const
+{
+    ensureAllComputed();
+    return m_columns;
+}
+
+ColumnStorage DataTableModel::columnStorage(int column) const
+{
+    return m_columns[column].storage;
+}
+
+QVector<double> DataTableModel::numericColumn(int column) const
+{
+    if (column < 0 || column >= m_columns.size()) return QVector<double>();
+
+    ensureComputed(column);
+    const DataColumn& col = m_columns[column];
+    if (col.storage == ColumnStorage::Numeric) {
+        return col.numbers;  // 隐式共享，无复制
+    }
+
+    QVector<double> values(m_rowCount, kNaN);
+    if (col.storage == ColumnStorage::Text) {
+        for (int row = 0; row < m_rowCount; ++row) {
+            bool ok = false;
+            double v = col.texts[row].trimmed().toDouble(&ok);
+            if (ok) values[row] = v;
+        }
+    }
+    return values;
+}
+
+QStringList DataTableModel::columnTexts(int column) const
+{
+    QStringList texts;
+    texts.reserve(m_rowCount);
+    for (int row = 0; row < m_rowCount; ++row) {
+        texts.append(text(row, column));
+    }
+    return texts;
+}
+
+QStringList DataTableModel::rowTexts(int row) const
+{
+    QStringList texts;
+    texts.reserve(m_columns.size());
+    for (int col = 0; col < m_columns.size(); ++col) {
+        texts.append(text(row, col));
+    }
+    return texts;
+}
+
+bool DataTableModel::isComputed(int column) const
+{
+    return column >= 0 && column < m_columns.size() && m_columns[column].formula;
+}
+
+quint64 DataTableModel::dataVersion() const
+{
+    return m_dataVersion;
+}
+
+void DataTableModel::setColumnNumberFormat(int column, char format, int precision)
+{
+    if (column < 0 || column >= m_columns.size()) return;
+    m_columns[column].numberFormat = format;
+    m_columns[column].precision = precision;
+    if (m_rowCount > 0) {
+        emit dataChanged(index(0, column), index(m_rowCount - 1, column), {Qt::DisplayRole});
+    }
+}
+
+void DataTableModel::setColumnForeground(int column, const QColor &color)
+{
+    if (column < 0 || column >= m_columns.size()) return;
+    m_columns[column].foreground = color;
+    if (m_rowCount > 0) {
+        emit dataChanged(index(0, column), index(m_rowCount - 1, column), {Qt::ForegroundRole});
+    }
+}
+
+void DataTableModel::setColumnBackground(int column, const QColor &color)
+{
+    if (column < 0 || column >= m_columns.size()) return;
+    m_columns[column].background = color;
+    if (m_rowCount > 0) {
+        emit dataChanged(index(0, column), index(m_rowCount - 1, column), {Qt::BackgroundRole});
+    }
+}
+
+void DataTableModel::setTableData(const QVector<DataColumn> &columns, int rows)
+{
+    beginResetModel();
+    m_columns = columns;
+    m_rowCount = rows;
+    for (DataColumn& column : m_columns) {
+        resizeColumn(column, rows);
+    }
+    endResetModel();
+}
+
+bool DataTableModel::extendTableData(const QVector<DataColumn> &columns, int rows)
+{
+    if (m_columns.isEmpty() || columns.size() != m_columns.size() || rows < m_rowCount) return false;
+    for (int col = 0; col < m_columns.size(); ++col) {
+        if (columns[col].storage != m_columns[col].storage || columns[col].header != m_columns[col].header) {
+            return false;
+        }
+    }
+
+    int shownRows = m_rowCount;
+    QVector<DataColumn> adopted = columns;
+    for (DataColumn& column : adopted) {
+        resizeColumn(column, rows);
+    }
+
+    if (rows > shownRows) beginInsertRows(QModelIndex(), shownRows, rows - 1);
+    m_columns.swap(adopted);
+    m_rowCount = rows;
+    if (rows > shownRows) endInsertRows();
+
+    // 已显示行的内容可能随完整数据的格式推断而变化（如小数位数）
+    if (shownRows > 0) {
+        emit dataChanged(index(0, 0), index(shownRows - 1, m_columns.size() - 1));
+    }
+    return true;
+}
+
+void DataTableModel::insertColumnData(int column, const DataColumn &data)
+{
+    column = qBound(0, column, static_cast<int>(m_columns.size()));
+
+    DataColumn inserted = data;
+    resizeColumn(inserted, m_rowCount);
+
+    beginInsertColumns(QModelIndex(), column, column);
+    shiftFormulaSources(column, 1);
+    m_columns.insert(column, inserted);
+    endInsertColumns();
+}
+
+QVector<DataColumn> DataTableModel::rowSlice(int row, int count) const
+{
+    QVector<DataColumn> slice;
+    if (row < 0 || count <= 0 || row + count > m_rowCount) return slice;
+
+    ensureAllComputed();
+    slice.reserve(m_columns.size());
+    for (const DataColumn& column : m_columns) {
+        DataColumn part;
+        part.storage = column.storage;
+        part.header = column.header;
+        part.timestampFormat = column.timestampFormat;
+        part.numberFormat = column.numberFormat;
+        part.precision = column.precision;
+        switch (column.storage) {
+        case ColumnStorage::Numeric:
+            part.numbers = column.numbers.mid(row, count);
+            break;
+        case ColumnStorage::Timestamp:
+            part.timestamps = column.timestamps.mid(row, count);
+            break;
+        case ColumnStorage::Text:
+            part.texts = column.texts.mid(row, count);
+            break;
+        }
+        if (column.storage != ColumnStorage::Text) {
+            for (int i = 0; i < count; ++i) {
+                if (!column.isValid(row + i)) part.setValid(i, false);
+            }
+        }
+        slice.append(part);
+    }
+    return slice;
+}
+
+void DataTableModel::insertRowSlice(int row, const QVector<DataColumn> &slice)
+{
+    if (slice.isEmpty() || row < 0 || row > m_rowCount) return;
+
+    int count = slice.first().size();
+    if (count <= 0 || !insertRows(row, count)) return;
+
+    for (int col = 0; col < m_columns.size() && col < slice.size(); ++col) {
+        DataColumn& column = m_columns[col];
+        const DataColumn& part = slice[col];
+        if (column.formula) continue;  // 派生列随版本变化重算
+
+        for (int i = 0; i < count; ++i) {
+            if (!part.isValid(i)) continue;
+
+            // 存储类型一致时直接拷贝原值，否则按文本写入
+            if (part.storage == column.storage && part.storage == ColumnStorage::Numeric) {
+                column.numbers[row + i] = part.numbers[i];
+                column.setValid(row + i, true);
+            } else if (part.storage == column.storage && part.storage == ColumnStorage::Timestamp
+                       && part.timestampFormat == column.timestampFormat) {
+                column.timestamps[row + i] = part.timestamps[i];
+                column.setValid(row + i, true);
+            } else {
+                setText(row + i, col, cellText(part, i));
+            }
+        }
+    }
+
+    if (!m_columns.isEmpty()) {
+        emit dataChanged(index(row, 0), index(row + count - 1, m_columns.size() - 1));
+    }
+}
+
+RowRanges DataTableModel::toRowRanges(QList<int> rows)
+{
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+    RowRanges ranges;
+    for (int row : rows) {
+        if (row < 0) continue;
+        if (!ranges.isEmpty() && ranges.last().first + ranges.last().second == row) {
+            ++ranges.last().second;
+        } else {
+            ranges.append(qMakePair(row, 1));
+        }
+    }
+    return ranges;
+}
+
+QVector<DataColumn> DataTableModel::takeRows(const RowRanges &ranges)
+{
+    QVector<DataColumn> removed;
+    int total = 0;
+    for (const QPair<int, int>& range : ranges) {
+        if (range.first < 0 || range.second <= 0 || range.first + range.second > m_rowCount) return removed;
+        total += range.second;
+    }
+    if (total == 0) return removed;
+
+    bool single = (ranges.size() == 1);
+    if (single) {
+        beginRemoveRows(QModelIndex(), ranges.first().first, ranges.first().first + total - 1);
+    } else {
+        beginResetModel();
+    }
+
+    // 每列按区间一次性拆分为保留部分与删除部分
+    removed.reserve(m_columns.size());
+    for (DataColumn& column : m_columns) {
+        DataColumn kept = emptyLike(column);
+        DataColumn part = emptyLike(column);
+        int pos = 0;
+        for (const QPair<int, int>& range : ranges) {
+            appendRange(kept, column, pos, range.first);
+            appendRange(part, column, range.first, range.first + range.second);
+            pos = range.first + range.second;
+        }
+        appendRange(kept, column, pos, m_rowCount);
+        column = kept;
+        removed.append(part);
+    }
+    m_rowCount -= total;
+
+    if (single) {
+        endRemoveRows();
+    } else {
+        endResetModel();
+    }
+    return removed;
+}
+
+void DataTableModel::restoreRows(const RowRanges &ranges, const QVector<DataColumn> &removed)
+{
+    int total = 0;
+    for (const QPair<int, int>& range : ranges) total += range.second;
+    if (total == 0 || removed.size() != m_columns.size()) return;
+
+    bool single = (ranges.size() == 1);
+    if (single) {
+        beginInsertRows(QModelIndex(), ranges.first().first, ranges.first().first + total - 1);
+    } else {
+        beginResetModel();
+    }
+
+    int newCount = m_rowCount + total;
+    for (int col = 0; col < m_columns.size(); ++col) {
+        DataColumn part = removed[col];
+        if (part.size() != total) {
+            part = emptyLike(m_columns[col]);
+            resizeColumn(part, total);
+        }
+
+        // 删除后列类型发生过变化时统一按文本合并
+        bool sameType = part.storage == m_columns[col].storage
+                        && (part.storage != ColumnStorage::Timestamp
+                            || part.timestampFormat == m_columns[col].timestampFormat);
+        if (!sameType) {
+            convertToText(col);
+            DataColumn textPart = emptyLike(m_columns[col]);
+            textPart.texts.resize(total);
+            for (int i = 0; i < total; ++i) textPart.texts[i] = cellText(part, i);
+            part = textPart;
+        }
+
+        const DataColumn& current = m_columns[col];
+        DataColumn merged = emptyLike(current);
+        int pos = 0;        // 当前列中的读取位置
+        int partPos = 0;    // 删除片段中的读取位置
+        for (const QPair<int, int>& range : ranges) {
+            int keep = range.first - (pos + partPos);
+            appendRange(merged, current, pos, pos + keep);
+            pos += keep;
+            appendRange(merged, part, partPos, partPos + range.second);
+            partPos += range.second;
+        }
+        appendRange(merged, current, pos, m_rowCount);
+        m_columns[col] = merged;
+    }
+    m_rowCount = newCount;
+
+    if (single) {
+        endInsertRows();
+    } else {
+        endResetModel();
+    }
+}
+
+DataColumn DataTableModel::cellSlice(int column, const QVector<int> &rows) const
+{
+    DataColumn part;
+    if (column < 0 || column >= m_columns.size()) return part;
+
+    ensureComputed(column);
+    const DataColumn& source = m_columns[column];
+    part = emptyLike(source);
+    int count = rows.size();
+    switch (source.storage) {
+    case ColumnStorage::Numeric:
+        part.numbers.resize(count);
+        for (int i = 0; i < count; ++i) part.numbers[i] = source.numbers[rows[i]];
+        break;
+    case ColumnStorage::Timestamp:
+        part.timestamps.resize(count);
+        for (int i = 0; i < count; ++i) part.timestamps[i] = source.timestamps[rows[i]];
+        break;
+    case ColumnStorage::Text:
+        part.texts.resize(count);
+        for (int i = 0; i < count; ++i) part.texts[i] = source.texts[rows[i]];
+        return part;
+    }
+    if (!source.validity.isEmpty()) {
+        for (int i = 0; i < count; ++i) {
+            if (!source.isValid(rows[i])) part.setValid(i, false);
+        }
+    }
+    return part;
+}
+
+void DataTableModel::setCellSlice(int column, const QVector<int> &rows, const DataColumn &values)
+{
+    if (column < 0 || column >= m_columns.size() || rows.isEmpty() || values.size() != rows.size()) return;
+
+    detachFormula(column);
+    DataColumn& target = m_columns[column];
+    bool sameType = values.storage == target.storage
+                    && (values.storage != ColumnStorage::Timestamp
+                        || values.timestampFormat == target.timestampFormat);
+    if (!sameType) {
+        // 类型不一致时按文本写入（可能把列转换为文本列）
+        for (int i = 0; i < rows.size(); ++i) {
+            setText(rows[i], column, cellText(values, i));
+        }
+        return;
+    }
+
+    int first = m_rowCount;
+    int last = -1;
+    for (int i = 0; i < rows.size(); ++i) {
+        int row = rows[i];
+        if (row < 0 || row >= m_rowCount) continue;
+        bool valid = values.isValid(i);
+        switch (target.storage) {
+        case ColumnStorage::Numeric:
+            target.numbers[row] = valid ? values.numbers[i] : kNaN;
+            break;
+        case ColumnStorage::Timestamp:
+            target.timestamps[row] = valid ? values.timestamps[i] : 0;
+            break;
+        case ColumnStorage::Text:
+            target.texts[row] = values.texts[i];
+            break;
+        }
+        target.setValid(row, valid);
+        first = qMin(first, row);
+        last = qMax(last, row);
+    }
+
+    if (last >= first) {
+        emit dataChanged(index(first, column), index(last, column));
+    }
+}
+
+void DataTableModel::replaceColumn(int column, const DataColumn &data)
+{
+    if (column < 0 || column >= m_columns.size()) return;
+
+    m_columns[column] = data;
+    resizeColumn(m_columns[column], m_rowCount);
+
+    emit headerDataChanged(Qt::Horizontal, column, column);
+    if (m_rowCount > 0) {
+        emit dataChanged(index(0, column), index(m_rowCount - 1, column));
+    }
+}
+
+DataColumn DataTableModel::buildColumn(const QString &header, const QVector<QString> &cells)
+{
+    DataColumn column;
+    column.header = header;
+    int n = cells.size();
+
+    // ---- 1. 数值列 ----
+    QVector<double> numbers(n, kNaN);
+    bool numeric = true;
+    bool anyEmpty = false;
+    int digits = -2;  // -2: 尚未确定；-1: 小数位不一致或含科学计数法
+    for (int i = 0; i < n && numeric; ++i) {
+        QString cell = cells[i].trimmed();
+        if (cell.isEmpty()) {
+            anyEmpty = true;
+            continue;
+        }
+        bool ok = false;
+        double v = cell.toDouble(&ok);
+        if (!ok || !std::isfinite(v)) {
+            numeric = false;
+            break;
+        }
+        numbers[i] = v;
+
+        int d = fractionDigits(cell);
+        if (digits == -2) {
+            digits = d;
+        } else if (digits != d) {
+            digits = -1;
+        }
+    }
+
+    if (numeric) {
+        column.storage = ColumnStorage::Numeric;
+        column.numbers = numbers;
+        if (digits >= 0) {
+            column.numberFormat = 'f';
+            column.precision = digits;
+        }
+        if (anyEmpty) {
+            for (int i = 0; i < n; ++i) {
+                if (std::isnan(numbers[i])) column.setValid(i, false);
+            }
+        }
+        return column;
+    }
+
+    // ---- 2. 时间戳列（要求逐格可原样往返） ----
+    int first = 0;
+    while (first < n && cells[first].trimmed().isEmpty()) ++first;
+    if (first < n) {
+        QString sample = cells[first].trimmed();
+        for (const char* candidate : kTimestampFormats) {
+            QString format = QString::fromLatin1(candidate);
+            qint64 msecs = 0;
+            if (!parseTimestamp(sample, format, msecs)) continue;
+
+            QVector<qint64> stamps(n, 0);
+            QVector<int> emptyRows;
+            bool allMatch = true;
+            for (int i = 0; i < n; ++i) {
+                QString cell = cells[i].trimmed();
+                if (cell.isEmpty()) {
+                    emptyRows.append(i);
+                    continue;
+                }
+                if (!parseTimestamp(cell, format, stamps[i])) {
+                    allMatch = false;
+                    break;
+                }
+            }
+            if (!allMatch) continue;
+
+            column.storage = ColumnStorage::Timestamp;
+            column.timestamps = stamps;
+            column.timestampFormat = format;
+            for (int row : emptyRows) column.setValid(row, false);
+            return column;
+        }
+    }
+
+    // ---- 3. 文本列 ----
+    column.storage = ColumnStorage::Text;
+    column.texts = cells;
+    return column;
+}
+
+DataColumn DataTableModel::makeNumericColumn(const QString &header, const QVector<double> &values,
+                                             char format, int precision)
+{
+    DataColumn column;
+    column.header = header;
+    column.storage = ColumnStorage::Numeric;
+    column.numbers = values;  // 隐式共享；仅在需要把 ±inf 改写为 NaN 时才复制
+    column.numberFormat = format;
+    column.precision = precision;
+    for (int i = 0; i < values.size(); ++i) {
+        if (std::isfinite(values[i])) continue;
+        if (!std::isnan(values[i])) {
+            column.numbers[i] = kNaN;
+        }
+        column.setValid(i, false);
+    }
+    return column;
+}
+
+qint64 DataTableModel::memoryUsage() const
+{
+    qint64 bytes = 0;
+    for (const DataColumn& column : m_columns) {
+        bytes += column.numbers.size() * qint64(sizeof(double));
+        bytes += column.timestamps.size() * qint64(sizeof(qint64));
+        bytes += column.validity.size() * qint64(sizeof(quint64));
+        for (const QString& text : column.texts) {
+            bytes += qint64(sizeof(QString)) + text.size() * qint64(sizeof(QChar));
+        }
+    }
+    return bytes;
+}
+
+QString DataTableModel::cellText(const DataColumn &column, int row)
+{
+    if (!column.isValid(row)) return QString();
+
+    switch (column.storage) {
+    case ColumnStorage::Numeric:
+        return formatNumber(column.numbers[row], column.numberFormat, column.precision);
+    case ColumnStorage::Timestamp:
+        return formatTimestamp(column.timestamps[row], column.timestampFormat);
+    case ColumnStorage::Text:
+    default:
+        return column.texts[row];
+    }
+}
+
+QString DataTableModel::formatNumber(double value, char format, int precision)
+{
+    return QString::number(value, format, precision);
+}
+
+bool DataTableModel::parseTimestamp(const QString &text, const QString &format, qint64 &msecs)
+{
+    QDateTime dt = QDateTime::fromString(text, format);
+    if (!dt.isValid()) return false;
+
+    // 按"日历日 + 当日毫秒"编码，与时区/夏令时无关
+    msecs = QDate(1970, 1, 1).daysTo(dt.date()) * kMsecsPerDay + dt.time().msecsSinceStartOfDay();
+    return formatTimestamp(msecs, format) == text;
+}
+
+QString DataTableModel::formatTimestamp(qint64 msecs, const QString &format)
+{
+    qint64 days = msecs / kMsecsPerDay;
+    qint64 rest = msecs % kMsecsPerDay;
+    if (rest < 0) {
+        rest += kMsecsPerDay;
+        --days;
+    }
+    QDateTime dt(QDate(1970, 1, 1).addDays(days), QTime::fromMSecsSinceStartOfDay(static_cast<int>(rest)));
+    return dt.toString(format);
+}
+
+void DataTableModel::resizeColumn(DataColumn &column, int rows)
+{
+    int oldSize = column.size();
+    if (oldSize == rows) return;
+
+    switch (column.storage) {
+    case ColumnStorage::Numeric:
+        column.numbers.resize(rows);
+        for (int i = oldSize; i < rows; ++i) column.numbers[i] = kNaN;
+        break;
+    case ColumnStorage::Timestamp:
+        column.timestamps.resize(rows);
+        break;
+    case ColumnStorage::Text:
+        column.texts.resize(rows);
+        return;
+    }
+
+    if (rows > oldSize) {
+        spliceValidity(column.validity, oldSize, oldSize, 0, rows - oldSize);
+    } else if (!column.validity.isEmpty()) {
+        spliceValidity(column.validity, oldSize, rows, oldSize - rows, 0);
+    }
+}
+
+void DataTableModel::convertToText(int column)
+{
+    DataColumn& col = m_columns[column];
+    if (col.storage == ColumnStorage::Text) return;
+
+    QVector<QString> texts(m_rowCount);
+    for (int row = 0; row < m_rowCount; ++row) {
+        texts[row] = text(row, column);
+    }
+
+    col.storage = ColumnStorage::Text;
+    col.texts = texts;
+    col.numbers.clear();
+    col.timestamps.clear();
+    col.validity.clear();
+}
+
+// ============================================================================
+// 派生列
+// ============================================================================
+
+void DataTableModel::onCellsChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                                    const QList<int> &roles)
+{
+    // 只改颜色等外观的通知不影响派生值
+    if (!roles.isEmpty() && !roles.contains(Qt::DisplayRole) && !roles.contains(Qt::EditRole)) return;
+
+    // 只涉及派生列的通知（包括重算后发出的通知）不改变数据版本
+    int lastColumn = qMin(bottomRight.column(), static_cast<int>(m_columns.size()) - 1);
+    for (int col = topLeft.column(); col <= lastColumn; ++col) {
+        if (!m_columns[col].formula) {
+            invalidateComputedColumns();
+            return;
+        }
+    }
+}
+
+void DataTableModel::invalidateComputedColumns()
+{
+    ++m_dataVersion;
+    if (m_rowCount == 0) return;
+
+    // 派生列的值在下一次读取时重算；先通知监听者整列已变化
+    for (int col = 0; col < m_columns.size(); ++col) {
+        if (m_columns[col].formula) {
+            emit dataChanged(index(0, col), index(m_rowCount - 1, col));
+        }
+    }
+}
+
+void DataTableModel::ensureComputed(int column) const
+{
+    if (column < 0 || column >= m_columns.size()) return;
+    if (!m_columns[column].formula || m_columns[column].formulaVersion == m_dataVersion) return;
+
+    // 缓存值的更新不改变模型的可见状态，因此允许在 const 读取接口中进行。
+    // 先记录版本再计算，公式间接引用自身时不会无限递归；
+    // 计算过程中可能读取其它派生列（导致数组分离），因此之后重新取引用。
+    DataTableModel* self = const_cast<DataTableModel*>(this);
+    QSharedPointer<const ColumnFormula> formula = m_columns[column].formula;
+    self->m_columns[column].formulaVersion = m_dataVersion;
+
+    QVector<double> values = formula->evaluate(this);
+    int computedRows = qMin(static_cast<int>(values.size()), m_rowCount);
+    values.resize(m_rowCount);
+    for (int row = computedRows; row < m_rowCount; ++row) values[row] = kNaN;
+    DataColumn& target = self->m_columns[column];
+    target.storage = ColumnStorage::Numeric;
+    target.texts.clear();
+    target.timestamps.clear();
+    target.validity.clear();
+    target.numbers = values;
+    for (int row = 0; row < m_rowCount; ++row) {
+        if (std::isfinite(values[row])) continue;
+        target.numbers[row] = kNaN;
+        target.setValid(row, false);
+    }
+}
+
+void DataTableModel::ensureAllComputed() const
+{
+    for (int col = 0; col < m_columns.size(); ++col) {
+        ensureComputed(col);
+    }
+}
+
+void DataTableModel::detachFormula(int column)
+{
+    if (!m_columns[column].formula) return;
+    ensureComputed(column);
+    m_columns[column].formula.reset();
+    emit headerDataChanged(Qt::Horizontal, column, column);
+}
+
+void DataTableModel::shiftFormulaSources(int from, int delta)
+{
+    for (DataColumn& column : m_columns) {
+        if (!column.formula) continue;
+
+        QVector<int> sources = column.formula->sources();
+        bool moved = false;
+        for (int& source : sources) {
+            if (source >= from) {
+                source += delta;
+                moved = true;
+            }
+        }
+        if (moved) column.formula = column.formula->withSources(sources);
+    }
+}
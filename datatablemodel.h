@@ -0,0 +1,203 @@
+#ifndef DATATABLEMODEL_H
+#define DATATABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QColor>
+#include <QPair>
+#include <QSharedPointer>
+
+// 列存储类型
+enum class ColumnStorage {
+    Numeric,    // 连续 double 数组
+    Timestamp,  // 连续 int64 毫秒时间戳（按列格式解析/显示）
+    Text        // 字符串（仅在无法按数值或时间解析时使用）
+};
+
+class DataTableModel;
+
+/**
+ * @brief 派生列公式
+ *
+ * 派生列（压降、导数、时间换算等）只保存公式与源列索引：值在首次读取时由
+ * evaluate() 算出并缓存在列的数值数组中，模型数据版本变化后的下一次读取才重算。
+ * 源列索引按派生列所在的列布局给出，列增删时由模型自动调整。
+ */
+class ColumnFormula
+{
+public:
+    explicit ColumnFormula(const QVector<int> &sources) : m_sources(sources) {}
+    virtual ~ColumnFormula() {}
+
+    const QVector<int> &sources() const { return m_sources; }
+
+    // 源列位置变化后的副本
+    QSharedPointer<const ColumnFormula> withSources(const QVector<int> &sources) const;
+
+    // 计算整列值（与行一一对应，NaN 表示空；返回空数组表示当前数据无法计算）
+    virtual QVector<double> evaluate(const DataTableModel *model) const = 0;
+
+    // 公式说明（表头提示，源列以当前表头命名）
+    virtual QString description(const DataTableModel *model) const = 0;
+
+protected:
+    virtual ColumnFormula *clone() const = 0;
+
+private:
+    QVector<int> m_sources;
+};
+
+/**
+ * @brief 单列类型化数据
+ *
+ * 数值列中无效（空）单元格同时以 NaN 存储，可直接用于数值计算；
+ * 有效位图仅在存在空单元格时分配（空位图表示全部有效）。
+ */
+struct DataColumn {
+    ColumnStorage storage;
+    QString header;
+    QVector<double> numbers;      // Numeric
+    QVector<qint64> timestamps;   // Timestamp
+    QString timestampFormat;      // Timestamp 的显示/解析格式
+    QVector<QString> texts;       // Text
+    QVector<quint64> validity;    // 有效位图（bit=1 表示有值）
+    char numberFormat;            // 数值显示格式：'f' 定点 / 'g' 有效数字
+    int precision;                // 'f' 为小数位数，'g' 为有效数字位数
+    QColor foreground;            // 列前景色（无效颜色表示默认）
+    QColor background;            // 列背景色（无效颜色表示默认）
+    QSharedPointer<const ColumnFormula> formula;  // 派生列公式（空表示普通数据列）
+    quint64 formulaVersion;       // 派生列缓存值对应的数据版本
+
+    DataColumn() :
+        storage(ColumnStorage::Numeric),
+        numberFormat('g'),
+        precision(15),
+        formulaVersion(0) {}
+
+    int size() const;
+    bool isValid(int row) const;
+    void setValid(int row, bool valid);
+};
+
+// 行区间集合：(起始行, 行数)，按起始行升序且互不重叠
+typedef QVector<QPair<int, int>> RowRanges;
+
+/**
+ * @brief 数据编辑器的列式表格模型
+ *
+ * 替代逐单元格 QStandardItem 的存储方式：数据按列保存在连续数组中，
+ * 文本格式化只在 data() 中进行。数值计算可通过 numericColumn() 直接取得
+ * 整列 double 数组（隐式共享，不复制），无需逐格 toDouble()。
+ *
+ * 带公式的派生列按需计算：任何非派生列的改动都会递增数据版本，派生列在
+ * 下一次被读取时才按新版本重算，并对视图发出 dataChanged。派生列在表格中只读，
+ * 通过 setText()/setValue()/setCellSlice() 写入时先按当前值物化为普通列。
+ */
+class DataTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit DataTableModel(QObject *parent = nullptr);
+
+    // QAbstractTableModel 接口
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    bool setHeaderData(int section, Qt::Orientation orientation, const QVariant &value,
+                       int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    bool insertRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
+    bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
+    bool insertColumns(int column, int count, const QModelIndex &parent = QModelIndex()) override;
+    bool removeColumns(int column, int count, const QModelIndex &parent = QModelIndex()) override;
+
+    // 表结构
+    void clear();
+    void setRowCount(int rows);
+    void setColumnCount(int columns);
+    void setHorizontalHeaderLabels(const QStringList &labels);
+    QString headerText(int column) const;
+    void setHeaderText(int column, const QString &text);
+
+    // 单元格访问
+    QString text(int row, int column) const;
+    void setText(int row, int column, const QString &text);
+    double value(int row, int column, bool *ok = nullptr) const;
+    void setValue(int row, int column, double value);
+    bool isEmpty(int row, int column) const;
+
+    // 整列访问
+    const DataColumn &column(int column) const;
+    QVector<DataColumn> tableColumns() const;   // 全部列（隐式共享，不复制数组）
+    ColumnStorage columnStorage(int column) const;
+    QVector<double> numericColumn(int column) const;
+    QStringList columnTexts(int column) const;
+    QStringList rowTexts(int row) const;
+    void setColumnNumberFormat(int column, char format, int precision);
+    void setColumnForeground(int column, const QColor &color);
+    void setColumnBackground(int column, const QColor &color);
+
+    // 派生列
+    bool isComputed(int column) const;
+    quint64 dataVersion() const;    // 非派生列每次改动后递增
+
+    // 批量写入（整表替换或插入整列，只发一次结构变化信号）
+    void setTableData(const QVector<DataColumn> &columns, int rows);
+    // 渐进加载收尾：列结构与当前一致且行数不少于当前时，用完整数据替换已显示的
+    // 前若干行并追加其余行（不重置视图）；结构不一致时返回 false，由调用方整表替换
+    bool extendTableData(const QVector<DataColumn> &columns, int rows);
+    // data 为派生列时，其源列索引按插入后的列位置给出
+    void insertColumnData(int column, const DataColumn &data);
+
+    // 行区间快照：按列类型原样保存/恢复（用于撤销删除行）
+    QVector<DataColumn> rowSlice(int row, int count) const;
+    void insertRowSlice(int row, const QVector<DataColumn> &slice);
+
+    // 批量删除/恢复多个行区间：每列一次线性拼接，只发一次结构变化信号
+    // （单个区间为 beginRemoveRows/beginInsertRows，多个区间为模型重置）
+    static RowRanges toRowRanges(QList<int> rows);
+    QVector<DataColumn> takeRows(const RowRanges &ranges);
+    void restoreRows(const RowRanges &ranges, const QVector<DataColumn> &removed);
+
+    // 列内按行号批量读写类型化值（不经文本往返），写入只发一次 dataChanged
+    DataColumn cellSlice(int column, const QVector<int> &rows) const;
+    void setCellSlice(int column, const QVector<int> &rows, const DataColumn &values);
+
+    // 整列替换（位置不变，用于整列变换的撤销快照）
+    void replaceColumn(int column, const DataColumn &data);
+
+    // 由文本单元格构建列：自动推断数值/时间戳/文本存储
+    static DataColumn buildColumn(const QString &header, const QVector<QString> &cells);
+    static DataColumn makeNumericColumn(const QString &header, const QVector<double> &values,
+                                        char format = 'g', int precision = 15);
+
+    // 估算的数据内存占用（字节）
+    qint64 memoryUsage() const;
+
+private slots:
+    void onCellsChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles);
+    void invalidateComputedColumns();
+
+private:
+    QVector<DataColumn> m_columns;
+    int m_rowCount;
+    quint64 m_dataVersion;
+
+    static QString cellText(const DataColumn &column, int row);
+    static QString formatNumber(double value, char format, int precision);
+    static bool parseTimestamp(const QString &text, const QString &format, qint64 &msecs);
+    static QString formatTimestamp(qint64 msecs, const QString &format);
+    static void resizeColumn(DataColumn &column, int rows);
+    void convertToText(int column);
+    void ensureComputed(int column) const;
+    void ensureAllComputed() const;
+    void detachFormula(int column);
+    void shiftFormulaSources(int from, int delta);
+};
+
+#endif // DATATABLEMODEL_H
@@ -0,0 +1,299 @@
+#include "datetimeparser.h"
+#include <QThread>
+#include <QtConcurrent>
+
+namespace {
+
+// 读取 1..maxDigits 位十进制数字；超过 maxDigits 位视为不匹配
+inline bool readNumber(const QChar*& p, const QChar* end, int maxDigits, int& value, int& digits)
+{
+    value = 0;
+    digits = 0;
+    while (p < end) {
+        unsigned d = unsigned(p->unicode()) - '0';
+        if (d > 9) break;
+        if (++digits > maxDigits) return false;
+        value = value * 10 + int(d);
+        ++p;
+    }
+    return digits > 0;
+}
+
+inline bool isSpace(const QChar* p)
+{
+    return p->unicode() == ' ' || p->unicode() == '\t';
+}
+
+inline bool isLeapYear(int year)
+{
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+inline int daysInMonth(int year, int month)
+{
+    static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return (month == 2 && isLeapYear(year)) ? 29 : days[month - 1];
+}
+
+} // namespace
+
+// ============================================================================
+// 格式推断
+// ============================================================================
+
+DateTimeFormat DateTimeParser::inferFormat(const QVector<QString>& texts, int sampleSize)
+{
+    // 样本：前部的非空格 + 全列均匀间隔的非空格
+    QVector<int> sample;
+    int head = sampleSize / 2;
+    for (int row = 0; row < texts.size() && sample.size() < head; ++row) {
+        if (!texts[row].trimmed().isEmpty()) sample.append(row);
+    }
+    int step = qMax(1, texts.size() / qMax(1, sampleSize - head));
+    int lastHead = sample.isEmpty() ? -1 : sample.last();
+    for (int row = lastHead + 1; row < texts.size() && sample.size() < sampleSize; row += step) {
+        if (!texts[row].trimmed().isEmpty()) sample.append(row);
+    }
+
+    DateTimeFormat best;
+    if (sample.isEmpty()) return best;
+
+    // 候选顺序即歧义时的优先级（日/月不可区分时按 dd/MM 解释，与原格式列表一致）
+    QVector<DateTimeFormat> candidates;
+    const DateTimeFormat::DateOrder orders[] = {
+        DateTimeFormat::YearMonthDay, DateTimeFormat::DayMonthYear,
+        DateTimeFormat::MonthDayYear, DateTimeFormat::NoDate
+    };
+    for (DateTimeFormat::DateOrder order : orders) {
+        DateTimeFormat candidate;
+        candidate.dateOrder = order;
+        candidate.hasTime = true;
+        candidate.minutesSeconds = (order == DateTimeFormat::NoDate);
+        candidate.valid = true;
+        candidates.append(candidate);
+    }
+
+    int bestCount = 0;
+    for (const DateTimeFormat& candidate : candidates) {
+        int count = 0;
+        qint64 msecs = 0;
+        for (int row : sample) {
+            if (parse(texts[row], candidate, msecs)) ++count;
+        }
+        if (count > bestCount) {
+            bestCount = count;
+            best = candidate;
+        }
+    }
+
+    // 样本中至少 80% 可解析才认为是日期/时刻列
+    if (bestCount * 5 < sample.size() * 4) {
+        return DateTimeFormat();
+    }
+    return best;
+}
+
+// ============================================================================
+// 单格解析
+// ============================================================================
+
+bool DateTimeParser::parse(QStringView text, const DateTimeFormat& format, qint64& msecs)
+{
+    if (!format.valid) return false;
+
+    const QChar* p = text.data();
+    const QChar* end = p + text.size();
+    while (p < end && isSpace(p)) ++p;
+    while (end > p && isSpace(end - 1)) --end;
+    if (p == end) return false;
+
+    qint64 days = 0;
+    if (format.dateOrder != DateTimeFormat::NoDate) {
+        int a = 0, b = 0, c = 0;
+        int da = 0, db = 0, dc = 0;
+        if (!readNumber(p, end, 4, a, da) || p == end) return false;
+
+        ushort separator = p->unicode();
+        if (separator != '-' && separator != '/' && separator != '.') return false;
+        ++p;
+        if (!readNumber(p, end, 2, b, db) || p == end || p->unicode() != separator) return false;
+        ++p;
+        if (!readNumber(p, end, 4, c, dc)) return false;
+
+        int year, month, day;
+        switch (format.dateOrder) {
+        case DateTimeFormat::YearMonthDay:
+            if (da != 4 || dc > 2) return false;
+            year = a; month = b; day = c;
+            break;
+        case DateTimeFormat::DayMonthYear:
+            if (dc != 4 || da > 2) return false;
+            year = c; month = b; day = a;
+            break;
+        case DateTimeFormat::MonthDayYear:
+        default:
+            if (dc != 4 || da > 2) return false;
+            year = c; month = a; day = b;
+            break;
+        }
+        if (month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month)) return false;
+        days = daysFromCivil(year, month, day);
+
+        if (p == end) {
+            msecs = days * MsecsPerDay;
+            return true;
+        }
+
+        // 日期与时刻之间：一个或多个空格，或 ISO 8601 的 'T'
+        if (p->unicode() == 'T') {
+            ++p;
+        } else if (isSpace(p)) {
+            while (p < end && isSpace(p)) ++p;
+        } else {
+            return false;
+        }
+        if (!format.hasTime || p == end) return false;
+    } else if (!format.hasTime) {
+        return false;
+    }
+
+    // 时刻：h[h]:mm[:ss[.f...]]
+    int first = 0, second = 0, third = 0;
+    int digits = 0;
+    if (!readNumber(p, end, 2, first, digits) || p == end || p->unicode() != ':') return false;
+    ++p;
+    if (!readNumber(p, end, 2, second, digits) || digits != 2) return false;
+
+    int hours, minutes, seconds;
+    qint64 fraction = 0;
+    if (p < end && p->unicode() == ':') {
+        ++p;
+        if (!readNumber(p, end, 2, third, digits) || digits != 2) return false;
+        hours = first;
+        minutes = second;
+        seconds = third;
+
+        // 秒的小数部分：取前三位为毫秒，第四位四舍五入，其余忽略
+        if (p < end && (p->unicode() == '.' || p->unicode() == ',')) {
+            ++p;
+            int count = 0;
+            int roundDigit = 0;
+            while (p < end) {
+                unsigned d = unsigned(p->unicode()) - '0';
+                if (d > 9) break;
+                if (count < 3) {
+                    fraction = fraction * 10 + d;
+                } else if (count == 3) {
+                    roundDigit = int(d);
+                }
+                ++count;
+                ++p;
+            }
+            if (count == 0) return false;
+            for (int i = count; i < 3; ++i) fraction *= 10;
+            if (roundDigit >= 5) ++fraction;
+        }
+    } else if (format.minutesSeconds) {
+        hours = 0;
+        minutes = first;
+        seconds = second;
+    } else {
+        hours = first;
+        minutes = second;
+        seconds = 0;
+    }
+
+    if (p != end) return false;
+    if (hours > 23 || minutes > 59 || seconds > 59) return false;
+
+    msecs = days * MsecsPerDay + ((hours * 60 + minutes) * 60 + seconds) * 1000LL + fraction;
+    return true;
+}
+
+// ============================================================================
+// 整列解析
+// ============================================================================
+
+int DateTimeParser::parseTexts(const QVector<QString>& texts, const DateTimeFormat& format,
+                               QVector<qint64>& msecs, QVector<char>& valid, int threads)
+{
+    const int rows = texts.size();
+    msecs = QVector<qint64>(rows, 0);
+    valid = QVector<char>(rows, 0);
+    if (!format.valid || rows == 0) return 0;
+
+    qint64* out = msecs.data();
+    char* ok = valid.data();
+    if (threads <= 0) threads = qMax(1, QThread::idealThreadCount());
+
+    // 按行块并行；每块写入互不重叠的输出区间
+    const int minChunk = 32768;
+    int chunks = qBound(1, rows / minChunk, threads * 4);
+    QVector<int> chunkIndices(chunks);
+    for (int i = 0; i < chunks; ++i) chunkIndices[i] = i;
+
+    QVector<int> parsedCounts(chunks, 0);
+    int* parsed = parsedCounts.data();
+    QtConcurrent::blockingMap(chunkIndices, [&](int& chunk) {
+        int begin = int(qint64(rows) * chunk / chunks);
+        int end = int(qint64(rows) * (chunk + 1) / chunks);
+        int count = 0;
+        for (int row = begin; row < end; ++row) {
+            if (parse(texts.at(row), format, out[row])) {
+                ok[row] = 1;
+                ++count;
+            }
+        }
+        parsed[chunk] = count;
+    });
+
+    int total = 0;
+    for (int count : parsedCounts) total += count;
+    return total;
+}
+
+bool DateTimeParser::columnMsecs(const DataColumn& column, QVector<qint64>& msecs, QVector<char>& valid,
+                                 bool& hasDate, QString& errorMessage, int threads)
+{
+    switch (column.storage) {
+    case ColumnStorage::Timestamp: {
+        // 模型已按列格式解析为时间戳，直接取数组（隐式共享）
+        msecs = column.timestamps;
+        valid = QVector<char>(msecs.size(), 1);
+        if (!column.validity.isEmpty()) {
+            for (int row = 0; row < msecs.size(); ++row) {
+                valid[row] = column.isValid(row) ? 1 : 0;
+            }
+        }
+        const QString& format = column.timestampFormat;
+        hasDate = format.contains('y') || format.contains('d') || format.contains('M');
+        return true;
+    }
+    case ColumnStorage::Text: {
+        DateTimeFormat format = inferFormat(column.texts);
+        if (!format.valid) {
+            errorMessage = QString("无法识别列 \"%1\" 的日期/时刻格式").arg(column.header);
+            return false;
+        }
+        hasDate = format.dateOrder != DateTimeFormat::NoDate;
+        parseTexts(column.texts, format, msecs, valid, threads);
+        return true;
+    }
+    case ColumnStorage::Numeric:
+        break;
+    }
+
+    errorMessage = QString("列 \"%1\" 是数值列，不是日期/时刻列").arg(column.header);
+    return false;
+}
+
+qint64 DateTimeParser::daysFromCivil(int year, int month, int day)
+{
+    // 公历日期与日序号的换算（适用于任意年份，不经 QDate）
+    year -= month <= 2 ? 1 : 0;
+    const qint64 era = (year >= 0 ? year : year - 399) / 400;
+    const qint64 yearOfEra = year - era * 400;
+    const qint64 dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const qint64 dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
@@ -0,0 +1,70 @@
+#ifndef DATETIMEPARSER_H
+#define DATETIMEPARSER_H
+
+#include <QString>
+#include <QStringView>
+#include <QVector>
+#include "datatablemodel.h"
+
+// 日期/时刻文本格式（由样本推断一次，之后逐格套用）
+struct DateTimeFormat {
+    enum DateOrder {
+        NoDate,         // 仅时刻
+        YearMonthDay,   // yyyy-MM-dd
+        DayMonthYear,   // dd/MM/yyyy
+        MonthDayYear    // MM/dd/yyyy
+    };
+
+    DateOrder dateOrder;
+    bool hasTime;           // 日期后可跟时刻（缺省视为 00:00:00）
+    bool minutesSeconds;    // 仅两段的时刻按 mm:ss 解释，否则按 hh:mm
+    bool valid;
+
+    DateTimeFormat() :
+        dateOrder(NoDate),
+        hasTime(false),
+        minutesSeconds(false),
+        valid(false) {}
+};
+
+/**
+ * @brief 日期/时刻文本的快速解析
+ *
+ * 格式只在样本上推断一次（年月日顺序、是否带时刻），之后每格由手写扫描器解析：
+ * 直接读 QStringView 中的数字与分隔符，按公历算法换算日数，不分配内存、
+ * 不构造 QDate/QDateTime。支持日期与时刻之间的空格或 'T'，秒的小数部分
+ * 按毫秒舍入。结果与模型时间戳一致，采用"日历日 + 当日毫秒"编码。
+ */
+class DateTimeParser
+{
+public:
+    static constexpr qint64 MsecsPerDay = 86400000LL;
+
+    /**
+     * @brief 从文本样本推断格式（取前部与均匀间隔的若干非空格，选解析成功最多的格式）
+     */
+    static DateTimeFormat inferFormat(const QVector<QString>& texts, int sampleSize = 256);
+
+    /**
+     * @brief 按给定格式解析一格
+     */
+    static bool parse(QStringView text, const DateTimeFormat& format, qint64& msecs);
+
+    /**
+     * @brief 并行解析整列文本，valid 标记每行是否解析成功，返回成功行数
+     */
+    static int parseTexts(const QVector<QString>& texts, const DateTimeFormat& format,
+                          QVector<qint64>& msecs, QVector<char>& valid, int threads = 0);
+
+    /**
+     * @brief 取列的毫秒值：时间戳列直接使用，文本列推断格式后解析
+     * @param hasDate 输出：列中是否含日期（否则为当日毫秒）
+     */
+    static bool columnMsecs(const DataColumn& column, QVector<qint64>& msecs, QVector<char>& valid,
+                            bool& hasDate, QString& errorMessage, int threads = 0);
+
+    // 公历日期 → 距 1970-01-01 的天数
+    static qint64 daysFromCivil(int year, int month, int day);
+};
+
+#endif // DATETIMEPARSER_H
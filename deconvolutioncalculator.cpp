@@ -0,0 +1,713 @@
+#include "deconvolutioncalculator.h"
+#include "pressurederivativecalculator.h"
+#include <QRegularExpression>
+#include <QtConcurrent>
+#include <QFuture>
+#include <QThread>
+#include <QDebug>
+#include <Eigen/Dense>
+#include <cmath>
+#include <algorithm>
+
+// ============================================================================
+// 内部辅助结构
+// ============================================================================
+
+namespace {
+
+// E(a,b) = (e^b - e^a) / (b - a) 及其对 a、b 的偏导
+// 分段线性 z(σ) 在一个节点区间上的积分为 h·E(z_k, z_k+1)
+struct SegmentIntegral {
+    double value;
+    double dA;
+    double dB;
+};
+
+inline SegmentIntegral expSegment(double a, double b)
+{
+    SegmentIntegral s;
+    double d = b - a;
+    double ea = std::exp(a);
+    if (std::abs(d) < 1e-6) {
+        // 小差值时使用泰勒展开，避免相消误差
+        s.value = ea * (1.0 + d / 2.0 + d * d / 6.0);
+        s.dA = ea * (0.5 + d / 6.0);
+        s.dB = ea * (0.5 + d / 3.0);
+    } else {
+        double eb = std::exp(b);
+        s.value = (eb - ea) / d;
+        s.dA = (s.value - ea) / d;
+        s.dB = (eb - s.value) / d;
+    }
+    return s;
+}
+
+// 给定 z 时的响应预计算量（各迭代线程只读共享）
+struct ResponseState {
+    double sigma0 = 0.0;           // 第一个节点 ln(τ0)
+    double h = 1.0;                // 节点间距
+    int nodes = 0;
+    std::vector<double> z;
+    std::vector<double> expZ;
+    std::vector<double> cumulative; // C_k = p_u(τ_k)
+    std::vector<double> fullDA;     // h·∂E/∂a（整段）
+    std::vector<double> fullDB;     // h·∂E/∂b（整段）
+
+    void prepare()
+    {
+        expZ.resize(nodes);
+        cumulative.resize(nodes);
+        fullDA.assign(std::max(nodes - 1, 0), 0.0);
+        fullDB.assign(std::max(nodes - 1, 0), 0.0);
+        for (int k = 0; k < nodes; ++k) expZ[k] = std::exp(z[k]);
+
+        // τ < τ0 段按井储单位斜率外推，∫ = e^{z0}
+        cumulative[0] = expZ[0];
+        for (int s = 0; s < nodes - 1; ++s) {
+            SegmentIntegral seg = expSegment(z[s], z[s + 1]);
+            cumulative[s + 1] = cumulative[s] + h * seg.value;
+            fullDA[s] = h * seg.dA;
+            fullDB[s] = h * seg.dB;
+        }
+    }
+};
+
+// 单个 τ 的单位流量响应：所在段及段内部分积分对两端节点的偏导
+// segment = -1 表示 τ < τ0，segment = nodes-1 表示超出最后节点
+struct PointResponse {
+    double value;
+    int segment;
+    double u;       // 段内位置 [0, 1)，段外为 0
+    double dLeft;
+    double dRight;
+};
+
+inline PointResponse evaluateResponse(const ResponseState& st, double tau)
+{
+    PointResponse r;
+    double sigma = std::log(tau);
+    double x = (sigma - st.sigma0) / st.h;
+
+    if (x < 0.0) {
+        r.segment = -1;
+        r.u = 0.0;
+        r.value = st.expZ[0] * std::exp(sigma - st.sigma0);
+        r.dLeft = r.value;
+        r.dRight = 0.0;
+        return r;
+    }
+
+    int s = static_cast<int>(x);
+    if (s >= st.nodes - 1) {
+        double ds = sigma - (st.sigma0 + (st.nodes - 1) * st.h);
+        r.segment = st.nodes - 1;
+        r.u = 0.0;
+        r.value = st.cumulative[st.nodes - 1] + st.expZ[st.nodes - 1] * ds;
+        r.dLeft = st.expZ[st.nodes - 1] * ds;
+        r.dRight = 0.0;
+        return r;
+    }
+
+    double u = x - s;
+    double a = st.z[s];
+    SegmentIntegral part = expSegment(a, a + u * (st.z[s + 1] - a));
+    r.segment = s;
+    r.u = u;
+    r.value = st.cumulative[s] + st.h * u * part.value;
+    r.dLeft = st.h * u * (part.dA + part.dB * (1.0 - u));
+    r.dRight = st.h * u * part.dB * u;
+    return r;
+}
+
+// 分块累加的法方程
+struct NormalEquations {
+    Eigen::MatrixXd JtJ;
+    Eigen::VectorXd Jtr;
+    double sse = 0.0;
+};
+
+// 历史流量台阶分箱：箱内各台阶距流动段起点的相对差 ≤ 5%，叠加时按箱中心二阶展开
+struct StepBin {
+    double center;  // 箱中心时间 Tc
+    double s0;      // Σ Δq
+    double s1;      // Σ Δq·(Tc - T_j)
+    double s2;      // Σ Δq·(T_j - Tc)²
+};
+
+// 反演问题的只读输入
+struct Problem {
+    const QVector<double>* time = nullptr;
+    const QVector<double>* pressure = nullptr;
+    std::vector<double> stepTime;
+    std::vector<double> stepDelta;  // 流量增量 Δq_j
+    std::vector<int> lastStep;      // 每个压力点之前（严格早于）的最后一个台阶索引
+    std::vector<StepBin> bins;      // 按流动段拼接的台阶分箱
+    std::vector<int> binOffset;     // 流动段 k 的分箱为 [binOffset[k], binOffset[k+1])
+    bool fitInitialPressure = true;
+};
+
+// 为出现压力点的每个流动段 k 构建台阶 0..k 的分箱，与 z 无关，只需构建一次
+// 分箱宽度按距 T_k 的距离几何增长：m 个台阶约 O(log m) 个箱，每箱 O(log m)
+void buildStepBins(Problem& pb)
+{
+    // 分箱相对宽度：箱内 |T_j - Tc| / τ ≤ 0.05，二阶展开单箱截断误差约 2e-5·|ΣΔq|·dp_u/dlnτ
+    const double binWidth = 0.1;
+
+    const std::vector<double>& T = pb.stepTime;
+    int m = static_cast<int>(T.size());
+    if (m == 0) return;
+
+    // 流量增量及其一、二阶矩的前缀和（时间以首个台阶为原点，减小相消误差）
+    double origin = T[0];
+    std::vector<double> P0(m + 1, 0.0), P1(m + 1, 0.0), P2(m + 1, 0.0);
+    for (int j = 0; j < m; ++j) {
+        double tj = T[j] - origin;
+        P0[j + 1] = P0[j] + pb.stepDelta[j];
+        P1[j + 1] = P1[j] + pb.stepDelta[j] * tj;
+        P2[j + 1] = P2[j] + pb.stepDelta[j] * tj * tj;
+    }
+
+    std::vector<char> used(m, 0);
+    for (int last : pb.lastStep) {
+        if (last >= 0) used[last] = 1;
+    }
+
+    pb.bins.clear();
+    pb.binOffset.assign(m + 1, 0);
+    for (int k = 0; k < m; ++k) {
+        pb.binOffset[k] = static_cast<int>(pb.bins.size());
+        if (!used[k]) continue;
+
+        int hi = k;
+        while (hi >= 0) {
+            double dHi = T[k] - T[hi];
+            double limit = T[k] - dHi * (1.0 + binWidth);
+            // lo = 第一个 T_j > limit 的台阶
+            int lo = static_cast<int>(std::upper_bound(T.begin(), T.begin() + hi + 1, limit) - T.begin());
+            lo = qMin(lo, hi);
+
+            double tc = 0.5 * (T[lo] + T[hi]) - origin;
+            double a0 = P0[hi + 1] - P0[lo];
+            double a1 = P1[hi + 1] - P1[lo];
+            double a2 = P2[hi + 1] - P2[lo];
+
+            StepBin bin;
+            bin.center = 0.5 * (T[lo] + T[hi]);
+            bin.s0 = a0;
+            bin.s1 = tc * a0 - a1;
+            bin.s2 = a2 - 2.0 * tc * a1 + tc * tc * a0;
+            if (bin.s0 != 0.0 || bin.s1 != 0.0 || bin.s2 != 0.0) pb.bins.push_back(bin);
+
+            hi = lo - 1;
+        }
+    }
+    pb.binOffset[m] = static_cast<int>(pb.bins.size());
+}
+
+// 一个分箱对 Σ Δq·p_u(t - T_j) 的贡献，τ = t - Tc：
+//   s0·p_u(τ) + s1·p_u'(τ) + ½·s2·p_u''(τ)，p_u' = e^{z(σ)}/τ，p_u'' = (z'(σ) - 1)·p_u'/τ
+// 单台阶箱 s1 = s2 = 0，结果精确。bucket/row 非空时同时累加对 z 的偏导
+inline double accumulateBin(const ResponseState& st, const StepBin& bin, double tau,
+                            double* bucket, double* row)
+{
+    const int N = st.nodes;
+    PointResponse r = evaluateResponse(st, tau);
+    double value = bin.s0 * r.value;
+
+    if (row) {
+        bucket[r.segment + 1] += bin.s0;
+        if (r.segment < 0) {
+            row[0] += bin.s0 * r.dLeft;
+        } else {
+            row[r.segment] += bin.s0 * r.dLeft;
+            if (r.segment + 1 < N) row[r.segment + 1] += bin.s0 * r.dRight;
+        }
+    }
+    if (bin.s1 == 0.0 && bin.s2 == 0.0) return value;
+
+    // z(σ) 的斜率：τ < τ0 段按单位斜率外推（z' = 1），超出末节点 z 取常数
+    int left;
+    double d1, slope;
+    bool interior = r.segment >= 0 && r.segment < N - 1;
+    if (r.segment < 0) {
+        left = 0;
+        d1 = r.value / tau;
+        slope = 1.0;
+    } else if (!interior) {
+        left = N - 1;
+        d1 = st.expZ[N - 1] / tau;
+        slope = 0.0;
+    } else {
+        left = r.segment;
+        d1 = std::exp(st.z[left] + r.u * (st.z[left + 1] - st.z[left])) / tau;
+        slope = (st.z[left + 1] - st.z[left]) / st.h;
+    }
+
+    double coef = bin.s1 + 0.5 * bin.s2 * (slope - 1.0) / tau;
+    value += coef * d1;
+
+    if (row) {
+        if (interior) {
+            double dSlope = 0.5 * bin.s2 * d1 / (tau * st.h);
+            row[left] += coef * d1 * (1.0 - r.u) - dSlope;
+            row[left + 1] += coef * d1 * r.u + dSlope;
+        } else {
+            row[left] += coef * d1;
+        }
+    }
+    return value;
+}
+
+// 对 [begin, end) 的压力点计算残差平方和，必要时累加法方程
+NormalEquations accumulateChunk(const Problem& pb, const ResponseState& st,
+                                double p0, int begin, int end, bool withJacobian)
+{
+    const int N = st.nodes;
+    const int P = N + 1;
+    const int blockRows = 256;
+
+    NormalEquations ne;
+    if (withJacobian) {
+        ne.JtJ = Eigen::MatrixXd::Zero(P, P);
+        ne.Jtr = Eigen::VectorXd::Zero(P);
+    }
+
+    Eigen::MatrixXd block;
+    Eigen::VectorXd blockRes;
+    if (withJacobian) {
+        block.resize(blockRows, P);
+        blockRes.resize(blockRows);
+    }
+    int filled = 0;
+
+    // 各段权重桶（下标偏移 1，对应段 -1 .. N-1）
+    std::vector<double> bucket(N + 1, 0.0);
+    std::vector<double> row(N, 0.0);
+
+    auto flush = [&]() {
+        if (filled == 0) return;
+        auto B = block.topRows(filled);
+        ne.JtJ.noalias() += B.transpose() * B;
+        ne.Jtr.noalias() += B.transpose() * blockRes.head(filled);
+        filled = 0;
+    };
+
+    for (int i = begin; i < end; ++i) {
+        int last = pb.lastStep[i];
+        double ti = (*pb.time)[i];
+        double superposed = 0.0;
+
+        if (withJacobian) {
+            std::fill(bucket.begin(), bucket.end(), 0.0);
+            std::fill(row.begin(), row.end(), 0.0);
+        }
+
+        if (last >= 0) {
+            double* bucketData = withJacobian ? bucket.data() : nullptr;
+            double* rowData = withJacobian ? row.data() : nullptr;
+            for (int b = pb.binOffset[last]; b < pb.binOffset[last + 1]; ++b) {
+                const StepBin& bin = pb.bins[b];
+                superposed += accumulateBin(st, bin, ti - bin.center, bucketData, rowData);
+            }
+        }
+
+        double residual = (*pb.pressure)[i] - (p0 - superposed);
+        ne.sse += residual * residual;
+
+        if (!withJacobian) continue;
+
+        // 整段贡献：W_q = Σ_{段号 > q} Δq，自后向前做后缀和，O(N)
+        double sumNonNegative = 0.0;
+        for (int s = 0; s < N; ++s) sumNonNegative += bucket[s + 1];
+        row[0] += st.expZ[0] * sumNonNegative;
+
+        double suffix = 0.0;
+        for (int q = N - 2; q >= 0; --q) {
+            suffix += bucket[q + 2];
+            if (suffix == 0.0) continue;
+            row[q] += suffix * st.fullDA[q];
+            row[q + 1] += suffix * st.fullDB[q];
+        }
+
+        // 模型 p = p0 - Σ Δq·p_u，故 ∂p/∂z = -row
+        for (int k = 0; k < N; ++k) block(filled, k) = -row[k];
+        block(filled, N) = pb.fitInitialPressure ? 1.0 : 0.0;
+        blockRes(filled) = residual;
+        if (++filled == blockRows) flush();
+    }
+
+    if (withJacobian) flush();
+    return ne;
+}
+
+// 按压力点分块并行累加
+NormalEquations accumulateAll(const Problem& pb, const ResponseState& st,
+                              double p0, bool withJacobian)
+{
+    int n = static_cast<int>(pb.lastStep.size());
+    int chunkCount = qMax(1, qMin(QThread::idealThreadCount(), n / 2000));
+    int chunkSize = (n + chunkCount - 1) / chunkCount;
+
+    QVector<QFuture<NormalEquations>> futures;
+    for (int c = 0; c < chunkCount; ++c) {
+        int begin = c * chunkSize;
+        int end = qMin(n, begin + chunkSize);
+        if (begin >= end) break;
+        futures.append(QtConcurrent::run([&pb, &st, p0, begin, end, withJacobian]() {
+            return accumulateChunk(pb, st, p0, begin, end, withJacobian);
+        }));
+    }
+
+    NormalEquations total = futures[0].result();
+    for (int c = 1; c < futures.size(); ++c) {
+        NormalEquations part = futures[c].result();
+        total.sse += part.sse;
+        if (withJacobian) {
+            total.JtJ += part.JtJ;
+            total.Jtr += part.Jtr;
+        }
+    }
+    return total;
+}
+
+// 曲率正则项 w·||D2·z||²
+double curvaturePenalty(const std::vector<double>& z, double weight)
+{
+    double sum = 0.0;
+    for (size_t k = 1; k + 1 < z.size(); ++k) {
+        double c = z[k - 1] - 2.0 * z[k] + z[k + 1];
+        sum += c * c;
+    }
+    return weight * sum;
+}
+
+} // namespace
+
+// ============================================================================
+// DeconvolutionCalculator
+// ============================================================================
+
+DeconvolutionCalculator::DeconvolutionCalculator(QObject *parent)
+    : QObject(parent)
+{
+}
+
+DeconvolutionCalculator::~DeconvolutionCalculator()
+{
+}
+
+DeconvolutionResult DeconvolutionCalculator::calculateDeconvolution(
+    DataTableModel* model, const DeconvolutionConfig& config)
+{
+    DeconvolutionResult result;
+
+    if (!model) {
+        result.errorMessage = "数据模型不存在";
+        return result;
+    }
+
+    int rowCount = model->rowCount();
+    if (rowCount < 10) {
+        result.errorMessage = "数据行数不足（至少需要10行）";
+        return result;
+    }
+
+    int columnCount = model->columnCount();
+    if (config.timeColumnIndex < 0 || config.timeColumnIndex >= columnCount) {
+        result.errorMessage = "时间列索引无效";
+        return result;
+    }
+    if (config.pressureColumnIndex < 0 || config.pressureColumnIndex >= columnCount) {
+        result.errorMessage = "压力列索引无效";
+        return result;
+    }
+    if (config.rateColumnIndex < 0 || config.rateColumnIndex >= columnCount) {
+        result.errorMessage = "流量列索引无效";
+        return result;
+    }
+
+    emit progressUpdated(10, "正在读取数据...");
+
+    QVector<double> timeData;
+    QVector<double> pressureData;
+    QVector<double> rateData;
+    timeData.reserve(rowCount);
+    pressureData.reserve(rowCount);
+    rateData.reserve(rowCount);
+
+    for (int row = 0; row < rowCount; ++row) {
+        // 跳过时间或压力为空的行
+        if (model->isEmpty(row, config.timeColumnIndex) || model->isEmpty(row, config.pressureColumnIndex)) {
+            continue;
+        }
+
+        double t = cellValue(model, row, config.timeColumnIndex);
+        if (!timeData.isEmpty() && t < timeData.last()) {
+            result.errorMessage = QString("时间列必须单调递增（行 %1）").arg(row + 1);
+            return result;
+        }
+
+        timeData.append(t);
+        pressureData.append(cellValue(model, row, config.pressureColumnIndex));
+        rateData.append(cellValue(model, row, config.rateColumnIndex));
+    }
+
+    emit progressUpdated(20, "正在整理流量历史...");
+
+    QVector<double> stepTime;
+    QVector<double> stepRate;
+    PressureDerivativeCalculator::buildRateSteps(timeData, rateData, config.rateTolerance, stepTime, stepRate);
+
+    emit progressUpdated(30, QString("正在反演（%1 个压力点，%2 个流量台阶）...")
+                                 .arg(timeData.size()).arg(stepTime.size()));
+
+    DeconvolutionResult solved = deconvolve(timeData, pressureData, stepTime, stepRate, config);
+    if (!solved.success) {
+        return solved;
+    }
+    result = solved;
+
+    emit progressUpdated(100, "计算完成");
+    emit calculationCompleted(result);
+
+    return result;
+}
+
+DeconvolutionResult DeconvolutionCalculator::deconvolve(const QVector<double>& timeData,
+                                                        const QVector<double>& pressureData,
+                                                        const QVector<double>& stepTime,
+                                                        const QVector<double>& stepRate,
+                                                        const DeconvolutionConfig& config)
+{
+    DeconvolutionResult result;
+
+    int n = qMin(timeData.size(), pressureData.size());
+    int m = qMin(stepTime.size(), stepRate.size());
+    int N = qMax(config.nodeCount, 4);
+
+    if (n < 10) {
+        result.errorMessage = "压力数据点不足（至少需要10个）";
+        return result;
+    }
+    if (m == 0) {
+        result.errorMessage = "流量历史为空，无法进行反褶积";
+        return result;
+    }
+
+    // ---- 1. 组装问题：流量增量、每个压力点前的最后台阶 (O(n + m)) ----
+    Problem pb;
+    pb.time = &timeData;
+    pb.pressure = &pressureData;
+    pb.fitInitialPressure = config.estimateInitialPressure;
+    pb.stepTime.assign(stepTime.begin(), stepTime.begin() + m);
+    pb.stepDelta.resize(m);
+    double referenceRate = 0.0;
+    for (int j = 0; j < m; ++j) {
+        pb.stepDelta[j] = stepRate[j] - (j > 0 ? stepRate[j - 1] : 0.0);
+        referenceRate = qMax(referenceRate, std::abs(stepRate[j]));
+    }
+    if (referenceRate <= 0.0) {
+        result.errorMessage = "流量全部为零，无法进行反褶积";
+        return result;
+    }
+
+    pb.lastStep.resize(n);
+    double tauMin = -1.0;
+    int j = -1;
+    for (int i = 0; i < n; ++i) {
+        while (j + 1 < m && pb.stepTime[j + 1] < timeData[i]) ++j;
+        pb.lastStep[i] = j;
+        if (j >= 0) {
+            double tau = timeData[i] - pb.stepTime[j];
+            if (tau > 0 && (tauMin < 0 || tau < tauMin)) tauMin = tau;
+        }
+    }
+    double tauMax = timeData[n - 1] - pb.stepTime[0];
+    if (tauMin <= 0 || tauMax <= tauMin) {
+        result.errorMessage = "流量开始后没有有效的压力数据";
+        return result;
+    }
+    tauMin = qMax(tauMin, tauMax * 1e-7);
+    buildStepBins(pb);
+
+    // ---- 2. 初值：常数 z 使总压降量级与实测一致 ----
+    ResponseState st;
+    st.nodes = N;
+    st.sigma0 = std::log(tauMin);
+    st.h = (std::log(tauMax) - st.sigma0) / (N - 1);
+
+    double p0 = config.estimateInitialPressure ? pressureData[0] : config.initialPressure;
+    double pMin = pressureData[0], pMax = pressureData[0];
+    for (int i = 0; i < n; ++i) {
+        pMin = qMin(pMin, pressureData[i]);
+        pMax = qMax(pMax, pressureData[i]);
+    }
+    if (config.estimateInitialPressure) p0 = pMax;
+    double pressureRange = qMax(pMax - pMin, 1e-9);
+    double span = 1.0 + (N - 1) * st.h;
+    st.z.assign(N, std::log(pressureRange / (referenceRate * span)));
+    st.prepare();
+
+    // 正则化权重：以压力变化幅度的 1% 作为期望拟合误差尺度
+    double scale = 0.01 * pressureRange;
+    double regWeight = qMax(config.regularization, 0.0) * n * scale * scale;
+
+    // ---- 3. Levenberg-Marquardt 迭代 ----
+    const int P = N + 1;
+    double lambda = 0.01;
+    NormalEquations ne = accumulateAll(pb, st, p0, true);
+    double currentObj = ne.sse + curvaturePenalty(st.z, regWeight);
+
+    int iterations = 0;
+    bool converged = false;
+    while (iterations < config.maxIterations && !converged) {
+        ++iterations;
+        // 五对角正则矩阵 w·D2ᵀD2 及其梯度，直接按带状结构累加
+        Eigen::MatrixXd A = ne.JtJ;
+        Eigen::VectorXd g = ne.Jtr;
+        for (int k = 1; k + 1 < N; ++k) {
+            const int idx[3] = { k - 1, k, k + 1 };
+            const double coef[3] = { 1.0, -2.0, 1.0 };
+            double c = st.z[k - 1] - 2.0 * st.z[k] + st.z[k + 1];
+            for (int a = 0; a < 3; ++a) {
+                g(idx[a]) -= regWeight * coef[a] * c;
+                for (int b = 0; b < 3; ++b) {
+                    A(idx[a], idx[b]) += regWeight * coef[a] * coef[b];
+                }
+            }
+        }
+        if (!config.estimateInitialPressure) {
+            A.row(N).setZero();
+            A.col(N).setZero();
+            A(N, N) = 1.0;
+            g(N) = 0.0;
+        }
+
+        bool stepAccepted = false;
+        while (!stepAccepted && lambda <= 1e10) {
+            Eigen::MatrixXd Alm = A;
+            for (int i = 0; i < P; ++i) Alm(i, i) += lambda * (1.0 + std::abs(A(i, i)));
+            Eigen::VectorXd delta = Alm.ldlt().solve(g);
+
+            ResponseState trial = st;
+            for (int k = 0; k < N; ++k) {
+                // 限制单步变化，避免 exp 溢出
+                trial.z[k] = st.z[k] + qBound(-2.0, delta(k), 2.0);
+            }
+            trial.prepare();
+            double trialP0 = p0 + delta(N);
+
+            NormalEquations trialNe = accumulateAll(pb, trial, trialP0, false);
+            double trialObj = trialNe.sse + curvaturePenalty(trial.z, regWeight);
+
+            if (std::isfinite(trialObj) && trialObj < currentObj) {
+                double improvement = (currentObj - trialObj) / qMax(currentObj, 1e-30);
+                st = trial;
+                p0 = trialP0;
+                currentObj = trialObj;
+                lambda /= 10.0;
+                stepAccepted = true;
+                converged = (improvement < 1e-8);
+            } else {
+                lambda *= 10.0;
+            }
+        }
+        if (!stepAccepted) break;
+        if (!converged && iterations < config.maxIterations) {
+            ne = accumulateAll(pb, st, p0, true);
+        }
+    }
+
+    NormalEquations finalNe = accumulateAll(pb, st, p0, false);
+
+    // ---- 4. 输出节点处响应（换算到参考流量）----
+    result.responseTime.reserve(N);
+    result.responsePressure.reserve(N);
+    result.responseDerivative.reserve(N);
+    for (int k = 0; k < N; ++k) {
+        result.responseTime.append(std::exp(st.sigma0 + k * st.h));
+        result.responsePressure.append(st.cumulative[k] * referenceRate);
+        result.responseDerivative.append(st.expZ[k] * referenceRate);
+    }
+
+    result.success = true;
+    result.processedRows = n;
+    result.initialPressure = p0;
+    result.referenceRate = referenceRate;
+    result.rmsError = std::sqrt(finalNe.sse / n);
+    result.iterations = iterations;
+    result.rateSteps = m;
+
+    qDebug() << "反褶积完成：迭代" << result.iterations << "次，RMS误差" << result.rmsError
+             << "，p0 =" << p0;
+
+    return result;
+}
+
+DeconvolutionConfig DeconvolutionCalculator::autoDetectColumns(DataTableModel* model)
+{
+    DeconvolutionConfig config;
+    if (!model) return config;
+
+    config.timeColumnIndex = findColumnByKeywords(model, {"时间", "time", "t\\", "小时", "hour"},
+                                                  {"反褶积"});
+    config.pressureColumnIndex = findColumnByKeywords(model, {"压力", "pressure", "pres", "P\\"},
+                                                      {"压降", "导数", "反褶积"});
+    config.rateColumnIndex = findColumnByKeywords(model, {"流量", "产量", "rate", "q\\"});
+    return config;
+}
+
+int DeconvolutionCalculator::findColumnByKeywords(DataTableModel* model,
+                                                  const QStringList& keywords,
+                                                  const QStringList& excludes)
+{
+    if (!model) return -1;
+
+    for (int col = 0; col < model->columnCount(); ++col) {
+        QString headerText = model->headerText(col);
+        bool excluded = false;
+        for (const QString& ex : excludes) {
+            if (headerText.contains(ex, Qt::CaseInsensitive)) {
+                excluded = true;
+                break;
+            }
+        }
+        if (excluded) continue;
+
+        for (const QString& keyword : keywords) {
+            if (headerText.contains(keyword, Qt::CaseInsensitive)) {
+                return col;
+            }
+        }
+    }
+    return -1;
+}
+
+double DeconvolutionCalculator::cellValue(DataTableModel* model, int row, int column)
+{
+    // 数值列直接取值，文本列按带单位文本解析
+    bool ok = false;
+    double value = model->value(row, column, &ok);
+    if (ok) return value;
+    return (model->columnStorage(column) == ColumnStorage::Text)
+               ? parseNumericValue(model->text(row, column)) : 0.0;
+}
+
+double DeconvolutionCalculator::parseNumericValue(const QString& str)
+{
+    if (str.isEmpty()) return 0.0;
+    QString cleanStr = str.trimmed();
+    bool ok;
+    double value = cleanStr.toDouble(&ok);
+    if (ok) return value;
+
+    cleanStr.remove(QRegularExpression("[a-zA-Z%\\s]+$"));
+    value = cleanStr.toDouble(&ok);
+    return ok ? value : 0.0;
+}
+
+QString DeconvolutionCalculator::formatValue(double value, int precision)
+{
+    if (std::isnan(value) || std::isinf(value)) return "0";
+    return QString::number(value, 'g', precision);
+}
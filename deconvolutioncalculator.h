@@ -0,0 +1,127 @@
+#ifndef DECONVOLUTIONCALCULATOR_H
+#define DECONVOLUTIONCALCULATOR_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include "datatablemodel.h"
+
+// 反褶积计算配置
+struct DeconvolutionConfig {
+    int timeColumnIndex;          // 时间列索引
+    int pressureColumnIndex;      // 压力列索引
+    int rateColumnIndex;          // 流量列索引
+    QString timeUnit;             // 时间单位
+    QString pressureUnit;         // 压力单位
+    int nodeCount;                // 对数导数节点数（在 ln(τ) 上均匀分布）
+    double regularization;        // 曲率正则化权重 ν（越大响应越光滑）
+    double rateTolerance;         // 流量台阶合并阈值（相对最大流量）
+    int maxIterations;            // 最大迭代次数
+    bool estimateInitialPressure; // 是否同时反演原始地层压力 p0
+    double initialPressure;       // 不反演 p0 时使用的原始地层压力
+
+    DeconvolutionConfig() :
+        timeColumnIndex(-1),
+        pressureColumnIndex(-1),
+        rateColumnIndex(-1),
+        timeUnit("h"),
+        pressureUnit("MPa"),
+        nodeCount(40),
+        regularization(1.0),
+        rateTolerance(0.01),
+        maxIterations(30),
+        estimateInitialPressure(true),
+        initialPressure(0.0) {}
+};
+
+// 反褶积计算结果
+struct DeconvolutionResult {
+    bool success;
+    QString errorMessage;
+    int processedRows;             // 参与反演的压力点数
+
+    QVector<double> responseTime;       // 响应时间 τ
+    QVector<double> responsePressure;   // 参考流量下的等效定产压降
+    QVector<double> responseDerivative; // 参考流量下的对数导数 dΔp/dln(τ)
+
+    double initialPressure;        // 反演得到（或给定）的原始地层压力
+    double referenceRate;          // 参考流量（响应按该流量换算）
+    double rmsError;               // 压力拟合均方根误差
+    int iterations;                // 实际迭代次数
+    int rateSteps;                 // 合并后的流量台阶数
+
+    DeconvolutionResult() :
+        success(false),
+        processedRows(0),
+        initialPressure(0.0),
+        referenceRate(0.0),
+        rmsError(0.0),
+        iterations(0),
+        rateSteps(0) {}
+};
+
+/**
+ * @brief 压力-流量反褶积计算器 (von Schroeter / Levitan 方法)
+ *
+ * 未知量为 σ = ln(τ) 均匀节点上的 z = ln(dp_u/dlnτ)（分段线性）以及原始压力 p0，
+ * 目标函数为 ||p - p_model||² + w·||D2·z||²，采用 Levenberg-Marquardt 求解。
+ *
+ * 压力点数 n 只出现在法方程累加中：Jacobian 按块累加为 (N+1)×(N+1) 的法方程，
+ * 不显式存储 n×N 矩阵；二阶差分正则项为五对角带状矩阵。
+ * 历史流量台阶按距当前台阶的距离几何分箱，每个压力点只需 O(log m) 次响应求值，
+ * 单次迭代代价 O(n·(log m + N²))，按压力点分块并行，可处理 10⁵ 量级的长期监测数据。
+ */
+class DeconvolutionCalculator : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DeconvolutionCalculator(QObject *parent = nullptr);
+    ~DeconvolutionCalculator();
+
+    /**
+     * @brief 对表格模型执行反褶积，响应曲线只通过结果返回，不修改表格
+     * @param model 数据模型
+     * @param config 计算配置
+     * @return 计算结果
+     */
+    DeconvolutionResult calculateDeconvolution(DataTableModel* model,
+                                               const DeconvolutionConfig& config);
+
+    /**
+     * @brief 自动检测时间、压力、流量列
+     */
+    DeconvolutionConfig autoDetectColumns(DataTableModel* model);
+
+    // =========================================================================
+    // 静态核心算法接口
+    // =========================================================================
+
+    /**
+     * @brief 反褶积核心算法
+     * @param timeData 压力采样时间（单调递增）
+     * @param pressureData 井底压力
+     * @param stepTime 流量台阶开始时间
+     * @param stepRate 流量台阶流量
+     * @param config 计算配置（仅使用求解相关参数）
+     * @return 计算结果（不含列信息）
+     */
+    static DeconvolutionResult deconvolve(const QVector<double>& timeData,
+                                          const QVector<double>& pressureData,
+                                          const QVector<double>& stepTime,
+                                          const QVector<double>& stepRate,
+                                          const DeconvolutionConfig& config);
+
+signals:
+    void progressUpdated(int progress, const QString& message);
+    void calculationCompleted(const DeconvolutionResult& result);
+
+private:
+    int findColumnByKeywords(DataTableModel* model, const QStringList& keywords,
+                             const QStringList& excludes = QStringList());
+    double cellValue(DataTableModel* model, int row, int column);
+    double parseNumericValue(const QString& str);
+    QString formatValue(double value, int precision = 6);
+};
+
+#endif // DECONVOLUTIONCALCULATOR_H
@@ -0,0 +1,237 @@
+#include "derivedcolumns.h"
+#include "datetimeparser.h"
+#include <cmath>
+#include <limits>
+
+namespace {
+
+const double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+QString sourceName(const DataTableModel *model, int column)
+{
+    return QString("「%1」").arg(model->headerText(column));
+}
+
+} // namespace
+
+// ============================================================================
+// 压降
+// ============================================================================
+
+PressureDropFormula::PressureDropFormula(int pressureColumn)
+    : ColumnFormula(QVector<int>{pressureColumn})
+{
+}
+
+QVector<double> PressureDropFormula::evaluate(const DataTableModel *model) const
+{
+    QVector<double> values = model->numericColumn(sources()[0]);
+
+    double initialPressure = kNaN;
+    for (double pressure : values) {
+        if (std::isfinite(pressure)) {
+            initialPressure = pressure;
+            break;
+        }
+    }
+
+    // 空单元格保持 NaN
+    for (double& value : values) {
+        value = initialPressure - value;
+    }
+    return values;
+}
+
+QString PressureDropFormula::description(const DataTableModel *model) const
+{
+    return QString("派生列：压降 = 初始压力 - %1").arg(sourceName(model, sources()[0]));
+}
+
+ColumnFormula *PressureDropFormula::clone() const
+{
+    return new PressureDropFormula(*this);
+}
+
+// ============================================================================
+// Bourdet 导数
+// ============================================================================
+
+BourdetDerivativeFormula::BourdetDerivativeFormula(const PressureDerivativeConfig &config)
+    : ColumnFormula(config.timeAxis == DerivativeTimeAxis::ElapsedTime
+                        ? QVector<int>{config.timeColumnIndex, config.pressureColumnIndex}
+                        : QVector<int>{config.timeColumnIndex, config.pressureColumnIndex,
+                                       config.rateColumnIndex}),
+      m_config(config)
+{
+}
+
+QVector<double> BourdetDerivativeFormula::evaluate(const DataTableModel *model) const
+{
+    PressureDerivativeConfig config = m_config;
+    config.timeColumnIndex = sources()[0];
+    config.pressureColumnIndex = sources()[1];
+    config.rateColumnIndex = sources().size() > 2 ? sources()[2] : -1;
+
+    QVector<double> derivative;
+    QString errorMessage;
+    if (model->rowCount() < 3
+        || !PressureDerivativeCalculator::computeDerivative(model, config, derivative, errorMessage)) {
+        return QVector<double>();
+    }
+    return derivative;
+}
+
+QString BourdetDerivativeFormula::description(const DataTableModel *model) const
+{
+    QString text = QString("派生列：%1 对 %2 的 Bourdet 导数（L = %3）")
+                       .arg(sourceName(model, sources()[1]),
+                            sourceName(model, sources()[0]))
+                       .arg(m_config.lSpacing);
+    if (sources().size() > 2) {
+        text += QString("，%1，流量 %2")
+                    .arg(PressureDerivativeCalculator::timeAxisName(m_config.timeAxis),
+                         sourceName(model, sources()[2]));
+    }
+    return text;
+}
+
+ColumnFormula *BourdetDerivativeFormula::clone() const
+{
+    return new BourdetDerivativeFormula(*this);
+}
+
+// ============================================================================
+// 经过时间
+// ============================================================================
+
+ElapsedTimeFormula::ElapsedTimeFormula(const QVector<int> &sources, const QString &unit)
+    : ColumnFormula(sources),
+      m_unit(unit)
+{
+}
+
+QVector<double> ElapsedTimeFormula::evaluate(const DataTableModel *model) const
+{
+    QVector<qint64> msecs;
+    QVector<char> valid;
+    bool hasDate = false;
+    QString errorMessage;
+    if (!absoluteMsecs(model, sources(), msecs, valid, hasDate, errorMessage)) {
+        return QVector<double>();
+    }
+    return elapsedValues(msecs, valid, m_unit);
+}
+
+QString ElapsedTimeFormula::description(const DataTableModel *model) const
+{
+    QString source = sources().size() == 2
+                         ? QString("%1 + %2").arg(sourceName(model, sources()[0]),
+                                                  sourceName(model, sources()[1]))
+                         : sourceName(model, sources()[0]);
+    QString unit = m_unit == "m" ? "min" : m_unit;
+    return QString("派生列：%1 的经过时间（%2）").arg(source, unit);
+}
+
+ColumnFormula *ElapsedTimeFormula::clone() const
+{
+    return new ElapsedTimeFormula(*this);
+}
+
+bool ElapsedTimeFormula::absoluteMsecs(const DataTableModel *model, const QVector<int> &sources,
+                                       QVector<qint64> &msecs, QVector<char> &valid,
+                                       bool &hasDate, QString &errorMessage)
+{
+    const qint64 msecsPerDay = DateTimeParser::MsecsPerDay;
+    const int rowCount = model->rowCount();
+    hasDate = false;
+
+    for (int source : sources) {
+        if (source < 0 || source >= model->columnCount()) {
+            errorMessage = "时间列索引无效";
+            return false;
+        }
+    }
+
+    if (sources.size() == 2) {
+        // 日期列与时刻列各自推断一次格式后整列解析（时间戳列直接取值）
+        QVector<qint64> dateMsecs, timeMsecs;
+        QVector<char> dateValid, timeValid;
+        bool timeHasDate = false;
+        if (!DateTimeParser::columnMsecs(model->column(sources[0]), dateMsecs, dateValid,
+                                         hasDate, errorMessage)) {
+            return false;
+        }
+        if (!hasDate) {
+            errorMessage = QString("列 \"%1\" 不含日期").arg(model->headerText(sources[0]));
+            return false;
+        }
+        if (!DateTimeParser::columnMsecs(model->column(sources[1]), timeMsecs, timeValid,
+                                         timeHasDate, errorMessage)) {
+            return false;
+        }
+
+        // 绝对时间 = 日期列的日历日 + 时刻列的当日毫秒
+        msecs = QVector<qint64>(rowCount, 0);
+        valid = QVector<char>(rowCount, 0);
+        for (int row = 0; row < rowCount; ++row) {
+            if (!dateValid[row] || !timeValid[row]) continue;
+            qint64 day = dateMsecs[row] - ((dateMsecs[row] % msecsPerDay) + msecsPerDay) % msecsPerDay;
+            qint64 timeOfDay = ((timeMsecs[row] % msecsPerDay) + msecsPerDay) % msecsPerDay;
+            msecs[row] = day + timeOfDay;
+            valid[row] = 1;
+        }
+
+        if (!valid.contains(1)) {
+            errorMessage = "未找到有效的日期和时刻数据";
+            return false;
+        }
+        return true;
+    }
+
+    if (!DateTimeParser::columnMsecs(model->column(sources[0]), msecs, valid, hasDate, errorMessage)) {
+        return false;
+    }
+    if (!valid.contains(1)) {
+        errorMessage = "未找到有效的时间数据";
+        return false;
+    }
+
+    // 只有时刻时按行序累计跨日：比前一个有效时刻倒退超过半天视为进入下一天
+    if (!hasDate) {
+        qint64 dayOffset = 0;
+        qint64 previous = -1;
+        for (int row = 0; row < rowCount; ++row) {
+            if (!valid[row]) continue;
+            qint64 current = msecs[row] + dayOffset;
+            if (previous >= 0 && current < previous - msecsPerDay / 2) {
+                dayOffset += msecsPerDay;
+                current += msecsPerDay;
+            }
+            msecs[row] = current;
+            previous = current;
+        }
+    }
+    return true;
+}
+
+QVector<double> ElapsedTimeFormula::elapsedValues(const QVector<qint64> &msecs, const QVector<char> &valid,
+                                                  const QString &unit)
+{
+    QVector<double> values(msecs.size(), kNaN);
+    int firstValid = valid.indexOf(1);
+    if (firstValid < 0) return values;
+
+    double divisor = 1000.0;
+    if (unit == "m") {
+        divisor = 60000.0;
+    } else if (unit == "h") {
+        divisor = 3600000.0;
+    }
+
+    // 毫秒精度
+    qint64 base = msecs[firstValid];
+    for (int row = 0; row < msecs.size(); ++row) {
+        if (valid[row]) values[row] = (msecs[row] - base) / divisor;
+    }
+    return values;
+}
@@ -0,0 +1,80 @@
+#ifndef DERIVEDCOLUMNS_H
+#define DERIVEDCOLUMNS_H
+
+#include <QString>
+#include <QVector>
+#include "datatablemodel.h"
+#include "pressurederivativecalculator.h"
+
+/**
+ * @brief 压降 Δp = p₀ - p
+ *
+ * 源列：[压力]。p₀ 取首个有效压力，空单元格的压降为空。
+ */
+class PressureDropFormula : public ColumnFormula
+{
+public:
+    explicit PressureDropFormula(int pressureColumn);
+
+    QVector<double> evaluate(const DataTableModel *model) const override;
+    QString description(const DataTableModel *model) const override;
+
+protected:
+    ColumnFormula *clone() const override;
+};
+
+/**
+ * @brief Bourdet 压力导数
+ *
+ * 源列：[时间, 压力]，等效时间/叠加时间轴时为 [时间, 压力, 流量]。
+ * 计算与 PressureDerivativeCalculator 完全一致；数据不满足条件时（如时间出现负值）整列为空。
+ */
+class BourdetDerivativeFormula : public ColumnFormula
+{
+public:
+    explicit BourdetDerivativeFormula(const PressureDerivativeConfig &config);
+
+    QVector<double> evaluate(const DataTableModel *model) const override;
+    QString description(const DataTableModel *model) const override;
+
+protected:
+    ColumnFormula *clone() const override;
+
+private:
+    PressureDerivativeConfig m_config;  // 列索引以 sources() 为准
+};
+
+/**
+ * @brief 经过时间（单位换算）
+ *
+ * 源列：[时间] 或 [日期, 时刻]。取各行绝对时间相对首个有效时间的差值，
+ * 按 unit（"s"/"m"/"h"）换算；仅有时刻时按行序累计跨日。
+ */
+class ElapsedTimeFormula : public ColumnFormula
+{
+public:
+    ElapsedTimeFormula(const QVector<int> &sources, const QString &unit);
+
+    QVector<double> evaluate(const DataTableModel *model) const override;
+    QString description(const DataTableModel *model) const override;
+
+    /**
+     * @brief 取源列各行的绝对毫秒值（日历日编码），无法解析的行 valid 为 0
+     * @param hasDate 输出：源数据是否含日期
+     */
+    static bool absoluteMsecs(const DataTableModel *model, const QVector<int> &sources,
+                              QVector<qint64> &msecs, QVector<char> &valid,
+                              bool &hasDate, QString &errorMessage);
+
+    // 相对首个有效时间的经过时间（按单位换算，无效行为 NaN）
+    static QVector<double> elapsedValues(const QVector<qint64> &msecs, const QVector<char> &valid,
+                                         const QString &unit);
+
+protected:
+    ColumnFormula *clone() const override;
+
+private:
+    QString m_unit;
+};
+
+#endif // DERIVEDCOLUMNS_H
@@ -0,0 +1,68 @@
+#include "fitlivechannel.h"
+#include <QMutexLocker>
+
+FitLiveChannel::FitLiveChannel(QObject* parent)
+    : QObject(parent),
+      m_maxFrameRate(30),
+      m_deliveryQueued(false)
+{
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &FitLiveChannel::deliver);
+}
+
+void FitLiveChannel::setMaxFrameRate(int framesPerSecond)
+{
+    m_maxFrameRate = qBound(1, framesPerSecond, 1000);
+}
+
+void FitLiveChannel::publish(const QSharedPointer<const FitSnapshot>& snapshot)
+{
+    if (!snapshot) return;
+
+    QMutexLocker locker(&m_mutex);
+    m_latest = snapshot;
+
+    // 已有送达在排队时只替换快照；结束快照另行排队，不等节流定时器
+    if (m_deliveryQueued && !snapshot->isFinal) return;
+    m_deliveryQueued = true;
+    locker.unlock();
+
+    QMetaObject::invokeMethod(this, &FitLiveChannel::deliver, Qt::QueuedConnection);
+}
+
+void FitLiveChannel::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_latest.reset();
+    m_deliveryQueued = false;
+    locker.unlock();
+
+    m_timer.stop();
+}
+
+void FitLiveChannel::deliver()
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_latest) {
+        m_deliveryQueued = false;
+        return;
+    }
+
+    // 距上一帧不足一个帧间隔：保持排队状态，到点再取最新快照
+    const qint64 interval = 1000 / m_maxFrameRate;
+    const qint64 elapsed = m_lastFrame.isValid() ? m_lastFrame.elapsed() : interval;
+    if (!m_latest->isFinal && elapsed < interval) {
+        locker.unlock();
+        if (!m_timer.isActive()) m_timer.start(int(interval - elapsed));
+        return;
+    }
+
+    QSharedPointer<const FitSnapshot> snapshot = m_latest;
+    m_latest.reset();
+    m_deliveryQueued = false;
+    locker.unlock();
+
+    m_timer.stop();
+    m_lastFrame.start();
+    emit snapshotReady(snapshot);
+}
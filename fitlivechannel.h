@@ -0,0 +1,66 @@
+#ifndef FITLIVECHANNEL_H
+#define FITLIVECHANNEL_H
+
+#include <QElapsedTimer>
+#include <QMap>
+#include <QMutex>
+#include <QObject>
+#include <QSharedPointer>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+// 拟合过程中某一时刻的结果快照（发布后只读，多个订阅者共享同一份数据）
+struct FitSnapshot {
+    double error;                       // 均方误差
+    QMap<QString, double> params;       // 当前参数
+    QVector<double> time;               // 理论曲线
+    QVector<double> pressure;
+    QVector<double> derivative;
+    bool isFinal;                       // 是否为拟合结束时的结果
+
+    FitSnapshot() : error(0.0), isFinal(false) {}
+};
+
+/**
+ * @brief 拟合线程到界面的实时更新通道
+ *
+ * 拟合线程每接受一步就 publish() 一份快照，只替换“最新快照”指针，不等待界面。
+ * 界面线程按最高帧率取出最新快照发出 snapshotReady()：两帧之间到达的多份快照
+ * 合并为最后一份，拟合可全速迭代，界面重绘次数有上限。拟合结束的快照立即送达。
+ */
+class FitLiveChannel : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FitLiveChannel(QObject* parent = nullptr);
+
+    // 最高刷新帧率（每秒快照数，默认 30）
+    void setMaxFrameRate(int framesPerSecond);
+    int maxFrameRate() const { return m_maxFrameRate; }
+
+    // 发布快照（任意线程可调用）
+    void publish(const QSharedPointer<const FitSnapshot>& snapshot);
+
+    // 丢弃尚未送达的快照
+    void clear();
+
+signals:
+    // 在通道所在线程发出
+    void snapshotReady(const QSharedPointer<const FitSnapshot>& snapshot);
+
+private slots:
+    void deliver();
+
+private:
+    int m_maxFrameRate;
+    QTimer m_timer;                     // 距上一帧不足一个帧间隔时延后送达
+    QElapsedTimer m_lastFrame;
+
+    QMutex m_mutex;                     // 保护以下成员
+    QSharedPointer<const FitSnapshot> m_latest;
+    bool m_deliveryQueued;              // 已安排送达，新快照只需替换 m_latest
+};
+
+#endif // FITLIVECHANNEL_H
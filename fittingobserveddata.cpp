@@ -53,6 +53,13 @@ FittingDataLoadDialog::FittingDataLoadDialog(const QList<QStringList>& previewDa
     grid->addWidget(new QLabel("导数列:",this), 1, 0); m_comboDeriv = new QComboBox(this); m_comboDeriv->addItem("自动计算 (Bourdet)",-1); m_comboDeriv->addItems(opts); grid->addWidget(m_comboDeriv, 1, 1);
     grid->addWidget(new QLabel("跳过首行数:",this), 1, 2); m_comboSkipRows = new QComboBox(this); for(int i=0;i<=20;++i) m_comboSkipRows->addItem(QString::number(i),i); m_comboSkipRows->setCurrentIndex(1); grid->addWidget(m_comboSkipRows, 1, 3);
     grid->addWidget(new QLabel("压力数据类型:",this), 2, 0); m_comboPressureType = new QComboBox(this); m_comboPressureType->addItem("原始压力 (自动计算压差 |P-Pi|)", 0); m_comboPressureType->addItem("压差数据 (直接使用 ΔP)", 1); grid->addWidget(m_comboPressureType, 2, 1, 1, 3);
+    grid->addWidget(new QLabel("流量列:",this), 3, 0); m_comboRate = new QComboBox(this); m_comboRate->addItem("无",-1); m_comboRate->addItems(opts); grid->addWidget(m_comboRate, 3, 1);
+    grid->addWidget(new QLabel("导数时间轴:",this), 3, 2); m_comboTimeAxis = new QComboBox(this);
+    m_comboTimeAxis->addItem(PressureDerivativeCalculator::timeAxisName(DerivativeTimeAxis::ElapsedTime), int(DerivativeTimeAxis::ElapsedTime));
+    m_comboTimeAxis->addItem(PressureDerivativeCalculator::timeAxisName(DerivativeTimeAxis::AgarwalEquivalent), int(DerivativeTimeAxis::AgarwalEquivalent));
+    m_comboTimeAxis->addItem(PressureDerivativeCalculator::timeAxisName(DerivativeTimeAxis::Superposition), int(DerivativeTimeAxis::Superposition));
+    grid->addWidget(m_comboTimeAxis, 3, 3);
+    grid->addWidget(new QLabel("生产时间 tp:",this), 4, 0); m_editProducingTime = new QLineEdit(this); m_editProducingTime->setPlaceholderText("无流量列时用于等效时间 (与时间列同单位)"); grid->addWidget(m_editProducingTime, 4, 1, 1, 3);
 
     layout->addWidget(grp);
     QHBoxLayout* btns = new QHBoxLayout; QPushButton* ok = new QPushButton("确定",this); QPushButton* cancel = new QPushButton("取消",this);
@@ -65,6 +72,9 @@ int FittingDataLoadDialog::getPressureColumnIndex() const { return m_comboPressu
 int FittingDataLoadDialog::getDerivativeColumnIndex() const { return m_comboDeriv->currentIndex()-1; }
 int FittingDataLoadDialog::getSkipRows() const { return m_comboSkipRows->currentData().toInt(); }
 int FittingDataLoadDialog::getPressureDataType() const { return m_comboPressureType->currentData().toInt(); }
+int FittingDataLoadDialog::getRateColumnIndex() const { return m_comboRate->currentIndex()-1; }
+int FittingDataLoadDialog::getTimeAxis() const { return m_comboTimeAxis->currentData().toInt(); }
+double FittingDataLoadDialog::getProducingTime() const { return m_editProducingTime->text().trimmed().toDouble(); }
 
 // ===========================================================================
 // FittingObservedData 实现
@@ -102,6 +112,8 @@ bool FittingObservedData::loadDataFromFile(QWidget* parentWidget)
     int pCol=dlg.getPressureColumnIndex();
     int dCol=dlg.getDerivativeColumnIndex();
     int pressureType = dlg.getPressureDataType();
+    int rCol = dlg.getRateColumnIndex();
+    DerivativeTimeAxis timeAxis = static_cast<DerivativeTimeAxis>(dlg.getTimeAxis());
 
     m_obsTime.clear();
     m_obsPressure.clear();
@@ -115,6 +127,13 @@ bool FittingObservedData::loadDataFromFile(QWidget* parentWidget)
         }
     }
 
+    // 有流量列且为原始压力时：按完整流量历史变换时间轴，取最后一个流动段作为分析段
+    if (timeAxis != DerivativeTimeAxis::ElapsedTime && rCol >= 0 && pCol >= 0 && pressureType == 0) {
+        if (loadLastFlowPeriod(data, dlg.getSkipRows(), tCol, pCol, rCol, dCol, timeAxis)) {
+            return true;
+        }
+    }
+
     // 解析数据
     for(int i=dlg.getSkipRows(); i<data.size(); ++i) {
         if(tCol<data[i].size()) {
@@ -140,6 +159,10 @@ bool FittingObservedData::loadDataFromFile(QWidget* parentWidget)
                 m_obsDerivative << data[i][dCol].toDouble();
             }
         }
+    } else if (timeAxis != DerivativeTimeAxis::ElapsedTime && dlg.getProducingTime() > 0) {
+        // 单一生产段后的压力恢复：对 Agarwal 等效时间求导（叠加时间导数与之等价）
+        QVector<double> te = PressureDerivativeCalculator::calculateEquivalentTime(m_obsTime, dlg.getProducingTime());
+        m_obsDerivative = PressureDerivativeCalculator::calculateBourdetDerivative(te, m_obsPressure, 0.15);
     } else {
         m_obsDerivative = PressureDerivativeCalculator::calculateBourdetDerivative(m_obsTime, m_obsPressure, 0.15);
     }
@@ -147,6 +170,48 @@ bool FittingObservedData::loadDataFromFile(QWidget* parentWidget)
     return true;
 }
 
+bool FittingObservedData::loadLastFlowPeriod(const QList<QStringList>& data, int skipRows,
+                                             int tCol, int pCol, int rCol, int dCol,
+                                             DerivativeTimeAxis timeAxis)
+{
+    QVector<double> t, p, q, d;
+    for(int i=skipRows; i<data.size(); ++i) {
+        const QStringList& row = data[i];
+        if(tCol>=row.size() || pCol>=row.size()) continue;
+        bool ok = false;
+        double tv = row[tCol].toDouble(&ok);
+        if(!ok || (!t.isEmpty() && tv < t.last())) continue;
+        t << tv;
+        p << row[pCol].toDouble();
+        q << (rCol<row.size() ? row[rCol].toDouble() : 0.0);
+        d << ((dCol>=0 && dCol<row.size()) ? row[dCol].toDouble() : 0.0);
+    }
+
+    QVector<double> stepTime, stepRate;
+    PressureDerivativeCalculator::buildRateSteps(t, q, 0.01, stepTime, stepRate);
+    if(stepTime.isEmpty()) return false;
+
+    QVector<int> period = PressureDerivativeCalculator::assignFlowPeriods(t, stepTime);
+    int k = period.isEmpty() ? -1 : period.last();
+    if(k < 0) return false;
+
+    QVector<double> deriv = PressureDerivativeCalculator::calculateDerivativeWithTimeAxis(t, p, stepTime, stepRate, timeAxis, 0.15);
+
+    // 段起点前最后一个压力作为参考压力
+    int first = period.indexOf(k);
+    double pRef = (first > 0) ? p[first-1] : p[first];
+    for(int i=first; i<t.size(); ++i) {
+        m_obsTime << t[i] - stepTime[k];
+        m_obsPressure << std::abs(p[i] - pRef);
+        m_obsDerivative << ((dCol>=0) ? d[i] : deriv[i]);
+    }
+    if(m_obsTime.size() < 3) {
+        m_obsTime.clear(); m_obsPressure.clear(); m_obsDerivative.clear();
+        return false;
+    }
+    return true;
+}
+
 QVector<double> FittingObservedData::getTime() const { return m_obsTime; }
 QVector<double> FittingObservedData::getPressure() const { return m_obsPressure; }
 QVector<double> FittingObservedData::getDerivative() const { return m_obsDerivative; }
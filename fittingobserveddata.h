@@ -6,6 +6,8 @@
 #include <QVector>
 #include <QTableWidget>
 #include <QComboBox>
+#include <QLineEdit>
+#include "pressurederivativecalculator.h"
 
 // ===========================================================================
 // 数据加载对话框 (从 fittingwidget.h 移动至此)
@@ -19,9 +21,14 @@ public:
     int getDerivativeColumnIndex() const;
     int getSkipRows() const;
     int getPressureDataType() const;
+    int getRateColumnIndex() const;
+    int getTimeAxis() const;          // 对应 DerivativeTimeAxis
+    double getProducingTime() const;  // 无流量列时 Agarwal 等效时间所用生产时间
 private:
     QTableWidget* m_previewTable;
     QComboBox *m_comboTime, *m_comboPressure, *m_comboDeriv, *m_comboSkipRows, *m_comboPressureType;
+    QComboBox *m_comboRate, *m_comboTimeAxis;
+    QLineEdit *m_editProducingTime;
     void validateSelection();
 };
 
@@ -50,6 +57,11 @@ private:
 
     // 辅助函数：解析文本行
     QStringList parseLine(const QString& line);
+
+    // 辅助函数：按流量历史变换时间轴，读取最后一个流动段
+    bool loadLastFlowPeriod(const QList<QStringList>& data, int skipRows,
+                            int tCol, int pCol, int rCol, int dCol,
+                            DerivativeTimeAxis timeAxis);
 };
 
 #endif // FITTINGOBSERVEDDATA_H
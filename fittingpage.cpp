@@ -3,6 +3,7 @@
 #include "wt_fittingwidget.h" // 【关键】引用改名后的拟合控件头文件
 #include "modelparameter.h"
 #include <QInputDialog>
+#include <QLabel>
 #include <QMessageBox>
 #include <QJsonArray>
 #include <QDebug>
@@ -13,6 +14,8 @@ FittingPage::FittingPage(QWidget *parent) :
     m_modelManager(nullptr)
 {
     ui->setupUi(this);
+
+    connect(ui->tabWidget, &QTabWidget::currentChanged, this, &FittingPage::onCurrentTabChanged);
 }
 
 FittingPage::~FittingPage()
@@ -32,7 +35,7 @@ void FittingPage::setModelManager(ModelManager *m)
 
 void FittingPage::setObservedDataToCurrent(const QVector<double> &t, const QVector<double> &p, const QVector<double> &d)
 {
-    FittingWidget* current = qobject_cast<FittingWidget*>(ui->tabWidget->currentWidget());
+    FittingWidget* current = ensureTabLoaded(ui->tabWidget->currentIndex());
     if (current) {
         current->setObservedData(t, p, d);
     } else {
@@ -43,6 +46,13 @@ void FittingPage::setObservedDataToCurrent(const QVector<double> &t, const QVect
     }
 }
 
+void FittingPage::addAnalysisWithObservedData(const QString &name, const QVector<double> &t,
+                                              const QVector<double> &p, const QVector<double> &d)
+{
+    FittingWidget* w = createNewTab(generateUniqueName(name));
+    if (w) w->setObservedData(t, p, d);
+}
+
 void FittingPage::updateBasicParameters()
 {
     for(int i = 0; i < ui->tabWidget->count(); ++i) {
@@ -51,13 +61,21 @@ void FittingPage::updateBasicParameters()
     }
 }
 
-FittingWidget* FittingPage::createNewTab(const QString &name, const QJsonObject &initData)
+FittingWidget* FittingPage::createFittingWidget()
 {
     // 创建 FittingWidget 实例
     FittingWidget* w = new FittingWidget(this);
     if(m_modelManager) w->setModelManager(m_modelManager);
 
     connect(w, &FittingWidget::sigRequestSave, this, &FittingPage::onChildRequestSave);
+    connect(w, &FittingWidget::sigStateChanged, this, [this, w]() { m_savedStates.remove(w); });
+    connect(w, &QObject::destroyed, this, [this, w]() { m_savedStates.remove(w); });
+    return w;
+}
+
+FittingWidget* FittingPage::createNewTab(const QString &name, const QJsonObject &initData)
+{
+    FittingWidget* w = createFittingWidget();
 
     int index = ui->tabWidget->addTab(w, name);
     ui->tabWidget->setCurrentIndex(index);
@@ -108,11 +126,8 @@ void FittingPage::on_btnNewAnalysis_clicked()
         createNewTab(newName);
     } else {
         int indexToCopy = items.indexOf(item) - 1;
-        FittingWidget* source = qobject_cast<FittingWidget*>(ui->tabWidget->widget(indexToCopy));
-        if(source) {
-            QJsonObject state = source->getJsonState();
-            createNewTab(newName, state);
-        }
+        QJsonObject state = tabState(indexToCopy);
+        if(!state.isEmpty()) createNewTab(newName, state);
     }
 }
 
@@ -150,12 +165,10 @@ void FittingPage::saveAllFittingStates()
 {
     QJsonArray analysesArray;
     for(int i=0; i<ui->tabWidget->count(); ++i) {
-        FittingWidget* w = qobject_cast<FittingWidget*>(ui->tabWidget->widget(i));
-        if(w) {
-            QJsonObject pageObj = w->getJsonState();
-            pageObj["_tabName"] = ui->tabWidget->tabText(i);
-            analysesArray.append(pageObj);
-        }
+        QJsonObject pageObj = tabState(i);
+        if(pageObj.isEmpty()) continue;
+        pageObj["_tabName"] = ui->tabWidget->tabText(i);
+        analysesArray.append(pageObj);
     }
 
     QJsonObject root;
@@ -173,15 +186,30 @@ void FittingPage::loadAllFittingStates()
         return;
     }
 
-    ui->tabWidget->clear();
+    // 删除旧页签（屏蔽信号，移除过程中不创建旧项目的占位页）
+    ui->tabWidget->blockSignals(true);
+    while(ui->tabWidget->count() > 0) {
+        QWidget* w = ui->tabWidget->widget(0);
+        ui->tabWidget->removeTab(0);
+        delete w;
+    }
+    ui->tabWidget->blockSignals(false);
 
     if(root.contains("analyses") && root["analyses"].isArray()) {
+        // 先放占位页，当前页立即创建，其余页在切换过去时再创建
         QJsonArray arr = root["analyses"].toArray();
         for(int i=0; i<arr.size(); ++i) {
             QJsonObject pageObj = arr[i].toObject();
             QString name = pageObj.contains("_tabName") ? pageObj["_tabName"].toString() : QString("Analysis %1").arg(i+1);
-            createNewTab(name, pageObj);
+
+            QLabel* placeholder = new QLabel("正在加载分析...", ui->tabWidget);
+            placeholder->setAlignment(Qt::AlignCenter);
+            m_pendingTabs.insert(placeholder, pageObj);
+            connect(placeholder, &QObject::destroyed, this, [this, placeholder]() { m_pendingTabs.remove(placeholder); });
+            ui->tabWidget->addTab(placeholder, name);
         }
+        ui->tabWidget->setCurrentIndex(0);
+        ensureTabLoaded(ui->tabWidget->currentIndex());
     } else {
         createNewTab("Analysis 1", root);
     }
@@ -189,6 +217,55 @@ void FittingPage::loadAllFittingStates()
     if(ui->tabWidget->count() == 0) createNewTab("Analysis 1");
 }
 
+FittingWidget* FittingPage::ensureTabLoaded(int index)
+{
+    QWidget* page = ui->tabWidget->widget(index);
+    auto pending = m_pendingTabs.find(page);
+    if(pending == m_pendingTabs.end()) return qobject_cast<FittingWidget*>(page);
+
+    QJsonObject state = pending.value();
+    m_pendingTabs.erase(pending);
+
+    // 用真正的拟合页替换占位页（屏蔽信号，避免替换时重入 currentChanged）
+    FittingWidget* w = createFittingWidget();
+    bool isCurrent = ui->tabWidget->currentIndex() == index;
+    QString name = ui->tabWidget->tabText(index);
+    ui->tabWidget->blockSignals(true);
+    ui->tabWidget->removeTab(index);
+    ui->tabWidget->insertTab(index, w, name);
+    if(isCurrent) ui->tabWidget->setCurrentIndex(index);
+    ui->tabWidget->blockSignals(false);
+    delete page;
+
+    // 观测数据与理论曲线在后台恢复；恢复完成前保存时沿用载入的状态
+    w->loadFittingState(state);
+    m_savedStates.insert(w, state);
+    return w;
+}
+
+QJsonObject FittingPage::tabState(int index)
+{
+    QWidget* page = ui->tabWidget->widget(index);
+
+    // 未创建的页签直接使用载入时的状态
+    auto pending = m_pendingTabs.constFind(page);
+    if(pending != m_pendingTabs.constEnd()) return pending.value();
+
+    FittingWidget* w = qobject_cast<FittingWidget*>(page);
+    if(!w) return QJsonObject();
+
+    auto cached = m_savedStates.constFind(w);
+    if(cached == m_savedStates.constEnd()) {
+        cached = m_savedStates.insert(w, w->getJsonState());
+    }
+    return cached.value();
+}
+
+void FittingPage::onCurrentTabChanged(int index)
+{
+    ensureTabLoaded(index);
+}
+
 void FittingPage::onChildRequestSave()
 {
     saveAllFittingStates();
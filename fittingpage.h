@@ -2,6 +2,7 @@
 #define FITTINGPAGE_H
 
 #include <QWidget>
+#include <QHash>
 #include <QJsonObject>
 #include <QTabWidget> // 显式包含，防止报错
 #include "modelmanager.h"
@@ -27,6 +28,10 @@ public:
     // 接收来自 MainWindow 的数据，传递给当前激活的 FittingWidget
     void setObservedDataToCurrent(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d);
 
+    // 新建一个拟合分析页签并载入观测数据（用于流动段提取，不覆盖当前分析）
+    void addAnalysisWithObservedData(const QString& name, const QVector<double>& t,
+                                     const QVector<double>& p, const QVector<double>& d);
+
     // 初始化/重置基本参数
     void updateBasicParameters();
 
@@ -41,13 +46,23 @@ private slots:
     void on_btnRenameAnalysis_clicked();
     void on_btnDeleteAnalysis_clicked();
     void onChildRequestSave();
+    void onCurrentTabChanged(int index);
 
 private:
     Ui::FittingPage *ui;
     ModelManager* m_modelManager;
 
+    // 各页签上次保存时的状态；页签状态变化时作废，保存时未变化的页签直接复用
+    QHash<FittingWidget*, QJsonObject> m_savedStates;
+
+    // 打开项目时尚未创建的页签（占位控件 → 保存的状态），切换到该页时才创建
+    QHash<QWidget*, QJsonObject> m_pendingTabs;
+
     // 内部函数：创建新页签
     FittingWidget* createNewTab(const QString& name, const QJsonObject& initData = QJsonObject());
+    FittingWidget* createFittingWidget();
+    FittingWidget* ensureTabLoaded(int index);
+    QJsonObject tabState(int index);
     QString generateUniqueName(const QString& baseName);
 };
 
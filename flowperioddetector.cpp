@@ -0,0 +1,446 @@
+#include "flowperioddetector.h"
+#include "pressurederivativecalculator.h"
+#include "derivedcolumns.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QDebug>
+#include <cmath>
+#include <algorithm>
+
+// ============================================================================
+// 内部辅助函数
+// ============================================================================
+
+namespace {
+
+// 中位数（O(n) nth_element，会打乱输入）
+double medianInPlace(std::vector<double>& values)
+{
+    if (values.empty()) return 0.0;
+    size_t mid = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + mid, values.end());
+    return values[mid];
+}
+
+// 由段首若干点的压力走势判断开井/关井
+FlowPeriodType classifyByPressure(const QVector<double>& pressureData, int start, int end, int window,
+                                  double tolerance)
+{
+    int probe = qMin(end, start + qMax(2 * window, 2));
+    double change = pressureData[probe] - pressureData[start];
+    if (std::abs(change) <= tolerance) return FlowPeriodType::Unknown;
+    return (change > 0) ? FlowPeriodType::Buildup : FlowPeriodType::Drawdown;
+}
+
+// 相邻两段斜率差（用于在窗口内精确定位拐点）
+double slopeJump(const QVector<double>& t, const QVector<double>& p, int j)
+{
+    double dtL = t[j] - t[j - 1];
+    double dtR = t[j + 1] - t[j];
+    if (dtL <= 0 || dtR <= 0) return 0.0;
+    return std::abs((p[j + 1] - p[j]) / dtR - (p[j] - p[j - 1]) / dtL);
+}
+
+} // namespace
+
+// ============================================================================
+// FlowPeriodDetector
+// ============================================================================
+
+FlowPeriodDetector::FlowPeriodDetector(QObject *parent)
+    : QObject(parent)
+{
+}
+
+FlowPeriodDetector::~FlowPeriodDetector()
+{
+}
+
+FlowPeriodDetectionResult FlowPeriodDetector::detect(DataTableModel* model,
+                                                     const FlowPeriodDetectionConfig& config)
+{
+    FlowPeriodDetectionResult result;
+
+    if (!model) {
+        result.errorMessage = "数据模型不存在";
+        return result;
+    }
+
+    int rowCount = model->rowCount();
+    int columnCount = model->columnCount();
+    if (config.timeColumnIndex < 0 || config.timeColumnIndex >= columnCount) {
+        result.errorMessage = "时间列索引无效";
+        return result;
+    }
+    if (config.pressureColumnIndex < 0 || config.pressureColumnIndex >= columnCount) {
+        result.errorMessage = "压力列索引无效";
+        return result;
+    }
+    bool hasRate = (config.rateColumnIndex >= 0 && config.rateColumnIndex < columnCount);
+
+    emit progressUpdated(10, "正在读取数据...");
+
+    // 时间戳列按相对首个有效时间的小时数参与识别（与经过时间列的换算一致）
+    QVector<double> elapsedHours;
+    if (model->columnStorage(config.timeColumnIndex) == ColumnStorage::Timestamp) {
+        QVector<qint64> msecs;
+        QVector<char> valid;
+        bool hasDate = false;
+        if (!ElapsedTimeFormula::absoluteMsecs(model, {config.timeColumnIndex}, msecs, valid,
+                                               hasDate, result.errorMessage)) {
+            return result;
+        }
+        elapsedHours = ElapsedTimeFormula::elapsedValues(msecs, valid, "h");
+    }
+
+    QVector<double> rateData;
+    result.timeData.reserve(rowCount);
+    result.pressureData.reserve(rowCount);
+    if (hasRate) rateData.reserve(rowCount);
+
+    for (int row = 0; row < rowCount; ++row) {
+        bool okT = false;
+        bool okP = false;
+        double t = 0.0;
+        if (elapsedHours.isEmpty()) {
+            t = model->value(row, config.timeColumnIndex, &okT);
+        } else {
+            t = elapsedHours[row];
+            okT = !std::isnan(t);
+        }
+        double p = model->value(row, config.pressureColumnIndex, &okP);
+        if (!okT || !okP) continue;
+
+        if (!result.timeData.isEmpty() && t < result.timeData.last()) {
+            result.errorMessage = QString("时间列必须单调递增（行 %1）").arg(row + 1);
+            return result;
+        }
+
+        result.timeData.append(t);
+        result.pressureData.append(p);
+        if (hasRate) {
+            rateData.append(model->value(row, config.rateColumnIndex));
+        }
+    }
+
+    int n = result.timeData.size();
+    if (n < qMax(config.minPeriodPoints, 3)) {
+        result.errorMessage = "有效数据点不足，无法划分流动段";
+        return result;
+    }
+
+    emit progressUpdated(40, "正在识别流动段...");
+
+    if (hasRate) {
+        PressureDerivativeCalculator::buildRateSteps(result.timeData, rateData, config.rateTolerance,
+                                                     result.stepTime, result.stepRate);
+    }
+
+    if (!result.stepTime.isEmpty()) {
+        result.periods = detectFromRate(result.timeData, result.pressureData, result.stepTime, result.stepRate);
+    } else {
+        result.periods = detectFromPressure(result.timeData, result.pressureData,
+                                            config.windowSize, config.threshold, config.minPeriodPoints);
+    }
+
+    emit progressUpdated(100, "识别完成");
+
+    result.success = !result.periods.isEmpty();
+    result.processedRows = n;
+    if (!result.success) {
+        result.errorMessage = "未识别到有效的流动段";
+    }
+    return result;
+}
+
+QVector<FlowPeriod> FlowPeriodDetector::detectFromRate(const QVector<double>& timeData,
+                                                       const QVector<double>& pressureData,
+                                                       const QVector<double>& stepTime,
+                                                       const QVector<double>& stepRate)
+{
+    QVector<FlowPeriod> periods;
+    int n = qMin(timeData.size(), pressureData.size());
+    int m = qMin(stepTime.size(), stepRate.size());
+    if (n == 0 || m == 0) return periods;
+
+    double maxRate = 0.0;
+    for (int j = 0; j < m; ++j) maxRate = qMax(maxRate, std::abs(stepRate[j]));
+    double zeroRate = 1e-9 * qMax(maxRate, 1e-300);
+
+    QVector<int> periodOf = PressureDerivativeCalculator::assignFlowPeriods(timeData, stepTime);
+
+    int i = 0;
+    while (i < n) {
+        int k = periodOf[i];
+        int end = i;
+        while (end + 1 < n && periodOf[end + 1] == k) ++end;
+
+        if (k >= 0) {
+            FlowPeriod period;
+            // 段起点前最后一个点作为参考压力点
+            period.startIndex = (i > 0) ? i - 1 : i;
+            period.endIndex = end;
+            period.startTime = stepTime[k];
+            period.endTime = timeData[end];
+            period.startPressure = pressureData[period.startIndex];
+            period.endPressure = pressureData[end];
+            period.rate = stepRate[k];
+
+            double previousRate = (k > 0) ? stepRate[k - 1] : 0.0;
+            if (std::abs(stepRate[k]) <= zeroRate) {
+                period.type = FlowPeriodType::Buildup;
+            } else if (std::abs(previousRate) <= zeroRate) {
+                period.type = FlowPeriodType::Drawdown;
+            } else {
+                period.type = FlowPeriodType::RateChange;
+            }
+            periods.append(period);
+        }
+
+        i = end + 1;
+    }
+
+    return periods;
+}
+
+QVector<FlowPeriod> FlowPeriodDetector::detectFromPressure(const QVector<double>& timeData,
+                                                           const QVector<double>& pressureData,
+                                                           int windowSize,
+                                                           double threshold,
+                                                           int minPeriodPoints)
+{
+    QVector<FlowPeriod> periods;
+    int n = qMin(timeData.size(), pressureData.size());
+    if (n < 3) return periods;
+
+    int w = qMax(windowSize, 2);
+    int minPoints = qMax(minPeriodPoints, 2 * w);
+
+    double pMin = pressureData[0];
+    double pMax = pressureData[0];
+    for (int i = 1; i < n; ++i) {
+        pMin = qMin(pMin, pressureData[i]);
+        pMax = qMax(pMax, pressureData[i]);
+    }
+    double pressureRange = pMax - pMin;
+
+    QVector<int> boundaries;
+    boundaries.append(0);
+
+    if (n > 2 * w + 2 && pressureRange > 0) {
+        // ---- 1. 变点得分：右窗口压力变化 与 按时长折算的左窗口变化 之差 ----
+        std::vector<double> score(n, 0.0);
+        for (int i = w; i < n - w; ++i) {
+            double dtL = timeData[i] - timeData[i - w];
+            double dtR = timeData[i + w] - timeData[i];
+            if (dtL <= 0 || dtR <= 0) continue;
+            double dpL = pressureData[i] - pressureData[i - w];
+            double dpR = pressureData[i + w] - pressureData[i];
+            score[i] = std::abs(dpR - dpL * dtR / dtL);
+        }
+
+        // ---- 2. 稳健阈值：中位数 + k·1.4826·MAD，O(n) ----
+        std::vector<double> work(score.begin() + w, score.end() - w);
+        double median = medianInPlace(work);
+        for (double& v : work) v = std::abs(v - median);
+        double mad = medianInPlace(work);
+        double cut = qMax(median + threshold * 1.4826 * mad, 1e-3 * pressureRange);
+
+        // ---- 3. 超阈值区间取局部极大值，再在窗口内按斜率突变定位 ----
+        int i = w;
+        while (i < n - w) {
+            if (score[i] <= cut) {
+                ++i;
+                continue;
+            }
+            int peak = i;
+            while (i < n - w && score[i] > cut) {
+                if (score[i] > score[peak]) peak = i;
+                ++i;
+            }
+
+            int best = peak;
+            double bestJump = -1.0;
+            for (int j = qMax(1, peak - w + 1); j <= qMin(n - 2, peak + w - 1); ++j) {
+                double jump = slopeJump(timeData, pressureData, j);
+                if (jump > bestJump) {
+                    bestJump = jump;
+                    best = j;
+                }
+            }
+
+            // 最短流动段约束
+            if (best - boundaries.last() >= minPoints && (n - 1) - best >= minPoints) {
+                boundaries.append(best);
+            }
+        }
+    }
+
+    boundaries.append(n - 1);
+
+    double tolerance = 1e-6 * qMax(pressureRange, 1e-300);
+    for (int b = 0; b + 1 < boundaries.size(); ++b) {
+        FlowPeriod period;
+        period.startIndex = boundaries[b];
+        period.endIndex = boundaries[b + 1];
+        period.startTime = timeData[period.startIndex];
+        period.endTime = timeData[period.endIndex];
+        period.startPressure = pressureData[period.startIndex];
+        period.endPressure = pressureData[period.endIndex];
+        period.type = classifyByPressure(pressureData, period.startIndex, period.endIndex, w, tolerance);
+        periods.append(period);
+    }
+
+    return periods;
+}
+
+bool FlowPeriodDetector::extractPeriod(const FlowPeriodDetectionResult& detection, int periodIndex,
+                                       QVector<double>& deltaTime,
+                                       QVector<double>& deltaPressure,
+                                       QVector<double>& derivative)
+{
+    deltaTime.clear();
+    deltaPressure.clear();
+    derivative.clear();
+
+    if (periodIndex < 0 || periodIndex >= detection.periods.size()) return false;
+
+    const FlowPeriod& period = detection.periods[periodIndex];
+    int count = period.endIndex - period.startIndex + 1;
+    QVector<double> segTime = detection.timeData.mid(period.startIndex, count);
+    QVector<double> segPressure = detection.pressureData.mid(period.startIndex, count);
+
+    QVector<double> segDerivative;
+    if (!detection.stepTime.isEmpty()) {
+        // 已知流量历史：对叠加时间求导
+        segDerivative = PressureDerivativeCalculator::calculateDerivativeWithTimeAxis(
+            segTime, segPressure, detection.stepTime, detection.stepRate,
+            DerivativeTimeAxis::Superposition, 0.15);
+    }
+
+    for (int i = 0; i < segTime.size(); ++i) {
+        double dt = segTime[i] - period.startTime;
+        if (dt <= 0) continue;
+        deltaTime.append(dt);
+        deltaPressure.append(std::abs(segPressure[i] - period.startPressure));
+        if (!segDerivative.isEmpty()) derivative.append(segDerivative[i]);
+    }
+
+    if (segDerivative.isEmpty()) {
+        derivative = PressureDerivativeCalculator::calculateBourdetDerivative(deltaTime, deltaPressure, 0.15);
+    }
+
+    return deltaTime.size() >= 3;
+}
+
+QString FlowPeriodDetector::periodTypeName(FlowPeriodType type)
+{
+    switch (type) {
+    case FlowPeriodType::Drawdown:
+        return "压降";
+    case FlowPeriodType::Buildup:
+        return "压力恢复";
+    case FlowPeriodType::RateChange:
+        return "变产量";
+    case FlowPeriodType::Unknown:
+    default:
+        return "未知";
+    }
+}
+
+// ============================================================================
+// FlowPeriodDialog
+// ============================================================================
+
+FlowPeriodDialog::FlowPeriodDialog(const FlowPeriodDetectionResult& detection, const QString& timeUnit,
+                                   const QString& pressureUnit, QWidget* parent)
+    : QDialog(parent), m_periods(detection.periods)
+{
+    setupUI(timeUnit, pressureUnit);
+    m_summaryLabel->setText(QString("共识别 %1 个流动段（%2 个数据点，%3）")
+                                .arg(m_periods.size())
+                                .arg(detection.processedRows)
+                                .arg(detection.stepTime.isEmpty() ? "依据压力变点" : "依据流量历史"));
+}
+
+void FlowPeriodDialog::setupUI(const QString& timeUnit, const QString& pressureUnit)
+{
+    setWindowTitle("流动段识别");
+    setModal(true);
+    resize(820, 480);
+
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+
+    m_summaryLabel = new QLabel;
+    m_summaryLabel->setStyleSheet("font-size: 14px; font-weight: bold; color: #2c3e50; margin: 6px;");
+    mainLayout->addWidget(m_summaryLabel);
+
+    QStringList headers;
+    headers << "序号" << "类型"
+            << QString("开始时间(%1)").arg(timeUnit) << QString("结束时间(%1)").arg(timeUnit)
+            << QString("持续时间(%1)").arg(timeUnit) << "点数"
+            << QString("起始压力(%1)").arg(pressureUnit) << QString("结束压力(%1)").arg(pressureUnit)
+            << "流量";
+
+    m_periodTable = new QTableWidget(m_periods.size(), headers.size(), this);
+    m_periodTable->setHorizontalHeaderLabels(headers);
+    m_periodTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_periodTable->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_periodTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_periodTable->verticalHeader()->setVisible(false);
+    m_periodTable->setAlternatingRowColors(true);
+
+    for (int row = 0; row < m_periods.size(); ++row) {
+        const FlowPeriod& period = m_periods[row];
+        QStringList values;
+        values << QString::number(row + 1)
+               << FlowPeriodDetector::periodTypeName(period.type)
+               << QString::number(period.startTime, 'g', 8)
+               << QString::number(period.endTime, 'g', 8)
+               << QString::number(period.endTime - period.startTime, 'g', 6)
+               << QString::number(period.pointCount())
+               << QString::number(period.startPressure, 'g', 8)
+               << QString::number(period.endPressure, 'g', 8)
+               << QString::number(period.rate, 'g', 6);
+        for (int col = 0; col < values.size(); ++col) {
+            QTableWidgetItem* item = new QTableWidgetItem(values[col]);
+            item->setTextAlignment(Qt::AlignCenter);
+            if (col == 1) {
+                item->setForeground(QBrush(period.type == FlowPeriodType::Buildup ? QColor("#1565C0")
+                                                                                   : QColor("#C62828")));
+            }
+            m_periodTable->setItem(row, col, item);
+        }
+    }
+    m_periodTable->resizeColumnsToContents();
+    mainLayout->addWidget(m_periodTable);
+
+    QHBoxLayout* buttonLayout = new QHBoxLayout;
+    m_extractButton = new QPushButton("📤 提取到拟合");
+    m_extractButton->setEnabled(false);
+    m_extractButton->setToolTip("将选中流动段作为新的拟合分析（Δt、Δp 及导数）");
+    QPushButton* closeButton = new QPushButton("关闭");
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(m_extractButton);
+    buttonLayout->addWidget(closeButton);
+    mainLayout->addLayout(buttonLayout);
+
+    connect(m_periodTable, &QTableWidget::itemSelectionChanged, this, &FlowPeriodDialog::onSelectionChanged);
+    connect(m_periodTable, &QTableWidget::cellDoubleClicked, this, &FlowPeriodDialog::onExtractClicked);
+    connect(m_extractButton, &QPushButton::clicked, this, &FlowPeriodDialog::onExtractClicked);
+    connect(closeButton, &QPushButton::clicked, this, &QDialog::accept);
+}
+
+void FlowPeriodDialog::onSelectionChanged()
+{
+    m_extractButton->setEnabled(m_periodTable->currentRow() >= 0);
+}
+
+void FlowPeriodDialog::onExtractClicked()
+{
+    int row = m_periodTable->currentRow();
+    if (row >= 0 && row < m_periods.size()) {
+        emit extractRequested(row);
+    }
+}
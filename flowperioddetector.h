@@ -0,0 +1,168 @@
+#ifndef FLOWPERIODDETECTOR_H
+#define FLOWPERIODDETECTOR_H
+
+#include <QObject>
+#include <QDialog>
+#include <QString>
+#include <QVector>
+#include "datatablemodel.h"
+#include <QTableWidget>
+#include <QPushButton>
+#include <QLabel>
+
+// 流动段类型
+enum class FlowPeriodType {
+    Drawdown,    // 压降（开井生产）
+    Buildup,     // 压力恢复（关井）
+    RateChange,  // 变产量
+    Unknown      // 无法判断
+};
+
+// 单个流动段
+struct FlowPeriod {
+    int startIndex;         // 起始点（含，即流动段起点处的参考压力点）
+    int endIndex;           // 结束点（含）
+    double startTime;
+    double endTime;
+    double startPressure;
+    double endPressure;
+    double rate;            // 段内流量（无流量列时为 0）
+    FlowPeriodType type;
+
+    FlowPeriod() :
+        startIndex(-1),
+        endIndex(-1),
+        startTime(0.0),
+        endTime(0.0),
+        startPressure(0.0),
+        endPressure(0.0),
+        rate(0.0),
+        type(FlowPeriodType::Unknown) {}
+
+    int pointCount() const { return endIndex - startIndex + 1; }
+};
+
+// 流动段识别配置
+struct FlowPeriodDetectionConfig {
+    int timeColumnIndex;      // 时间列索引
+    int pressureColumnIndex;  // 压力列索引
+    int rateColumnIndex;      // 流量列索引（-1 表示仅用压力识别）
+    int windowSize;           // 斜率比较窗口（采样点数）
+    double threshold;         // 突变阈值（稳健标准差的倍数）
+    int minPeriodPoints;      // 最短流动段点数
+    double rateTolerance;     // 流量台阶合并阈值（相对最大流量）
+
+    FlowPeriodDetectionConfig() :
+        timeColumnIndex(-1),
+        pressureColumnIndex(-1),
+        rateColumnIndex(-1),
+        windowSize(10),
+        threshold(8.0),
+        minPeriodPoints(20),
+        rateTolerance(0.01) {}
+};
+
+// 流动段识别结果
+struct FlowPeriodDetectionResult {
+    bool success;
+    QString errorMessage;
+    int processedRows;
+    QVector<FlowPeriod> periods;
+
+    // 识别所用的原始序列（提取流动段时复用，避免再次解析表格）
+    QVector<double> timeData;   // 时间戳列换算为相对首个有效时间的小时数
+    QVector<double> pressureData;
+    QVector<double> stepTime;   // 流量台阶（仅流量列识别时非空）
+    QVector<double> stepRate;
+
+    FlowPeriodDetectionResult() :
+        success(false),
+        processedRows(0) {}
+};
+
+/**
+ * @brief 流动段（开井/关井）自动划分
+ *
+ * 有流量列时直接由阶梯流量历史划分；仅有压力时在压力序列上做变点检测：
+ * 用前缀窗口比较每点左右两侧的压力变化量，以中位数/MAD 估计噪声水平，
+ * 超过阈值的局部极大值即为流动段边界，再在窗口内按二阶差分精确定位。
+ * 全部步骤 O(n)（中位数使用 nth_element），适用于百万级监测数据。
+ */
+class FlowPeriodDetector : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FlowPeriodDetector(QObject *parent = nullptr);
+    ~FlowPeriodDetector();
+
+    /**
+     * @brief 对表格模型识别流动段
+     */
+    FlowPeriodDetectionResult detect(DataTableModel* model, const FlowPeriodDetectionConfig& config);
+
+    // =========================================================================
+    // 静态核心算法接口
+    // =========================================================================
+
+    /**
+     * @brief 由流量历史划分流动段
+     */
+    static QVector<FlowPeriod> detectFromRate(const QVector<double>& timeData,
+                                              const QVector<double>& pressureData,
+                                              const QVector<double>& stepTime,
+                                              const QVector<double>& stepRate);
+
+    /**
+     * @brief 仅由压力序列进行变点检测划分流动段
+     */
+    static QVector<FlowPeriod> detectFromPressure(const QVector<double>& timeData,
+                                                  const QVector<double>& pressureData,
+                                                  int windowSize,
+                                                  double threshold,
+                                                  int minPeriodPoints);
+
+    /**
+     * @brief 提取流动段为拟合用数据：Δt、|Δp| 及 Bourdet 导数
+     *
+     * 提供流量历史时对叠加时间求导，否则对段内经过时间求导。
+     */
+    static bool extractPeriod(const FlowPeriodDetectionResult& detection, int periodIndex,
+                              QVector<double>& deltaTime,
+                              QVector<double>& deltaPressure,
+                              QVector<double>& derivative);
+
+    static QString periodTypeName(FlowPeriodType type);
+
+signals:
+    void progressUpdated(int progress, const QString& message);
+};
+
+/**
+ * @brief 流动段列表对话框：显示识别结果，可一键提取到拟合页
+ */
+class FlowPeriodDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit FlowPeriodDialog(const FlowPeriodDetectionResult& detection, const QString& timeUnit,
+                              const QString& pressureUnit, QWidget* parent = nullptr);
+
+signals:
+    void extractRequested(int periodIndex);
+
+private slots:
+    void onExtractClicked();
+    void onSelectionChanged();
+
+private:
+    void setupUI(const QString& timeUnit, const QString& pressureUnit);
+
+    QVector<FlowPeriod> m_periods;
+    QTableWidget* m_periodTable;
+    QPushButton* m_extractButton;
+    QLabel* m_summaryLabel;
+};
+
+#endif // FLOWPERIODDETECTOR_H
@@ -0,0 +1,393 @@
+#include "flowregimeidentifier.h"
+#include <cmath>
+#include <algorithm>
+
+// ============================================================================
+// 内部辅助函数
+// ============================================================================
+
+namespace {
+
+// 分箱数上限（极宽时间跨度时自动放宽箱宽）
+const int kMaxBins = 20000;
+
+// 按 log10(t) 等宽分箱，输出非空箱的均值
+// logValues 为 true 时对数值取 log10（非正值忽略），否则直接平均原值
+int buildLogBins(const QVector<double>& timeData, const QVector<double>& values, double binWidth,
+                 bool logValues, QVector<double>& binX, QVector<double>& binY, QVector<int>& binCount)
+{
+    binX.clear();
+    binY.clear();
+    binCount.clear();
+
+    int n = qMin(timeData.size(), values.size());
+    auto valid = [&](int i) {
+        return timeData[i] > 0 && std::isfinite(timeData[i]) && std::isfinite(values[i]) &&
+               (!logValues || values[i] > 0);
+    };
+
+    double xMin = 0.0;
+    double xMax = 0.0;
+    int used = 0;
+    for (int i = 0; i < n; ++i) {
+        if (!valid(i)) continue;
+        double x = std::log10(timeData[i]);
+        if (used == 0) {
+            xMin = xMax = x;
+        } else {
+            xMin = qMin(xMin, x);
+            xMax = qMax(xMax, x);
+        }
+        ++used;
+    }
+    if (used == 0) return 0;
+
+    double width = qMax(binWidth, 1e-6);
+    if ((xMax - xMin) / width > kMaxBins) width = (xMax - xMin) / kMaxBins;
+    int nb = static_cast<int>((xMax - xMin) / width) + 1;
+
+    std::vector<double> sumX(nb, 0.0);
+    std::vector<double> sumY(nb, 0.0);
+    std::vector<int> count(nb, 0);
+    for (int i = 0; i < n; ++i) {
+        if (!valid(i)) continue;
+        double x = std::log10(timeData[i]);
+        int b = qMin(nb - 1, static_cast<int>((x - xMin) / width));
+        sumX[b] += x;
+        sumY[b] += logValues ? std::log10(values[i]) : values[i];
+        ++count[b];
+    }
+
+    for (int b = 0; b < nb; ++b) {
+        if (count[b] == 0) continue;
+        binX.append(sumX[b] / count[b]);
+        binY.append(sumY[b] / count[b]);
+        binCount.append(count[b]);
+    }
+    return used;
+}
+
+// 滑动窗口最小二乘局部斜率（前缀和 + 双指针，O(B)）
+QVector<double> localSlopes(const QVector<double>& x, const QVector<double>& y, double halfWindow)
+{
+    int count = x.size();
+    QVector<double> slopes(count, 0.0);
+    if (count < 2) return slopes;
+
+    double x0 = x[0];
+    std::vector<double> sx(count + 1, 0.0), sy(count + 1, 0.0), sxx(count + 1, 0.0), sxy(count + 1, 0.0);
+    for (int i = 0; i < count; ++i) {
+        double dx = x[i] - x0;
+        sx[i + 1] = sx[i] + dx;
+        sy[i + 1] = sy[i] + y[i];
+        sxx[i + 1] = sxx[i] + dx * dx;
+        sxy[i + 1] = sxy[i] + dx * y[i];
+    }
+
+    int lo = 0;
+    int hi = 0;
+    for (int j = 0; j < count; ++j) {
+        while (x[lo] < x[j] - halfWindow) ++lo;
+        if (hi < j) hi = j;
+        while (hi + 1 < count && x[hi + 1] <= x[j] + halfWindow) ++hi;
+
+        // 窗口内不足 3 个箱时向两侧各补一个
+        int a = lo;
+        int b = hi;
+        if (b - a < 2) {
+            a = qMax(0, a - 1);
+            b = qMin(count - 1, b + 1);
+        }
+
+        double m = b - a + 1;
+        double Sx = sx[b + 1] - sx[a];
+        double Sy = sy[b + 1] - sy[a];
+        double Sxx = sxx[b + 1] - sxx[a];
+        double Sxy = sxy[b + 1] - sxy[a];
+        double den = m * Sxx - Sx * Sx;
+        slopes[j] = (std::abs(den) > 1e-300) ? (m * Sxy - Sx * Sy) / den : 0.0;
+    }
+    return slopes;
+}
+
+// 按局部斜率归类
+FlowRegimeType classifySlope(double slope, double tolerance)
+{
+    if (slope < -1.0) return FlowRegimeType::ConstantPressureBoundary;
+
+    static const struct { double slope; FlowRegimeType type; } targets[] = {
+        { 1.0,  FlowRegimeType::WellboreStorage },
+        { 0.5,  FlowRegimeType::Linear },
+        { 0.25, FlowRegimeType::Bilinear },
+        { 0.0,  FlowRegimeType::Radial },
+        { -0.5, FlowRegimeType::Spherical },
+    };
+
+    FlowRegimeType best = FlowRegimeType::Transition;
+    double bestDiff = tolerance;
+    for (const auto& target : targets) {
+        double diff = std::abs(slope - target.slope);
+        if (diff <= bestDiff) {
+            bestDiff = diff;
+            best = target.type;
+        }
+    }
+    return best;
+}
+
+bool isReservoirFlow(FlowRegimeType type)
+{
+    return type == FlowRegimeType::Bilinear || type == FlowRegimeType::Linear ||
+           type == FlowRegimeType::Radial || type == FlowRegimeType::Spherical;
+}
+
+struct BinRun {
+    FlowRegimeType type;
+    int first;
+    int last;
+};
+
+void mergeEqualRuns(QVector<BinRun>& runs)
+{
+    QVector<BinRun> merged;
+    for (const BinRun& run : runs) {
+        if (!merged.isEmpty() && merged.last().type == run.type) {
+            merged.last().last = run.last;
+        } else {
+            merged.append(run);
+        }
+    }
+    runs = merged;
+}
+
+} // namespace
+
+// ============================================================================
+// FlowRegimeSegment / FlowRegimeResult
+// ============================================================================
+
+double FlowRegimeSegment::derivativeAt(double t) const
+{
+    if (t <= 0) return 0.0;
+    return std::pow(10.0, intercept + slope * std::log10(t));
+}
+
+bool FlowRegimeResult::hasRegime(FlowRegimeType type) const
+{
+    for (const FlowRegimeSegment& segment : segments) {
+        if (segment.type == type) return true;
+    }
+    return false;
+}
+
+// ============================================================================
+// FlowRegimeIdentifier
+// ============================================================================
+
+FlowRegimeResult FlowRegimeIdentifier::identifyFromDerivative(const QVector<double>& timeData,
+                                                              const QVector<double>& derivativeData,
+                                                              const FlowRegimeConfig& config)
+{
+    QVector<double> binX, binY;
+    QVector<int> binCount;
+    int used = buildLogBins(timeData, derivativeData, config.binWidth, true, binX, binY, binCount);
+
+    FlowRegimeResult result = segmentLogLog(binX, binY, binCount, config);
+    result.processedRows = used;
+    return result;
+}
+
+FlowRegimeResult FlowRegimeIdentifier::identifyFromPressure(const QVector<double>& timeData,
+                                                            const QVector<double>& pressureDropData,
+                                                            const FlowRegimeConfig& config)
+{
+    QVector<double> binX, binP;
+    QVector<int> binCount;
+    int used = buildLogBins(timeData, pressureDropData, config.binWidth, false, binX, binP, binCount);
+
+    // 分箱压差对 log10(t) 的局部斜率 / ln(10) 即 dΔp/dln(t)
+    double derivativeWindow = qMax(2.0 * config.binWidth, 0.1);
+    QVector<double> slopes = localSlopes(binX, binP, derivativeWindow);
+
+    // 直接给出压力（压降时递减）时按整体趋势取号
+    double sign = (!binP.isEmpty() && binP.last() < binP.first()) ? -1.0 : 1.0;
+
+    QVector<double> derivX, derivY;
+    QVector<int> derivCount;
+    for (int j = 0; j < binX.size(); ++j) {
+        double derivative = sign * slopes[j] / std::log(10.0);
+        if (derivative <= 0) continue;
+        derivX.append(binX[j]);
+        derivY.append(std::log10(derivative));
+        derivCount.append(binCount[j]);
+    }
+
+    FlowRegimeResult result = segmentLogLog(derivX, derivY, derivCount, config);
+    result.processedRows = used;
+    return result;
+}
+
+FlowRegimeResult FlowRegimeIdentifier::segmentLogLog(const QVector<double>& binX,
+                                                     const QVector<double>& binY,
+                                                     const QVector<int>& binCount,
+                                                     const FlowRegimeConfig& config)
+{
+    FlowRegimeResult result;
+    int count = binX.size();
+    if (count < 5) {
+        result.errorMessage = "有效数据点不足（导数需为正且跨越足够的对数时间范围）";
+        return result;
+    }
+
+    QVector<double> slopes = localSlopes(binX, binY, config.slopeHalfWindow);
+
+    // ---- 1. 逐箱归类并合并为连续段 ----
+    QVector<BinRun> runs;
+    for (int j = 0; j < count; ++j) {
+        FlowRegimeType type = classifySlope(slopes[j], config.slopeTolerance);
+        if (!runs.isEmpty() && runs.last().type == type) {
+            runs.last().last = j;
+        } else {
+            runs.append({type, j, j});
+        }
+    }
+
+    // ---- 2. 跨度过短、或斜率在段内单调扫过整个容差带（过渡曲线途经）的段视为过渡段 ----
+    for (BinRun& run : runs) {
+        if (run.type == FlowRegimeType::Transition) continue;
+        double span = binX[run.last] - binX[run.first] + config.binWidth;
+        double sweep = std::abs(slopes[run.last] - slopes[run.first]);
+        if (span < config.minSegmentDecades || sweep > 1.5 * config.slopeTolerance) {
+            run.type = FlowRegimeType::Transition;
+        }
+    }
+    mergeEqualRuns(runs);
+
+    // ---- 3. 按出现先后修正：晚期单位斜率为拟稳态，井储后的下降为驼峰过渡 ----
+    bool seenReservoirFlow = false;
+    int firstFlowBin = count;
+    for (BinRun& run : runs) {
+        if (run.type == FlowRegimeType::WellboreStorage && seenReservoirFlow) {
+            run.type = FlowRegimeType::ClosedBoundary;
+        } else if (!seenReservoirFlow && (run.type == FlowRegimeType::Spherical ||
+                                          run.type == FlowRegimeType::ConstantPressureBoundary)) {
+            run.type = FlowRegimeType::Transition;
+        }
+        if (isReservoirFlow(run.type) && !seenReservoirFlow) {
+            seenReservoirFlow = true;
+            firstFlowBin = run.first;
+        }
+    }
+    mergeEqualRuns(runs);
+
+    // ---- 4. 各段最小二乘拟合 ----
+    double longestRadial = 0.0;
+    for (const BinRun& run : runs) {
+        FlowRegimeSegment segment;
+        segment.type = run.type;
+        segment.startTime = std::pow(10.0, binX[run.first]);
+        segment.endTime = std::pow(10.0, binX[run.last]);
+
+        double m = 0, Sx = 0, Sy = 0, Sxx = 0, Sxy = 0;
+        for (int j = run.first; j <= run.last; ++j) {
+            double dx = binX[j] - binX[run.first];
+            m += 1.0;
+            Sx += dx;
+            Sy += binY[j];
+            Sxx += dx * dx;
+            Sxy += dx * binY[j];
+            segment.pointCount += binCount[j];
+        }
+        double den = m * Sxx - Sx * Sx;
+        segment.slope = (std::abs(den) > 1e-300) ? (m * Sxy - Sx * Sy) / den : slopes[run.first];
+        double meanY = Sy / m;
+        double meanX = Sx / m + binX[run.first];
+        segment.intercept = meanY - segment.slope * meanX;
+
+        if (segment.type == FlowRegimeType::Radial) {
+            double span = binX[run.last] - binX[run.first];
+            if (span >= longestRadial) {
+                longestRadial = span;
+                result.radialDerivativeLevel = std::pow(10.0, meanY);
+            }
+        }
+
+        result.segments.append(segment);
+    }
+
+    result.maxEarlySlope = slopes[0];
+    for (int j = 1; j < qMin(firstFlowBin, count); ++j) {
+        result.maxEarlySlope = qMax(result.maxEarlySlope, slopes[j]);
+    }
+
+    result.binTime.reserve(count);
+    result.binDerivative.reserve(count);
+    for (int j = 0; j < count; ++j) {
+        result.binTime.append(std::pow(10.0, binX[j]));
+        result.binDerivative.append(std::pow(10.0, binY[j]));
+    }
+    result.binSlope = slopes;
+    result.success = true;
+    return result;
+}
+
+int FlowRegimeIdentifier::recommendModelIndex(const FlowRegimeResult& result)
+{
+    // 0: 无限大  1: 封闭边界  2: 定压边界
+    int boundary = 0;
+    if (result.hasRegime(FlowRegimeType::ClosedBoundary)) {
+        boundary = 1;
+    } else if (result.hasRegime(FlowRegimeType::ConstantPressureBoundary)) {
+        boundary = 2;
+    }
+
+    // 早期斜率明显大于 1（导数陡升/驼峰）提示变井储
+    bool variableStorage = result.maxEarlySlope > 1.3;
+    return boundary * 2 + (variableStorage ? 0 : 1);
+}
+
+QString FlowRegimeIdentifier::regimeName(FlowRegimeType type)
+{
+    switch (type) {
+    case FlowRegimeType::WellboreStorage:
+        return "井储";
+    case FlowRegimeType::Bilinear:
+        return "双线性流";
+    case FlowRegimeType::Linear:
+        return "线性流";
+    case FlowRegimeType::Radial:
+        return "径向流";
+    case FlowRegimeType::Spherical:
+        return "球形流";
+    case FlowRegimeType::ClosedBoundary:
+        return "封闭边界";
+    case FlowRegimeType::ConstantPressureBoundary:
+        return "定压边界";
+    case FlowRegimeType::Transition:
+    default:
+        return "过渡段";
+    }
+}
+
+QColor FlowRegimeIdentifier::regimeColor(FlowRegimeType type)
+{
+    switch (type) {
+    case FlowRegimeType::WellboreStorage:
+        return QColor("#6D4C41");
+    case FlowRegimeType::Bilinear:
+        return QColor("#8E24AA");
+    case FlowRegimeType::Linear:
+        return QColor("#1E88E5");
+    case FlowRegimeType::Radial:
+        return QColor("#43A047");
+    case FlowRegimeType::Spherical:
+        return QColor("#FB8C00");
+    case FlowRegimeType::ClosedBoundary:
+        return QColor("#E53935");
+    case FlowRegimeType::ConstantPressureBoundary:
+        return QColor("#00ACC1");
+    case FlowRegimeType::Transition:
+    default:
+        return QColor("#9E9E9E");
+    }
+}
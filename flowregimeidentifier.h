@@ -0,0 +1,123 @@
+#ifndef FLOWREGIMEIDENTIFIER_H
+#define FLOWREGIMEIDENTIFIER_H
+
+#include <QString>
+#include <QVector>
+#include <QColor>
+
+// 流态类型（双对数导数曲线特征斜率）
+enum class FlowRegimeType {
+    WellboreStorage,          // 井筒储集（早期单位斜率）
+    Bilinear,                 // 双线性流（1/4 斜率）
+    Linear,                   // 线性流（1/2 斜率）
+    Radial,                   // 径向流（水平导数）
+    Spherical,                // 球形流（-1/2 斜率）
+    ClosedBoundary,           // 封闭边界拟稳态（晚期单位斜率）
+    ConstantPressureBoundary, // 定压边界（晚期导数快速下降）
+    Transition                // 过渡段
+};
+
+// 识别得到的单个流态段
+struct FlowRegimeSegment {
+    FlowRegimeType type;
+    double startTime;
+    double endTime;
+    double slope;       // log(导数)-log(t) 拟合斜率
+    double intercept;   // log10(导数) 在 t=1 处的截距
+    int pointCount;     // 段内原始数据点数
+
+    FlowRegimeSegment() :
+        type(FlowRegimeType::Transition),
+        startTime(0.0),
+        endTime(0.0),
+        slope(0.0),
+        intercept(0.0),
+        pointCount(0) {}
+
+    // 段内任意时刻的拟合导数值
+    double derivativeAt(double t) const;
+};
+
+// 流态识别配置
+struct FlowRegimeConfig {
+    double binWidth;           // 对数时间分箱宽度（十进制对数周期）
+    double slopeHalfWindow;    // 局部斜率拟合半窗口（对数周期）
+    double slopeTolerance;     // 与特征斜率的允许偏差
+    double minSegmentDecades;  // 有效流态段最短跨度（对数周期）
+
+    FlowRegimeConfig() :
+        binWidth(0.05),
+        slopeHalfWindow(0.25),
+        slopeTolerance(0.1),
+        minSegmentDecades(0.5) {}
+};
+
+// 流态识别结果
+struct FlowRegimeResult {
+    bool success;
+    QString errorMessage;
+    int processedRows;
+
+    QVector<FlowRegimeSegment> segments;
+
+    // 分箱后的导数曲线（用于叠加显示）及各箱局部斜率
+    QVector<double> binTime;
+    QVector<double> binDerivative;
+    QVector<double> binSlope;
+
+    double radialDerivativeLevel;  // 最长径向流段的导数平台值（无径向流时为 0）
+    double maxEarlySlope;          // 首个流态出现前的最大局部斜率（>1 提示变井储）
+
+    FlowRegimeResult() :
+        success(false),
+        processedRows(0),
+        radialDerivativeLevel(0.0),
+        maxEarlySlope(0.0) {}
+
+    bool hasRegime(FlowRegimeType type) const;
+};
+
+/**
+ * @brief 双对数导数曲线流态自动识别
+ *
+ * 先按 log(t) 等宽分箱把 n 个点压缩为数百个箱（O(n)），在箱序列上用前缀和做
+ * 滑动窗口最小二乘求局部斜率，按特征斜率（1、1/2、1/4、0、-1/2）归类并合并为
+ * 分段线性的流态段；晚期单位斜率判为封闭边界，晚期陡降判为定压边界。
+ * 总代价 O(n + 箱数)，10⁵ 点数据可即时完成。
+ */
+class FlowRegimeIdentifier
+{
+public:
+    /**
+     * @brief 由压力导数曲线识别流态
+     * @param timeData 时间（无需排序，非正值忽略）
+     * @param derivativeData 压力导数（非正值忽略）
+     */
+    static FlowRegimeResult identifyFromDerivative(const QVector<double>& timeData,
+                                                   const QVector<double>& derivativeData,
+                                                   const FlowRegimeConfig& config = FlowRegimeConfig());
+
+    /**
+     * @brief 由压差曲线识别流态（在分箱上直接求 dΔp/dln(t)，不做逐点 Bourdet 求导）
+     */
+    static FlowRegimeResult identifyFromPressure(const QVector<double>& timeData,
+                                                 const QVector<double>& pressureDropData,
+                                                 const FlowRegimeConfig& config = FlowRegimeConfig());
+
+    /**
+     * @brief 按识别结果推荐理论模型
+     * @return 与 ModelWidget01_06::ModelType 一致的序号：边界类型×2 + (恒定井储 ? 1 : 0)
+     */
+    static int recommendModelIndex(const FlowRegimeResult& result);
+
+    static QString regimeName(FlowRegimeType type);
+    static QColor regimeColor(FlowRegimeType type);
+
+private:
+    static FlowRegimeResult segmentLogLog(const QVector<double>& binX,
+                                          const QVector<double>& binY,
+                                          const QVector<int>& binCount,
+                                          const FlowRegimeConfig& config);
+};
+
+#endif // FLOWREGIMEIDENTIFIER_H
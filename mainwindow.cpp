@@ -9,11 +9,11 @@
 #include "wt_fittingwidget.h"
 #include "settingswidget.h"
 #include "modelparameter.h"
+#include "autosaveservice.h"
 
 #include <QDateTime>
 #include <QMessageBox>
 #include <QDebug>
-#include <QStandardItemModel>
 #include <QTimer>
 #include <QSpacerItem>
 #include <QStackedWidget>
@@ -23,6 +23,7 @@
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
+    , m_AutoSaveService(nullptr)
     , m_isProjectLoaded(false)
 {
     ui->setupUi(this);
@@ -124,6 +125,7 @@ void MainWindow::init()
     ui->verticalLayoutHandle->addWidget(m_DataEditorWidget);
     connect(m_DataEditorWidget, &DataEditorWidget::fileChanged, this, &MainWindow::onFileLoaded);
     connect(m_DataEditorWidget, &DataEditorWidget::dataChanged, this, &MainWindow::onDataEditorDataChanged);
+    connect(m_DataEditorWidget, &DataEditorWidget::analysisDataExtracted, this, &MainWindow::onAnalysisDataExtracted);
 
     // 3.3 模型管理器
     m_ModelManager = new ModelManager(this);
@@ -158,6 +160,15 @@ void MainWindow::init()
     connect(m_SettingsWidget, &SettingsWidget::backupSettingsChanged,
             this, &MainWindow::onBackupSettingsChanged);
 
+    // 3.7 自动保存与备份
+    m_AutoSaveService = new AutoSaveService(this);
+    connect(m_AutoSaveService, &AutoSaveService::autoSaveDue, this, &MainWindow::onAutoSaveDue);
+    connect(m_AutoSaveService, &AutoSaveService::backupFinished, this, &MainWindow::onBackupFinished);
+    // 备份任务读取项目数据容器，切换或关闭项目前等待其写完
+    connect(ModelParameter::instance(), &ModelParameter::projectAboutToChange,
+            m_AutoSaveService, &AutoSaveService::waitForFinished);
+    applyAutoSaveSettings();
+
     initProjectForm(); // [修改]
     initDataEditorForm();
     initModelForm();
@@ -224,6 +235,11 @@ void MainWindow::onPlotAnalysisCompleted(const QString &analysisType, const QMap
 
 void MainWindow::onDataReadyForPlotting()
 {
+    // 数据编辑器在后台加载文件，完成后再传递
+    if (m_DataEditorWidget && m_DataEditorWidget->isLoading()) {
+        QTimer::singleShot(500, this, &MainWindow::onDataReadyForPlotting);
+        return;
+    }
     transferDataFromEditorToPlotting();
 }
 
@@ -250,7 +266,7 @@ void MainWindow::transferDataToFitting()
 {
     if (!m_FittingPage || !m_DataEditorWidget) return;
 
-    QStandardItemModel* model = m_DataEditorWidget->getDataModel();
+    DataTableModel* model = m_DataEditorWidget->getDataModel();
     if (!model || model->rowCount() == 0) {
         return;
     }
@@ -259,19 +275,16 @@ void MainWindow::transferDataToFitting()
     double p_initial = 0.0;
 
     for(int r=0; r<model->rowCount(); ++r) {
-        QModelIndex idx = model->index(r, 1);
-        if(idx.isValid()) {
-            double p = idx.data().toDouble();
-            if (std::abs(p) > 1e-6) {
-                p_initial = p;
-                break;
-            }
+        double p = model->value(r, 1);
+        if (std::abs(p) > 1e-6) {
+            p_initial = p;
+            break;
         }
     }
 
     for(int r=0; r<model->rowCount(); ++r) {
-        double t = model->index(r, 0).data().toDouble();
-        double p_raw = model->index(r, 1).data().toDouble();
+        double t = model->value(r, 0);
+        double p_raw = model->value(r, 1);
         if (t > 0) {
             tVec.append(t);
             pVec.append(std::abs(p_raw - p_initial));
@@ -308,12 +321,55 @@ void MainWindow::onFittingProgressChanged(int progress)
     }
 }
 
-void MainWindow::onSystemSettingsChanged() {}
-void MainWindow::onAutoSaveIntervalChanged(int interval) { Q_UNUSED(interval); }
-void MainWindow::onBackupSettingsChanged(bool enabled) { Q_UNUSED(enabled); }
+void MainWindow::onSystemSettingsChanged() { applyAutoSaveSettings(); }
+void MainWindow::onAutoSaveIntervalChanged(int interval) { Q_UNUSED(interval); applyAutoSaveSettings(); }
+void MainWindow::onBackupSettingsChanged(bool enabled) { Q_UNUSED(enabled); applyAutoSaveSettings(); }
 void MainWindow::onPerformanceSettingsChanged() {}
 
-QStandardItemModel* MainWindow::getDataEditorModel() const
+void MainWindow::applyAutoSaveSettings()
+{
+    if (!m_AutoSaveService || !m_SettingsWidget) return;
+
+    AutoSaveConfig config;
+    config.intervalMinutes = m_SettingsWidget->getAutoSaveInterval();
+    config.backupEnabled = m_SettingsWidget->isBackupEnabled();
+    config.maxBackups = m_SettingsWidget->getMaxBackups();
+    config.backupPath = m_SettingsWidget->getCurrentBackupPath();
+    m_AutoSaveService->setConfig(config);
+}
+
+void MainWindow::onAutoSaveDue()
+{
+    ModelParameter* project = ModelParameter::instance();
+    if (!m_isProjectLoaded || !project->hasLoadedProject()) return;
+
+    // 1. 项目增量保存：只有变化的部分写入日志，写盘在后台完成
+    if (m_FittingPage) m_FittingPage->saveAllFittingStates();
+    project->saveProject();
+
+    // 2. 备份：界面线程只取隐式共享的快照，序列化、压缩与轮换在后台完成
+    AutoSaveSnapshot snapshot;
+    snapshot.projectFile = project->getProjectFilePath();
+    snapshot.project = project->getProjectDocument();
+    snapshot.dataStore = project->dataStore();
+    snapshot.takenAt = QDateTime::currentDateTime();
+    if (m_DataEditorWidget && !m_DataEditorWidget->isLoading() && getDataEditorModel()) {
+        snapshot.editorFile = getCurrentFileName();
+        snapshot.editorColumns = getDataEditorModel()->tableColumns();
+    }
+    m_AutoSaveService->writeBackup(snapshot);
+
+    statusBar()->showMessage(QString("已自动保存 %1").arg(snapshot.takenAt.toString("hh:mm:ss")), 5000);
+}
+
+void MainWindow::onBackupFinished(bool success, const QString& message)
+{
+    if (!success) {
+        statusBar()->showMessage(QString("自动备份失败：%1").arg(message), 10000);
+    }
+}
+
+DataTableModel* MainWindow::getDataEditorModel() const
 {
     if (!m_DataEditorWidget) return nullptr;
     return m_DataEditorWidget->getDataModel();
@@ -334,7 +390,7 @@ bool MainWindow::hasDataLoaded()
 void MainWindow::transferDataFromEditorToPlotting()
 {
     if (!m_DataEditorWidget || !m_PlottingWidget) return;
-    QStandardItemModel* model = m_DataEditorWidget->getDataModel();
+    DataTableModel* model = m_DataEditorWidget->getDataModel();
     if (model && model->rowCount() > 0 && model->columnCount() > 0) {
         QString fileName = m_DataEditorWidget->getCurrentFileName();
         m_PlottingWidget->setTableDataFromModel(model, fileName);
@@ -366,6 +422,25 @@ WellTestData MainWindow::createDemoWellTestData()
     return wellData;
 }
 
+void MainWindow::onAnalysisDataExtracted(const QString &name, const QVector<double> &t,
+                                         const QVector<double> &p, const QVector<double> &d)
+{
+    if (!m_FittingPage) return;
+
+    // 直接新建页签，不经过 transferDataToFitting（避免覆盖当前分析）
+    m_FittingPage->addAnalysisWithObservedData(name, t, p, d);
+    ui->stackedWidget->setCurrentIndex(4);
+
+    QMap<QString,NavBtn*>::Iterator item = m_NavBtnMap.begin();
+    while (item != m_NavBtnMap.end()) {
+        ((NavBtn*)(item.value()))->setNormalStyle();
+        if(item.key() == tr("拟合")) {
+            ((NavBtn*)(item.value()))->setClickedStyle();
+        }
+        item++;
+    }
+}
+
 void MainWindow::updateNavigationState()
 {
     QMap<QString,NavBtn*>::Iterator item = m_NavBtnMap.begin();
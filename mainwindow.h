@@ -4,7 +4,7 @@
 #include <QMainWindow>
 #include <QMap>
 #include <QTimer>
-#include <QStandardItemModel>
+#include "datatablemodel.h"
 #include "modelmanager.h"
 
 class NavBtn;
@@ -13,6 +13,7 @@ class DataEditorWidget;
 class PlottingWidget;
 class FittingPage;
 class SettingsWidget;
+class AutoSaveService;
 
 struct WellTestData;
 
@@ -46,8 +47,16 @@ private slots:
     void onAutoSaveIntervalChanged(int interval);
     void onBackupSettingsChanged(bool enabled);
     void onPerformanceSettingsChanged();
+
+    // 自动保存：提交项目增量保存并写入后台备份
+    void onAutoSaveDue();
+    void onBackupFinished(bool success, const QString& message);
     void onModelCalculationCompleted(const QString &analysisType, const QMap<QString, double> &results);
 
+    // 数据编辑器提取的流动段或反褶积响应 -> 新建拟合分析
+    void onAnalysisDataExtracted(const QString& name, const QVector<double>& t,
+                                 const QVector<double>& p, const QVector<double>& d);
+
     // 拟合进度信号（可选保留用于状态栏）
     void onFittingProgressChanged(int progress);
 
@@ -59,6 +68,7 @@ private:
     PlottingWidget* m_PlottingWidget;
     FittingPage* m_FittingPage;
     SettingsWidget* m_SettingsWidget;
+    AutoSaveService* m_AutoSaveService;
     QMap<QString,NavBtn*>::Iterator item; // [修正] Iterator 成员需要移除或局部化，这里保留NavBtnMap即可
     QMap<QString,NavBtn*> m_NavBtnMap;
     QTimer m_timer;
@@ -70,8 +80,9 @@ private:
     void transferDataFromEditorToPlotting();
     void updateNavigationState();
     void transferDataToFitting();
+    void applyAutoSaveSettings();
 
-    QStandardItemModel* getDataEditorModel() const;
+    DataTableModel* getDataEditorModel() const;
     QString getCurrentFileName() const;
     bool hasDataLoaded();
     WellTestData createDemoWellTestData();
@@ -1,5 +1,7 @@
 #include "modelparameter.h"
+#include <QCoreApplication>
 #include <QFile>
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QFileInfo>
 #include <QDebug>
@@ -20,6 +22,17 @@ ModelParameter::ModelParameter(QObject* parent) : QObject(parent), m_hasLoaded(f
     m_rw = 0.1;
     m_projectPath = "";
     m_projectFilePath = "";
+
+    connect(&m_saveEngine, &ProjectSaveEngine::saveFinished, this, [](bool success, const QString& message) {
+        if (!success) qDebug() << "项目保存失败:" << message;
+    });
+
+    // 退出前等待后台写入完成，并把日志合并进项目文件
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, [this]() {
+            m_saveEngine.close();
+        });
+    }
 }
 
 // 获取单例实例
@@ -43,6 +56,9 @@ void ModelParameter::setParameters(double phi, double h, double mu, double B, do
     m_q = q;
     m_rw = rw;
 
+    // 数据容器即将切换文件，先让读取它的后台任务结束
+    emit projectAboutToChange();
+
     m_projectFilePath = path; // 保存完整文件路径
 
     // 提取并保存目录路径
@@ -53,7 +69,10 @@ void ModelParameter::setParameters(double phi, double h, double mu, double B, do
         m_projectPath = path;
     }
 
+    // 先结束上一个项目的后台写入
+    m_saveEngine.close();
     m_hasLoaded = true;
+    openDataStore();
 
     // 如果是新建项目，m_fullProjectData 可能为空，需要初始化基本的 JSON 结构
     // 这样后续 saveProject 时才有完整结构
@@ -72,27 +91,26 @@ void ModelParameter::setParameters(double phi, double h, double mu, double B, do
         m_fullProjectData["reservoir"] = reservoir;
         m_fullProjectData["pvt"] = pvt;
     }
+
+    // 项目文件已由新建对话框写好，此后的保存只追加修改
+    m_saveEngine.create(m_projectFilePath, &m_dataStore, m_fullProjectData);
 }
 
 // 加载项目文件
 bool ModelParameter::loadProject(const QString& filePath)
 {
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) {
-        qDebug() << "无法打开项目文件:" << filePath;
-        return false;
-    }
-
-    QByteArray data = file.readAll();
-    file.close();
-
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    if (doc.isNull()) {
-        qDebug() << "项目文件格式错误";
+    // 读取项目文件并回放增量保存日志
+    // （打开失败时保持当前项目不变；上一个项目未合并的日志留在磁盘上，下次打开时回放）
+    emit projectAboutToChange();
+
+    QString error;
+    QJsonObject document;
+    if (!m_saveEngine.open(filePath, &m_dataStore, document, error)) {
+        qDebug() << "无法加载项目文件:" << filePath << error;
         return false;
     }
 
-    m_fullProjectData = doc.object(); // 缓存整个JSON对象
+    m_fullProjectData = document; // 缓存整个JSON对象
 
     // 解析 reservoir (储层) 部分
     QJsonObject reservoir = m_fullProjectData["reservoir"].toObject();
@@ -113,6 +131,7 @@ bool ModelParameter::loadProject(const QString& filePath)
     m_projectPath = fi.absolutePath();
 
     m_hasLoaded = true;
+    openDataStore();
     qDebug() << "项目参数加载成功, 路径:" << m_projectPath;
     return true;
 }
@@ -144,36 +163,32 @@ bool ModelParameter::saveProject()
     pvt["compressibility"] = m_Ct;
     m_fullProjectData["pvt"] = pvt;
 
-    // 注意：fitting (拟合结果) 已经在 saveFittingResult 中被更新到 m_fullProjectData 了
-    // 这里不需要额外处理，直接写入即可
+    // 注意：fitting (拟合结果) 已经在 saveFittingResult 中提交过了
 
-    // 2. 写入文件
-    QFile file(m_projectFilePath);
-    if (!file.open(QIODevice::WriteOnly)) {
-        qDebug() << "无法打开文件进行写入:" << m_projectFilePath;
-        return false;
-    }
-
-    QJsonDocument doc(m_fullProjectData);
-    file.write(doc.toJson()); // 写入 JSON 文本
-    file.close();
+    // 2. 只有内容变化的节进入日志，写盘在后台线程完成
+    m_saveEngine.setSection("reservoir", reservoir);
+    m_saveEngine.setSection("pvt", pvt);
+    m_saveEngine.save();
 
-    qDebug() << "项目已成功保存至:" << m_projectFilePath;
+    qDebug() << "项目保存已提交:" << m_projectFilePath;
     return true;
 }
 
 // [新增] 关闭项目
 void ModelParameter::closeProject()
 {
-    // 1. 重置状态标志
+    // 1. 重置状态标志（先让读取数据容器的后台任务结束）
+    emit projectAboutToChange();
     m_hasLoaded = false;
 
     // 2. 清空路径信息
     m_projectPath.clear();
     m_projectFilePath.clear();
 
-    // 3. 清空数据缓存
+    // 3. 写完剩余修改并合并日志，再清空数据缓存
+    m_saveEngine.close();
     m_fullProjectData = QJsonObject();
+    m_dataStore.close();
 
     // 4. 重置参数为默认值 (防止下次新建前残留旧数据)
     m_phi = 0.05;
@@ -187,24 +202,32 @@ void ModelParameter::closeProject()
     qDebug() << "项目已关闭，内存已重置";
 }
 
-// 保存拟合结果（更新到内存缓存，并尝试写入文件）
+// 保存拟合结果（更新到内存缓存，并提交后台保存）
 void ModelParameter::saveFittingResult(const QJsonObject& fittingData)
 {
     if (m_projectFilePath.isEmpty()) return;
 
     // 更新内存中的 fitting 字段
+    QJsonObject previous = m_fullProjectData["fitting"].toObject();
     m_fullProjectData["fitting"] = fittingData;
 
-    // 立即写回文件，保证数据安全
-    QFile file(m_projectFilePath);
-    if (file.open(QIODevice::WriteOnly)) {
-        QJsonDocument doc(m_fullProjectData);
-        file.write(doc.toJson());
-        file.close();
-        qDebug() << "拟合结果已保存到:" << m_projectFilePath;
+    // 分析页数量与其余字段不变时逐页提交，只有改动过的分析页进入日志；
+    // 增删分析页时整节提交。合并日志时写回完整的 fitting 节
+    const QJsonArray analyses = fittingData["analyses"].toArray();
+    QJsonObject previousHeader = previous;
+    QJsonObject header = fittingData;
+    previousHeader.remove("analyses");
+    header.remove("analyses");
+    if (!analyses.isEmpty() && previous["analyses"].toArray().size() == analyses.size() && previousHeader == header) {
+        for (int i = 0; i < analyses.size(); ++i) {
+            m_saveEngine.setSection(QString("fitting/analyses/%1").arg(i), analyses[i]);
+        }
     } else {
-        qDebug() << "保存拟合结果失败，无法写入文件";
+        m_saveEngine.setSection("fitting", fittingData);
     }
+
+    // 立即提交，保证数据安全；与上次保存相同时不写盘
+    m_saveEngine.save();
 }
 
 // 获取拟合结果
@@ -215,3 +238,15 @@ QJsonObject ModelParameter::getFittingResult() const
     }
     return QJsonObject();
 }
+
+// 关联当前项目文件的边车容器
+void ModelParameter::openDataStore()
+{
+    QString path = ProjectDataStore::sidecarPath(m_projectFilePath);
+    if (m_dataStore.filePath() == path) return;
+
+    QString error;
+    if (!m_dataStore.open(path, error)) {
+        qDebug() << "无法打开项目数据文件:" << error;
+    }
+}
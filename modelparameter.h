@@ -6,6 +6,8 @@
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <QMutex>
+#include "projectdatastore.h"
+#include "projectsaveengine.h"
 
 // 项目参数单例类
 // 用于在不同模块间共享项目基础信息，并负责项目文件的读取与写入
@@ -27,8 +29,8 @@ public:
     bool loadProject(const QString& filePath);
 
     // [新增] 保存当前项目
-    // 将内存中的参数写入当前关联的文件中
-    // 返回: 成功返回 true
+    // 将内存中的参数提交到后台增量保存（只写入有修改的部分）
+    // 返回: 成功提交返回 true
     bool saveProject();
 
     // [新增] 关闭当前项目
@@ -41,6 +43,12 @@ public:
     // 获取当前项目所在的目录路径
     QString getProjectPath() const { return m_projectPath; }
 
+    // 获取当前项目文件的完整路径
+    QString getProjectFilePath() const { return m_projectFilePath; }
+
+    // 当前完整项目文档（隐式共享，用于自动备份取快照）
+    QJsonObject getProjectDocument() const { return m_fullProjectData; }
+
     // ========================================================================
     // 数据存取接口
     // ========================================================================
@@ -57,12 +65,20 @@ public:
     double getQ() const { return m_q; }     // 产量
     double getRw() const { return m_rw; }   // 井筒半径
 
-    // 保存拟合结果到内存缓存（随后通过 saveProject 写入磁盘）
+    // 保存拟合结果并提交后台保存（内容未变化时不写盘）
     void saveFittingResult(const QJsonObject& fittingData);
 
     // 获取项目文件中存储的拟合结果
     QJsonObject getFittingResult() const;
 
+    // 项目的二进制数组容器（观测数据等大数组按内容哈希引用，随项目一起保存）
+    ProjectDataStore* dataStore() { return &m_dataStore; }
+
+signals:
+    // 即将新建、打开或关闭项目（数据容器随后会关联到其他文件）；
+    // 在后台读取 dataStore() 的任务应在此等待结束
+    void projectAboutToChange();
+
 private:
     // 私有构造函数，确保单例模式
     explicit ModelParameter(QObject* parent = nullptr);
@@ -78,6 +94,12 @@ private:
     // 缓存完整的JSON对象，以便保存时不丢失其他未修改的信息
     QJsonObject m_fullProjectData;
 
+    // 边车数组容器（<项目名>.wtdata）
+    ProjectDataStore m_dataStore;
+
+    // 增量保存：修改节追加到日志，由后台线程写盘并定期合并进项目文件
+    ProjectSaveEngine m_saveEngine;
+
     // 基础物理参数成员变量
     double m_phi; // 孔隙度
     double m_h;   // 厚度
@@ -86,6 +108,9 @@ private:
     double m_Ct;  // 综合压缩系数
     double m_q;   // 产量
     double m_rw;  // 井筒半径
+
+    // 关联当前项目文件的边车容器
+    void openDataStore();
 };
 
 #endif // MODELPARAMETER_H
@@ -1,4 +1,5 @@
 #include "mousezoom.h"
+#include "sampledgraph.h"
 #include <QMenu>
 #include <QAction>
 #include <QApplication>
@@ -18,6 +19,19 @@ MouseZoom::MouseZoom(QWidget *parent) : QCustomPlot(parent)
     connect(this, &QCustomPlot::customContextMenuRequested, this, &MouseZoom::onChartContextMenuRequest);
 }
 
+QCPGraph* MouseZoom::addGraph(QCPAxis* keyAxis, QCPAxis* valueAxis)
+{
+    if (!keyAxis) keyAxis = xAxis;
+    if (!valueAxis) valueAxis = yAxis;
+    if (!keyAxis || !valueAxis) return nullptr;
+    if (keyAxis->parentPlot() != this || valueAxis->parentPlot() != this) return nullptr;
+
+    // 构造时自动注册到本绘图控件
+    QCPGraph* graph = new SampledGraph(keyAxis, valueAxis);
+    graph->setName(QLatin1String("Graph ") + QString::number(graphCount()));
+    return graph;
+}
+
 void MouseZoom::wheelEvent(QWheelEvent *event)
 {
     Qt::MouseButtons buttons = QApplication::mouseButtons();
@@ -19,6 +19,9 @@ public:
     // 静态辅助函数：为外部表格添加通用右键菜单（复制等）
     static void addTableContextMenu(QTableWidget* table);
 
+    // 添加曲线：与 QCustomPlot::addGraph 相同，但创建按像素抽稀的 SampledGraph
+    QCPGraph* addGraph(QCPAxis* keyAxis = nullptr, QCPAxis* valueAxis = nullptr);
+
 protected:
     void wheelEvent(QWheelEvent *event) override;
 
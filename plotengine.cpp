@@ -0,0 +1,417 @@
+#include "plotengine.h"
+#include "curveindex.h"
+#include "plottingwidget.h"
+#include <QtMath>
+#include <algorithm>
+#include <limits>
+
+// ============================================================================
+// 内部辅助函数
+// ============================================================================
+
+namespace {
+
+// 线性轴系数：像素 = offset + scale * v
+void linearCoefficients(double minimum, double maximum, double pixelStart, double pixelSpan,
+                        double& scale, double& offset)
+{
+    if (maximum > minimum) {
+        scale = pixelSpan / (maximum - minimum);
+        offset = pixelStart - scale * minimum;
+    } else {
+        scale = 0.0;
+        offset = pixelStart;
+    }
+}
+
+// 单轴以 center 为中心缩放（值空间已按需取对数）
+void zoomRange(double& minimum, double& maximum, double center, double factor)
+{
+    double range = maximum - minimum;
+    double newRange = range / factor;
+    minimum = center - newRange * (center - minimum) / range;
+    maximum = center + newRange * (maximum - center) / range;
+}
+
+void zoomAxis(double& minimum, double& maximum, bool logActive, double center, double factor)
+{
+    if (factor == 1.0 || maximum == minimum) return;
+    if (logActive && center > 0) {
+        double logMin = log10(minimum);
+        double logMax = log10(maximum);
+        zoomRange(logMin, logMax, log10(center), factor);
+        minimum = pow(10, logMin);
+        maximum = pow(10, logMax);
+    } else {
+        zoomRange(minimum, maximum, center, factor);
+    }
+}
+
+// 单轴平移 fraction 个绘图区宽度（正值使视图向较小值移动）
+void panAxis(double& minimum, double& maximum, bool logActive, double fraction)
+{
+    if (logActive) {
+        double logMin = log10(minimum);
+        double logMax = log10(maximum);
+        double logDelta = -fraction * (logMax - logMin);
+        minimum = pow(10, logMin + logDelta);
+        maximum = pow(10, logMax + logDelta);
+    } else {
+        double delta = fraction * (maximum - minimum);
+        minimum -= delta;
+        maximum -= delta;
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// PlotMapping
+// ============================================================================
+
+PlotMapping::PlotMapping()
+    : PlotMapping(QRect(), 0.0, 1.0, 0.0, 1.0, false, false)
+{
+}
+
+PlotMapping::PlotMapping(const QRect& area, double xMin, double xMax, double yMin, double yMax,
+                         bool xLog, bool yLog)
+    : m_area(area),
+      m_xMin(xMin), m_xMax(xMax),
+      m_yMin(yMin), m_yMax(yMax),
+      m_xLog(xLog), m_yLog(yLog),
+      m_xLogActive(xLog && xMin > 0 && xMax > xMin),
+      m_yLogActive(yLog && yMin > 0 && yMax > yMin),
+      m_xScale(0.0), m_xOffset(area.left()),
+      m_yScale(0.0), m_yOffset(area.bottom())
+{
+    linearCoefficients(xMin, xMax, area.left(), area.width(), m_xLinearScale, m_xLinearOffset);
+    linearCoefficients(yMin, yMax, area.bottom(), -area.height(), m_yLinearScale, m_yLinearOffset);
+
+    if (m_xLogActive) {
+        linearCoefficients(log10(xMin), log10(xMax), area.left(), area.width(), m_xScale, m_xOffset);
+    }
+    if (m_yLogActive) {
+        linearCoefficients(log10(yMin), log10(yMax), area.bottom(), -area.height(), m_yScale, m_yOffset);
+    }
+}
+
+void PlotMapping::mapPoints(const double* x, const double* y, int count, QVector<QPointF>& out) const
+{
+    out.reserve(out.size() + count);
+    // 轴类型在循环外确定，内层只做乘加
+    if (!m_xLogActive && !m_yLogActive) {
+        for (int i = 0; i < count; ++i) {
+            out.append(QPointF(m_xLinearOffset + m_xLinearScale * x[i],
+                               m_yLinearOffset + m_yLinearScale * y[i]));
+        }
+        return;
+    }
+    for (int i = 0; i < count; ++i) {
+        out.append(map(x[i], y[i]));
+    }
+}
+
+double PlotMapping::unmapX(double pixelX) const
+{
+    if (m_xLogActive) return pow(10, (pixelX - m_xOffset) / m_xScale);
+    if (m_xLinearScale != 0.0) return (pixelX - m_xLinearOffset) / m_xLinearScale;
+    return m_xMin;
+}
+
+double PlotMapping::unmapY(double pixelY) const
+{
+    if (m_yLogActive) return pow(10, (pixelY - m_yOffset) / m_yScale);
+    if (m_yLinearScale != 0.0) return (pixelY - m_yLinearOffset) / m_yLinearScale;
+    return m_yMin;
+}
+
+bool PlotMapping::accepts(double x, double y) const
+{
+    if (!qIsFinite(x) || !qIsFinite(y)) return false;
+    if (m_xLog && x <= 0) return false;
+    if (m_yLog && y <= 0) return false;
+    return true;
+}
+
+// ============================================================================
+// PlotEngine
+// ============================================================================
+
+PlotMapping PlotEngine::mapping(const QRect& plotArea, const PlotSettings& settings)
+{
+    return PlotMapping(plotArea, settings.xMin, settings.xMax, settings.yMin, settings.yMax,
+                       settings.xAxisType == AxisType::Logarithmic,
+                       settings.yAxisType == AxisType::Logarithmic);
+}
+
+QVector<double> PlotEngine::axisTicks(double min, double max, AxisType axisType)
+{
+    QVector<double> labels;
+
+    if (max <= min) {
+        return labels;
+    }
+
+    if (axisType == AxisType::Logarithmic) {
+        if (min <= 0) min = 1e-10;
+        if (max <= 0) max = 1;
+
+        int startPower = qFloor(log10(min));
+        int endPower = qCeil(log10(max));
+
+        // 10 的整数次幂
+        for (int power = startPower; power <= endPower; ++power) {
+            double value = qPow(10, power);
+            if (value >= min * 0.999 && value <= max * 1.001) {
+                labels.append(value);
+            }
+        }
+
+        // 跨度不大时加次要刻度（2, 3, 5）
+        if (endPower - startPower <= 3) {
+            for (int power = startPower; power < endPower; ++power) {
+                for (int mult : {2, 3, 5}) {
+                    double value = mult * qPow(10, power);
+                    if (value > min && value < max) {
+                        labels.append(value);
+                    }
+                }
+            }
+        }
+    } else {
+        double range = max - min;
+        double step = qPow(10, qFloor(log10(range)));
+
+        double labelCount = range / step;
+        if (labelCount < 4) {
+            step = step / 5;
+        } else if (labelCount < 6) {
+            step = step / 2;
+        } else if (labelCount > 10) {
+            step = step * 2;
+        }
+
+        double startValue = qFloor(min / step) * step;
+        if (startValue < min) {
+            startValue += step;
+        }
+
+        // 范围包含 0 时保证有 0 刻度
+        if (min <= 0 && max >= 0) {
+            labels.append(0);
+        }
+
+        for (double value = startValue; value <= max + step * 0.001; value += step) {
+            if (value >= min && value <= max && qAbs(value) > 1e-10) {
+                labels.append(value);
+            }
+        }
+    }
+
+    std::sort(labels.begin(), labels.end());
+    labels.erase(std::unique(labels.begin(), labels.end(), [](double a, double b) {
+                     return qAbs(a - b) < 1e-10;
+                 }), labels.end());
+    return labels;
+}
+
+QString PlotEngine::formatAxisLabel(double value, bool isLog)
+{
+    if (isLog) {
+        // 10 的整数次幂用简洁格式
+        double logValue = log10(qAbs(value));
+        if (qAbs(logValue - qRound(logValue)) < 0.01) {
+            int power = qRound(logValue);
+            if (power == 0) return "1";
+            if (power == 1) return "10";
+            if (power == 2) return "100";
+            if (power == 3) return "1000";
+            if (power == -1) return "0.1";
+            if (power == -2) return "0.01";
+            return QString("10^%1").arg(power);
+        }
+        if (value >= 1000) {
+            return QString::number(value, 'g', 2);
+        } else if (value >= 1) {
+            return QString::number(value, 'f', 0);
+        }
+        return QString::number(value, 'g', 2);
+    }
+
+    if (qAbs(value) >= 100000) {
+        return QString::number(value, 'e', 1);
+    } else if (qAbs(value) >= 1000) {
+        return QString::number(value, 'f', 0);
+    } else if (qAbs(value) >= 1) {
+        return QString::number(value, 'f', 1);
+    } else if (qAbs(value) >= 0.01) {
+        return QString::number(value, 'f', 2);
+    } else if (value == 0) {
+        return "0";
+    }
+    return QString::number(value, 'g', 2);
+}
+
+QString PlotEngine::formatScientific(double value, int decimals)
+{
+    if (qIsNaN(value) || !qIsFinite(value)) {
+        return "N/A";
+    }
+
+    if (qAbs(value) >= 1000 || (qAbs(value) < 0.01 && value != 0)) {
+        return QString::number(value, 'e', decimals);
+    }
+    return QString::number(value, 'f', decimals);
+}
+
+QPair<double, double> PlotEngine::optimalRange(double min, double max, bool isLog)
+{
+    if (max <= min) {
+        return QPair<double, double>(min, max);
+    }
+
+    if (isLog) {
+        // 扩展到最近的 10 的整数次幂，至少显示一个数量级
+        if (min <= 0) min = 1e-10;
+        if (max <= 0) max = 1;
+
+        double rangeMin = pow(10, floor(log10(min)));
+        double rangeMax = pow(10, ceil(log10(max)));
+        if (rangeMax / rangeMin < 10) {
+            rangeMin = rangeMin / 10;
+            rangeMax = rangeMax * 10;
+        }
+        return QPair<double, double>(rangeMin, rangeMax);
+    }
+
+    double range = max - min;
+
+    // 刻度间隔
+    double orderOfMagnitude = pow(10, floor(log10(range)));
+    double normalizedRange = range / orderOfMagnitude;
+
+    double tickInterval;
+    if (normalizedRange <= 1.5) {
+        tickInterval = orderOfMagnitude * 0.2;
+    } else if (normalizedRange <= 3) {
+        tickInterval = orderOfMagnitude * 0.5;
+    } else if (normalizedRange <= 7) {
+        tickInterval = orderOfMagnitude;
+    } else {
+        tickInterval = orderOfMagnitude * 2;
+    }
+
+    // 对齐刻度并留 5% 边距
+    double rangeMin = floor(min / tickInterval) * tickInterval;
+    double rangeMax = ceil(max / tickInterval) * tickInterval;
+    double margin = (rangeMax - rangeMin) * 0.05;
+    rangeMin -= margin;
+    rangeMax += margin;
+
+    // 跨 0 时 0 点对齐到刻度
+    if (rangeMin < 0 && rangeMax > 0) {
+        rangeMin = floor(rangeMin / tickInterval) * tickInterval;
+        rangeMax = ceil(rangeMax / tickInterval) * tickInterval;
+    }
+
+    // 正值数据的最小值接近 0 时从 0 开始
+    if (min > 0 && rangeMin < 0 && min < range * 0.2) {
+        rangeMin = 0;
+    }
+
+    return QPair<double, double>(rangeMin, rangeMax);
+}
+
+bool PlotEngine::dataBounds(const QVector<CurveData>& curves, bool xLog, bool yLog, CurveIndexCache& indexes,
+                            double& minX, double& maxX, double& minY, double& maxY)
+{
+    minX = minY = std::numeric_limits<double>::max();
+    maxX = maxY = std::numeric_limits<double>::lowest();
+    bool hasValidData = false;
+
+    for (const CurveData& curve : curves) {
+        if (!curve.visible) continue;
+
+        double curveMinX, curveMaxX, curveMinY, curveMaxY;
+        if (!indexes.index(curve.xData, curve.yData)->bounds(xLog, yLog, curveMinX, curveMaxX,
+                                                             curveMinY, curveMaxY)) continue;
+        minX = qMin(minX, curveMinX);
+        maxX = qMax(maxX, curveMaxX);
+        minY = qMin(minY, curveMinY);
+        maxY = qMax(maxY, curveMaxY);
+        hasValidData = true;
+    }
+    return hasValidData;
+}
+
+bool PlotEngine::yRangeInX(const QVector<CurveData>& curves, double xMin, double xMax, bool yLog,
+                           CurveIndexCache& indexes, double& minY, double& maxY)
+{
+    minY = std::numeric_limits<double>::max();
+    maxY = std::numeric_limits<double>::lowest();
+    bool hasValidData = false;
+
+    for (const CurveData& curve : curves) {
+        if (!curve.visible) continue;
+
+        double curveMinY, curveMaxY;
+        if (!indexes.index(curve.xData, curve.yData)->yRange(xMin, xMax, yLog, curveMinY, curveMaxY)) continue;
+        minY = qMin(minY, curveMinY);
+        maxY = qMax(maxY, curveMaxY);
+        hasValidData = true;
+    }
+    return hasValidData;
+}
+
+bool PlotEngine::fitYToX(PlotSettings& settings, const QVector<CurveData>& curves, CurveIndexCache& indexes)
+{
+    const bool yLog = settings.yAxisType == AxisType::Logarithmic;
+    double minY, maxY;
+    if (!yRangeInX(curves, settings.xMin, settings.xMax, yLog, indexes, minY, maxY) || minY >= maxY) {
+        return false;
+    }
+
+    QPair<double, double> yRange = optimalRange(minY, maxY, yLog);
+    settings.yMin = yRange.first;
+    settings.yMax = yRange.second;
+    return true;
+}
+
+bool PlotEngine::nearestPoint(const QVector<CurveData>& curves, const PlotMapping& mapping, const QPointF& pixel,
+                              double radius, CurveIndexCache& indexes, int& curveIndex, int& pointIndex)
+{
+    double best = radius;
+    curveIndex = pointIndex = -1;
+
+    for (int c = 0; c < curves.size(); ++c) {
+        const CurveData& curve = curves[c];
+        if (!curve.visible) continue;
+
+        // best 逐条收紧，后面的曲线只搜索更近的点
+        int index = indexes.index(curve.xData, curve.yData)->nearest(mapping, pixel, best);
+        if (index >= 0) {
+            curveIndex = c;
+            pointIndex = index;
+        }
+    }
+    return curveIndex >= 0;
+}
+
+void PlotEngine::zoomAt(PlotSettings& settings, const QRect& plotArea, const QPointF& pixel,
+                        double factorX, double factorY)
+{
+    const PlotMapping view = mapping(plotArea, settings);
+    const QPointF center = view.unmap(pixel);
+    zoomAxis(settings.xMin, settings.xMax, view.xLogActive(), center.x(), factorX);
+    zoomAxis(settings.yMin, settings.yMax, view.yLogActive(), center.y(), factorY);
+}
+
+void PlotEngine::pan(PlotSettings& settings, const QRect& plotArea, const QPointF& pixelDelta)
+{
+    if (plotArea.width() <= 0 || plotArea.height() <= 0) return;
+
+    const PlotMapping view = mapping(plotArea, settings);
+    panAxis(settings.xMin, settings.xMax, view.xLogActive(), pixelDelta.x() / plotArea.width());
+    panAxis(settings.yMin, settings.yMax, view.yLogActive(), -pixelDelta.y() / plotArea.height());
+}
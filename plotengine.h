@@ -0,0 +1,135 @@
+#ifndef PLOTENGINE_H
+#define PLOTENGINE_H
+
+#include <QPair>
+#include <QPointF>
+#include <QRect>
+#include <QString>
+#include <QVector>
+#include <cmath>
+
+struct PlotSettings;
+struct CurveData;
+enum class AxisType;
+class CurveIndexCache;
+
+/**
+ * @brief 数据坐标 ↔ 像素坐标的预计算变换
+ *
+ * 构造时按坐标轴类型求出每轴的仿射系数（对数轴在 log10 空间），之后每个点只需
+ * 一次乘加（对数轴外加一次 log10）。对数轴只在范围为正时生效；对数轴上的非正值
+ * 与范围退化（max <= min）的处理与各绘图窗口原有的 dataToPixel 一致。
+ */
+class PlotMapping
+{
+public:
+    PlotMapping();
+    PlotMapping(const QRect& area, double xMin, double xMax, double yMin, double yMax,
+                bool xLog, bool yLog);
+
+    const QRect& area() const { return m_area; }
+    double xMin() const { return m_xMin; }
+    double xMax() const { return m_xMax; }
+    double yMin() const { return m_yMin; }
+    double yMax() const { return m_yMax; }
+    bool xLog() const { return m_xLog; }
+    bool yLog() const { return m_yLog; }
+
+    // 对数变换是否实际生效（对数轴且范围为正）
+    bool xLogActive() const { return m_xLogActive; }
+    bool yLogActive() const { return m_yLogActive; }
+
+    double mapX(double x) const
+    {
+        return (m_xLogActive && x > 0) ? m_xOffset + m_xScale * std::log10(x)
+                                       : m_xLinearOffset + m_xLinearScale * x;
+    }
+    double mapY(double y) const
+    {
+        return (m_yLogActive && y > 0) ? m_yOffset + m_yScale * std::log10(y)
+                                       : m_yLinearOffset + m_yLinearScale * y;
+    }
+    QPointF map(double x, double y) const { return QPointF(mapX(x), mapY(y)); }
+    QPointF map(const QPointF& point) const { return map(point.x(), point.y()); }
+
+    // 批量变换 [0, count)，结果追加到 out
+    void mapPoints(const double* x, const double* y, int count, QVector<QPointF>& out) const;
+
+    double unmapX(double pixelX) const;
+    double unmapY(double pixelY) const;
+    QPointF unmap(const QPointF& pixel) const { return QPointF(unmapX(pixel.x()), unmapY(pixel.y())); }
+
+    // 当前坐标轴下该点能否绘制（有限值，对数轴要求正值）
+    bool accepts(double x, double y) const;
+
+private:
+    QRect m_area;
+    double m_xMin, m_xMax;
+    double m_yMin, m_yMax;
+    bool m_xLog, m_yLog;
+    bool m_xLogActive, m_yLogActive;
+
+    // 像素 = offset + scale * log10(v)
+    double m_xScale, m_xOffset;
+    double m_yScale, m_yOffset;
+    // 像素 = offset + scale * v（线性轴，及对数轴上的非正值）
+    double m_xLinearScale, m_xLinearOffset;
+    double m_yLinearScale, m_yLinearOffset;
+};
+
+/**
+ * @brief 绘图窗口共用的坐标轴与视图计算
+ *
+ * PlottingWidget、PlotWindow 与 DualPlotWindow 的两个子图共用同一套实现：
+ * 坐标变换、刻度生成与格式化、自适应范围、数据边界与点拾取以及对数轴感知的缩放平移。
+ */
+class PlotEngine
+{
+public:
+    // 绘图区与坐标设置 → 坐标变换
+    static PlotMapping mapping(const QRect& plotArea, const PlotSettings& settings);
+
+    // 坐标轴刻度（对数轴：10 的整数次幂，跨度不超过三个数量级时加 2、3、5 倍刻度）
+    static QVector<double> axisTicks(double min, double max, AxisType axisType);
+
+    // 刻度标签文字
+    static QString formatAxisLabel(double value, bool isLog);
+
+    // 坐标读数（过大或过小时用科学计数法）
+    static QString formatScientific(double value, int decimals = 2);
+
+    // 包含 [min, max] 的合适显示范围（对数轴扩展到整数量级，线性轴对齐刻度并留 5% 边距）
+    static QPair<double, double> optimalRange(double min, double max, bool isLog);
+
+    /**
+     * @brief 可见曲线的数据边界（跳过非有限值，对数轴跳过非正值）
+     *
+     * 经区间索引计算：索引建好后每条曲线只需 O(log n)。
+     * @return 是否存在有效数据点
+     */
+    static bool dataBounds(const QVector<CurveData>& curves, bool xLog, bool yLog, CurveIndexCache& indexes,
+                           double& minX, double& maxX, double& minY, double& maxY);
+
+    // 可见曲线在 X ∈ [xMin, xMax] 内的 Y 范围
+    static bool yRangeInX(const QVector<CurveData>& curves, double xMin, double xMax, bool yLog,
+                          CurveIndexCache& indexes, double& minY, double& maxY);
+
+    // Y 轴适应当前 X 范围内的数据（范围内没有数据时不改动）
+    static bool fitYToX(PlotSettings& settings, const QVector<CurveData>& curves, CurveIndexCache& indexes);
+
+    /**
+     * @brief 像素点 radius 以内最近的可见数据点
+     * @param pointIndex 输出该点在曲线数据数组中的下标
+     */
+    static bool nearestPoint(const QVector<CurveData>& curves, const PlotMapping& mapping, const QPointF& pixel,
+                             double radius, CurveIndexCache& indexes, int& curveIndex, int& pointIndex);
+
+    // 以像素点为中心缩放（factor > 1 放大），对数轴在 log10 空间缩放
+    static void zoomAt(PlotSettings& settings, const QRect& plotArea, const QPointF& pixel,
+                       double factorX, double factorY);
+
+    // 按像素位移平移视图，对数轴在 log10 空间平移
+    static void pan(PlotSettings& settings, const QRect& plotArea, const QPointF& pixelDelta);
+};
+
+#endif // PLOTENGINE_H
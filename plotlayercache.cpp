@@ -0,0 +1,119 @@
+#include "plotlayercache.h"
+#include "plottingwidget.h"
+#include <cstring>
+
+namespace {
+
+const int kDataSamples = 16;        // 数据数组抽样点数
+
+} // namespace
+
+// ============================================================================
+// PlotLayerKey
+// ============================================================================
+
+PlotLayerKey& PlotLayerKey::addBits(quint64 bits)
+{
+    m_hash = (m_hash ^ bits) * 1099511628211ULL;
+    return *this;
+}
+
+PlotLayerKey& PlotLayerKey::add(double value)
+{
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return addBits(bits);
+}
+
+PlotLayerKey& PlotLayerKey::add(const QString& text)
+{
+    addBits(quint64(text.size()));
+    for (QChar ch : text) addBits(ch.unicode());
+    return *this;
+}
+
+PlotLayerKey& PlotLayerKey::add(const QColor& color)
+{
+    return addBits(color.isValid() ? quint64(color.rgba()) : ~0ULL);
+}
+
+PlotLayerKey& PlotLayerKey::add(const QRect& rect)
+{
+    return add(rect.x()).add(rect.y()).add(rect.width()).add(rect.height());
+}
+
+PlotLayerKey& PlotLayerKey::add(const QPointF& point)
+{
+    return add(point.x()).add(point.y());
+}
+
+PlotLayerKey& PlotLayerKey::add(const QVector<double>& data)
+{
+    addBits(quint64(quintptr(data.constData())));
+    addBits(quint64(data.size()));
+    if (data.isEmpty()) return *this;
+    for (int s = 0; s < kDataSamples; ++s) {
+        add(data[int(qint64(data.size() - 1) * s / (kDataSamples - 1))]);
+    }
+    return *this;
+}
+
+PlotLayerKey& PlotLayerKey::add(const PlotSettings& settings)
+{
+    add(settings.showGrid);
+    add(settings.backgroundColor).add(settings.gridColor).add(settings.textColor);
+    add(settings.lineWidth).add(settings.pointSize);
+    add(settings.xAxisTitle).add(settings.yAxisTitle).add(settings.plotTitle);
+    add(settings.xMin).add(settings.xMax).add(settings.yMin).add(settings.yMax);
+    add(int(settings.xAxisType)).add(int(settings.yAxisType));
+    return *this;
+}
+
+PlotLayerKey& PlotLayerKey::add(const CurveData& curve)
+{
+    add(curve.visible);
+    if (!curve.visible) return *this;
+    add(curve.color).add(curve.lineWidth).add(curve.pointSize);
+    add(int(curve.lineStyle)).add(int(curve.drawType));
+    add(curve.xData).add(curve.yData);
+    return *this;
+}
+
+// ============================================================================
+// PlotLayerCache
+// ============================================================================
+
+const QImage& PlotLayerCache::layer(Layer layer, const QSize& size, qreal devicePixelRatio, quint64 key,
+                                    const std::function<void(QPainter&)>& paint)
+{
+    Entry& entry = m_layers[layer];
+    const QSize pixelSize = size * devicePixelRatio;
+
+    if (entry.valid && entry.key == key && entry.image.size() == pixelSize
+        && qFuzzyCompare(entry.image.devicePixelRatio(), devicePixelRatio)) {
+        return entry.image;
+    }
+
+    if (entry.image.size() != pixelSize) {
+        entry.image = QImage(pixelSize, QImage::Format_ARGB32_Premultiplied);
+    }
+    entry.image.setDevicePixelRatio(devicePixelRatio);
+    entry.image.fill(Qt::transparent);
+    entry.key = key;
+    entry.valid = true;
+
+    if (!entry.image.isNull()) {
+        QPainter painter(&entry.image);
+        painter.setRenderHint(QPainter::Antialiasing, true);
+        painter.setRenderHint(QPainter::TextAntialiasing, true);
+        paint(painter);
+    }
+    return entry.image;
+}
+
+void PlotLayerCache::invalidate()
+{
+    for (Entry& entry : m_layers) {
+        entry.valid = false;
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef PLOTLAYERCACHE_H
+#define PLOTLAYERCACHE_H
+
+#include <QColor>
+#include <QImage>
+#include <QPainter>
+#include <QPointF>
+#include <QRect>
+#include <QString>
+#include <QVector>
+#include <functional>
+
+struct PlotSettings;
+struct CurveData;
+
+/**
+ * @brief 图层输入指纹
+ *
+ * 依次累加影响图层内容的值（FNV-1a），指纹不变即可复用缓存的图层。
+ * 数据数组按地址、长度和抽样值计入：替换数组或修改长度必然察觉，
+ * 原地修改个别未抽到的元素不会察觉（绘图数据都是整体替换的）。
+ */
+class PlotLayerKey
+{
+public:
+    PlotLayerKey() : m_hash(1469598103934665603ULL) {}
+
+    PlotLayerKey& add(bool value) { return addBits(value ? 1 : 0); }
+    PlotLayerKey& add(int value) { return addBits(quint64(qint64(value))); }
+    PlotLayerKey& add(double value);
+    PlotLayerKey& add(const QString& text);
+    PlotLayerKey& add(const QColor& color);
+    PlotLayerKey& add(const QRect& rect);
+    PlotLayerKey& add(const QPointF& point);
+    PlotLayerKey& add(const QVector<double>& data);
+    PlotLayerKey& add(const PlotSettings& settings);
+    PlotLayerKey& add(const CurveData& curve);
+
+    quint64 value() const { return m_hash; }
+
+private:
+    quint64 m_hash;
+
+    PlotLayerKey& addBits(quint64 bits);
+};
+
+/**
+ * @brief 绘图分层缓存
+ *
+ * 静态层（背景、网格、坐标轴）缓存为按设备像素比分配的 QImage，只有指纹变化时才重绘；
+ * 曲线层由 CurveRenderer 渲染成位图。十字光标、框选、图例等交互叠加层每帧直接画在
+ * 位图之上，鼠标移动时重绘代价只剩位图合成。
+ */
+class PlotLayerCache
+{
+public:
+    enum Layer {
+        StaticLayer,    // 背景、网格、坐标轴
+        LayerCount
+    };
+
+    /**
+     * @brief 取出图层，尺寸、像素比或指纹变化时清空后调用 paint 重绘
+     * @param size 逻辑像素尺寸（绘图控件大小）
+     * @param devicePixelRatio 设备像素比
+     */
+    const QImage& layer(Layer layer, const QSize& size, qreal devicePixelRatio, quint64 key,
+                        const std::function<void(QPainter&)>& paint);
+
+    // 丢弃所有图层（下次取出时重绘）
+    void invalidate();
+
+private:
+    struct Entry {
+        QImage image;
+        quint64 key;
+        bool valid;
+
+        Entry() : key(0), valid(false) {}
+    };
+
+    Entry m_layers[LayerCount];
+};
+
+#endif // PLOTLAYERCACHE_H
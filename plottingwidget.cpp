@@ -1,5 +1,6 @@
 #include "plottingwidget.h"
 #include "ui_plottingwidget.h"
+#include "modelmanager.h"
 #include <QPaintEvent>
 #include <QPainter>
 #include <QApplication>
@@ -75,6 +76,8 @@ PlottingWidget::PlottingWidget(QWidget *parent) :
     setMouseTracking(true);
     ui->widget_plot->setMouseTracking(true);
     ui->widget_plot->installEventFilter(this);
+    connect(&m_curveRenderer, &CurveRenderer::frameReady,
+            ui->widget_plot, QOverload<>::of(&QWidget::update));
 
     // 美化坐标标签
     m_coordinateLabel = new QLabel(this);
@@ -252,6 +255,7 @@ void PlottingWidget::setupContextMenu()
     m_zoomOutAction = m_zoomMenu->addAction("➖ 缩小 (-25%)");
     m_zoomFitAction = m_zoomMenu->addAction("📐 适应窗口");
     m_resetZoomAction = m_zoomMenu->addAction("🔄 重置缩放");
+    m_fitYAction = m_zoomMenu->addAction("↕️ 纵向适应数据");
 
     m_zoomMenu->addSeparator();
     m_zoomXInAction = m_zoomMenu->addAction("↔️ 横向放大");
@@ -259,6 +263,18 @@ void PlottingWidget::setupContextMenu()
     m_zoomYInAction = m_zoomMenu->addAction("↕️ 纵向放大");
     m_zoomYOutAction = m_zoomMenu->addAction("↕️ 纵向缩小");
 
+    m_contextMenu->addSeparator();
+
+    // 流态分析（结果通过 analysisCompleted 发出）
+    QMenu* analysisMenu = m_contextMenu->addMenu("📊 流态分析");
+    connect(analysisMenu->addAction("📈 双对数分析"), &QAction::triggered, this, &PlottingWidget::performLogLogAnalysis);
+    connect(analysisMenu->addAction("📉 导数流态识别"), &QAction::triggered, this, &PlottingWidget::performDerivativeAnalysis);
+    connect(analysisMenu->addAction("🧩 模型匹配"), &QAction::triggered, this, &PlottingWidget::performModelMatching);
+    connect(analysisMenu->addAction("🗑️ 清除流态标记"), &QAction::triggered, this, [this]() {
+        m_regimeMarkers.clear();
+        updatePlot();
+    });
+
     connect(m_addMarkerAction, &QAction::triggered, this, &PlottingWidget::onMarkerAdded);
     connect(m_addAnnotationAction, &QAction::triggered, this, &PlottingWidget::onAnnotationAdded);
     connect(m_removeLastMarkerAction, &QAction::triggered, this, &PlottingWidget::onRemoveLastMarker);
@@ -268,6 +284,7 @@ void PlottingWidget::setupContextMenu()
     connect(m_zoomOutAction, &QAction::triggered, this, &PlottingWidget::zoomOut);
     connect(m_zoomFitAction, &QAction::triggered, this, &PlottingWidget::zoomToFit);
     connect(m_resetZoomAction, &QAction::triggered, this, &PlottingWidget::resetZoom);
+    connect(m_fitYAction, &QAction::triggered, this, &PlottingWidget::fitYToVisibleX);
 
     // 连接单独缩放功能
     connect(m_zoomXInAction, &QAction::triggered, this, &PlottingWidget::zoomXIn);
@@ -617,6 +634,24 @@ void PlottingWidget::showDataSelectionDialog(const QString &plotType)
     yUnitEdit->setPlaceholderText("如：m³/d");
     axisLayout->addWidget(yUnitEdit, 3, 3);
 
+    axisLayout->addWidget(new QLabel("X轴时间变换:"), 4, 0);
+    QComboBox *xTransformCombo = new QComboBox();
+    xTransformCombo->addItems(QStringList() << "无"
+                                            << PressureDerivativeCalculator::timeAxisName(DerivativeTimeAxis::AgarwalEquivalent)
+                                            << PressureDerivativeCalculator::timeAxisName(DerivativeTimeAxis::Superposition));
+    axisLayout->addWidget(xTransformCombo, 4, 1);
+
+    axisLayout->addWidget(new QLabel("流量列:"), 4, 2);
+    QComboBox *rateCombo = new QComboBox();
+    for (int i = 0; i < m_tableData.headers.size(); ++i) {
+        rateCombo->addItem(QString("%1 (列%2)").arg(m_tableData.headers[i]).arg(i + 1));
+    }
+    rateCombo->setEnabled(false);
+    connect(xTransformCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), rateCombo, [rateCombo](int index) {
+        rateCombo->setEnabled(index > 0);
+    });
+    axisLayout->addWidget(rateCombo, 4, 3);
+
     layout->addWidget(axisGroup);
 
     QGroupBox *styleGroup = new QGroupBox("曲线样式");
@@ -692,6 +727,13 @@ void PlottingWidget::showDataSelectionDialog(const QString &plotType)
                                                       xUnitEdit->text().trimmed(), yUnitEdit->text().trimmed(),
                                                       lineWidthSpin->value(), pointSizeSpin->value());
 
+        if (xTransformCombo->currentIndex() > 0) {
+            if (!applyTimeAxisTransform(newCurve, xIndex, yIndex, rateCombo->currentIndex(), xTransformCombo->currentIndex())) {
+                QMessageBox::warning(this, "创建图表", "时间轴变换失败：请检查时间列是否递增、流量列是否有效！");
+                return;
+            }
+        }
+
         if (newWindowCheck->isChecked()) {
             QString windowTitle = QString("%1 - %2").arg(curveName).arg(plotType);
             PlotWindow *plotWindow = createPlotWindow(windowTitle, plotType);
@@ -842,6 +884,63 @@ CurveData PlottingWidget::createCurveFromTableData(int xColumn, int yColumn, con
     return curve;
 }
 
+bool PlottingWidget::applyTimeAxisTransform(CurveData &curve, int timeColumn, int yColumn, int rateColumn, int mode)
+{
+    if (timeColumn < 0 || timeColumn >= m_tableData.columns.size() ||
+        yColumn < 0 || yColumn >= m_tableData.columns.size() ||
+        rateColumn < 0 || rateColumn >= m_tableData.columns.size()) {
+        return false;
+    }
+
+    const QVector<double> &timeData = m_tableData.columns[timeColumn];
+    const QVector<double> &yData = m_tableData.columns[yColumn];
+    const QVector<double> &rateData = m_tableData.columns[rateColumn];
+    int dataSize = qMin(timeData.size(), qMin(yData.size(), rateData.size()));
+
+    for (int i = 1; i < dataSize; ++i) {
+        if (timeData[i] < timeData[i - 1]) {
+            return false;
+        }
+    }
+
+    QVector<double> time = timeData.mid(0, dataSize);
+    QVector<double> stepTime;
+    QVector<double> stepRate;
+    PressureDerivativeCalculator::buildRateSteps(time, rateData.mid(0, dataSize), 0.01, stepTime, stepRate);
+    if (stepTime.isEmpty()) {
+        return false;
+    }
+
+    QVector<double> transformed = (mode == 1)
+        ? PressureDerivativeCalculator::calculateEquivalentTime(time, stepTime, stepRate)
+        : PressureDerivativeCalculator::calculateSuperpositionTime(time, stepTime, stepRate);
+
+    // 只保留最后一个流动段（分析段）的数据点
+    QVector<int> period = PressureDerivativeCalculator::assignFlowPeriods(time, stepTime);
+    int lastPeriod = period.isEmpty() ? -1 : period.last();
+
+    curve.xData.clear();
+    curve.yData.clear();
+    for (int i = 0; i < dataSize; ++i) {
+        if (period[i] != lastPeriod || lastPeriod < 0) continue;
+        if (mode == 1 && transformed[i] <= 0) continue;
+        if (isValidDataPoint(transformed[i], yData[i])) {
+            curve.xData.append(transformed[i]);
+            curve.yData.append(yData[i]);
+        }
+    }
+
+    curve.xLabel = (mode == 1) ? PressureDerivativeCalculator::timeAxisName(DerivativeTimeAxis::AgarwalEquivalent)
+                               : PressureDerivativeCalculator::timeAxisName(DerivativeTimeAxis::Superposition);
+    if (mode == 2) {
+        // 叠加时间函数可为负值，不适用对数坐标
+        curve.xAxisType = AxisType::Linear;
+        curve.xUnit.clear();
+    }
+
+    return !curve.xData.isEmpty();
+}
+
 void PlottingWidget::addCurve(const CurveData &curve)
 {
     m_curves.append(curve);
@@ -879,16 +978,24 @@ void PlottingWidget::paintPlotArea(QPaintEvent *)
     QRect widgetRect = ui->widget_plot->rect();
     m_plotArea = QRect(80, 50, widgetRect.width() - 160, widgetRect.height() - 100);
 
-    drawBackground(painter);
+    // 静态层只在输入变化时重绘，选择框、坐标、图例每帧直接绘制
+    const qreal dpr = ui->widget_plot->devicePixelRatioF();
 
-    if (m_plotSettings.showGrid) {
-        drawGrid(painter);
-    }
-
-    drawAxes(painter);
+    PlotLayerKey staticKey;
+    staticKey.add(m_plotArea).add(m_plotSettings);
+    painter.drawImage(0, 0, m_layerCache.layer(PlotLayerCache::StaticLayer, widgetRect.size(), dpr,
+                                               staticKey.value(), [this](QPainter &layer) {
+        drawBackground(layer);
+        if (m_plotSettings.showGrid) {
+            drawGrid(layer);
+        }
+        drawAxes(layer);
+    }));
 
+    // 曲线层：数据量大时在后台线程渲染，期间显示变换后的旧帧
     if (!m_curves.isEmpty()) {
-        drawAllCurves(painter);
+        m_curveRenderer.paint(painter, m_curves, PlotEngine::mapping(m_plotArea, m_plotSettings),
+                              widgetRect.size(), dpr);
     } else {
         drawNoDataMessage(painter);
     }
@@ -920,8 +1027,8 @@ void PlottingWidget::drawGrid(QPainter &painter)
 {
     painter.setPen(QPen(m_plotSettings.gridColor, 1, Qt::DotLine));
 
-    QVector<double> xLabels = generateOptimizedAxisLabels(m_plotSettings.xMin, m_plotSettings.xMax, m_plotSettings.xAxisType);
-    QVector<double> yLabels = generateOptimizedAxisLabels(m_plotSettings.yMin, m_plotSettings.yMax, m_plotSettings.yAxisType);
+    QVector<double> xLabels = PlotEngine::axisTicks(m_plotSettings.xMin, m_plotSettings.xMax, m_plotSettings.xAxisType);
+    QVector<double> yLabels = PlotEngine::axisTicks(m_plotSettings.yMin, m_plotSettings.yMax, m_plotSettings.yAxisType);
 
     // 绘制X轴网格线 - 使用正确的对数转换
     for (double value : xLabels) {
@@ -958,57 +1065,14 @@ void PlottingWidget::drawGrid(QPainter &painter)
     }
 }
 
-// 格式化坐标轴标签，参考Saphir软件风格
-QString PlottingWidget::formatAxisLabel(double value, bool isLog)
-{
-    if (isLog) {
-        // 对数坐标：对于10的整数次幂显示简洁格式
-        double logValue = log10(qAbs(value));
-        if (qAbs(logValue - qRound(logValue)) < 0.01) {
-            int power = qRound(logValue);
-            if (power == 0) return "1";
-            if (power == 1) return "10";
-            if (power == 2) return "100";
-            if (power == 3) return "1000";
-            if (power == -1) return "0.1";
-            if (power == -2) return "0.01";
-            return QString("10^%1").arg(power);
-        } else {
-            // 非10的整数次幂，显示实际数值
-            if (value >= 1000) {
-                return QString::number(value, 'g', 2);
-            } else if (value >= 1) {
-                return QString::number(value, 'f', 0);
-            } else {
-                return QString::number(value, 'g', 2);
-            }
-        }
-    } else {
-        // 线性坐标：智能格式化
-        if (qAbs(value) >= 100000) {
-            return QString::number(value, 'e', 1);
-        } else if (qAbs(value) >= 1000) {
-            return QString::number(value, 'f', 0);
-        } else if (qAbs(value) >= 1) {
-            return QString::number(value, 'f', 1);
-        } else if (qAbs(value) >= 0.01) {
-            return QString::number(value, 'f', 2);
-        } else if (value == 0) {
-            return "0";
-        } else {
-            return QString::number(value, 'g', 2);
-        }
-    }
-}
-
 // 修改后的drawAxes函数 - 正确处理对数坐标系
 void PlottingWidget::drawAxes(QPainter &painter)
 {
     painter.setPen(QPen(Qt::black, 2));
     painter.setFont(QFont("Arial", 9));
 
-    QVector<double> xLabels = generateOptimizedAxisLabels(m_plotSettings.xMin, m_plotSettings.xMax, m_plotSettings.xAxisType);
-    QVector<double> yLabels = generateOptimizedAxisLabels(m_plotSettings.yMin, m_plotSettings.yMax, m_plotSettings.yAxisType);
+    QVector<double> xLabels = PlotEngine::axisTicks(m_plotSettings.xMin, m_plotSettings.xMax, m_plotSettings.xAxisType);
+    QVector<double> yLabels = PlotEngine::axisTicks(m_plotSettings.yMin, m_plotSettings.yMax, m_plotSettings.yAxisType);
 
     // 绘制X轴标签 - 参考Saphir软件风格
     for (double value : xLabels) {
@@ -1024,7 +1088,7 @@ void PlottingWidget::drawAxes(QPainter &painter)
 
         if (x >= m_plotArea.left() && x <= m_plotArea.right()) {
             painter.drawLine(x, m_plotArea.bottom(), x, m_plotArea.bottom() - 8);
-            QString label = formatAxisLabel(value, m_plotSettings.xAxisType == AxisType::Logarithmic);
+            QString label = PlotEngine::formatAxisLabel(value, m_plotSettings.xAxisType == AxisType::Logarithmic);
             QRect textRect(x - 30, m_plotArea.bottom() + 5, 60, 15);
             painter.drawText(textRect, Qt::AlignCenter, label);
         }
@@ -1044,7 +1108,7 @@ void PlottingWidget::drawAxes(QPainter &painter)
 
         if (y >= m_plotArea.top() && y <= m_plotArea.bottom()) {
             painter.drawLine(m_plotArea.left(), y, m_plotArea.left() + 8, y);
-            QString label = formatAxisLabel(value, m_plotSettings.yAxisType == AxisType::Logarithmic);
+            QString label = PlotEngine::formatAxisLabel(value, m_plotSettings.yAxisType == AxisType::Logarithmic);
             QRect textRect(m_plotArea.left() - 75, y - 8, 70, 16);
             painter.drawText(textRect, Qt::AlignRight | Qt::AlignVCenter, label);
         }
@@ -1066,130 +1130,6 @@ void PlottingWidget::drawAxes(QPainter &painter)
     painter.drawText(titleRect, Qt::AlignCenter, m_plotSettings.plotTitle);
 }
 
-void PlottingWidget::drawAllCurves(QPainter &painter)
-{
-    for (const CurveData &curve : m_curves) {
-        if (curve.visible) {
-            drawCurve(painter, curve);
-        }
-    }
-}
-
-void PlottingWidget::drawCurve(QPainter &painter, const CurveData &curve)
-{
-    if (curve.drawType == CurveType::Step) {
-        drawStepCurve(painter, curve);
-        return;
-    }
-
-    if (curve.xData.isEmpty() || curve.yData.isEmpty()) {
-        return;
-    }
-
-    Qt::PenStyle penStyle = lineStyleToQt(curve.lineStyle);
-    painter.setPen(QPen(curve.color, curve.lineWidth, penStyle));
-
-    QVector<QPointF> points;
-    int maxPoints = qMin(curve.xData.size(), curve.yData.size());
-
-    for (int i = 0; i < maxPoints; ++i) {
-        if (!isValidDataPoint(curve.xData[i], curve.yData[i])) {
-            continue;
-        }
-
-        // 对数坐标需要正值
-        if (m_plotSettings.xAxisType == AxisType::Logarithmic && curve.xData[i] <= 0) continue;
-        if (m_plotSettings.yAxisType == AxisType::Logarithmic && curve.yData[i] <= 0) continue;
-
-        QPointF dataPoint(curve.xData[i], curve.yData[i]);
-        QPointF pixelPoint = dataToPixel(dataPoint);
-
-        if (pixelPoint.x() >= m_plotArea.left() - 50 && pixelPoint.x() <= m_plotArea.right() + 50 &&
-            pixelPoint.y() >= m_plotArea.top() - 50 && pixelPoint.y() <= m_plotArea.bottom() + 50) {
-            points.append(pixelPoint);
-        }
-    }
-
-    if (points.size() > 1) {
-        painter.setClipRect(m_plotArea.adjusted(-5, -5, 5, 5));
-        for (int i = 0; i < points.size() - 1; ++i) {
-            painter.drawLine(points[i], points[i + 1]);
-        }
-        painter.setClipping(false);
-    }
-
-    painter.setBrush(curve.color);
-    for (const QPointF &point : points) {
-        if (m_plotArea.contains(point.toPoint())) {
-            painter.drawEllipse(point, curve.pointSize/2, curve.pointSize/2);
-        }
-    }
-}
-
-void PlottingWidget::drawStepCurve(QPainter &painter, const CurveData &curve)
-{
-    if (curve.xData.isEmpty() || curve.yData.isEmpty()) {
-        return;
-    }
-
-    Qt::PenStyle penStyle = lineStyleToQt(curve.lineStyle);
-    painter.setPen(QPen(curve.color, curve.lineWidth, penStyle));
-
-    painter.setClipRect(m_plotArea.adjusted(-5, -5, 5, 5));
-
-    int dataSize = qMin(curve.xData.size(), curve.yData.size());
-
-    // 绘制阶梯状曲线
-    for (int i = 0; i < dataSize - 1; i += 2) {
-        if (i + 1 >= dataSize) break;
-
-        if (!isValidDataPoint(curve.xData[i], curve.yData[i]) ||
-            !isValidDataPoint(curve.xData[i+1], curve.yData[i+1])) {
-            continue;
-        }
-
-        // 对数坐标检查
-        if (m_plotSettings.xAxisType == AxisType::Logarithmic &&
-            (curve.xData[i] <= 0 || curve.xData[i+1] <= 0)) continue;
-        if (m_plotSettings.yAxisType == AxisType::Logarithmic &&
-            (curve.yData[i] <= 0 || curve.yData[i+1] <= 0)) continue;
-
-        QPointF segmentStart = dataToPixel(QPointF(curve.xData[i], curve.yData[i]));
-        QPointF segmentEnd = dataToPixel(QPointF(curve.xData[i+1], curve.yData[i+1]));
-
-        painter.drawLine(segmentStart, segmentEnd);
-
-        if (i + 2 < dataSize && i + 3 < dataSize) {
-            if (isValidDataPoint(curve.xData[i+2], curve.yData[i+2])) {
-                // 对数坐标检查
-                if (m_plotSettings.xAxisType == AxisType::Logarithmic && curve.xData[i+2] <= 0) continue;
-                if (m_plotSettings.yAxisType == AxisType::Logarithmic && curve.yData[i+2] <= 0) continue;
-
-                QPointF nextSegmentStart = dataToPixel(QPointF(curve.xData[i+2], curve.yData[i+2]));
-                QPointF verticalStart = segmentEnd;
-                QPointF verticalEnd = QPointF(segmentEnd.x(), nextSegmentStart.y());
-                painter.drawLine(verticalStart, verticalEnd);
-            }
-        }
-    }
-
-    painter.setClipping(false);
-
-    painter.setBrush(curve.color);
-    for (int i = 0; i < dataSize; i += 2) {
-        if (i < dataSize && isValidDataPoint(curve.xData[i], curve.yData[i])) {
-            // 对数坐标检查
-            if (m_plotSettings.xAxisType == AxisType::Logarithmic && curve.xData[i] <= 0) continue;
-            if (m_plotSettings.yAxisType == AxisType::Logarithmic && curve.yData[i] <= 0) continue;
-
-            QPointF pixelPoint = dataToPixel(QPointF(curve.xData[i], curve.yData[i]));
-            if (m_plotArea.contains(pixelPoint.toPoint())) {
-                painter.drawEllipse(pixelPoint, curve.pointSize/2, curve.pointSize/2);
-            }
-        }
-    }
-}
-
 void PlottingWidget::drawLegend(QPainter &painter)
 {
     if (m_curves.isEmpty()) return;
@@ -1353,6 +1293,22 @@ void PlottingWidget::drawAnnotations(QPainter &painter)
         painter.drawRect(textRect);
         painter.drawText(textRect, Qt::AlignCenter, text);
     }
+
+    // 流态识别标记：特征斜率拟合线 + 流态名称
+    for (const RegimeMarker &marker : m_regimeMarkers) {
+        painter.setPen(QPen(marker.color, 2, Qt::DashLine));
+        painter.drawLine(dataToPixel(marker.start), dataToPixel(marker.end));
+
+        painter.setPen(QPen(marker.color, 1));
+        QFontMetrics fm(painter.font());
+        QRect textRect = fm.boundingRect(marker.text);
+        textRect.moveCenter(dataToPixel(marker.labelPosition).toPoint());
+        textRect.adjust(-3, -1, 3, 1);
+
+        painter.fillRect(textRect, QColor(255, 255, 255, 220));
+        painter.drawRect(textRect);
+        painter.drawText(textRect, Qt::AlignCenter, marker.text);
+    }
 }
 
 void PlottingWidget::drawSelection(QPainter &painter)
@@ -1382,8 +1338,8 @@ void PlottingWidget::drawCoordinates(QPainter &)
 
     QPointF dataPos = pixelToData(m_lastMousePos);
     QString coordText = QString("X: %1, Y: %2")
-                            .arg(formatScientific(dataPos.x(), 3))
-                            .arg(formatScientific(dataPos.y(), 3));
+                            .arg(PlotEngine::formatScientific(dataPos.x(), 3))
+                            .arg(PlotEngine::formatScientific(dataPos.y(), 3));
 
     m_coordinateLabel->setText(coordText);
     m_coordinateLabel->adjustSize();
@@ -1467,7 +1423,7 @@ void PlottingWidget::setTableData(const TableData &data)
     ui->label_dataInfo->setText(dataInfo);
 }
 
-void PlottingWidget::setTableDataFromModel(QStandardItemModel* model, const QString &fileName)
+void PlottingWidget::setTableDataFromModel(DataTableModel* model, const QString &fileName)
 {
     if (!model) {
         return;
@@ -1478,7 +1434,7 @@ void PlottingWidget::setTableDataFromModel(QStandardItemModel* model, const QStr
     data.rowCount = model->rowCount();
 
     for (int col = 0; col < model->columnCount(); ++col) {
-        QString header = model->headerData(col, Qt::Horizontal).toString();
+        QString header = model->headerText(col);
         if (header.isEmpty()) {
             header = QString("列%1").arg(col + 1);
         }
@@ -1487,85 +1443,29 @@ void PlottingWidget::setTableDataFromModel(QStandardItemModel* model, const QStr
 
     data.columns.resize(model->columnCount());
     for (int col = 0; col < model->columnCount(); ++col) {
-        for (int row = 0; row < model->rowCount(); ++row) {
-            QStandardItem* item = model->item(row, col);
-            if (item) {
-                bool ok;
-                double value = item->text().toDouble(&ok);
-                if (ok) {
-                    data.columns[col].append(value);
-                } else {
-                    data.columns[col].append(0.0);
-                }
-            } else {
-                data.columns[col].append(0.0);
+        // 整列取出 double 数组，无效单元格按 0 处理
+        QVector<double> values = model->numericColumn(col);
+        for (double& value : values) {
+            if (std::isnan(value)) {
+                value = 0.0;
             }
         }
+        data.columns[col] = values;
     }
 
     setTableData(data);
 }
 
-// 修改后的坐标转换函数 - 正确处理对数坐标系
+// 数据坐标 → 像素坐标
 QPointF PlottingWidget::dataToPixel(const QPointF &dataPoint)
 {
-    double x, y;
-
-    // X轴坐标转换
-    if (m_plotSettings.xAxisType == AxisType::Logarithmic && dataPoint.x() > 0 && m_plotSettings.xMin > 0) {
-        double normalizedX = (log10(dataPoint.x()) - log10(m_plotSettings.xMin)) /
-                             (log10(m_plotSettings.xMax) - log10(m_plotSettings.xMin));
-        x = m_plotArea.left() + normalizedX * m_plotArea.width();
-    } else {
-        if (m_plotSettings.xMax > m_plotSettings.xMin) {
-            x = m_plotArea.left() + (dataPoint.x() - m_plotSettings.xMin) /
-                                        (m_plotSettings.xMax - m_plotSettings.xMin) * m_plotArea.width();
-        } else {
-            x = m_plotArea.left();
-        }
-    }
-
-    // Y轴坐标转换
-    if (m_plotSettings.yAxisType == AxisType::Logarithmic && dataPoint.y() > 0 && m_plotSettings.yMin > 0) {
-        double normalizedY = (log10(dataPoint.y()) - log10(m_plotSettings.yMin)) /
-                             (log10(m_plotSettings.yMax) - log10(m_plotSettings.yMin));
-        y = m_plotArea.bottom() - normalizedY * m_plotArea.height();
-    } else {
-        if (m_plotSettings.yMax > m_plotSettings.yMin) {
-            y = m_plotArea.bottom() - (dataPoint.y() - m_plotSettings.yMin) /
-                                          (m_plotSettings.yMax - m_plotSettings.yMin) * m_plotArea.height();
-        } else {
-            y = m_plotArea.bottom();
-        }
-    }
-
-    return QPointF(x, y);
+    return PlotEngine::mapping(m_plotArea, m_plotSettings).map(dataPoint);
 }
 
-// 修改后的像素到数据转换函数 - 正确处理对数坐标系
+// 像素坐标 → 数据坐标
 QPointF PlottingWidget::pixelToData(const QPointF &pixelPoint)
 {
-    double x, y;
-
-    // X轴反向转换
-    if (m_plotSettings.xAxisType == AxisType::Logarithmic && m_plotSettings.xMin > 0 && m_plotSettings.xMax > 0) {
-        double normalizedX = (pixelPoint.x() - m_plotArea.left()) / m_plotArea.width();
-        x = pow(10, log10(m_plotSettings.xMin) + normalizedX * (log10(m_plotSettings.xMax) - log10(m_plotSettings.xMin)));
-    } else {
-        x = m_plotSettings.xMin + (pixelPoint.x() - m_plotArea.left()) / m_plotArea.width() *
-                                      (m_plotSettings.xMax - m_plotSettings.xMin);
-    }
-
-    // Y轴反向转换
-    if (m_plotSettings.yAxisType == AxisType::Logarithmic && m_plotSettings.yMin > 0 && m_plotSettings.yMax > 0) {
-        double normalizedY = (m_plotArea.bottom() - pixelPoint.y()) / m_plotArea.height();
-        y = pow(10, log10(m_plotSettings.yMin) + normalizedY * (log10(m_plotSettings.yMax) - log10(m_plotSettings.yMin)));
-    } else {
-        y = m_plotSettings.yMin + (m_plotArea.bottom() - pixelPoint.y()) / m_plotArea.height() *
-                                      (m_plotSettings.yMax - m_plotSettings.yMin);
-    }
-
-    return QPointF(x, y);
+    return PlotEngine::mapping(m_plotArea, m_plotSettings).unmap(pixelPoint);
 }
 
 // 修改后的数据边界计算 - 正确处理对数坐标系
@@ -1573,36 +1473,14 @@ void PlottingWidget::calculateDataBounds()
 {
     if (m_curves.isEmpty()) return;
 
-    double minX = 1e10, maxX = -1e10;
-    double minY = 1e10, maxY = -1e10;
-    bool hasValidData = false;
-
-    for (const CurveData &curve : m_curves) {
-        if (!curve.visible || curve.xData.isEmpty() || curve.yData.isEmpty()) {
-            continue;
-        }
-
-        for (int i = 0; i < qMin(curve.xData.size(), curve.yData.size()); ++i) {
-            double x = curve.xData[i];
-            double y = curve.yData[i];
+    const bool xLog = m_plotSettings.xAxisType == AxisType::Logarithmic;
+    const bool yLog = m_plotSettings.yAxisType == AxisType::Logarithmic;
+    double minX, maxX, minY, maxY;
+    if (!PlotEngine::dataBounds(m_curves, xLog, yLog, m_curveIndex, minX, maxX, minY, maxY)) return;
 
-            if (!qIsFinite(x) || !qIsFinite(y)) continue;
-
-            // 对数坐标系需要正值
-            if (m_plotSettings.xAxisType == AxisType::Logarithmic && x <= 0) continue;
-            if (m_plotSettings.yAxisType == AxisType::Logarithmic && y <= 0) continue;
-
-            minX = qMin(minX, x);
-            maxX = qMax(maxX, x);
-            minY = qMin(minY, y);
-            maxY = qMax(maxY, y);
-            hasValidData = true;
-        }
-    }
-
-    if (hasValidData && minX < maxX && minY < maxY) {
-        QPair<double, double> xRange = calculateOptimalRange(minX, maxX, m_plotSettings.xAxisType == AxisType::Logarithmic);
-        QPair<double, double> yRange = calculateOptimalRange(minY, maxY, m_plotSettings.yAxisType == AxisType::Logarithmic);
+    if (minX < maxX && minY < maxY) {
+        QPair<double, double> xRange = PlotEngine::optimalRange(minX, maxX, xLog);
+        QPair<double, double> yRange = PlotEngine::optimalRange(minY, maxY, yLog);
 
         m_plotSettings.xMin = xRange.first;
         m_plotSettings.xMax = xRange.second;
@@ -1611,172 +1489,6 @@ void PlottingWidget::calculateDataBounds()
     }
 }
 
-// 修改后的最优范围计算函数 - 正确处理对数坐标系
-QPair<double, double> PlottingWidget::calculateOptimalRange(double min, double max, bool isLog)
-{
-    if (max <= min) {
-        return QPair<double, double>(min, max);
-    }
-
-    if (isLog) {
-        // 对数坐标系：扩展到最近的10的整数次幂，参考Saphir软件
-        if (min <= 0) min = 1e-10;  // 确保正值
-        if (max <= 0) max = 1;
-
-        double logMin = log10(min);
-        double logMax = log10(max);
-
-        // 向下取整到最近的10的次幂
-        double rangeMin = pow(10, floor(logMin));
-
-        // 向上取整到最近的10的次幂
-        double rangeMax = pow(10, ceil(logMax));
-
-        // 如果数据范围太小，至少显示一个数量级
-        if (rangeMax / rangeMin < 10) {
-            rangeMin = rangeMin / 10;
-            rangeMax = rangeMax * 10;
-        }
-
-        return QPair<double, double>(rangeMin, rangeMax);
-    } else {
-        // 线性坐标系：智能计算合适的范围
-        double range = max - min;
-
-        if (range == 0) {
-            // 如果所有数据相同，扩展范围
-            return QPair<double, double>(min - 1, max + 1);
-        }
-
-        // 计算合适的刻度间隔
-        double orderOfMagnitude = pow(10, floor(log10(range)));
-        double normalizedRange = range / orderOfMagnitude;
-
-        double tickInterval;
-        if (normalizedRange <= 1.5) {
-            tickInterval = orderOfMagnitude * 0.2;
-        } else if (normalizedRange <= 3) {
-            tickInterval = orderOfMagnitude * 0.5;
-        } else if (normalizedRange <= 7) {
-            tickInterval = orderOfMagnitude;
-        } else {
-            tickInterval = orderOfMagnitude * 2;
-        }
-
-        // 计算范围，确保包含所有数据点并留有余量
-        double rangeMin = floor(min / tickInterval) * tickInterval;
-        double rangeMax = ceil(max / tickInterval) * tickInterval;
-
-        // 添加5%的边距，使数据点不会贴边
-        double margin = (rangeMax - rangeMin) * 0.05;
-        rangeMin -= margin;
-        rangeMax += margin;
-
-        // 如果范围包含0，确保0点对齐到刻度
-        if (rangeMin < 0 && rangeMax > 0) {
-            rangeMin = floor(rangeMin / tickInterval) * tickInterval;
-            rangeMax = ceil(rangeMax / tickInterval) * tickInterval;
-        }
-
-        // 如果原始最小值接近0，将范围最小值设为0
-        if (min > 0 && rangeMin < 0 && min < range * 0.2) {
-            rangeMin = 0;
-        }
-
-        return QPair<double, double>(rangeMin, rangeMax);
-    }
-}
-
-// 优化的对数坐标标签生成函数，参考Saphir软件
-QVector<double> PlottingWidget::generateOptimizedAxisLabels(double min, double max, AxisType axisType)
-{
-    QVector<double> labels;
-
-    if (max <= min) {
-        return labels;
-    }
-
-    if (axisType == AxisType::Logarithmic) {
-        // 对数坐标系：生成Saphir软件风格的对数标签
-        if (min <= 0) min = 1e-10;
-        if (max <= 0) max = 1;
-
-        double logMin = log10(min);
-        double logMax = log10(max);
-
-        int startPower = qFloor(logMin);
-        int endPower = qCeil(logMax);
-
-        // 添加主要的10的整数次幂
-        for (int power = startPower; power <= endPower; ++power) {
-            double value = qPow(10, power);
-            if (value >= min * 0.999 && value <= max * 1.001) {
-                labels.append(value);
-            }
-        }
-
-        // 根据范围决定是否显示中间刻度
-        bool showMinorTicks = (endPower - startPower) <= 3;
-
-        if (showMinorTicks) {
-            // 添加次要刻度（2, 3, 5）
-            for (int power = startPower; power < endPower; ++power) {
-                for (int mult : {2, 3, 5}) {
-                    double value = mult * qPow(10, power);
-                    if (value > min && value < max) {
-                        labels.append(value);
-                    }
-                }
-            }
-        }
-
-        // 排序去重
-        std::sort(labels.begin(), labels.end());
-        labels.erase(std::unique(labels.begin(), labels.end(), [](double a, double b) {
-                         return qAbs(a - b) < 1e-10;
-                     }), labels.end());
-
-    } else {
-        // 线性坐标系：智能生成合适的刻度
-        double range = max - min;
-        double logRange = log10(range);
-        int magnitude = qFloor(logRange);
-        double step = qPow(10, magnitude);
-
-        double labelCount = range / step;
-        if (labelCount < 4) {
-            step = step / 5;
-        } else if (labelCount < 6) {
-            step = step / 2;
-        } else if (labelCount > 10) {
-            step = step * 2;
-        }
-
-        double startValue = qFloor(min / step) * step;
-        if (startValue < min) {
-            startValue += step;
-        }
-
-        // 确保包含0（如果在范围内）
-        if (min <= 0 && max >= 0) {
-            labels.append(0);
-        }
-
-        for (double value = startValue; value <= max + step * 0.001; value += step) {
-            if (value >= min && value <= max && qAbs(value) > 1e-10) {
-                labels.append(value);
-            }
-        }
-
-        std::sort(labels.begin(), labels.end());
-        labels.erase(std::unique(labels.begin(), labels.end(), [](double a, double b) {
-                         return qAbs(a - b) < 1e-10;
-                     }), labels.end());
-    }
-
-    return labels;
-}
-
 // 鼠标事件处理
 void PlottingWidget::mousePressEvent(QMouseEvent *event)
 {
@@ -1808,6 +1520,15 @@ void PlottingWidget::mousePressEvent(QMouseEvent *event)
         } else {
             m_isDragging = true;
             m_isPanning = true;
+
+            // 拾取附近的数据点
+            const double pickRadius = 8.0;
+            int curveIndex, pointIndex;
+            if (PlotEngine::nearestPoint(m_curves, PlotEngine::mapping(m_plotArea, m_plotSettings), plotPos,
+                                         pickRadius, m_curveIndex, curveIndex, pointIndex)) {
+                const CurveData &curve = m_curves[curveIndex];
+                emit dataPointClicked(curve.xData[pointIndex], curve.yData[pointIndex]);
+            }
         }
     }
 }
@@ -1835,11 +1556,6 @@ void PlottingWidget::mouseMoveEvent(QMouseEvent *event)
         m_lastMousePos = plotPos;
     }
 
-    if (ui->widget_plot->rect().contains(plotPos) && m_plotArea.contains(plotPos)) {
-        QPointF dataPos = pixelToData(plotPos);
-        emit dataPointClicked(dataPos.x(), dataPos.y());
-    }
-
     updatePlot();
 }
 
@@ -1929,6 +1645,13 @@ void PlottingWidget::zoomToFit()
     updatePlot();
 }
 
+void PlottingWidget::fitYToVisibleX()
+{
+    if (PlotEngine::fitYToX(m_plotSettings, m_curves, m_curveIndex)) {
+        updatePlot();
+    }
+}
+
 // 新增单独缩放功能
 void PlottingWidget::zoomXIn()
 {
@@ -2016,75 +1739,13 @@ void PlottingWidget::zoomYOut()
 
 void PlottingWidget::zoomAtPoint(const QPointF &point, double factor)
 {
-    QPointF dataPoint = pixelToData(point);
-
-    if (m_plotSettings.xAxisType == AxisType::Logarithmic && m_plotSettings.xMin > 0 && m_plotSettings.xMax > 0 && dataPoint.x() > 0) {
-        // 对数坐标系下的缩放
-        double logMin = log10(m_plotSettings.xMin);
-        double logMax = log10(m_plotSettings.xMax);
-        double logPoint = log10(dataPoint.x());
-        double logRange = logMax - logMin;
-        double newLogRange = logRange / factor;
-
-        m_plotSettings.xMin = pow(10, logPoint - newLogRange * (logPoint - logMin) / logRange);
-        m_plotSettings.xMax = pow(10, logPoint + newLogRange * (logMax - logPoint) / logRange);
-    } else {
-        double xRange = m_plotSettings.xMax - m_plotSettings.xMin;
-        double newXRange = xRange / factor;
-        m_plotSettings.xMin = dataPoint.x() - newXRange * (dataPoint.x() - m_plotSettings.xMin) / xRange;
-        m_plotSettings.xMax = dataPoint.x() + newXRange * (m_plotSettings.xMax - dataPoint.x()) / xRange;
-    }
-
-    if (m_plotSettings.yAxisType == AxisType::Logarithmic && m_plotSettings.yMin > 0 && m_plotSettings.yMax > 0 && dataPoint.y() > 0) {
-        // 对数坐标系下的缩放
-        double logMin = log10(m_plotSettings.yMin);
-        double logMax = log10(m_plotSettings.yMax);
-        double logPoint = log10(dataPoint.y());
-        double logRange = logMax - logMin;
-        double newLogRange = logRange / factor;
-
-        m_plotSettings.yMin = pow(10, logPoint - newLogRange * (logPoint - logMin) / logRange);
-        m_plotSettings.yMax = pow(10, logPoint + newLogRange * (logMax - logPoint) / logRange);
-    } else {
-        double yRange = m_plotSettings.yMax - m_plotSettings.yMin;
-        double newYRange = yRange / factor;
-        m_plotSettings.yMin = dataPoint.y() - newYRange * (dataPoint.y() - m_plotSettings.yMin) / yRange;
-        m_plotSettings.yMax = dataPoint.y() + newYRange * (m_plotSettings.yMax - dataPoint.y()) / yRange;
-    }
-
+    PlotEngine::zoomAt(m_plotSettings, m_plotArea, point, factor, factor);
     updatePlot();
 }
 
 void PlottingWidget::panView(const QPointF &delta)
 {
-    if (m_plotSettings.xAxisType == AxisType::Logarithmic && m_plotSettings.xMin > 0 && m_plotSettings.xMax > 0) {
-        // 对数坐标系下的平移
-        double logMin = log10(m_plotSettings.xMin);
-        double logMax = log10(m_plotSettings.xMax);
-        double logRange = logMax - logMin;
-        double logDelta = -delta.x() / m_plotArea.width() * logRange;
-        m_plotSettings.xMin = pow(10, logMin + logDelta);
-        m_plotSettings.xMax = pow(10, logMax + logDelta);
-    } else {
-        QPointF dataDelta = pixelToData(delta) - pixelToData(QPointF(0, 0));
-        m_plotSettings.xMin -= dataDelta.x();
-        m_plotSettings.xMax -= dataDelta.x();
-    }
-
-    if (m_plotSettings.yAxisType == AxisType::Logarithmic && m_plotSettings.yMin > 0 && m_plotSettings.yMax > 0) {
-        // 对数坐标系下的平移
-        double logMin = log10(m_plotSettings.yMin);
-        double logMax = log10(m_plotSettings.yMax);
-        double logRange = logMax - logMin;
-        double logDelta = delta.y() / m_plotArea.height() * logRange;
-        m_plotSettings.yMin = pow(10, logMin + logDelta);
-        m_plotSettings.yMax = pow(10, logMax + logDelta);
-    } else {
-        QPointF dataDelta = pixelToData(delta) - pixelToData(QPointF(0, 0));
-        m_plotSettings.yMin -= dataDelta.y();
-        m_plotSettings.yMax -= dataDelta.y();
-    }
-
+    PlotEngine::pan(m_plotSettings, m_plotArea, delta);
     updatePlot();
 }
 
@@ -2152,8 +1813,8 @@ void PlottingWidget::onMarkerAdded()
     updatePlot();
 
     QString message = QString("标记已添加在 (%1, %2)")
-                          .arg(formatScientific(dataPos.x(), 3))
-                          .arg(formatScientific(dataPos.y(), 3));
+                          .arg(PlotEngine::formatScientific(dataPos.x(), 3))
+                          .arg(PlotEngine::formatScientific(dataPos.y(), 3));
     QMessageBox::information(this, "添加标记", message);
 }
 
@@ -2168,8 +1829,8 @@ void PlottingWidget::onAnnotationAdded()
         updatePlot();
 
         QString message = QString("注释已添加在 (%1, %2)")
-                              .arg(formatScientific(dataPos.x(), 3))
-                              .arg(formatScientific(dataPos.y(), 3));
+                              .arg(PlotEngine::formatScientific(dataPos.x(), 3))
+                              .arg(PlotEngine::formatScientific(dataPos.y(), 3));
         QMessageBox::information(this, "添加注释", message);
     }
 }
@@ -2250,41 +1911,11 @@ void PlottingWidget::paintEvent(QPaintEvent *event)
     QWidget::paintEvent(event);
 }
 
-// 辅助函数
-QString PlottingWidget::formatScientific(double value, int decimals)
-{
-    if (qIsNaN(value) || !qIsFinite(value)) {
-        return "N/A";
-    }
-
-    if (qAbs(value) >= 1000 || (qAbs(value) < 0.01 && value != 0)) {
-        return QString::number(value, 'e', decimals);
-    } else {
-        return QString::number(value, 'f', decimals);
-    }
-}
-
 bool PlottingWidget::isValidDataPoint(double x, double y)
 {
     return !qIsNaN(x) && !qIsNaN(y) && qIsFinite(x) && qIsFinite(y);
 }
 
-double PlottingWidget::transformToLogScale(double value, bool isLog)
-{
-    if (isLog && value > 0) {
-        return log10(value);
-    }
-    return value;
-}
-
-double PlottingWidget::transformFromLogScale(double value, bool isLog)
-{
-    if (isLog) {
-        return pow(10, value);
-    }
-    return value;
-}
-
 // 其他数据管理函数
 void PlottingWidget::setWellTestData(const WellTestData &data)
 {
@@ -2306,6 +1937,7 @@ void PlottingWidget::clearAllData()
     m_currentData = WellTestData();
     m_markers.clear();
     m_annotations.clear();
+    m_regimeMarkers.clear();
     m_hasTableData = false;
     m_tableData = TableData();
     m_curves.clear();
@@ -2425,13 +2057,37 @@ void PlottingWidget::exportPlot(const QString &fileName, const QString &format)
     }
 }
 
-// 分析函数实现（占位符）
+// 分析函数实现
 void PlottingWidget::performLogLogAnalysis()
 {
-    QMap<QString, double> results;
-    QString message = "双对数分析完成\n使用当前显示的数据进行分析";
+    FlowRegimeResult regimes;
+    QString errorMessage;
+    if (!identifyFlowRegimes(false, regimes, errorMessage)) {
+        QMessageBox::warning(this, "双对数分析", errorMessage);
+        return;
+    }
+
+    // 无导数曲线时叠加分箱导数，便于对照流态标记
+    if (findAnalysisCurveIndex(true) < 0) {
+        CurveData derivativeCurve;
+        derivativeCurve.name = "流态识别导数";
+        derivativeCurve.color = QColor("#6A1B9A");
+        derivativeCurve.xData = regimes.binTime;
+        derivativeCurve.yData = regimes.binDerivative;
+        derivativeCurve.xLabel = "时间";
+        derivativeCurve.yLabel = "压力导数";
+        derivativeCurve.curveType = "压力导数";
+        derivativeCurve.xAxisType = AxisType::Logarithmic;
+        derivativeCurve.yAxisType = AxisType::Logarithmic;
+        derivativeCurve.lineWidth = 1;
+        derivativeCurve.pointSize = 3;
+        addCurve(derivativeCurve);
+    }
 
-    QMessageBox::information(this, "分析完成", "双对数分析功能正在开发中！");
+    showRegimeMarkers(regimes);
+
+    QMap<QString, double> results = regimeResultsToMap(regimes);
+    QMessageBox::information(this, "双对数分析完成", regimeSummaryText(regimes));
     emit analysisCompleted("双对数分析", results);
 }
 
@@ -2451,14 +2107,151 @@ void PlottingWidget::performCartesianAnalysis()
 
 void PlottingWidget::performDerivativeAnalysis()
 {
-    QMap<QString, double> results;
-    QMessageBox::information(this, "分析完成", "压力导数分析功能正在开发中！");
+    FlowRegimeResult regimes;
+    QString errorMessage;
+    if (!identifyFlowRegimes(true, regimes, errorMessage)) {
+        QMessageBox::warning(this, "压力导数分析", errorMessage);
+        return;
+    }
+
+    showRegimeMarkers(regimes);
+
+    QMap<QString, double> results = regimeResultsToMap(regimes);
+    QMessageBox::information(this, "压力导数分析完成", regimeSummaryText(regimes));
     emit analysisCompleted("压力导数分析", results);
 }
 
 void PlottingWidget::performModelMatching()
 {
-    QMap<QString, double> results;
-    QMessageBox::information(this, "分析完成", "模型匹配功能正在开发中！");
+    FlowRegimeResult regimes;
+    QString errorMessage;
+    if (!identifyFlowRegimes(true, regimes, errorMessage)) {
+        QMessageBox::warning(this, "模型匹配", errorMessage);
+        return;
+    }
+
+    showRegimeMarkers(regimes);
+
+    int modelIndex = FlowRegimeIdentifier::recommendModelIndex(regimes);
+    QString modelName = ModelManager::getModelTypeName(static_cast<ModelManager::ModelType>(modelIndex));
+
+    QMap<QString, double> results = regimeResultsToMap(regimes);
+    results["推荐模型"] = modelIndex + 1;
+
+    QMessageBox::information(this, "模型匹配完成",
+                             regimeSummaryText(regimes) + QString("\n推荐模型：%1").arg(modelName));
     emit analysisCompleted("模型匹配", results);
 }
+
+// ============================================================================
+// 流态识别辅助函数
+// ============================================================================
+
+// 查找参与分析的曲线：derivativeCurve 为 true 时找导数曲线，否则找压差/压力曲线
+int PlottingWidget::findAnalysisCurveIndex(bool derivativeCurve) const
+{
+    for (int i = 0; i < m_curves.size(); ++i) {
+        const CurveData &curve = m_curves[i];
+        if (!curve.visible || curve.xData.isEmpty() || curve.yData.isEmpty()) continue;
+
+        bool isDerivative = curve.name.contains("导数") || curve.yLabel.contains("导数") ||
+                            curve.name.contains("derivative", Qt::CaseInsensitive);
+        if (isDerivative == derivativeCurve) return i;
+    }
+    return -1;
+}
+
+bool PlottingWidget::identifyFlowRegimes(bool preferDerivative, FlowRegimeResult &regimes, QString &errorMessage)
+{
+    int derivativeIndex = findAnalysisCurveIndex(true);
+    int pressureIndex = findAnalysisCurveIndex(false);
+
+    if (derivativeIndex < 0 && pressureIndex < 0) {
+        errorMessage = "请先添加压差或压力导数曲线！";
+        return false;
+    }
+
+    if ((preferDerivative || pressureIndex < 0) && derivativeIndex >= 0) {
+        const CurveData &curve = m_curves[derivativeIndex];
+        regimes = FlowRegimeIdentifier::identifyFromDerivative(curve.xData, curve.yData);
+    } else {
+        const CurveData &curve = m_curves[pressureIndex];
+        regimes = FlowRegimeIdentifier::identifyFromPressure(curve.xData, curve.yData);
+    }
+
+    if (!regimes.success) {
+        errorMessage = regimes.errorMessage;
+        return false;
+    }
+    return true;
+}
+
+// 在双对数坐标下显示各流态的特征斜率线和名称
+void PlottingWidget::showRegimeMarkers(const FlowRegimeResult &regimes)
+{
+    m_regimeMarkers.clear();
+
+    for (const FlowRegimeSegment &segment : regimes.segments) {
+        if (segment.type == FlowRegimeType::Transition) continue;
+
+        double midTime = std::sqrt(segment.startTime * segment.endTime);
+
+        RegimeMarker marker;
+        marker.start = QPointF(segment.startTime, segment.derivativeAt(segment.startTime));
+        marker.end = QPointF(segment.endTime, segment.derivativeAt(segment.endTime));
+        marker.labelPosition = QPointF(midTime, segment.derivativeAt(midTime) * 1.8);
+        marker.text = QString("%1 (m=%2)").arg(FlowRegimeIdentifier::regimeName(segment.type))
+                          .arg(segment.slope, 0, 'f', 2);
+        marker.color = FlowRegimeIdentifier::regimeColor(segment.type);
+        m_regimeMarkers.append(marker);
+    }
+
+    m_plotSettings.logScaleX = true;
+    m_plotSettings.logScaleY = true;
+    m_plotSettings.xAxisType = AxisType::Logarithmic;
+    m_plotSettings.yAxisType = AxisType::Logarithmic;
+    calculateDataBounds();
+    updatePlot();
+}
+
+QMap<QString, double> PlottingWidget::regimeResultsToMap(const FlowRegimeResult &regimes) const
+{
+    QMap<QString, double> results;
+    results["数据点数"] = regimes.processedRows;
+    results["流态段数"] = regimes.segments.size();
+    results["径向流导数平台"] = regimes.radialDerivativeLevel;
+    results["早期最大斜率"] = regimes.maxEarlySlope;
+
+    for (int i = 0; i < regimes.segments.size(); ++i) {
+        const FlowRegimeSegment &segment = regimes.segments[i];
+        QString prefix = QString("段%1_").arg(i + 1);
+        results[prefix + "类型"] = static_cast<int>(segment.type);
+        results[prefix + "开始时间"] = segment.startTime;
+        results[prefix + "结束时间"] = segment.endTime;
+        results[prefix + "斜率"] = segment.slope;
+    }
+    return results;
+}
+
+QString PlottingWidget::regimeSummaryText(const FlowRegimeResult &regimes) const
+{
+    QString text = QString("共 %1 个数据点，识别到以下流态：\n").arg(regimes.processedRows);
+
+    int regimeCount = 0;
+    for (const FlowRegimeSegment &segment : regimes.segments) {
+        if (segment.type == FlowRegimeType::Transition) continue;
+        text += QString("  %1：%2 ~ %3，斜率 %4\n")
+                    .arg(FlowRegimeIdentifier::regimeName(segment.type))
+                    .arg(segment.startTime, 0, 'g', 4)
+                    .arg(segment.endTime, 0, 'g', 4)
+                    .arg(segment.slope, 0, 'f', 3);
+        ++regimeCount;
+    }
+    if (regimeCount == 0) {
+        text += "  未识别到明确的流态段（均为过渡段）\n";
+    }
+    if (regimes.radialDerivativeLevel > 0) {
+        text += QString("径向流导数平台：%1\n").arg(regimes.radialDerivativeLevel, 0, 'g', 5);
+    }
+    return text;
+}
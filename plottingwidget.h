@@ -29,7 +29,6 @@
 #include <QScrollArea>
 #include <QSlider>
 #include <QProgressBar>
-#include <QStandardItemModel>
 #include <QMessageBox>
 #include <QLineEdit>
 #include <QListWidget>
@@ -41,6 +40,14 @@
 #include <QMdiArea>
 #include <QMdiSubWindow>
 #include <cmath>
+#include "datatablemodel.h"
+#include "pressurederivativecalculator.h"
+#include "flowregimeidentifier.h"
+#include "curveindex.h"
+#include "curvelod.h"
+#include "plotengine.h"
+#include "plotlayercache.h"
+#include "curverenderer.h"
 
 namespace Ui {
 class PlottingWidget;
@@ -135,6 +142,15 @@ struct PlotSettings {
     AxisType yAxisType;           // Y轴类型
 };
 
+// 流态识别标记（拟合直线 + 文字标签）
+struct RegimeMarker {
+    QPointF start;          // 拟合直线起点（数据坐标）
+    QPointF end;            // 拟合直线终点（数据坐标）
+    QPointF labelPosition;  // 标签位置（数据坐标）
+    QString text;
+    QColor color;
+};
+
 // 双图窗口类（用于压力产量联合显示）- 修改后版本
 class DualPlotWindow : public QMainWindow
 {
@@ -178,6 +194,10 @@ private:
     PlotSettings m_productionSettings;
     QRect m_pressurePlotArea;
     QRect m_productionPlotArea;
+    CurveRenderer m_pressureRenderer;     // 压力图曲线层
+    CurveRenderer m_productionRenderer;   // 产量图曲线层
+    CurveIndexCache m_pressureIndex;      // 压力图区间索引
+    CurveIndexCache m_productionIndex;    // 产量图区间索引
 
     // 交互状态 - 分别为压力图和产量图
     bool m_pressureDragging;
@@ -215,8 +235,6 @@ private:
     void drawAxesOnWidget(QPainter &painter, const QRect &plotArea, const PlotSettings &settings);
     void drawLegendOnWidget(QPainter &painter, const QVector<CurveData> &curves,
                             const QRect &plotArea, const QPoint &offset);
-    void drawCurveOnWidget(QPainter &painter, const CurveData &curve,
-                           const QRect &plotArea, const PlotSettings &settings);
 
     // 坐标转换函数
     QPointF pressureDataToPixel(const QPointF &dataPoint);
@@ -259,6 +277,7 @@ private slots:
     void onToggleGrid();
     void onToggleLegend();
     void onResetZoom();
+    void onFitYToData();
     void onZoomIn();
     void onZoomOut();
 
@@ -271,6 +290,9 @@ private:
     PlotSettings m_plotSettings;
     QRect m_plotArea;
     QRect m_legendArea;
+    PlotLayerCache m_layerCache;  // 静态层缓存
+    CurveRenderer m_curveRenderer;  // 曲线层渲染
+    CurveIndexCache m_curveIndex;  // 区间索引（自适应、拾取）
 
     // 交互状态
     bool m_isDragging;
@@ -294,6 +316,7 @@ private:
     QAction* m_zoomInAction;
     QAction* m_zoomOutAction;
     QAction* m_resetZoomAction;
+    QAction* m_fitYAction;
 
     void setupUI();
     void setupContextMenu();
@@ -304,9 +327,6 @@ private:
     void drawBackground(QPainter &painter);
     void drawGrid(QPainter &painter);
     void drawAxes(QPainter &painter);
-    void drawCurves(QPainter &painter);
-    void drawCurve(QPainter &painter, const CurveData &curve);
-    void drawStepCurve(QPainter &painter, const CurveData &curve);
     void drawLegend(QPainter &painter);
     void drawMarkers(QPainter &painter);
     void drawAnnotations(QPainter &painter);
@@ -318,19 +338,10 @@ private:
 
     // 数据边界计算
     void calculateDataBounds();
-    QPair<double, double> calculateOptimalRange(double min, double max, bool isLog);
 
     // 缩放和平移
     void zoomAtPoint(const QPointF &point, double factor);
     void panView(const QPointF &delta);
-
-    // 辅助函数
-    double transformToLogScale(double value, bool isLog);
-    double transformFromLogScale(double value, bool isLog);
-    QVector<double> generateOptimizedAxisLabels(double min, double max, AxisType axisType);
-    QString formatAxisLabel(double value, bool isLog);
-    QString formatScientific(double value, int decimals = 2);
-    bool isValidDataPoint(double x, double y);
 };
 
 class PlottingWidget : public QWidget
@@ -349,7 +360,7 @@ public:
 
     // 设置表格数据
     void setTableData(const TableData &data);
-    void setTableDataFromModel(QStandardItemModel* model, const QString &fileName = "");
+    void setTableDataFromModel(DataTableModel* model, const QString &fileName = "");
 
     // 多曲线管理
     void addCurve(const CurveData &curve);
@@ -374,6 +385,9 @@ public:
     void zoomYIn();
     void zoomYOut();
 
+    // Y 轴适应当前 X 范围内的数据
+    void fitYToVisibleX();
+
     void exportPlot(const QString &fileName, const QString &format = "PNG");
 
     // 设置管理
@@ -442,6 +456,9 @@ private:
     PlotSettings m_plotSettings;
     QRect m_plotArea;
     QRect m_legendArea;           // 图例区域
+    PlotLayerCache m_layerCache;  // 静态层缓存
+    CurveRenderer m_curveRenderer;  // 曲线层渲染
+    CurveIndexCache m_curveIndex;  // 区间索引（自适应、拾取）
 
     // 交互状态
     bool m_isDragging;
@@ -482,6 +499,7 @@ private:
     QAction* m_zoomOutAction;
     QAction* m_zoomFitAction;
     QAction* m_resetZoomAction;
+    QAction* m_fitYAction;
 
     // 新增单独缩放菜单项
     QAction* m_zoomXInAction;
@@ -493,6 +511,9 @@ private:
     QVector<QPointF> m_markers;
     QVector<QPair<QPointF, QString>> m_annotations;
 
+    // 流态识别标记（每次分析整体替换）
+    QVector<RegimeMarker> m_regimeMarkers;
+
     // 坐标显示
     QLabel* m_coordinateLabel;
 
@@ -511,9 +532,6 @@ private:
     void drawBackground(QPainter &painter);
     void drawGrid(QPainter &painter);
     void drawAxes(QPainter &painter);
-    void drawAllCurves(QPainter &painter);
-    void drawCurve(QPainter &painter, const CurveData &curve);
-    void drawStepCurve(QPainter &painter, const CurveData &curve);
     void drawLegend(QPainter &painter);
     void drawMarkers(QPainter &painter);
     void drawAnnotations(QPainter &painter);
@@ -525,16 +543,6 @@ private:
     QPointF dataToPixel(const QPointF &dataPoint);
     QPointF pixelToData(const QPointF &pixelPoint);
 
-    // 对数坐标转换函数
-    double transformToLogScale(double value, bool isLog);
-    double transformFromLogScale(double value, bool isLog);
-
-    // 坐标轴标签生成函数 - 优化后的版本，参考Saphir软件
-    QVector<double> generateOptimizedAxisLabels(double min, double max, AxisType axisType);
-
-    // 格式化坐标轴标签函数 - 新增，参考Saphir软件风格
-    QString formatAxisLabel(double value, bool isLog);
-
     // 计算函数
     void calculateDataBounds();
 
@@ -547,18 +555,21 @@ private:
 
     // 辅助函数
     void updateControlsFromSettings();
-    QString formatScientific(double value, int decimals = 2);
 
     // 数据处理函数
     bool isValidDataPoint(double x, double y);
 
-    // 数据范围计算优化函数
-    QPair<double, double> calculateOptimalRange(double min, double max, bool isLog);
-
     // 绘图窗口创建函数
     PlotWindow* createPlotWindow(const QString &title, const QString &dataType);
     DualPlotWindow* createDualPlotWindow(const QString &title);
 
+    // 流态识别辅助函数
+    int findAnalysisCurveIndex(bool derivativeCurve) const;
+    bool identifyFlowRegimes(bool preferDerivative, FlowRegimeResult &regimes, QString &errorMessage);
+    void showRegimeMarkers(const FlowRegimeResult &regimes);
+    QMap<QString, double> regimeResultsToMap(const FlowRegimeResult &regimes) const;
+    QString regimeSummaryText(const FlowRegimeResult &regimes) const;
+
     // 对话框函数
     void showDataSelectionDialog(const QString &plotType);
     void showPressureProdDataDialog();  // 新的压力产量联合对话框
@@ -582,6 +593,9 @@ private:
                                         const QString &timeLabel = "", const QString &productionLabel = "",
                                         const QString &timeUnit = "", const QString &productionUnit = "",
                                         int lineWidth = 2, int pointSize = 4);
+
+    // 时间轴变换：将曲线X数据替换为等效时间或叠加时间函数（mode: 1=Agarwal等效时间, 2=叠加时间）
+    bool applyTimeAxisTransform(CurveData &curve, int timeColumn, int yColumn, int rateColumn, int mode);
 };
 
 // 美化的图例绘制函数（可以作为全局辅助函数）
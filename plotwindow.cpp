@@ -45,6 +45,8 @@ PlotWindow::PlotWindow(const QString &windowTitle, QWidget *parent)
     setMouseTracking(true);
     m_plotWidget->setMouseTracking(true);
     m_plotWidget->installEventFilter(this);
+    connect(&m_curveRenderer, &CurveRenderer::frameReady,
+            m_plotWidget, QOverload<>::of(&QWidget::update));
 }
 
 PlotWindow::~PlotWindow()
@@ -175,6 +177,7 @@ void PlotWindow::setupContextMenu()
     m_zoomInAction = m_contextMenu->addAction("🔍➕ 放大", this, &PlotWindow::onZoomIn);
     m_zoomOutAction = m_contextMenu->addAction("🔍➖ 缩小", this, &PlotWindow::onZoomOut);
     m_resetZoomAction = m_contextMenu->addAction("🔄 重置缩放", this, &PlotWindow::onResetZoom);
+    m_fitYAction = m_contextMenu->addAction("↕️ 纵向适应数据", this, &PlotWindow::onFitYToData);
 }
 
 void PlotWindow::initializePlotSettings()
@@ -251,16 +254,24 @@ void PlotWindow::paintPlotArea(QPainter &painter)
     QRect widgetRect = m_plotWidget->rect();
     m_plotArea = QRect(80, 50, widgetRect.width() - 160, widgetRect.height() - 100);
 
-    drawBackground(painter);
+    // 静态层只在输入变化时重绘，选择框、图例每帧直接绘制
+    const qreal dpr = m_plotWidget->devicePixelRatioF();
 
-    if (m_plotSettings.showGrid) {
-        drawGrid(painter);
-    }
-
-    drawAxes(painter);
+    PlotLayerKey staticKey;
+    staticKey.add(m_plotArea).add(m_plotSettings);
+    painter.drawImage(0, 0, m_layerCache.layer(PlotLayerCache::StaticLayer, widgetRect.size(), dpr,
+                                               staticKey.value(), [this](QPainter &layer) {
+        drawBackground(layer);
+        if (m_plotSettings.showGrid) {
+            drawGrid(layer);
+        }
+        drawAxes(layer);
+    }));
 
+    // 曲线层：数据量大时在后台线程渲染，期间显示变换后的旧帧
     if (!m_curves.isEmpty()) {
-        drawCurves(painter);
+        m_curveRenderer.paint(painter, m_curves, PlotEngine::mapping(m_plotArea, m_plotSettings),
+                              widgetRect.size(), dpr);
     }
 
     drawMarkers(painter);
@@ -288,8 +299,8 @@ void PlotWindow::drawGrid(QPainter &painter)
 {
     painter.setPen(QPen(m_plotSettings.gridColor, 1, Qt::DotLine));
 
-    QVector<double> xLabels = generateOptimizedAxisLabels(m_plotSettings.xMin, m_plotSettings.xMax, m_plotSettings.xAxisType);
-    QVector<double> yLabels = generateOptimizedAxisLabels(m_plotSettings.yMin, m_plotSettings.yMax, m_plotSettings.yAxisType);
+    QVector<double> xLabels = PlotEngine::axisTicks(m_plotSettings.xMin, m_plotSettings.xMax, m_plotSettings.xAxisType);
+    QVector<double> yLabels = PlotEngine::axisTicks(m_plotSettings.yMin, m_plotSettings.yMax, m_plotSettings.yAxisType);
 
     // 绘制X轴网格线 - 使用正确的对数转换
     for (double value : xLabels) {
@@ -331,8 +342,8 @@ void PlotWindow::drawAxes(QPainter &painter)
     painter.setPen(QPen(Qt::black, 2));
     painter.setFont(QFont("Arial", 9));
 
-    QVector<double> xLabels = generateOptimizedAxisLabels(m_plotSettings.xMin, m_plotSettings.xMax, m_plotSettings.xAxisType);
-    QVector<double> yLabels = generateOptimizedAxisLabels(m_plotSettings.yMin, m_plotSettings.yMax, m_plotSettings.yAxisType);
+    QVector<double> xLabels = PlotEngine::axisTicks(m_plotSettings.xMin, m_plotSettings.xMax, m_plotSettings.xAxisType);
+    QVector<double> yLabels = PlotEngine::axisTicks(m_plotSettings.yMin, m_plotSettings.yMax, m_plotSettings.yAxisType);
 
     // 绘制X轴标签 - 参考Saphir软件风格
     for (double value : xLabels) {
@@ -348,7 +359,7 @@ void PlotWindow::drawAxes(QPainter &painter)
 
         if (x >= m_plotArea.left() && x <= m_plotArea.right()) {
             painter.drawLine(x, m_plotArea.bottom(), x, m_plotArea.bottom() - 8);
-            QString label = formatAxisLabel(value, m_plotSettings.logScaleX);
+            QString label = PlotEngine::formatAxisLabel(value, m_plotSettings.logScaleX);
             QRect textRect(x - 30, m_plotArea.bottom() + 5, 60, 15);
             painter.drawText(textRect, Qt::AlignCenter, label);
         }
@@ -368,7 +379,7 @@ void PlotWindow::drawAxes(QPainter &painter)
 
         if (y >= m_plotArea.top() && y <= m_plotArea.bottom()) {
             painter.drawLine(m_plotArea.left(), y, m_plotArea.left() + 8, y);
-            QString label = formatAxisLabel(value, m_plotSettings.logScaleY);
+            QString label = PlotEngine::formatAxisLabel(value, m_plotSettings.logScaleY);
             QRect textRect(m_plotArea.left() - 75, y - 8, 70, 16);
             painter.drawText(textRect, Qt::AlignRight | Qt::AlignVCenter, label);
         }
@@ -390,111 +401,6 @@ void PlotWindow::drawAxes(QPainter &painter)
     painter.drawText(titleRect, Qt::AlignCenter, m_plotSettings.plotTitle);
 }
 
-void PlotWindow::drawCurves(QPainter &painter)
-{
-    for (const CurveData &curve : m_curves) {
-        if (curve.visible) {
-            drawCurve(painter, curve);
-        }
-    }
-}
-
-void PlotWindow::drawCurve(QPainter &painter, const CurveData &curve)
-{
-    if (curve.drawType == CurveType::Step) {
-        drawStepCurve(painter, curve);
-        return;
-    }
-
-    if (curve.xData.isEmpty() || curve.yData.isEmpty()) {
-        return;
-    }
-
-    Qt::PenStyle penStyle = lineStyleToQt(curve.lineStyle);
-    painter.setPen(QPen(curve.color, curve.lineWidth, penStyle));
-
-    QVector<QPointF> points;
-    int maxPoints = qMin(curve.xData.size(), curve.yData.size());
-
-    for (int i = 0; i < maxPoints; ++i) {
-        if (!isValidDataPoint(curve.xData[i], curve.yData[i])) {
-            continue;
-        }
-
-        QPointF dataPoint(curve.xData[i], curve.yData[i]);
-        QPointF pixelPoint = dataToPixel(dataPoint);
-
-        if (pixelPoint.x() >= m_plotArea.left() - 50 && pixelPoint.x() <= m_plotArea.right() + 50 &&
-            pixelPoint.y() >= m_plotArea.top() - 50 && pixelPoint.y() <= m_plotArea.bottom() + 50) {
-            points.append(pixelPoint);
-        }
-    }
-
-    if (points.size() > 1) {
-        painter.setClipRect(m_plotArea.adjusted(-5, -5, 5, 5));
-        for (int i = 0; i < points.size() - 1; ++i) {
-            painter.drawLine(points[i], points[i + 1]);
-        }
-        painter.setClipping(false);
-    }
-
-    painter.setBrush(curve.color);
-    for (const QPointF &point : points) {
-        if (m_plotArea.contains(point.toPoint())) {
-            painter.drawEllipse(point, curve.pointSize/2, curve.pointSize/2);
-        }
-    }
-}
-
-void PlotWindow::drawStepCurve(QPainter &painter, const CurveData &curve)
-{
-    if (curve.xData.isEmpty() || curve.yData.isEmpty()) {
-        return;
-    }
-
-    Qt::PenStyle penStyle = lineStyleToQt(curve.lineStyle);
-    painter.setPen(QPen(curve.color, curve.lineWidth, penStyle));
-
-    painter.setClipRect(m_plotArea.adjusted(-5, -5, 5, 5));
-
-    int dataSize = qMin(curve.xData.size(), curve.yData.size());
-
-    for (int i = 0; i < dataSize - 1; i += 2) {
-        if (i + 1 >= dataSize) break;
-
-        if (!isValidDataPoint(curve.xData[i], curve.yData[i]) ||
-            !isValidDataPoint(curve.xData[i+1], curve.yData[i+1])) {
-            continue;
-        }
-
-        QPointF segmentStart = dataToPixel(QPointF(curve.xData[i], curve.yData[i]));
-        QPointF segmentEnd = dataToPixel(QPointF(curve.xData[i+1], curve.yData[i+1]));
-
-        painter.drawLine(segmentStart, segmentEnd);
-
-        if (i + 2 < dataSize && i + 3 < dataSize) {
-            if (isValidDataPoint(curve.xData[i+2], curve.yData[i+2])) {
-                QPointF nextSegmentStart = dataToPixel(QPointF(curve.xData[i+2], curve.yData[i+2]));
-                QPointF verticalStart = segmentEnd;
-                QPointF verticalEnd = QPointF(segmentEnd.x(), nextSegmentStart.y());
-                painter.drawLine(verticalStart, verticalEnd);
-            }
-        }
-    }
-
-    painter.setClipping(false);
-
-    painter.setBrush(curve.color);
-    for (int i = 0; i < dataSize; i += 2) {
-        if (i < dataSize && isValidDataPoint(curve.xData[i], curve.yData[i])) {
-            QPointF pixelPoint = dataToPixel(QPointF(curve.xData[i], curve.yData[i]));
-            if (m_plotArea.contains(pixelPoint.toPoint())) {
-                painter.drawEllipse(pixelPoint, curve.pointSize/2, curve.pointSize/2);
-            }
-        }
-    }
-}
-
 void PlotWindow::drawLegend(QPainter &painter)
 {
     if (m_curves.isEmpty()) return;
@@ -597,57 +503,15 @@ void PlotWindow::drawSelection(QPainter &painter)
     painter.drawRect(m_selectionRect);
 }
 
-// 坐标转换函数 - 修正对数坐标转换
+// 坐标转换函数
 QPointF PlotWindow::dataToPixel(const QPointF &dataPoint)
 {
-    double x, y;
-
-    // X轴坐标转换
-    if (m_plotSettings.xAxisType == AxisType::Logarithmic && dataPoint.x() > 0 && m_plotSettings.xMin > 0) {
-        double normalizedX = (log10(dataPoint.x()) - log10(m_plotSettings.xMin)) /
-                             (log10(m_plotSettings.xMax) - log10(m_plotSettings.xMin));
-        x = m_plotArea.left() + normalizedX * m_plotArea.width();
-    } else {
-        x = m_plotArea.left() + (dataPoint.x() - m_plotSettings.xMin) /
-                                    (m_plotSettings.xMax - m_plotSettings.xMin) * m_plotArea.width();
-    }
-
-    // Y轴坐标转换
-    if (m_plotSettings.yAxisType == AxisType::Logarithmic && dataPoint.y() > 0 && m_plotSettings.yMin > 0) {
-        double normalizedY = (log10(dataPoint.y()) - log10(m_plotSettings.yMin)) /
-                             (log10(m_plotSettings.yMax) - log10(m_plotSettings.yMin));
-        y = m_plotArea.bottom() - normalizedY * m_plotArea.height();
-    } else {
-        y = m_plotArea.bottom() - (dataPoint.y() - m_plotSettings.yMin) /
-                                      (m_plotSettings.yMax - m_plotSettings.yMin) * m_plotArea.height();
-    }
-
-    return QPointF(x, y);
+    return PlotEngine::mapping(m_plotArea, m_plotSettings).map(dataPoint);
 }
 
 QPointF PlotWindow::pixelToData(const QPointF &pixelPoint)
 {
-    double x, y;
-
-    // X轴反向转换
-    if (m_plotSettings.xAxisType == AxisType::Logarithmic && m_plotSettings.xMin > 0 && m_plotSettings.xMax > 0) {
-        double normalizedX = (pixelPoint.x() - m_plotArea.left()) / m_plotArea.width();
-        x = pow(10, log10(m_plotSettings.xMin) + normalizedX * (log10(m_plotSettings.xMax) - log10(m_plotSettings.xMin)));
-    } else {
-        x = m_plotSettings.xMin + (pixelPoint.x() - m_plotArea.left()) / m_plotArea.width() *
-                                      (m_plotSettings.xMax - m_plotSettings.xMin);
-    }
-
-    // Y轴反向转换
-    if (m_plotSettings.yAxisType == AxisType::Logarithmic && m_plotSettings.yMin > 0 && m_plotSettings.yMax > 0) {
-        double normalizedY = (m_plotArea.bottom() - pixelPoint.y()) / m_plotArea.height();
-        y = pow(10, log10(m_plotSettings.yMin) + normalizedY * (log10(m_plotSettings.yMax) - log10(m_plotSettings.yMin)));
-    } else {
-        y = m_plotSettings.yMin + (m_plotArea.bottom() - pixelPoint.y()) / m_plotArea.height() *
-                                      (m_plotSettings.yMax - m_plotSettings.yMin);
-    }
-
-    return QPointF(x, y);
+    return PlotEngine::mapping(m_plotArea, m_plotSettings).unmap(pixelPoint);
 }
 
 // 数据边界计算 - 增强的自适应功能，特别针对产量数据
@@ -655,36 +519,14 @@ void PlotWindow::calculateDataBounds()
 {
     if (m_curves.isEmpty()) return;
 
-    double minX = 1e10, maxX = -1e10;
-    double minY = 1e10, maxY = -1e10;
-    bool hasValidData = false;
-
-    for (const CurveData &curve : m_curves) {
-        if (!curve.visible || curve.xData.isEmpty() || curve.yData.isEmpty()) {
-            continue;
-        }
-
-        for (int i = 0; i < qMin(curve.xData.size(), curve.yData.size()); ++i) {
-            double x = curve.xData[i];
-            double y = curve.yData[i];
-
-            if (!qIsFinite(x) || !qIsFinite(y)) continue;
-
-            // 对数坐标系需要正值
-            if (m_plotSettings.xAxisType == AxisType::Logarithmic && x <= 0) continue;
-            if (m_plotSettings.yAxisType == AxisType::Logarithmic && y <= 0) continue;
-
-            minX = qMin(minX, x);
-            maxX = qMax(maxX, x);
-            minY = qMin(minY, y);
-            maxY = qMax(maxY, y);
-            hasValidData = true;
-        }
-    }
+    const bool xLog = m_plotSettings.xAxisType == AxisType::Logarithmic;
+    const bool yLog = m_plotSettings.yAxisType == AxisType::Logarithmic;
+    double minX, maxX, minY, maxY;
+    if (!PlotEngine::dataBounds(m_curves, xLog, yLog, m_curveIndex, minX, maxX, minY, maxY)) return;
 
-    if (hasValidData && minX < maxX && minY < maxY) {
+    if (minX < maxX && minY < maxY) {
         // 计算X轴范围
-        QPair<double, double> xRange = calculateOptimalRange(minX, maxX, m_plotSettings.xAxisType == AxisType::Logarithmic);
+        QPair<double, double> xRange = PlotEngine::optimalRange(minX, maxX, xLog);
         m_plotSettings.xMin = xRange.first;
         m_plotSettings.xMax = xRange.second;
 
@@ -692,11 +534,11 @@ void PlotWindow::calculateDataBounds()
         QPair<double, double> yRange;
         bool isProductionData = m_plotSettings.yAxisTitle.contains("产量") || m_plotSettings.yAxisTitle.contains("mÂ³");
 
-        if (isProductionData && m_plotSettings.yAxisType == AxisType::Linear) {
+        if (isProductionData && !yLog) {
             // 产量数据线性坐标，最小值固定为0
-            yRange = calculateOptimalRange(0, maxY, false);
+            yRange = PlotEngine::optimalRange(0, maxY, false);
         } else {
-            yRange = calculateOptimalRange(minY, maxY, m_plotSettings.yAxisType == AxisType::Logarithmic);
+            yRange = PlotEngine::optimalRange(minY, maxY, yLog);
         }
 
         m_plotSettings.yMin = yRange.first;
@@ -704,282 +546,20 @@ void PlotWindow::calculateDataBounds()
     }
 }
 
-// 优化的范围计算函数 - 更智能的自适应
-QPair<double, double> PlotWindow::calculateOptimalRange(double min, double max, bool isLog)
-{
-    if (max <= min) {
-        return QPair<double, double>(min, max);
-    }
-
-    if (isLog) {
-        // 对数坐标系：扩展到最近的10的整数次幂，参考Saphir软件
-        if (min <= 0) min = 1e-10;  // 确保正值
-        if (max <= 0) max = 1;
-
-        double logMin = log10(min);
-        double logMax = log10(max);
-
-        // 向下取整到最近的10的次幂
-        double rangeMin = pow(10, floor(logMin));
-
-        // 向上取整到最近的10的次幂
-        double rangeMax = pow(10, ceil(logMax));
-
-        // 如果数据范围太小，至少显示一个数量级
-        if (rangeMax / rangeMin < 10) {
-            rangeMin = rangeMin / 10;
-            rangeMax = rangeMax * 10;
-        }
-
-        return QPair<double, double>(rangeMin, rangeMax);
-    } else {
-        // 线性坐标系：智能计算合适的范围
-        double range = max - min;
-
-        if (range == 0) {
-            // 如果所有数据相同，扩展范围
-            return QPair<double, double>(min - 1, max + 1);
-        }
-
-        // 计算合适的刻度间隔
-        double orderOfMagnitude = pow(10, floor(log10(range)));
-        double normalizedRange = range / orderOfMagnitude;
-
-        double tickInterval;
-        if (normalizedRange <= 1.5) {
-            tickInterval = orderOfMagnitude * 0.2;
-        } else if (normalizedRange <= 3) {
-            tickInterval = orderOfMagnitude * 0.5;
-        } else if (normalizedRange <= 7) {
-            tickInterval = orderOfMagnitude;
-        } else {
-            tickInterval = orderOfMagnitude * 2;
-        }
-
-        // 计算范围，确保包含所有数据点并留有余量
-        double rangeMin = floor(min / tickInterval) * tickInterval;
-        double rangeMax = ceil(max / tickInterval) * tickInterval;
-
-        // 添加5%的边距，使数据点不会贴边
-        double margin = (rangeMax - rangeMin) * 0.05;
-        rangeMin -= margin;
-        rangeMax += margin;
-
-        // 如果范围包含0，确保0点对齐到刻度
-        if (rangeMin < 0 && rangeMax > 0) {
-            rangeMin = floor(rangeMin / tickInterval) * tickInterval;
-            rangeMax = ceil(rangeMax / tickInterval) * tickInterval;
-        }
-
-        return QPair<double, double>(rangeMin, rangeMax);
-    }
-}
-
 // 缩放和平移
 void PlotWindow::zoomAtPoint(const QPointF &point, double factor)
 {
-    QPointF dataPoint = pixelToData(point);
-
-    double xRange = m_plotSettings.xMax - m_plotSettings.xMin;
-    double yRange = m_plotSettings.yMax - m_plotSettings.yMin;
-
-    double newXRange = xRange / factor;
-    double newYRange = yRange / factor;
-
-    m_plotSettings.xMin = dataPoint.x() - newXRange * (dataPoint.x() - m_plotSettings.xMin) / xRange;
-    m_plotSettings.xMax = dataPoint.x() + newXRange * (m_plotSettings.xMax - dataPoint.x()) / xRange;
-    m_plotSettings.yMin = dataPoint.y() - newYRange * (dataPoint.y() - m_plotSettings.yMin) / yRange;
-    m_plotSettings.yMax = dataPoint.y() + newYRange * (m_plotSettings.yMax - dataPoint.y()) / yRange;
-
+    PlotEngine::zoomAt(m_plotSettings, m_plotArea, point, factor, factor);
     updatePlot();
 }
 
 void PlotWindow::panView(const QPointF &delta)
 {
-    QPointF dataDelta = pixelToData(delta) - pixelToData(QPointF(0, 0));
-
-    m_plotSettings.xMin -= dataDelta.x();
-    m_plotSettings.xMax -= dataDelta.x();
-    m_plotSettings.yMin -= dataDelta.y();
-    m_plotSettings.yMax -= dataDelta.y();
-
+    PlotEngine::pan(m_plotSettings, m_plotArea, delta);
     updatePlot();
 }
 
 // 辅助函数
-double PlotWindow::transformToLogScale(double value, bool isLog)
-{
-    if (isLog && value > 0) {
-        return log10(value);
-    }
-    return value;
-}
-
-double PlotWindow::transformFromLogScale(double value, bool isLog)
-{
-    if (isLog) {
-        return pow(10, value);
-    }
-    return value;
-}
-
-// 优化的坐标轴标签生成函数，参考Saphir软件
-QVector<double> PlotWindow::generateOptimizedAxisLabels(double min, double max, AxisType axisType)
-{
-    QVector<double> labels;
-
-    if (max <= min) {
-        return labels;
-    }
-
-    if (axisType == AxisType::Logarithmic) {
-        // 对数坐标系：生成Saphir风格的对数标签
-        if (min <= 0) min = 1e-10;
-        if (max <= 0) max = 1;
-
-        double logMin = log10(min);
-        double logMax = log10(max);
-
-        int startPower = qFloor(logMin);
-        int endPower = qCeil(logMax);
-
-        // 添加主要的10的整数次幂
-        for (int power = startPower; power <= endPower; ++power) {
-            double value = qPow(10, power);
-            if (value >= min * 0.999 && value <= max * 1.001) {
-                labels.append(value);
-            }
-        }
-
-        // 根据范围决定是否显示中间刻度
-        bool showMinorTicks = (endPower - startPower) <= 3;
-
-        if (showMinorTicks) {
-            // 添加次要刻度（2, 3, 5）
-            for (int power = startPower; power < endPower; ++power) {
-                for (int mult : {2, 3, 5}) {
-                    double value = mult * qPow(10, power);
-                    if (value > min && value < max) {
-                        labels.append(value);
-                    }
-                }
-            }
-        }
-
-        // 排序去重
-        std::sort(labels.begin(), labels.end());
-        labels.erase(std::unique(labels.begin(), labels.end(), [](double a, double b) {
-                         return qAbs(a - b) < 1e-10;
-                     }), labels.end());
-
-    } else {
-        // 线性坐标系：生成合适的刻度
-        double range = max - min;
-        double orderOfMagnitude = pow(10, floor(log10(range)));
-        double normalizedRange = range / orderOfMagnitude;
-
-        double tickInterval;
-        int maxTicks;
-
-        if (normalizedRange <= 1.5) {
-            tickInterval = orderOfMagnitude * 0.2;
-            maxTicks = 8;
-        } else if (normalizedRange <= 3) {
-            tickInterval = orderOfMagnitude * 0.5;
-            maxTicks = 7;
-        } else if (normalizedRange <= 7) {
-            tickInterval = orderOfMagnitude;
-            maxTicks = 8;
-        } else {
-            tickInterval = orderOfMagnitude * 2;
-            maxTicks = 6;
-        }
-
-        // 确保第一个刻度对齐
-        double firstTick = ceil(min / tickInterval) * tickInterval;
-
-        // 生成刻度
-        for (int i = 0; i < maxTicks; ++i) {
-            double value = firstTick + i * tickInterval;
-            if (value > max) break;
-            if (value >= min) {
-                labels.append(value);
-            }
-        }
-
-        // 确保包含0（如果在范围内）
-        if (min <= 0 && max >= 0 && !labels.contains(0)) {
-            labels.append(0);
-            std::sort(labels.begin(), labels.end());
-        }
-    }
-
-    return labels;
-}
-
-// 格式化坐标轴标签，参考Saphir软件
-QString PlotWindow::formatAxisLabel(double value, bool isLog)
-{
-    if (isLog) {
-        // 对数坐标：对于10的整数次幂显示简洁格式
-        double logValue = log10(qAbs(value));
-        if (qAbs(logValue - qRound(logValue)) < 0.01) {
-            int power = qRound(logValue);
-            if (power == 0) return "1";
-            if (power == 1) return "10";
-            if (power == 2) return "100";
-            if (power == 3) return "1000";
-            if (power == -1) return "0.1";
-            if (power == -2) return "0.01";
-            return QString("10^%1").arg(power);
-        } else {
-            // 非10的整数次幂，显示实际数值
-            if (value >= 1000) {
-                return QString::number(value, 'g', 2);
-            } else if (value >= 1) {
-                return QString::number(value, 'f', 0);
-            } else {
-                return QString::number(value, 'g', 2);
-            }
-        }
-    } else {
-        // 线性坐标：智能格式化
-        if (qAbs(value) >= 100000) {
-            return QString::number(value, 'e', 1);
-        } else if (qAbs(value) >= 1000) {
-            return QString::number(value, 'f', 0);
-        } else if (qAbs(value) >= 1) {
-            if (qAbs(value - qRound(value)) < 0.01) {
-                return QString::number(qRound(value));
-            } else {
-                return QString::number(value, 'f', 1);
-            }
-        } else if (value == 0) {
-            return "0";
-        } else {
-            return QString::number(value, 'g', 3);
-        }
-    }
-}
-
-QString PlotWindow::formatScientific(double value, int decimals)
-{
-    if (qIsNaN(value) || !qIsFinite(value)) {
-        return "N/A";
-    }
-
-    if (qAbs(value) >= 1000 || (qAbs(value) < 0.01 && value != 0)) {
-        return QString::number(value, 'e', decimals);
-    } else {
-        return QString::number(value, 'f', decimals);
-    }
-}
-
-bool PlotWindow::isValidDataPoint(double x, double y)
-{
-    return !qIsNaN(x) && !qIsNaN(y) && qIsFinite(x) && qIsFinite(y);
-}
-
 // 鼠标事件处理
 void PlotWindow::mousePressEvent(QMouseEvent *event)
 {
@@ -1126,6 +706,13 @@ void PlotWindow::onResetZoom()
     updatePlot();
 }
 
+void PlotWindow::onFitYToData()
+{
+    if (PlotEngine::fitYToX(m_plotSettings, m_curves, m_curveIndex)) {
+        updatePlot();
+    }
+}
+
 void PlotWindow::onZoomIn()
 {
     QPointF center = m_plotArea.center();
@@ -1329,6 +916,10 @@ void DualPlotWindow::setupUI()
     // 设置绘图更新
     m_pressurePlotWidget->installEventFilter(this);
     m_productionPlotWidget->installEventFilter(this);
+    connect(&m_pressureRenderer, &CurveRenderer::frameReady,
+            m_pressurePlotWidget, QOverload<>::of(&QWidget::update));
+    connect(&m_productionRenderer, &CurveRenderer::frameReady,
+            m_productionPlotWidget, QOverload<>::of(&QWidget::update));
 
     // 美化状态栏
     statusBar()->setStyleSheet(
@@ -1507,12 +1098,9 @@ void DualPlotWindow::paintPressurePlot()
     // 绘制坐标轴
     drawAxesOnWidget(painter, m_pressurePlotArea, m_pressureSettings);
 
-    // 绘制曲线
-    for (const CurveData &curve : m_pressureCurves) {
-        if (curve.visible) {
-            drawCurveOnWidget(painter, curve, m_pressurePlotArea, m_pressureSettings);
-        }
-    }
+    // 绘制曲线（数据量大时在后台线程渲染）
+    m_pressureRenderer.paint(painter, m_pressureCurves, PlotEngine::mapping(m_pressurePlotArea, m_pressureSettings),
+                          widgetRect.size(), m_pressurePlotWidget->devicePixelRatioF());
 
     // 绘制图例
     if (m_pressureSettings.showLegend && !m_pressureCurves.isEmpty()) {
@@ -1549,12 +1137,9 @@ void DualPlotWindow::paintProductionPlot()
     // 绘制坐标轴
     drawAxesOnWidget(painter, m_productionPlotArea, m_productionSettings);
 
-    // 绘制曲线
-    for (const CurveData &curve : m_productionCurves) {
-        if (curve.visible) {
-            drawCurveOnWidget(painter, curve, m_productionPlotArea, m_productionSettings);
-        }
-    }
+    // 绘制曲线（数据量大时在后台线程渲染）
+    m_productionRenderer.paint(painter, m_productionCurves, PlotEngine::mapping(m_productionPlotArea, m_productionSettings),
+                          widgetRect.size(), m_productionPlotWidget->devicePixelRatioF());
 
     // 绘制图例
     if (m_productionSettings.showLegend && !m_productionCurves.isEmpty()) {
@@ -2097,6 +1682,7 @@ void DualPlotWindow::onPressureMouseRelease(QMouseEvent *event)
         if (m_syncZoom) {
             m_productionSettings.xMin = m_pressureSettings.xMin;
             m_productionSettings.xMax = m_pressureSettings.xMax;
+            PlotEngine::fitYToX(m_productionSettings, m_productionCurves, m_productionIndex);
         }
     }
 
@@ -2115,9 +1701,10 @@ void DualPlotWindow::onPressureWheel(QWheelEvent *event)
         zoomPressureAtPoint(pos, factor);
 
         if (m_syncZoom) {
-            // 同步X轴缩放到产量图
+            // 同步X轴缩放到产量图，产量图Y轴适应新X范围内的数据
             m_productionSettings.xMin = m_pressureSettings.xMin;
             m_productionSettings.xMax = m_pressureSettings.xMax;
+            PlotEngine::fitYToX(m_productionSettings, m_productionCurves, m_productionIndex);
             updatePlots();
         }
     }
@@ -2179,6 +1766,7 @@ void DualPlotWindow::onProductionMouseRelease(QMouseEvent *event)
         if (m_syncZoom) {
             m_pressureSettings.xMin = m_productionSettings.xMin;
             m_pressureSettings.xMax = m_productionSettings.xMax;
+            PlotEngine::fitYToX(m_pressureSettings, m_pressureCurves, m_pressureIndex);
         }
     }
 
@@ -2197,217 +1785,74 @@ void DualPlotWindow::onProductionWheel(QWheelEvent *event)
         zoomProductionAtPoint(pos, factor);
 
         if (m_syncZoom) {
-            // 同步X轴缩放到压力图
+            // 同步X轴缩放到压力图，压力图Y轴适应新X范围内的数据
             m_pressureSettings.xMin = m_productionSettings.xMin;
             m_pressureSettings.xMax = m_productionSettings.xMax;
+            PlotEngine::fitYToX(m_pressureSettings, m_pressureCurves, m_pressureIndex);
             updatePlots();
         }
     }
 }
 
-// 坐标转换函数 - 修正对数坐标
+// 坐标转换函数
 QPointF DualPlotWindow::pressureDataToPixel(const QPointF &dataPoint)
 {
-    double x, y;
-
-    if (m_pressureSettings.xMax > m_pressureSettings.xMin) {
-        if (m_pressureSettings.xAxisType == AxisType::Logarithmic && dataPoint.x() > 0 && m_pressureSettings.xMin > 0) {
-            double normalizedX = (log10(dataPoint.x()) - log10(m_pressureSettings.xMin)) /
-                                 (log10(m_pressureSettings.xMax) - log10(m_pressureSettings.xMin));
-            x = m_pressurePlotArea.left() + normalizedX * m_pressurePlotArea.width();
-        } else {
-            x = m_pressurePlotArea.left() + (dataPoint.x() - m_pressureSettings.xMin) /
-                                                (m_pressureSettings.xMax - m_pressureSettings.xMin) * m_pressurePlotArea.width();
-        }
-    } else {
-        x = m_pressurePlotArea.left();
-    }
-
-    if (m_pressureSettings.yMax > m_pressureSettings.yMin) {
-        if (m_pressureSettings.yAxisType == AxisType::Logarithmic && dataPoint.y() > 0 && m_pressureSettings.yMin > 0) {
-            double normalizedY = (log10(dataPoint.y()) - log10(m_pressureSettings.yMin)) /
-                                 (log10(m_pressureSettings.yMax) - log10(m_pressureSettings.yMin));
-            y = m_pressurePlotArea.bottom() - normalizedY * m_pressurePlotArea.height();
-        } else {
-            y = m_pressurePlotArea.bottom() - (dataPoint.y() - m_pressureSettings.yMin) /
-                                                  (m_pressureSettings.yMax - m_pressureSettings.yMin) * m_pressurePlotArea.height();
-        }
-    } else {
-        y = m_pressurePlotArea.bottom();
-    }
-
-    return QPointF(x, y);
+    return PlotEngine::mapping(m_pressurePlotArea, m_pressureSettings).map(dataPoint);
 }
 
 QPointF DualPlotWindow::pixelToPressureData(const QPointF &pixelPoint)
 {
-    double x, y;
-
-    if (m_pressureSettings.xAxisType == AxisType::Logarithmic && m_pressureSettings.xMin > 0 && m_pressureSettings.xMax > 0) {
-        double normalizedX = (pixelPoint.x() - m_pressurePlotArea.left()) / m_pressurePlotArea.width();
-        x = pow(10, log10(m_pressureSettings.xMin) + normalizedX * (log10(m_pressureSettings.xMax) - log10(m_pressureSettings.xMin)));
-    } else {
-        x = m_pressureSettings.xMin + (pixelPoint.x() - m_pressurePlotArea.left()) / m_pressurePlotArea.width() *
-                                          (m_pressureSettings.xMax - m_pressureSettings.xMin);
-    }
-
-    if (m_pressureSettings.yAxisType == AxisType::Logarithmic && m_pressureSettings.yMin > 0 && m_pressureSettings.yMax > 0) {
-        double normalizedY = (m_pressurePlotArea.bottom() - pixelPoint.y()) / m_pressurePlotArea.height();
-        y = pow(10, log10(m_pressureSettings.yMin) + normalizedY * (log10(m_pressureSettings.yMax) - log10(m_pressureSettings.yMin)));
-    } else {
-        y = m_pressureSettings.yMin + (m_pressurePlotArea.bottom() - pixelPoint.y()) / m_pressurePlotArea.height() *
-                                          (m_pressureSettings.yMax - m_pressureSettings.yMin);
-    }
-
-    return QPointF(x, y);
+    return PlotEngine::mapping(m_pressurePlotArea, m_pressureSettings).unmap(pixelPoint);
 }
 
 QPointF DualPlotWindow::productionDataToPixel(const QPointF &dataPoint)
 {
-    double x, y;
-
-    if (m_productionSettings.xMax > m_productionSettings.xMin) {
-        if (m_productionSettings.xAxisType == AxisType::Logarithmic && dataPoint.x() > 0 && m_productionSettings.xMin > 0) {
-            double normalizedX = (log10(dataPoint.x()) - log10(m_productionSettings.xMin)) /
-                                 (log10(m_productionSettings.xMax) - log10(m_productionSettings.xMin));
-            x = m_productionPlotArea.left() + normalizedX * m_productionPlotArea.width();
-        } else {
-            x = m_productionPlotArea.left() + (dataPoint.x() - m_productionSettings.xMin) /
-                                                  (m_productionSettings.xMax - m_productionSettings.xMin) * m_productionPlotArea.width();
-        }
-    } else {
-        x = m_productionPlotArea.left();
-    }
-
-    if (m_productionSettings.yMax > m_productionSettings.yMin) {
-        if (m_productionSettings.yAxisType == AxisType::Logarithmic && dataPoint.y() > 0 && m_productionSettings.yMin > 0) {
-            double normalizedY = (log10(dataPoint.y()) - log10(m_productionSettings.yMin)) /
-                                 (log10(m_productionSettings.yMax) - log10(m_productionSettings.yMin));
-            y = m_productionPlotArea.bottom() - normalizedY * m_productionPlotArea.height();
-        } else {
-            y = m_productionPlotArea.bottom() - (dataPoint.y() - m_productionSettings.yMin) /
-                                                    (m_productionSettings.yMax - m_productionSettings.yMin) * m_productionPlotArea.height();
-        }
-    } else {
-        y = m_productionPlotArea.bottom();
-    }
-
-    return QPointF(x, y);
+    return PlotEngine::mapping(m_productionPlotArea, m_productionSettings).map(dataPoint);
 }
 
 QPointF DualPlotWindow::pixelToProductionData(const QPointF &pixelPoint)
 {
-    double x, y;
-
-    if (m_productionSettings.xAxisType == AxisType::Logarithmic && m_productionSettings.xMin > 0 && m_productionSettings.xMax > 0) {
-        double normalizedX = (pixelPoint.x() - m_productionPlotArea.left()) / m_productionPlotArea.width();
-        x = pow(10, log10(m_productionSettings.xMin) + normalizedX * (log10(m_productionSettings.xMax) - log10(m_productionSettings.xMin)));
-    } else {
-        x = m_productionSettings.xMin + (pixelPoint.x() - m_productionPlotArea.left()) / m_productionPlotArea.width() *
-                                            (m_productionSettings.xMax - m_productionSettings.xMin);
-    }
-
-    if (m_productionSettings.yAxisType == AxisType::Logarithmic && m_productionSettings.yMin > 0 && m_productionSettings.yMax > 0) {
-        double normalizedY = (m_productionPlotArea.bottom() - pixelPoint.y()) / m_productionPlotArea.height();
-        y = pow(10, log10(m_productionSettings.yMin) + normalizedY * (log10(m_productionSettings.yMax) - log10(m_productionSettings.yMin)));
-    } else {
-        y = m_productionSettings.yMin + (m_productionPlotArea.bottom() - pixelPoint.y()) / m_productionPlotArea.height() *
-                                            (m_productionSettings.yMax - m_productionSettings.yMin);
-    }
-
-    return QPointF(x, y);
+    return PlotEngine::mapping(m_productionPlotArea, m_productionSettings).unmap(pixelPoint);
 }
 
 // 缩放和平移函数
 void DualPlotWindow::zoomPressureAtPoint(const QPointF &point, double factor)
 {
-    QPointF dataPoint = pixelToPressureData(point);
-
-    double xRange = m_pressureSettings.xMax - m_pressureSettings.xMin;
-    double yRange = m_pressureSettings.yMax - m_pressureSettings.yMin;
-
-    double newXRange = xRange / factor;
-    double newYRange = yRange / factor;
-
-    m_pressureSettings.xMin = dataPoint.x() - newXRange * (dataPoint.x() - m_pressureSettings.xMin) / xRange;
-    m_pressureSettings.xMax = dataPoint.x() + newXRange * (m_pressureSettings.xMax - dataPoint.x()) / xRange;
-    m_pressureSettings.yMin = dataPoint.y() - newYRange * (dataPoint.y() - m_pressureSettings.yMin) / yRange;
-    m_pressureSettings.yMax = dataPoint.y() + newYRange * (m_pressureSettings.yMax - dataPoint.y()) / yRange;
-
+    PlotEngine::zoomAt(m_pressureSettings, m_pressurePlotArea, point, factor, factor);
     updatePlots();
 }
 
 void DualPlotWindow::zoomProductionAtPoint(const QPointF &point, double factor)
 {
-    QPointF dataPoint = pixelToProductionData(point);
-
-    double xRange = m_productionSettings.xMax - m_productionSettings.xMin;
-    double yRange = m_productionSettings.yMax - m_productionSettings.yMin;
-
-    double newXRange = xRange / factor;
-    double newYRange = yRange / factor;
-
-    m_productionSettings.xMin = dataPoint.x() - newXRange * (dataPoint.x() - m_productionSettings.xMin) / xRange;
-    m_productionSettings.xMax = dataPoint.x() + newXRange * (m_productionSettings.xMax - dataPoint.x()) / xRange;
-    m_productionSettings.yMin = dataPoint.y() - newYRange * (dataPoint.y() - m_productionSettings.yMin) / yRange;
-    m_productionSettings.yMax = dataPoint.y() + newYRange * (m_productionSettings.yMax - dataPoint.y()) / yRange;
-
+    PlotEngine::zoomAt(m_productionSettings, m_productionPlotArea, point, factor, factor);
     updatePlots();
 }
 
 void DualPlotWindow::panPressureView(const QPointF &delta)
 {
-    QPointF dataDelta = pixelToPressureData(delta) - pixelToPressureData(QPointF(0, 0));
-
-    m_pressureSettings.xMin -= dataDelta.x();
-    m_pressureSettings.xMax -= dataDelta.x();
-    m_pressureSettings.yMin -= dataDelta.y();
-    m_pressureSettings.yMax -= dataDelta.y();
-
+    PlotEngine::pan(m_pressureSettings, m_pressurePlotArea, delta);
     updatePlots();
 }
 
 void DualPlotWindow::panProductionView(const QPointF &delta)
 {
-    QPointF dataDelta = pixelToProductionData(delta) - pixelToProductionData(QPointF(0, 0));
-
-    m_productionSettings.xMin -= dataDelta.x();
-    m_productionSettings.xMax -= dataDelta.x();
-    m_productionSettings.yMin -= dataDelta.y();
-    m_productionSettings.yMax -= dataDelta.y();
-
+    PlotEngine::pan(m_productionSettings, m_productionPlotArea, delta);
     updatePlots();
 }
 
 // 增强的数据自适应功能 - 特别针对产量数据
 void DualPlotWindow::synchronizeXAxis()
 {
-    // 同步两个图的X轴范围
-    double minX = 1e10, maxX = -1e10;
-    bool hasValidData = false;
-
-    // 检查压力数据
-    for (const CurveData &curve : m_pressureCurves) {
-        for (int i = 0; i < curve.xData.size(); ++i) {
-            double x = curve.xData[i];
-            if (qIsFinite(x) && x > 0) {  // 对数坐标需要正值
-                minX = qMin(minX, x);
-                maxX = qMax(maxX, x);
-                hasValidData = true;
-            }
-        }
-    }
-
-    // 检查产量数据
-    for (const CurveData &curve : m_productionCurves) {
-        for (int i = 0; i < curve.xData.size(); ++i) {
-            double x = curve.xData[i];
-            if (qIsFinite(x) && x > 0) {  // 对数坐标需要正值
-                minX = qMin(minX, x);
-                maxX = qMax(maxX, x);
-                hasValidData = true;
-            }
-        }
+    // 同步两个图的X轴范围（对数坐标需要正值）
+    double minX, maxX, minY, maxY;
+    double productionMinX, productionMaxX;
+    bool hasValidData = PlotEngine::dataBounds(m_pressureCurves, true, false, m_pressureIndex,
+                                               minX, maxX, minY, maxY);
+    if (PlotEngine::dataBounds(m_productionCurves, true, false, m_productionIndex,
+                               productionMinX, productionMaxX, minY, maxY)) {
+        minX = hasValidData ? qMin(minX, productionMinX) : productionMinX;
+        maxX = hasValidData ? qMax(maxX, productionMaxX) : productionMaxX;
+        hasValidData = true;
     }
 
     if (hasValidData && minX < maxX) {
@@ -2447,19 +1892,10 @@ void DualPlotWindow::calculatePressureBounds()
 {
     if (m_pressureCurves.isEmpty()) return;
 
-    double minY = 1e10, maxY = -1e10;
-    bool hasValidData = false;
-
-    for (const CurveData &curve : m_pressureCurves) {
-        for (int i = 0; i < curve.yData.size(); ++i) {
-            double y = curve.yData[i];
-            if (qIsFinite(y) && y > 0) {  // 对数坐标需要正值
-                minY = qMin(minY, y);
-                maxY = qMax(maxY, y);
-                hasValidData = true;
-            }
-        }
-    }
+    // 对数坐标需要正值
+    double minX, maxX, minY, maxY;
+    bool hasValidData = PlotEngine::dataBounds(m_pressureCurves, false, true, m_pressureIndex,
+                                               minX, maxX, minY, maxY);
 
     if (hasValidData && minY < maxY) {
         if (m_pressureSettings.yAxisType == AxisType::Logarithmic) {
@@ -2500,19 +1936,10 @@ void DualPlotWindow::calculateProductionBounds()
 {
     if (m_productionCurves.isEmpty()) return;
 
-    double minY = 1e10, maxY = -1e10;
-    bool hasValidData = false;
-
-    for (const CurveData &curve : m_productionCurves) {
-        for (int i = 0; i < curve.yData.size(); ++i) {
-            double y = curve.yData[i];
-            if (qIsFinite(y) && y > 0) {  // 对数坐标需要正值
-                minY = qMin(minY, y);
-                maxY = qMax(maxY, y);
-                hasValidData = true;
-            }
-        }
-    }
+    // 对数坐标需要正值
+    double minX, maxX, minY, maxY;
+    bool hasValidData = PlotEngine::dataBounds(m_productionCurves, false, true, m_productionIndex,
+                                               minX, maxX, minY, maxY);
 
     if (hasValidData && minY < maxY) {
         if (m_productionSettings.yAxisType == AxisType::Logarithmic) {
@@ -2541,188 +1968,3 @@ void DualPlotWindow::calculateProductionBounds()
         }
     }
 }
-
-// 优化的曲线绘制函数 - 正确处理对数坐标
-void DualPlotWindow::drawCurveOnWidget(QPainter &painter, const CurveData &curve,
-                                       const QRect &plotArea, const PlotSettings &settings)
-{
-    if (curve.drawType == CurveType::Step) {
-        // 阶梯状曲线绘制
-        Qt::PenStyle penStyle = lineStyleToQt(curve.lineStyle);
-        painter.setPen(QPen(curve.color, curve.lineWidth, penStyle));
-
-        painter.setClipRect(plotArea.adjusted(-5, -5, 5, 5));
-
-        int dataSize = qMin(curve.xData.size(), curve.yData.size());
-
-        for (int i = 0; i < dataSize - 1; i += 2) {
-            if (i + 1 >= dataSize) break;
-
-            // 数据有效性检查
-            if (!qIsFinite(curve.xData[i]) || !qIsFinite(curve.yData[i]) ||
-                !qIsFinite(curve.xData[i+1]) || !qIsFinite(curve.yData[i+1])) {
-                continue;
-            }
-
-            // 对数坐标需要正值
-            if (settings.xAxisType == AxisType::Logarithmic &&
-                (curve.xData[i] <= 0 || curve.xData[i+1] <= 0)) continue;
-            if (settings.yAxisType == AxisType::Logarithmic &&
-                (curve.yData[i] <= 0 || curve.yData[i+1] <= 0)) continue;
-
-            // 坐标转换
-            double x1, y1, x2, y2;
-
-            if (settings.xAxisType == AxisType::Logarithmic) {
-                x1 = (log10(curve.xData[i]) - log10(settings.xMin)) /
-                     (log10(settings.xMax) - log10(settings.xMin));
-                x2 = (log10(curve.xData[i+1]) - log10(settings.xMin)) /
-                     (log10(settings.xMax) - log10(settings.xMin));
-            } else {
-                x1 = (curve.xData[i] - settings.xMin) / (settings.xMax - settings.xMin);
-                x2 = (curve.xData[i+1] - settings.xMin) / (settings.xMax - settings.xMin);
-            }
-
-            if (settings.yAxisType == AxisType::Logarithmic) {
-                y1 = (log10(curve.yData[i]) - log10(settings.yMin)) /
-                     (log10(settings.yMax) - log10(settings.yMin));
-                y2 = (log10(curve.yData[i+1]) - log10(settings.yMin)) /
-                     (log10(settings.yMax) - log10(settings.yMin));
-            } else {
-                y1 = (curve.yData[i] - settings.yMin) / (settings.yMax - settings.yMin);
-                y2 = (curve.yData[i+1] - settings.yMin) / (settings.yMax - settings.yMin);
-            }
-
-            double pixelX1 = plotArea.left() + x1 * plotArea.width();
-            double pixelY1 = plotArea.bottom() - y1 * plotArea.height();
-            double pixelX2 = plotArea.left() + x2 * plotArea.width();
-            double pixelY2 = plotArea.bottom() - y2 * plotArea.height();
-
-            QPointF segmentStart(pixelX1, pixelY1);
-            QPointF segmentEnd(pixelX2, pixelY2);
-
-            painter.drawLine(segmentStart, segmentEnd);
-
-            // 绘制垂直连接线
-            if (i + 2 < dataSize && i + 3 < dataSize) {
-                if (qIsFinite(curve.xData[i+2]) && qIsFinite(curve.yData[i+2])) {
-                    // 对数坐标检查
-                    if (settings.xAxisType == AxisType::Logarithmic && curve.xData[i+2] <= 0) continue;
-                    if (settings.yAxisType == AxisType::Logarithmic && curve.yData[i+2] <= 0) continue;
-
-                    double x3, y3;
-                    if (settings.xAxisType == AxisType::Logarithmic) {
-                        x3 = (log10(curve.xData[i+2]) - log10(settings.xMin)) /
-                             (log10(settings.xMax) - log10(settings.xMin));
-                    } else {
-                        x3 = (curve.xData[i+2] - settings.xMin) / (settings.xMax - settings.xMin);
-                    }
-
-                    if (settings.yAxisType == AxisType::Logarithmic) {
-                        y3 = (log10(curve.yData[i+2]) - log10(settings.yMin)) /
-                             (log10(settings.yMax) - log10(settings.yMin));
-                    } else {
-                        y3 = (curve.yData[i+2] - settings.yMin) / (settings.yMax - settings.yMin);
-                    }
-
-                    double pixelX3 = plotArea.left() + x3 * plotArea.width();
-                    double pixelY3 = plotArea.bottom() - y3 * plotArea.height();
-                    QPointF nextSegmentStart(pixelX3, pixelY3);
-                    QPointF verticalStart = segmentEnd;
-                    QPointF verticalEnd = QPointF(segmentEnd.x(), nextSegmentStart.y());
-                    painter.drawLine(verticalStart, verticalEnd);
-                }
-            }
-        }
-
-        painter.setClipping(false);
-
-        // 绘制数据点
-        painter.setBrush(curve.color);
-        for (int i = 0; i < dataSize; i += 2) {
-            if (i < dataSize && qIsFinite(curve.xData[i]) && qIsFinite(curve.yData[i])) {
-                // 对数坐标检查
-                if (settings.xAxisType == AxisType::Logarithmic && curve.xData[i] <= 0) continue;
-                if (settings.yAxisType == AxisType::Logarithmic && curve.yData[i] <= 0) continue;
-
-                double x, y;
-                if (settings.xAxisType == AxisType::Logarithmic) {
-                    x = (log10(curve.xData[i]) - log10(settings.xMin)) /
-                        (log10(settings.xMax) - log10(settings.xMin));
-                } else {
-                    x = (curve.xData[i] - settings.xMin) / (settings.xMax - settings.xMin);
-                }
-
-                if (settings.yAxisType == AxisType::Logarithmic) {
-                    y = (log10(curve.yData[i]) - log10(settings.yMin)) /
-                        (log10(settings.yMax) - log10(settings.yMin));
-                } else {
-                    y = (curve.yData[i] - settings.yMin) / (settings.yMax - settings.yMin);
-                }
-
-                double pixelX = plotArea.left() + x * plotArea.width();
-                double pixelY = plotArea.bottom() - y * plotArea.height();
-                QPointF pixelPoint(pixelX, pixelY);
-                if (plotArea.contains(pixelPoint.toPoint())) {
-                    painter.drawEllipse(pixelPoint, curve.pointSize/2, curve.pointSize/2);
-                }
-            }
-        }
-        return;
-    }
-
-    // 普通曲线绘制
-    Qt::PenStyle penStyle = lineStyleToQt(curve.lineStyle);
-    painter.setPen(QPen(curve.color, curve.lineWidth, penStyle));
-
-    QVector<QPointF> points;
-    int maxPoints = qMin(curve.xData.size(), curve.yData.size());
-
-    for (int i = 0; i < maxPoints; ++i) {
-        if (qIsFinite(curve.xData[i]) && qIsFinite(curve.yData[i])) {
-            // 对数坐标需要正值
-            if (settings.xAxisType == AxisType::Logarithmic && curve.xData[i] <= 0) continue;
-            if (settings.yAxisType == AxisType::Logarithmic && curve.yData[i] <= 0) continue;
-
-            double x, y;
-
-            // X轴坐标转换
-            if (settings.xAxisType == AxisType::Logarithmic) {
-                x = (log10(curve.xData[i]) - log10(settings.xMin)) /
-                    (log10(settings.xMax) - log10(settings.xMin));
-            } else {
-                x = (curve.xData[i] - settings.xMin) / (settings.xMax - settings.xMin);
-            }
-
-            // Y轴坐标转换
-            if (settings.yAxisType == AxisType::Logarithmic) {
-                y = (log10(curve.yData[i]) - log10(settings.yMin)) /
-                    (log10(settings.yMax) - log10(settings.yMin));
-            } else {
-                y = (curve.yData[i] - settings.yMin) / (settings.yMax - settings.yMin);
-            }
-
-            double pixelX = plotArea.left() + x * plotArea.width();
-            double pixelY = plotArea.bottom() - y * plotArea.height();
-
-            points.append(QPointF(pixelX, pixelY));
-        }
-    }
-
-    // 绘制曲线
-    if (points.size() > 1) {
-        painter.setClipRect(plotArea.adjusted(-5, -5, 5, 5));
-        for (int i = 0; i < points.size() - 1; ++i) {
-            painter.drawLine(points[i], points[i + 1]);
-        }
-        painter.setClipping(false);
-    }
-
-    // 绘制数据点
-    painter.setBrush(curve.color);
-    for (const QPointF &point : points) {
-        if (plotArea.contains(point.toPoint())) {
-            painter.drawEllipse(point, curve.pointSize/2, curve.pointSize/2);
-        }
-    }
-}
@@ -1,8 +1,9 @@
 #include "pressurederivativecalculator.h"
-#include <QStandardItem>
+#include "derivedcolumns.h"
 #include <QRegularExpression>
 #include <QDebug>
 #include <cmath>
+#include <algorithm>
 
 PressureDerivativeCalculator::PressureDerivativeCalculator(QObject *parent)
     : QObject(parent)
@@ -14,7 +15,7 @@ PressureDerivativeCalculator::~PressureDerivativeCalculator()
 }
 
 PressureDerivativeResult PressureDerivativeCalculator::calculatePressureDerivative(
-    QStandardItemModel* model, const PressureDerivativeConfig& config)
+    DataTableModel* model, const PressureDerivativeConfig& config)
 {
     PressureDerivativeResult result;
     result.success = false;
@@ -50,36 +51,73 @@ PressureDerivativeResult PressureDerivativeCalculator::calculatePressureDerivati
         return result;
     }
 
-    emit progressUpdated(10, "正在读取数据...");
+    bool useTimeAxis = (config.timeAxis != DerivativeTimeAxis::ElapsedTime);
+    if (useTimeAxis && (config.rateColumnIndex < 0 || config.rateColumnIndex >= model->columnCount())) {
+        result.errorMessage = QString("使用%1需要指定流量列").arg(timeAxisName(config.timeAxis));
+        return result;
+    }
 
-    // 读取时间和压力数据 (使用 QVector 提高性能)
-    QVector<double> timeData;
-    QVector<double> pressureData;
-    timeData.reserve(rowCount);
-    pressureData.reserve(rowCount);
+    emit progressUpdated(30, "正在计算Bourdet导数（L-Spacing平滑）...");
 
-    for (int row = 0; row < rowCount; ++row) {
-        QStandardItem* timeItem = model->item(row, config.timeColumnIndex);
-        QStandardItem* pressureItem = model->item(row, config.pressureColumnIndex);
+    QVector<double> derivativeData;
+    if (!computeDerivative(model, config, derivativeData, result.errorMessage)) {
+        return result;
+    }
 
-        double timeValue = 0.0;
-        double pressureValue = 0.0;
+    emit progressUpdated(80, "正在写入结果...");
 
-        if (timeItem) {
-            timeValue = parseNumericValue(timeItem->text());
-        }
-        if (pressureItem) {
-            pressureValue = parseNumericValue(pressureItem->text());
-        }
+    // 在压力列后面插入新列
+    int newColumnIndex = config.pressureColumnIndex + 1;
+
+    // 设置列标题
+    QString columnName = useTimeAxis
+                             ? QString("压力导数(%1)\\%2").arg(timeAxisName(config.timeAxis), config.pressureUnit)
+                             : QString("压力导数\\%1").arg(config.pressureUnit);
+
+    // 插入派生列：源列索引换算为插入后的位置，已算出的值作为当前版本的缓存
+    PressureDerivativeConfig formulaConfig = config;
+    auto shifted = [newColumnIndex](int column) { return column >= newColumnIndex ? column + 1 : column; };
+    formulaConfig.timeColumnIndex = shifted(config.timeColumnIndex);
+    formulaConfig.pressureColumnIndex = shifted(config.pressureColumnIndex);
+    formulaConfig.rateColumnIndex = useTimeAxis ? shifted(config.rateColumnIndex) : -1;
+
+    DataColumn column = DataTableModel::makeNumericColumn(columnName, derivativeData, 'g', 6);
+    column.foreground = QColor("#1565C0"); // 蓝色文字
+    column.formula = QSharedPointer<const ColumnFormula>(new BourdetDerivativeFormula(formulaConfig));
+    column.formulaVersion = model->dataVersion();
+    model->insertColumnData(newColumnIndex, column);
+    result.processedRows = rowCount;
+
+    emit progressUpdated(100, "计算完成");
+
+    // 设置返回结果
+    result.success = true;
+    result.addedColumnIndex = newColumnIndex;
+    result.columnName = columnName;
+
+    emit calculationCompleted(result);
+
+    return result;
+}
+
+bool PressureDerivativeCalculator::computeDerivative(const DataTableModel* model,
+                                                     const PressureDerivativeConfig& config,
+                                                     QVector<double>& derivativeData,
+                                                     QString& errorMessage)
+{
+    int rowCount = model->rowCount();
+    bool useTimeAxis = (config.timeAxis != DerivativeTimeAxis::ElapsedTime);
+
+    // 读取时间和压力数据（数值列整列取出，不逐格解析文本）
+    QVector<double> timeData = readColumnValues(model, config.timeColumnIndex);
+    QVector<double> pressureData = readColumnValues(model, config.pressureColumnIndex);
 
+    for (int row = 0; row < rowCount; ++row) {
         // 检查时间值有效性（允许从0开始）
-        if (timeValue < 0) {
-            result.errorMessage = QString("检测到无效时间值（行 %1），时间不能为负数").arg(row + 1);
-            return result;
+        if (timeData[row] < 0) {
+            errorMessage = QString("检测到无效时间值（行 %1），时间不能为负数").arg(row + 1);
+            return false;
         }
-
-        timeData.append(timeValue);
-        pressureData.append(pressureValue);
     }
 
     // 检查是否需要添加时间偏移（处理t=0的情况）
@@ -108,7 +146,6 @@ PressureDerivativeResult PressureDerivativeCalculator::calculatePressureDerivati
                 // 如果所有时间都<=0，使用配置的偏移量
                 actualTimeOffset = config.timeOffset;
             }
-            qDebug() << "检测到时间从0开始，自动添加时间偏移：" << actualTimeOffset;
         }
     } else {
         actualTimeOffset = config.timeOffset;
@@ -121,8 +158,6 @@ PressureDerivativeResult PressureDerivativeCalculator::calculatePressureDerivati
         adjustedTimeData.append(t + actualTimeOffset);
     }
 
-    emit progressUpdated(30, "正在计算压降...");
-
     // 计算压降 (初始压力 - 当前压力，假定是压降测试)
     QVector<double> pressureDropData;
     pressureDropData.reserve(rowCount);
@@ -133,46 +168,37 @@ PressureDerivativeResult PressureDerivativeCalculator::calculatePressureDerivati
         pressureDropData.append(pressureDrop);
     }
 
-    emit progressUpdated(50, "正在计算Bourdet导数（L-Spacing平滑）...");
-
-    // 调用静态统一算法
-    QVector<double> derivativeData = calculateBourdetDerivative(adjustedTimeData, pressureDropData, config.lSpacing);
-
-    if (derivativeData.size() != rowCount) {
-        result.errorMessage = "导数计算结果数量不匹配";
-        return result;
-    }
-
-    emit progressUpdated(80, "正在写入结果...");
+    if (useTimeAxis) {
+        // 按流动段对等效时间/叠加时间求导
+        QVector<double> rateData = readColumnValues(model, config.rateColumnIndex);
 
-    // 在压力列后面插入新列
-    int newColumnIndex = config.pressureColumnIndex + 1;
-    model->insertColumn(newColumnIndex);
+        for (int row = 1; row < rowCount; ++row) {
+            if (timeData[row] < timeData[row - 1]) {
+                errorMessage = QString("时间列必须单调递增（行 %1）").arg(row + 1);
+                return false;
+            }
+        }
 
-    // 设置列标题
-    QString columnName = QString("压力导数\\%1").arg(config.pressureUnit);
-    QStandardItem* headerItem = new QStandardItem(columnName);
-    model->setHorizontalHeaderItem(newColumnIndex, headerItem);
+        QVector<double> stepTime;
+        QVector<double> stepRate;
+        buildRateSteps(timeData, rateData, 0.01, stepTime, stepRate);
+        if (stepTime.isEmpty()) {
+            errorMessage = "流量列全部为零，无法计算等效时间";
+            return false;
+        }
 
-    // 写入导数数据
-    for (int row = 0; row < rowCount; ++row) {
-        QString valueText = formatValue(derivativeData[row], 6);
-        QStandardItem* item = new QStandardItem(valueText);
-        item->setForeground(QBrush(QColor("#1565C0"))); // 蓝色文字
-        model->setItem(row, newColumnIndex, item);
-        result.processedRows++;
+        derivativeData = calculateDerivativeWithTimeAxis(timeData, pressureData, stepTime, stepRate,
+                                                         config.timeAxis, config.lSpacing);
+    } else {
+        // 调用静态统一算法
+        derivativeData = calculateBourdetDerivative(adjustedTimeData, pressureDropData, config.lSpacing);
     }
 
-    emit progressUpdated(100, "计算完成");
-
-    // 设置返回结果
-    result.success = true;
-    result.addedColumnIndex = newColumnIndex;
-    result.columnName = columnName;
-
-    emit calculationCompleted(result);
-
-    return result;
+    if (derivativeData.size() != rowCount) {
+        errorMessage = "导数计算结果数量不匹配";
+        return false;
+    }
+    return true;
 }
 
 // 静态方法实现：Bourdet 导数核心算法 (Saphir 方法)
@@ -313,7 +339,305 @@ double PressureDerivativeCalculator::calculateDerivativeValue(double t1, double
     return (p1 - p2) / deltaLnT;
 }
 
-PressureDerivativeConfig PressureDerivativeCalculator::autoDetectColumns(QStandardItemModel* model)
+// ============================================================================
+// 时间轴变换：等效时间与叠加时间
+// ============================================================================
+
+void PressureDerivativeCalculator::buildRateSteps(const QVector<double>& timeData,
+                                                  const QVector<double>& rateData,
+                                                  double tolerance,
+                                                  QVector<double>& stepTime,
+                                                  QVector<double>& stepRate)
+{
+    stepTime.clear();
+    stepRate.clear();
+
+    int n = qMin(timeData.size(), rateData.size());
+    if (n == 0) return;
+
+    double maxRate = 0.0;
+    for (int i = 0; i < n; ++i) maxRate = qMax(maxRate, std::abs(rateData[i]));
+    double threshold = qMax(tolerance, 0.0) * maxRate;
+
+    // 相对当前台阶流量变化超过阈值时开启新台阶
+    double current = 0.0;
+    for (int i = 0; i < n; ++i) {
+        double q = rateData[i];
+        if (std::abs(q - current) > threshold || (stepTime.isEmpty() && q != 0.0)) {
+            if (!stepTime.isEmpty() && stepTime.last() == timeData[i]) {
+                stepRate.last() = q;
+            } else {
+                stepTime.append(timeData[i]);
+                stepRate.append(q);
+            }
+            current = q;
+        }
+    }
+}
+
+QVector<int> PressureDerivativeCalculator::assignFlowPeriods(const QVector<double>& timeData,
+                                                             const QVector<double>& stepTime)
+{
+    // 时间点与台阶均有序，双指针 O(n + m)
+    QVector<int> period(timeData.size(), -1);
+    int m = stepTime.size();
+    int j = -1;
+    for (int i = 0; i < timeData.size(); ++i) {
+        while (j + 1 < m && stepTime[j + 1] < timeData[i]) ++j;
+        period[i] = j;
+    }
+    return period;
+}
+
+QVector<double> PressureDerivativeCalculator::calculateEquivalentTime(const QVector<double>& timeData,
+                                                                      const QVector<double>& stepTime,
+                                                                      const QVector<double>& stepRate)
+{
+    int n = timeData.size();
+    int m = qMin(stepTime.size(), stepRate.size());
+    QVector<double> result(n, 0.0);
+    if (m == 0) return result;
+
+    // 累计产量前缀和：cumulative[k] = 台阶 k 开始前的累计产量
+    QVector<double> cumulative(m, 0.0);
+    for (int k = 1; k < m; ++k) {
+        cumulative[k] = cumulative[k - 1] + stepRate[k - 1] * (stepTime[k] - stepTime[k - 1]);
+    }
+
+    QVector<int> period = assignFlowPeriods(timeData, stepTime);
+    for (int i = 0; i < n; ++i) {
+        int k = period[i];
+        if (k < 0) continue;
+
+        double dt = timeData[i] - stepTime[k];
+        double previousRate = (k > 0) ? stepRate[k - 1] : 0.0;
+        if (k == 0 || std::abs(previousRate) < 1e-12) {
+            result[i] = dt;
+            continue;
+        }
+
+        // Horner 有效生产时间
+        double tp = cumulative[k] / previousRate;
+        result[i] = (tp > 0) ? tp * dt / (tp + dt) : dt;
+    }
+    return result;
+}
+
+QVector<double> PressureDerivativeCalculator::calculateEquivalentTime(const QVector<double>& deltaTime,
+                                                                      double producingTime)
+{
+    QVector<double> result;
+    result.reserve(deltaTime.size());
+    for (double dt : deltaTime) {
+        if (producingTime > 0 && dt > 0) {
+            result.append(producingTime * dt / (producingTime + dt));
+        } else {
+            result.append(dt);
+        }
+    }
+    return result;
+}
+
+QVector<double> PressureDerivativeCalculator::calculateSuperpositionTime(const QVector<double>& timeData,
+                                                                         const QVector<double>& stepTime,
+                                                                         const QVector<double>& stepRate)
+{
+    QVector<double> superposition;
+    computeSuperposition(timeData, stepTime, stepRate, &superposition, nullptr);
+    return superposition;
+}
+
+void PressureDerivativeCalculator::computeSuperposition(const QVector<double>& timeData,
+                                                        const QVector<double>& stepTime,
+                                                        const QVector<double>& stepRate,
+                                                        QVector<double>* superpositionOut,
+                                                        QVector<double>* equivalentOut)
+{
+    // 分箱相对宽度：箱内 |T_i - Tc| / (T - Tc) ≤ 0.05，二阶展开单箱截断误差约 4e-5·|ΣΔq|
+    const double binWidth = 0.1;
+
+    int n = timeData.size();
+    int m = qMin(stepTime.size(), stepRate.size());
+    if (superpositionOut) superpositionOut->fill(qQNaN(), n);
+    if (equivalentOut) equivalentOut->fill(0.0, n);
+    if (m == 0 || n == 0) return;
+
+    // 流量增量及其一、二阶矩的前缀和（时间以首个台阶为原点，减小相消误差）
+    double origin = stepTime[0];
+    double maxRate = 0.0;
+    QVector<double> dq(m), P0(m + 1, 0.0), P1(m + 1, 0.0), P2(m + 1, 0.0);
+    for (int j = 0; j < m; ++j) {
+        dq[j] = stepRate[j] - (j > 0 ? stepRate[j - 1] : 0.0);
+        double tj = stepTime[j] - origin;
+        P0[j + 1] = P0[j] + dq[j];
+        P1[j + 1] = P1[j] + dq[j] * tj;
+        P2[j + 1] = P2[j] + dq[j] * tj * tj;
+        maxRate = qMax(maxRate, std::abs(stepRate[j]));
+    }
+
+    struct Bin {
+        double dc;  // 箱中心距流动段起点的时间
+        double s0;  // Σ Δq
+        double s1;  // Σ Δq·(Tc - T_i)
+        double s2;  // Σ Δq·(T_i - Tc)²
+    };
+    QVector<Bin> bins;
+
+    QVector<int> period = assignFlowPeriods(timeData, stepTime);
+
+    int i = 0;
+    while (i < n) {
+        int k = period[i];
+        int end = i;
+        while (end < n && period[end] == k) ++end;
+
+        if (k < 0) {
+            i = end;
+            continue;
+        }
+
+        double tk = stepTime[k];
+        bool degenerate = std::abs(dq[k]) <= 1e-12 * qMax(maxRate, 1e-300);
+
+        // ---- 为流动段 k 构建历史台阶分箱：每箱 O(log m) ----
+        bins.clear();
+        if (!degenerate) {
+            int hi = k - 1;
+            while (hi >= 0) {
+                double dHi = tk - stepTime[hi];
+                double limit = tk - dHi * (1.0 + binWidth);
+                // lo = 第一个 T_j > limit 的台阶
+                int lo = int(std::upper_bound(stepTime.constBegin(), stepTime.constBegin() + hi + 1, limit)
+                             - stepTime.constBegin());
+                lo = qMin(lo, hi);
+
+                double tc = 0.5 * (stepTime[lo] + stepTime[hi]) - origin;
+                double a0 = P0[hi + 1] - P0[lo];
+                double a1 = P1[hi + 1] - P1[lo];
+                double a2 = P2[hi + 1] - P2[lo];
+
+                Bin bin;
+                bin.dc = tk - origin - tc;
+                bin.s0 = a0;
+                bin.s1 = tc * a0 - a1;
+                bin.s2 = a2 - 2.0 * tc * a1 + tc * tc * a0;
+                bins.append(bin);
+
+                hi = lo - 1;
+            }
+        }
+
+        // ---- 段内每个时间点 O(箱数) ----
+        for (int idx = i; idx < end; ++idx) {
+            double dt = timeData[idx] - tk;
+
+            if (degenerate) {
+                if (superpositionOut) (*superpositionOut)[idx] = std::log(dt);
+                if (equivalentOut) (*equivalentOut)[idx] = dt;
+                continue;
+            }
+
+            double absolute = 0.0;   // Σ w·ln(D + Δt)
+            double relative = 0.0;   // Σ w·[ln(D + Δt) - ln(D)]
+            for (const Bin& bin : bins) {
+                double e = bin.dc + dt;
+                double invE = 1.0 / e;
+                double invD = 1.0 / bin.dc;
+                if (superpositionOut) {
+                    absolute += bin.s0 * std::log(e) + bin.s1 * invE - 0.5 * bin.s2 * invE * invE;
+                }
+                relative += bin.s0 * std::log1p(dt * invD)
+                            + bin.s1 * (invE - invD)
+                            - 0.5 * bin.s2 * (invE * invE - invD * invD);
+            }
+
+            if (superpositionOut) (*superpositionOut)[idx] = std::log(dt) + absolute / dq[k];
+            if (equivalentOut) (*equivalentOut)[idx] = dt * std::exp(relative / dq[k]);
+        }
+
+        i = end;
+    }
+}
+
+QVector<double> PressureDerivativeCalculator::calculateDerivativeWithTimeAxis(const QVector<double>& timeData,
+                                                                              const QVector<double>& pressureData,
+                                                                              const QVector<double>& stepTime,
+                                                                              const QVector<double>& stepRate,
+                                                                              DerivativeTimeAxis timeAxis,
+                                                                              double lSpacing)
+{
+    int n = qMin(timeData.size(), pressureData.size());
+    int m = qMin(stepTime.size(), stepRate.size());
+    QVector<double> derivative(n, 0.0);
+    if (n == 0 || m == 0) return derivative;
+
+    // 计算整条序列的变换时间；叠加时间模式下 exp(X - X(0)) 即等效时间，
+    // 对其取 Bourdet 导数等价于 dΔp/dX
+    QVector<double> axisTime;
+    switch (timeAxis) {
+    case DerivativeTimeAxis::AgarwalEquivalent:
+        axisTime = calculateEquivalentTime(timeData, stepTime, stepRate);
+        break;
+    case DerivativeTimeAxis::Superposition:
+        computeSuperposition(timeData, stepTime, stepRate, nullptr, &axisTime);
+        break;
+    case DerivativeTimeAxis::ElapsedTime:
+    default:
+        axisTime.resize(n);
+        break;
+    }
+
+    QVector<int> period = assignFlowPeriods(timeData, stepTime);
+
+    int i = 0;
+    while (i < n) {
+        int k = period[i];
+        int end = i;
+        while (end < n && period[end] == k) ++end;
+
+        if (k >= 0 && end - i >= 3) {
+            double dqk = stepRate[k] - (k > 0 ? stepRate[k - 1] : 0.0);
+            double sign = (dqk < 0) ? -1.0 : 1.0;
+            // 参考压力：段起点前最后一个点，若无则取段内首点
+            double pRef = (i > 0) ? pressureData[i - 1] : pressureData[i];
+
+            QVector<double> segTime;
+            QVector<double> segDp;
+            segTime.reserve(end - i);
+            segDp.reserve(end - i);
+            for (int idx = i; idx < end; ++idx) {
+                double t = (timeAxis == DerivativeTimeAxis::ElapsedTime)
+                               ? timeData[idx] - stepTime[k] : axisTime[idx];
+                segTime.append(t);
+                segDp.append((pRef - pressureData[idx]) * sign);
+            }
+
+            QVector<double> segDerivative = calculateBourdetDerivative(segTime, segDp, lSpacing);
+            for (int idx = i; idx < end; ++idx) {
+                derivative[idx] = segDerivative[idx - i];
+            }
+        }
+
+        i = end;
+    }
+
+    return derivative;
+}
+
+QString PressureDerivativeCalculator::timeAxisName(DerivativeTimeAxis timeAxis)
+{
+    switch (timeAxis) {
+    case DerivativeTimeAxis::AgarwalEquivalent:
+        return "Agarwal等效时间";
+    case DerivativeTimeAxis::Superposition:
+        return "叠加时间";
+    case DerivativeTimeAxis::ElapsedTime:
+    default:
+        return "实际时间";
+    }
+}
+
+PressureDerivativeConfig PressureDerivativeCalculator::autoDetectColumns(DataTableModel* model)
 {
     PressureDerivativeConfig config;
     if (!model) return config;
@@ -323,20 +647,17 @@ PressureDerivativeConfig PressureDerivativeCalculator::autoDetectColumns(QStanda
     return config;
 }
 
-int PressureDerivativeCalculator::findPressureColumn(QStandardItemModel* model)
+int PressureDerivativeCalculator::findPressureColumn(DataTableModel* model)
 {
     if (!model) return -1;
     QStringList pressureKeywords = {"压力", "pressure", "pres", "P\\", "压力\\"};
 
     for (int col = 0; col < model->columnCount(); ++col) {
-        QStandardItem* headerItem = model->horizontalHeaderItem(col);
-        if (headerItem) {
-            QString headerText = headerItem->text();
-            for (const QString& keyword : pressureKeywords) {
-                if (headerText.contains(keyword, Qt::CaseInsensitive)) {
-                    if (!headerText.contains("压降") && !headerText.contains("导数")) {
-                        return col;
-                    }
+        QString headerText = model->headerText(col);
+        for (const QString& keyword : pressureKeywords) {
+            if (headerText.contains(keyword, Qt::CaseInsensitive)) {
+                if (!headerText.contains("压降") && !headerText.contains("导数")) {
+                    return col;
                 }
             }
         }
@@ -344,25 +665,41 @@ int PressureDerivativeCalculator::findPressureColumn(QStandardItemModel* model)
     return -1;
 }
 
-int PressureDerivativeCalculator::findTimeColumn(QStandardItemModel* model)
+int PressureDerivativeCalculator::findTimeColumn(DataTableModel* model)
 {
     if (!model) return -1;
     QStringList timeKeywords = {"时间", "time", "t\\", "小时", "hour", "min", "sec"};
 
     for (int col = 0; col < model->columnCount(); ++col) {
-        QStandardItem* headerItem = model->horizontalHeaderItem(col);
-        if (headerItem) {
-            QString headerText = headerItem->text();
-            for (const QString& keyword : timeKeywords) {
-                if (headerText.contains(keyword, Qt::CaseInsensitive)) {
-                    return col;
-                }
+        QString headerText = model->headerText(col);
+        for (const QString& keyword : timeKeywords) {
+            if (headerText.contains(keyword, Qt::CaseInsensitive)) {
+                return col;
             }
         }
     }
     return -1;
 }
 
+QVector<double> PressureDerivativeCalculator::readColumnValues(const DataTableModel* model, int column)
+{
+    // 数值列直接取连续数组（空单元格按 0 处理），文本列逐格解析（允许带单位后缀）
+    int rowCount = model->rowCount();
+    QVector<double> values;
+    if (model->columnStorage(column) == ColumnStorage::Numeric) {
+        values = model->numericColumn(column);
+        for (double& v : values) {
+            if (std::isnan(v)) v = 0.0;
+        }
+    } else {
+        values.reserve(rowCount);
+        for (int row = 0; row < rowCount; ++row) {
+            values.append(parseNumericValue(model->text(row, column)));
+        }
+    }
+    return values;
+}
+
 double PressureDerivativeCalculator::parseNumericValue(const QString& str)
 {
     if (str.isEmpty()) return 0.0;
@@ -4,7 +4,14 @@
 #include <QObject>
 #include <QString>
 #include <QVector>
-#include <QStandardItemModel>
+#include "datatablemodel.h"
+
+// 导数计算使用的时间轴
+enum class DerivativeTimeAxis {
+    ElapsedTime,        // 实际经过时间
+    AgarwalEquivalent,  // Agarwal 等效时间（Horner 有效生产时间）
+    Superposition       // 多流量叠加时间
+};
 
 // 压力导数计算结果结构
 struct PressureDerivativeResult {
@@ -29,6 +36,8 @@ struct PressureDerivativeConfig {
     double lSpacing;          // L-Spacing平滑参数（对数周期，通常0.1-0.5）
     double timeOffset;        // 时间偏移量（用于处理t=0的情况）
     bool autoTimeOffset;      // 是否自动添加时间偏移
+    DerivativeTimeAxis timeAxis; // 导数时间轴
+    int rateColumnIndex;      // 流量列索引（等效时间/叠加时间需要）
 
     PressureDerivativeConfig() :
         timeColumnIndex(-1),
@@ -37,7 +46,9 @@ struct PressureDerivativeConfig {
         pressureUnit("MPa"),
         lSpacing(0.15),        // 默认值0.15个对数周期 (Saphir标准默认值附近)
         timeOffset(0.0001),    // 默认偏移量0.0001
-        autoTimeOffset(true) {}// 默认自动添加偏移
+        autoTimeOffset(true), // 默认自动添加偏移
+        timeAxis(DerivativeTimeAxis::ElapsedTime),
+        rateColumnIndex(-1) {}
 };
 
 /**
@@ -58,11 +69,13 @@ public:
 
     /**
      * @brief 计算压力导数（针对表格模型的封装）
+     *
+     * 插入的导数列是派生列：压力/时间/流量列改动后在下一次读取时自动重算。
      * @param model 数据模型
      * @param config 计算配置
      * @return 计算结果
      */
-    PressureDerivativeResult calculatePressureDerivative(QStandardItemModel* model,
+    PressureDerivativeResult calculatePressureDerivative(DataTableModel* model,
                                                          const PressureDerivativeConfig& config);
 
     /**
@@ -70,7 +83,19 @@ public:
      * @param model 数据模型
      * @return 配置对象，包含检测到的列索引
      */
-    PressureDerivativeConfig autoDetectColumns(QStandardItemModel* model);
+    PressureDerivativeConfig autoDetectColumns(DataTableModel* model);
+
+    /**
+     * @brief 按配置从表格读取数据并计算整列导数（派生列重算时复用）
+     * @return 数据不满足计算条件时返回 false，errorMessage 给出原因
+     */
+    static bool computeDerivative(const DataTableModel* model, const PressureDerivativeConfig& config,
+                                  QVector<double>& derivativeData, QString& errorMessage);
+
+    /**
+     * @brief 读取列数值：数值列整列取出（空单元格按 0 处理），文本列逐格解析（允许带单位后缀）
+     */
+    static QVector<double> readColumnValues(const DataTableModel* model, int column);
 
     // =========================================================================
     // 静态核心算法接口 (Saphir 风格 Bourdet 导数)
@@ -87,6 +112,79 @@ public:
                                                       const QVector<double>& pressureDropData,
                                                       double lSpacing);
 
+    // =========================================================================
+    // 时间轴变换 (等效时间 / 叠加时间)
+    //
+    // 流量历史以阶梯形式给出：stepRate[j] 自 stepTime[j] 起生效。
+    // 每个时间点归属于严格早于它的最后一个流量台阶（流动段），
+    // Δt 为该点距流动段起点的时间。时间点需单调递增。
+    // =========================================================================
+
+    /**
+     * @brief 将逐点记录的流量序列合并为阶梯流量历史
+     * @param timeData 时间序列（单调递增）
+     * @param rateData 与时间对应的流量
+     * @param tolerance 相对最大流量的合并阈值
+     * @param stepTime 输出：各流量台阶开始时间
+     * @param stepRate 输出：各流量台阶的流量
+     */
+    static void buildRateSteps(const QVector<double>& timeData,
+                               const QVector<double>& rateData,
+                               double tolerance,
+                               QVector<double>& stepTime,
+                               QVector<double>& stepRate);
+
+    /**
+     * @brief 计算每个时间点所属的流动段（流量台阶）索引，首个台阶之前为 -1
+     */
+    static QVector<int> assignFlowPeriods(const QVector<double>& timeData,
+                                          const QVector<double>& stepTime);
+
+    /**
+     * @brief Agarwal 等效时间 te = tp·Δt / (tp + Δt)
+     *
+     * tp 取 Horner 有效生产时间（前期累计产量 / 上一段流量），
+     * 累计产量由流量历史前缀和得到，总代价 O(n + m)。首个流动段 te = Δt。
+     */
+    static QVector<double> calculateEquivalentTime(const QVector<double>& timeData,
+                                                   const QVector<double>& stepTime,
+                                                   const QVector<double>& stepRate);
+
+    /**
+     * @brief 单一生产段后的 Agarwal 等效时间（已知生产时间 tp，输入为关井时间 Δt）
+     */
+    static QVector<double> calculateEquivalentTime(const QVector<double>& deltaTime,
+                                                   double producingTime);
+
+    /**
+     * @brief 多流量叠加时间函数 X = Σ (Δq_i / Δq_n)·ln(t - T_i)
+     *
+     * 历史台阶按 ln(t - T_i) 几何分箱，每个箱的 ΣΔq、ΣΔq·T、ΣΔq·T² 由前缀和 O(1) 得到，
+     * 并以二阶展开代替逐台阶求和（相对误差约 1e-4）。每个时间点代价与台阶数无关。
+     * 首个台阶之前的点返回 NaN。
+     */
+    static QVector<double> calculateSuperpositionTime(const QVector<double>& timeData,
+                                                      const QVector<double>& stepTime,
+                                                      const QVector<double>& stepRate);
+
+    /**
+     * @brief 按指定时间轴分流动段计算 Bourdet 导数
+     *
+     * 每个流动段内压差取 (p_ref - p)·sign(Δq)，p_ref 为段起点前最后一个压力；
+     * 叠加时间模式下导数为 dΔp/dX。返回值与输入逐点对应，首个台阶之前为 0。
+     */
+    static QVector<double> calculateDerivativeWithTimeAxis(const QVector<double>& timeData,
+                                                           const QVector<double>& pressureData,
+                                                           const QVector<double>& stepTime,
+                                                           const QVector<double>& stepRate,
+                                                           DerivativeTimeAxis timeAxis,
+                                                           double lSpacing);
+
+    /**
+     * @brief 时间轴名称（用于列标题和界面显示）
+     */
+    static QString timeAxisName(DerivativeTimeAxis timeAxis);
+
 signals:
     void progressUpdated(int progress, const QString& message);
     void calculationCompleted(const PressureDerivativeResult& result);
@@ -97,9 +195,16 @@ private:
     static int findRightPoint(const QVector<double>& timeData, int currentIndex, double lSpacing);
     static double calculateDerivativeValue(double t1, double t2, double p1, double p2);
 
-    int findPressureColumn(QStandardItemModel* model);
-    int findTimeColumn(QStandardItemModel* model);
-    double parseNumericValue(const QString& str);
+    // 叠加时间核心：可同时输出叠加时间函数 X 与等效时间 exp(X - X(Δt=0))
+    static void computeSuperposition(const QVector<double>& timeData,
+                                     const QVector<double>& stepTime,
+                                     const QVector<double>& stepRate,
+                                     QVector<double>* superpositionOut,
+                                     QVector<double>* equivalentOut);
+
+    int findPressureColumn(DataTableModel* model);
+    int findTimeColumn(DataTableModel* model);
+    static double parseNumericValue(const QString& str);
     QString formatValue(double value, int precision = 6);
 };
 
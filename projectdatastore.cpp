@@ -0,0 +1,504 @@
+#include "projectdatastore.h"
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QtEndian>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+// ============================================================================
+// 内部辅助函数
+// ============================================================================
+
+namespace {
+
+const char kFileMagic[4] = {'W', 'T', 'D', 'B'};
+const char kEntryMagic[4] = {'B', 'L', 'O', 'B'};
+const quint32 kFileVersion = 1;
+const qint64 kFileHeaderSize = 8;
+const qint64 kEntryHeaderSize = 48;
+const int kHashSize = 20;                   // SHA-1
+const quint8 kCompressedFlag = 0x01;
+
+inline qint64 padded(qint64 size)
+{
+    return (size + 7) & ~qint64(7);
+}
+
+inline int elementSize(BlobEncoding encoding)
+{
+    return encoding == BlobEncoding::Float32 ? 4 : 8;
+}
+
+inline QString encodingName(BlobEncoding encoding)
+{
+    return encoding == BlobEncoding::Float32 ? QStringLiteral("f32") : QStringLiteral("f64");
+}
+
+QByteArray fileHeader()
+{
+    QByteArray header(kFileHeaderSize, '\0');
+    std::memcpy(header.data(), kFileMagic, 4);
+    qToLittleEndian<quint32>(kFileVersion, header.data() + 4);
+    return header;
+}
+
+} // namespace
+
+// ============================================================================
+// 打开与关闭
+// ============================================================================
+
+ProjectDataStore::ProjectDataStore()
+    : m_mapped(nullptr),
+      m_mappedSize(0),
+      m_validSize(0),
+      m_generation(0)
+{
+}
+
+ProjectDataStore::~ProjectDataStore()
+{
+    close();
+}
+
+bool ProjectDataStore::open(const QString& filePath, QString& errorMessage)
+{
+    close();
+
+    QMutexLocker locker(&m_mutex);
+    m_filePath = filePath;
+    if (!QFileInfo::exists(filePath)) return true;
+
+    if (!mapFile(errorMessage) || !scanEntries(errorMessage)) {
+        // 无法识别的文件不再写入，以免覆盖
+        unmapFile();
+        m_blobs.clear();
+        m_filePath.clear();
+        return false;
+    }
+    return true;
+}
+
+void ProjectDataStore::close()
+{
+    QMutexLocker locker(&m_mutex);
+    unmapFile();
+    m_blobs.clear();
+    m_filePath.clear();
+    m_validSize = 0;
+}
+
+QString ProjectDataStore::filePath() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_filePath;
+}
+
+bool ProjectDataStore::mapFile(QString& errorMessage)
+{
+    m_file.setFileName(m_filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        errorMessage = QString("无法打开数据文件: %1").arg(m_file.errorString());
+        return false;
+    }
+
+    m_mappedSize = m_file.size();
+    m_mapped = m_mappedSize > 0 ? m_file.map(0, m_mappedSize) : nullptr;
+    if (m_mappedSize > 0 && !m_mapped) {
+        errorMessage = QString("无法映射数据文件: %1").arg(m_file.errorString());
+        m_file.close();
+        m_mappedSize = 0;
+        return false;
+    }
+    return true;
+}
+
+void ProjectDataStore::unmapFile()
+{
+    if (m_mapped) {
+        m_file.unmap(m_mapped);
+        m_mapped = nullptr;
+    }
+    m_mappedSize = 0;
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+}
+
+bool ProjectDataStore::scanEntries(QString& errorMessage)
+{
+    m_validSize = 0;
+    if (m_mappedSize < kFileHeaderSize || std::memcmp(m_mapped, kFileMagic, 4) != 0) {
+        // 空文件或损坏的文件头：下次写入时重建
+        if (m_mappedSize > 0) qDebug() << "数据文件头无效，将重建:" << m_filePath;
+        return true;
+    }
+    if (qFromLittleEndian<quint32>(m_mapped + 4) > kFileVersion) {
+        errorMessage = "数据文件版本过新，请升级软件";
+        return false;
+    }
+
+    // 只读条目头，按负载大小跳过；不完整的尾部条目视为写入中断
+    qint64 pos = kFileHeaderSize;
+    while (pos + kEntryHeaderSize <= m_mappedSize) {
+        const uchar* header = m_mapped + pos;
+        if (std::memcmp(header, kEntryMagic, 4) != 0) break;
+
+        Blob blob;
+        blob.encoding = static_cast<BlobEncoding>(header[4]);
+        blob.compressed = (header[5] & kCompressedFlag) != 0;
+        blob.count = qint64(qFromLittleEndian<quint64>(header + 28));
+        blob.size = qint64(qFromLittleEndian<quint64>(header + 36));
+        blob.offset = pos + kEntryHeaderSize;
+        if (blob.size < 0 || blob.offset + blob.size > m_mappedSize) break;
+
+        QString hash = QString::fromLatin1(
+            QByteArray(reinterpret_cast<const char*>(header + 8), kHashSize).toHex());
+        m_blobs.insert(hash, blob);
+
+        pos = qMin(m_mappedSize, blob.offset + padded(blob.size));
+        m_validSize = pos;
+    }
+    if (m_validSize == 0) m_validSize = kFileHeaderSize;
+
+    if (m_validSize < m_mappedSize) {
+        qDebug() << "数据文件末尾有不完整的条目，已忽略:" << m_filePath;
+    }
+    return true;
+}
+
+// ============================================================================
+// 读写数组
+// ============================================================================
+
+QJsonObject ProjectDataStore::putArray(const QVector<double>& values, BlobEncoding encoding, bool compress)
+{
+    // 编码为小端序负载
+    const int width = elementSize(encoding);
+    QByteArray payload(values.size() * width, Qt::Uninitialized);
+    char* out = payload.data();
+    if (encoding == BlobEncoding::Float32) {
+        for (int i = 0; i < values.size(); ++i) {
+            qToLittleEndian<float>(float(values[i]), out + i * 4);
+        }
+    } else {
+        for (int i = 0; i < values.size(); ++i) {
+            qToLittleEndian<double>(values[i], out + i * 8);
+        }
+    }
+
+    QString hash = QString::fromLatin1(QCryptographicHash::hash(payload, QCryptographicHash::Sha1).toHex());
+
+    QJsonObject ref;
+    ref["blob"] = hash;
+    ref["count"] = values.size();
+    ref["encoding"] = encodingName(encoding);
+
+    QMutexLocker locker(&m_mutex);
+    auto existing = m_blobs.find(hash);
+    if (existing != m_blobs.end()) {
+        // 已保存的内容重新被引用：更新代号，避免被按旧快照进行的整理删除
+        existing->generation = ++m_generation;
+    } else {
+        Blob blob;
+        blob.encoding = encoding;
+        blob.count = values.size();
+        if (compress) {
+            QByteArray packed = qCompress(payload);
+            if (packed.size() < payload.size()) {
+                payload = packed;
+                blob.compressed = true;
+            }
+        }
+        blob.size = payload.size();
+        blob.payload = payload;
+        blob.generation = ++m_generation;
+        m_blobs.insert(hash, blob);
+    }
+    return ref;
+}
+
+QVector<double> ProjectDataStore::getArray(const QJsonValue& value, bool* ok) const
+{
+    if (ok) *ok = true;
+
+    // 旧格式：JSON 数字数组
+    if (value.isArray()) {
+        QJsonArray array = value.toArray();
+        QVector<double> values;
+        values.reserve(array.size());
+        for (const QJsonValue& item : array) values.append(item.toDouble());
+        return values;
+    }
+    if (!isReference(value)) return QVector<double>();
+
+    QString hash = value.toObject()["blob"].toString();
+    QMutexLocker locker(&m_mutex);
+    auto it = m_blobs.constFind(hash);
+    if (it == m_blobs.constEnd()) {
+        qDebug() << "数据文件中缺少数组:" << hash;
+        if (ok) *ok = false;
+        return QVector<double>();
+    }
+    QVector<double> values = decode(it.value());
+    if (ok) *ok = values.size() == it.value().count;
+    return values;
+}
+
+bool ProjectDataStore::contains(const QJsonValue& value) const
+{
+    if (!isReference(value)) return false;
+    QMutexLocker locker(&m_mutex);
+    return m_blobs.contains(value.toObject()["blob"].toString());
+}
+
+quint64 ProjectDataStore::generation() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_generation;
+}
+
+QVector<double> ProjectDataStore::decode(const Blob& blob) const
+{
+    const uchar* data = nullptr;
+    if (blob.offset >= 0) {
+        if (!m_mapped || blob.offset + blob.size > m_mappedSize) return QVector<double>();
+        data = m_mapped + blob.offset;
+    } else {
+        data = reinterpret_cast<const uchar*>(blob.payload.constData());
+    }
+
+    qint64 size = blob.size;
+    QByteArray unpacked;
+    if (blob.compressed) {
+        unpacked = qUncompress(data, size);
+        data = reinterpret_cast<const uchar*>(unpacked.constData());
+        size = unpacked.size();
+    }
+
+    const int width = elementSize(blob.encoding);
+    if (size != blob.count * width) {
+        qDebug() << "数据文件中的数组大小不一致";
+        return QVector<double>();
+    }
+
+    QVector<double> values(int(blob.count));
+    double* out = values.data();
+    if (blob.encoding == BlobEncoding::Float32) {
+        for (qint64 i = 0; i < blob.count; ++i) {
+            out[i] = qFromLittleEndian<float>(data + i * 4);
+        }
+    } else {
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        std::memcpy(out, data, size_t(size));
+#else
+        for (qint64 i = 0; i < blob.count; ++i) {
+            out[i] = qFromLittleEndian<double>(data + i * 8);
+        }
+#endif
+    }
+    return values;
+}
+
+QByteArray ProjectDataStore::entryHeader(const QString& hash, const Blob& blob) const
+{
+    QByteArray header(kEntryHeaderSize, '\0');
+    char* p = header.data();
+    std::memcpy(p, kEntryMagic, 4);
+    p[4] = char(blob.encoding);
+    p[5] = char(blob.compressed ? kCompressedFlag : 0);
+    QByteArray digest = QByteArray::fromHex(hash.toLatin1());
+    std::memcpy(p + 8, digest.constData(), qMin(kHashSize, int(digest.size())));
+    qToLittleEndian<quint64>(quint64(blob.count), p + 28);
+    qToLittleEndian<quint64>(quint64(blob.size), p + 36);
+    return header;
+}
+
+// ============================================================================
+// 写入文件
+// ============================================================================
+
+bool ProjectDataStore::flush(QString& errorMessage)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_filePath.isEmpty()) {
+        errorMessage = "未关联数据文件";
+        return false;
+    }
+
+    QList<QString> pending;
+    for (auto it = m_blobs.constBegin(); it != m_blobs.constEnd(); ++it) {
+        if (it.value().offset < 0) pending.append(it.key());
+    }
+    if (pending.isEmpty()) return true;
+
+    // 追加前解除映射；截掉上次中断写入留下的不完整条目
+    unmapFile();
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::ReadWrite)) {
+        errorMessage = QString("无法写入数据文件: %1").arg(file.errorString());
+        QString mapError;
+        mapFile(mapError);
+        return false;
+    }
+    if (file.size() < kFileHeaderSize || m_validSize < kFileHeaderSize) {
+        file.resize(0);
+        file.write(fileHeader());
+        m_validSize = kFileHeaderSize;
+    } else if (file.size() > m_validSize) {
+        file.resize(m_validSize);
+    }
+    file.seek(m_validSize);
+
+    const QByteArray padding(8, '\0');
+    qint64 pos = m_validSize;
+    QHash<QString, qint64> offsets;
+    bool ok = true;
+    for (const QString& hash : pending) {
+        const Blob& blob = m_blobs[hash];
+        qint64 written = file.write(entryHeader(hash, blob));
+        written += file.write(blob.payload);
+        written += file.write(padding.constData(), padded(blob.size) - blob.size);
+        if (written != kEntryHeaderSize + padded(blob.size)) {
+            ok = false;
+            break;
+        }
+        offsets.insert(hash, pos + kEntryHeaderSize);
+        pos += kEntryHeaderSize + padded(blob.size);
+    }
+    // 断电时日志可能保留下来，引用的数组必须先于日志记录真正落盘
+    ok = syncToDisk(file) && ok;
+    file.close();
+
+    if (!ok) {
+        errorMessage = QString("写入数据文件失败: %1").arg(file.errorString());
+        QString mapError;
+        mapFile(mapError);
+        return false;
+    }
+
+    // 已写入的条目改为从映射读取，释放内存中的负载
+    for (auto it = offsets.constBegin(); it != offsets.constEnd(); ++it) {
+        Blob& blob = m_blobs[it.key()];
+        blob.offset = it.value();
+        blob.payload.clear();
+    }
+    m_validSize = pos;
+    return mapFile(errorMessage);
+}
+
+bool ProjectDataStore::compact(const QSet<QString>& referenced, quint64 sinceGeneration, QString& errorMessage)
+{
+    QMutexLocker locker(&m_mutex);
+
+    // 尚未写入的数组保留：后台保存时界面线程可能刚登记、还没进入任何快照；
+    // 快照之后重新登记的数组同样保留（快照中不再引用，但最新文档可能又引用了）
+    auto keep = [&referenced, sinceGeneration](const QString& hash, const Blob& blob) {
+        return referenced.contains(hash) || blob.generation > sinceGeneration;
+    };
+    qint64 liveBytes = kFileHeaderSize;
+    for (auto it = m_blobs.constBegin(); it != m_blobs.constEnd(); ++it) {
+        if (it.value().offset >= 0 && keep(it.key(), it.value())) {
+            liveBytes += kEntryHeaderSize + padded(it.value().size);
+        }
+    }
+    if (!m_mapped || liveBytes * 2 > m_validSize) return true;
+
+    // 引用的条目写入新文件后整体替换（写入失败时原文件保持不变）
+    QSaveFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        errorMessage = QString("无法重写数据文件: %1").arg(file.errorString());
+        return false;
+    }
+    file.write(fileHeader());
+
+    const QByteArray padding(8, '\0');
+    qint64 pos = kFileHeaderSize;
+    QHash<QString, Blob> kept;
+    for (auto it = m_blobs.constBegin(); it != m_blobs.constEnd(); ++it) {
+        if (it.value().offset < 0 || !keep(it.key(), it.value())) continue;
+
+        Blob blob = it.value();
+        file.write(entryHeader(it.key(), blob));
+        file.write(reinterpret_cast<const char*>(m_mapped + blob.offset), blob.size);
+        file.write(padding.constData(), padded(blob.size) - blob.size);
+        blob.offset = pos + kEntryHeaderSize;
+        pos += kEntryHeaderSize + padded(blob.size);
+        kept.insert(it.key(), blob);
+    }
+
+    // Windows 上被映射的文件不能被替换，提交前先解除映射
+    unmapFile();
+    if (!file.commit()) {
+        errorMessage = QString("重写数据文件失败: %1").arg(file.errorString());
+        QString mapError;
+        mapFile(mapError);
+        return false;
+    }
+
+    for (auto it = m_blobs.constBegin(); it != m_blobs.constEnd(); ++it) {
+        if (it.value().offset < 0) kept.insert(it.key(), it.value());
+    }
+    m_blobs = kept;
+    m_validSize = pos;
+    return mapFile(errorMessage);
+}
+
+// ============================================================================
+// 静态工具接口
+// ============================================================================
+
+bool ProjectDataStore::isReference(const QJsonValue& value)
+{
+    return value.isObject() && value.toObject().contains("blob");
+}
+
+bool ProjectDataStore::syncToDisk(QFile& file)
+{
+    if (!file.flush()) return false;
+#ifdef Q_OS_WIN
+    HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(file.handle()));
+    return handle != INVALID_HANDLE_VALUE && FlushFileBuffers(handle);
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
+
+void ProjectDataStore::collectReferences(const QJsonValue& value, QSet<QString>& hashes)
+{
+    if (isReference(value)) {
+        hashes.insert(value.toObject()["blob"].toString());
+    } else if (value.isObject()) {
+        QJsonObject object = value.toObject();
+        for (auto it = object.constBegin(); it != object.constEnd(); ++it) {
+            collectReferences(it.value(), hashes);
+        }
+    } else if (value.isArray()) {
+        // 数字数组（旧格式数据）中不会有引用，跳过以免逐项遍历
+        QJsonArray array = value.toArray();
+        if (!array.isEmpty() && array.first().isDouble()) return;
+        for (const QJsonValue& item : array) {
+            collectReferences(item, hashes);
+        }
+    }
+}
+
+QString ProjectDataStore::sidecarPath(const QString& projectFilePath)
+{
+    QFileInfo info(projectFilePath);
+    return info.absoluteDir().filePath(info.completeBaseName() + ".wtdata");
+}
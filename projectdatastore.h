@@ -0,0 +1,122 @@
+#ifndef PROJECTDATASTORE_H
+#define PROJECTDATASTORE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+// 数组在容器中的编码（均为小端序）
+enum class BlobEncoding : quint8 {
+    Float64 = 0,
+    Float32 = 1
+};
+
+/**
+ * @brief 项目文件的二进制边车容器（<项目名>.wtdata）
+ *
+ * 观测数据等大数组不再以 JSON 数字数组写入项目文件，而是按内容哈希存入边车容器，
+ * JSON 中只保留引用 {"blob": SHA-1, "count": n, "encoding": "f64"|"f32"}。
+ *
+ * 文件格式：8 字节文件头（"WTDB" + 版本），之后为顺序追加的条目。每个条目由
+ * 48 字节条目头（"BLOB"、编码、压缩标志、SHA-1、元素数、负载字节数）和负载组成，
+ * 负载按 8 字节对齐，未压缩的 float64 负载可直接从内存映射中读取。压缩负载为
+ * zlib（qCompress 格式）。哈希按编码后、压缩前的负载计算，相同内容只存一份。
+ *
+ * 打开时整体内存映射并扫描条目头建立索引（不读负载）；末尾不完整的条目
+ * （写入中断）被忽略，下次追加时截掉。新数组先登记在内存中，flush() 时才追加写入；
+ * compact() 在失效数据超过一半时只保留仍被引用的条目（及尚未写入的数组）并整体替换文件。
+ * 每次 putArray() 都给数组打上递增的代号（内容已存在时同样更新），后台按较早的快照整理时，
+ * 快照之后重新登记的数组不会被删除。所有接口线程安全。
+ */
+class ProjectDataStore
+{
+public:
+    ProjectDataStore();
+    ~ProjectDataStore();
+
+    // 关联边车文件（文件不存在时在首次 flush() 时创建）
+    bool open(const QString& filePath, QString& errorMessage);
+    void close();
+    QString filePath() const;
+
+    /**
+     * @brief 登记数组，返回 JSON 引用（内容已存在时不重复保存）
+     */
+    QJsonObject putArray(const QVector<double>& values,
+                         BlobEncoding encoding = BlobEncoding::Float64,
+                         bool compress = false);
+
+    /**
+     * @brief 解析 JSON 值：引用从容器读取，数字数组按旧格式逐项读取
+     * @param ok 非空时返回是否读取成功（引用的数组缺失或已损坏时为 false）
+     */
+    QVector<double> getArray(const QJsonValue& value, bool* ok = nullptr) const;
+
+    // 引用的数组是否在容器中（已写入或已登记）
+    bool contains(const QJsonValue& value) const;
+
+    // 当前代号：之后 putArray() 登记的数组代号都大于它
+    quint64 generation() const;
+
+    /**
+     * @brief 把尚未写入的数组追加到边车文件
+     */
+    bool flush(QString& errorMessage);
+
+    /**
+     * @brief 只保留 referenced 中的数组；失效数据超过一半时重写文件
+     * @param sinceGeneration 取 referenced 时的 generation()；此后登记过的数组一律保留
+     */
+    bool compact(const QSet<QString>& referenced, quint64 sinceGeneration, QString& errorMessage);
+
+    // =========================================================================
+    // 静态工具接口
+    // =========================================================================
+
+    static bool isReference(const QJsonValue& value);
+
+    // 把文件内容写到磁盘（不只是系统缓存）；日志记录引用的数据必须先落盘
+    static bool syncToDisk(QFile& file);
+
+    // 递归收集 JSON 中的全部引用哈希
+    static void collectReferences(const QJsonValue& value, QSet<QString>& hashes);
+
+    // 项目文件对应的边车文件路径
+    static QString sidecarPath(const QString& projectFilePath);
+
+private:
+    struct Blob {
+        BlobEncoding encoding;
+        bool compressed;
+        qint64 count;
+        qint64 offset;          // 负载在文件中的偏移（-1 表示尚未写入）
+        qint64 size;            // 负载字节数（不含对齐填充）
+        QByteArray payload;     // 尚未写入的负载
+        quint64 generation;     // 最近一次 putArray() 的代号（从文件读入的为 0）
+
+        Blob() : encoding(BlobEncoding::Float64), compressed(false), count(0), offset(-1), size(0), generation(0) {}
+    };
+
+    mutable QMutex m_mutex;
+    QString m_filePath;
+    QFile m_file;
+    uchar* m_mapped;
+    qint64 m_mappedSize;
+    qint64 m_validSize;         // 最后一个完整条目的结束位置
+    QHash<QString, Blob> m_blobs;
+    quint64 m_generation;
+
+    bool mapFile(QString& errorMessage);
+    void unmapFile();
+    bool scanEntries(QString& errorMessage);
+    QByteArray entryHeader(const QString& hash, const Blob& blob) const;
+    QVector<double> decode(const Blob& blob) const;
+};
+
+#endif // PROJECTDATASTORE_H
@@ -0,0 +1,367 @@
+#include "projectsaveengine.h"
+#include "projectdatastore.h"
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QStringList>
+#include <QtConcurrent>
+#include <QtEndian>
+#include <cstring>
+
+// ============================================================================
+// 内部辅助函数
+// ============================================================================
+
+namespace {
+
+const char kJournalMagic[4] = {'W', 'T', 'J', 'L'};
+const quint32 kJournalVersion = 1;
+const qint64 kJournalHeaderSize = 8;
+const qint64 kRecordHeaderSize = 8;
+const qint64 kMaxJournalSize = 1024 * 1024;     // 超过后合并进项目文件
+const int kMaxJournalRecords = 256;
+
+QByteArray journalHeader()
+{
+    QByteArray header(kJournalHeaderSize, '\0');
+    std::memcpy(header.data(), kJournalMagic, 4);
+    qToLittleEndian<quint32>(kJournalVersion, header.data() + 4);
+    return header;
+}
+
+QByteArray checksum(const QByteArray& payload)
+{
+    return QCryptographicHash::hash(payload, QCryptographicHash::Sha1).left(4);
+}
+
+// 按节路径取值（数字段为数组下标），不存在时为 Undefined
+QJsonValue valueAt(const QJsonValue& root, const QStringList& path)
+{
+    QJsonValue node = root;
+    for (const QString& part : path) {
+        if (node.isArray()) {
+            bool ok = false;
+            const int index = part.toInt(&ok);
+            const QJsonArray array = node.toArray();
+            if (!ok || index < 0 || index >= array.size()) return QJsonValue(QJsonValue::Undefined);
+            node = array.at(index);
+        } else if (node.isObject()) {
+            node = node.toObject().value(part);
+        } else {
+            return QJsonValue(QJsonValue::Undefined);
+        }
+    }
+    return node;
+}
+
+// 返回把 path 处替换为 value 后的副本（数组下标越界时原样返回，等于末尾时追加）
+QJsonValue withValueAt(const QJsonValue& node, const QStringList& path, int depth, const QJsonValue& value)
+{
+    if (depth == path.size()) return value;
+
+    const QString& part = path[depth];
+    if (node.isArray()) {
+        bool ok = false;
+        const int index = part.toInt(&ok);
+        QJsonArray array = node.toArray();
+        if (!ok || index < 0 || index > array.size()) return node;
+        if (index == array.size()) {
+            array.append(withValueAt(QJsonValue(), path, depth + 1, value));
+        } else {
+            array[index] = withValueAt(array.at(index), path, depth + 1, value);
+        }
+        return array;
+    }
+
+    QJsonObject object = node.toObject();
+    object[part] = withValueAt(object.value(part), path, depth + 1, value);
+    return object;
+}
+
+} // namespace
+
+// ============================================================================
+// 打开与关闭
+// ============================================================================
+
+ProjectSaveEngine::ProjectSaveEngine(QObject* parent)
+    : QObject(parent),
+      m_dataStore(nullptr),
+      m_journalSize(0),
+      m_journalRecords(0)
+{
+    // 单线程保证写入按提交顺序执行
+    m_writer.setMaxThreadCount(1);
+}
+
+ProjectSaveEngine::~ProjectSaveEngine()
+{
+    waitForFinished();
+}
+
+bool ProjectSaveEngine::open(const QString& filePath, ProjectDataStore* dataStore,
+                             QJsonObject& document, QString& errorMessage)
+{
+    waitForFinished();
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        errorMessage = QString("无法打开项目文件: %1").arg(file.errorString());
+        return false;
+    }
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    file.close();
+    if (!doc.isObject()) {
+        errorMessage = "项目文件格式错误";
+        return false;
+    }
+    QJsonObject merged = doc.object();
+
+    // 回放日志：在第一条损坏的记录处停止
+    qint64 journalSize = 0;
+    int journalRecords = 0;
+    QFile journal(journalPath(filePath));
+    if (journal.open(QIODevice::ReadOnly)) {
+        const QByteArray data = journal.readAll();
+        journal.close();
+
+        if (data.size() >= kJournalHeaderSize
+            && std::memcmp(data.constData(), kJournalMagic, 4) == 0) {
+            quint32 version = qFromLittleEndian<quint32>(data.constData() + 4);
+            if (version > kJournalVersion) {
+                errorMessage = QString("项目日志版本 %1 过高，请升级软件").arg(version);
+                return false;
+            }
+
+            qint64 pos = kJournalHeaderSize;
+            while (pos + kRecordHeaderSize <= data.size()) {
+                qint64 length = qFromLittleEndian<quint32>(data.constData() + pos);
+                if (pos + kRecordHeaderSize + length > data.size()) break;
+
+                QByteArray payload = data.mid(pos + kRecordHeaderSize, length);
+                if (checksum(payload) != data.mid(pos + 4, 4)) break;
+                QJsonDocument record = QJsonDocument::fromJson(payload);
+                if (!record.isObject()) break;
+
+                QJsonObject entry = record.object();
+                merged = withValueAt(merged, entry["key"].toString().split('/'), 0, entry["value"]).toObject();
+                pos += kRecordHeaderSize + length;
+                ++journalRecords;
+            }
+            journalSize = pos;
+
+            if (pos < data.size()) {
+                qDebug() << "项目日志末尾不完整，已忽略" << (data.size() - pos) << "字节";
+            }
+        }
+    }
+
+    m_filePath = filePath;
+    m_dataStore = dataStore;
+    m_document = merged;
+    m_dirty.clear();
+    m_journalSize = journalSize;
+    m_journalRecords = journalRecords;
+
+    document = merged;
+    return true;
+}
+
+void ProjectSaveEngine::create(const QString& filePath, ProjectDataStore* dataStore, const QJsonObject& document)
+{
+    waitForFinished();
+
+    // 同名旧项目留下的日志不能回放到新项目上
+    QFile::remove(journalPath(filePath));
+
+    m_filePath = filePath;
+    m_dataStore = dataStore;
+    m_document = document;
+    m_dirty.clear();
+    m_journalSize = 0;
+    m_journalRecords = 0;
+}
+
+void ProjectSaveEngine::close()
+{
+    if (m_filePath.isEmpty()) return;
+
+    submit(takeDirtyRecords(), true);
+    waitForFinished();
+
+    m_filePath.clear();
+    m_dataStore = nullptr;
+    m_document = QJsonObject();
+}
+
+void ProjectSaveEngine::waitForFinished()
+{
+    m_writer.waitForDone();
+}
+
+QString ProjectSaveEngine::journalPath(const QString& projectFilePath)
+{
+    QFileInfo info(projectFilePath);
+    return info.absoluteDir().filePath(info.completeBaseName() + ".wtjournal");
+}
+
+// ============================================================================
+// 修改跟踪与提交
+// ============================================================================
+
+void ProjectSaveEngine::setSection(const QString& key, const QJsonValue& value)
+{
+    const QStringList path = key.split('/');
+    if (valueAt(m_document, path) == value) return;
+    m_document = withValueAt(m_document, path, 0, value).toObject();
+    m_dirty.insert(key);
+}
+
+void ProjectSaveEngine::save()
+{
+    if (m_filePath.isEmpty() || m_dirty.isEmpty()) return;
+    submit(takeDirtyRecords(), false);
+}
+
+QJsonObject ProjectSaveEngine::takeDirtyRecords()
+{
+    QJsonObject records;
+    for (const QString& key : m_dirty) {
+        // 上级节也修改过时由上级节的记录覆盖
+        bool covered = false;
+        for (int slash = key.indexOf('/'); slash >= 0 && !covered; slash = key.indexOf('/', slash + 1)) {
+            covered = m_dirty.contains(key.left(slash));
+        }
+        if (!covered) records[key] = valueAt(m_document, key.split('/'));
+    }
+    m_dirty.clear();
+    return records;
+}
+
+void ProjectSaveEngine::submit(const QJsonObject& records, bool mergeJournal)
+{
+    // 快照在界面线程取出，之后的修改不影响本次写入
+    const QString filePath = m_filePath;
+    ProjectDataStore* dataStore = m_dataStore;
+    const QJsonObject snapshot = m_document;
+    const quint64 generation = dataStore ? dataStore->generation() : 0;
+
+    (void)QtConcurrent::run(&m_writer, [this, filePath, dataStore, generation, records, snapshot, mergeJournal]() {
+        writeChanges(filePath, dataStore, generation, records, snapshot, mergeJournal);
+    });
+}
+
+// ============================================================================
+// 后台写入
+// ============================================================================
+
+void ProjectSaveEngine::writeChanges(const QString& filePath, ProjectDataStore* dataStore, quint64 generation,
+                                     const QJsonObject& records, const QJsonObject& snapshot,
+                                     bool mergeJournal)
+{
+    QString error;
+    QSet<QString> referenced;
+    ProjectDataStore::collectReferences(snapshot, referenced);
+
+    // 1. 数组先落盘
+    if (dataStore && !referenced.isEmpty() && !dataStore->flush(error)) {
+        emit saveFinished(false, QString("保存项目数据失败: %1").arg(error));
+        return;
+    }
+
+    // 2. 修改节追加到日志
+    if (!records.isEmpty() && !appendJournal(filePath, records, error)) {
+        emit saveFinished(false, error);
+        return;
+    }
+
+    // 3. 日志过大或关闭项目时合并进项目文件
+    if (m_journalRecords > 0
+        && (mergeJournal || m_journalSize > kMaxJournalSize || m_journalRecords > kMaxJournalRecords)) {
+        if (!compactJournal(filePath, snapshot, error)) {
+            emit saveFinished(false, error);
+            return;
+        }
+    }
+
+    // 4. 清理不再引用的数组（后续快照可能重新引用的由代号保护）
+    if (dataStore && !dataStore->compact(referenced, generation, error)) {
+        qDebug() << "整理项目数据文件失败:" << error;
+    }
+
+    emit saveFinished(true, QString());
+}
+
+bool ProjectSaveEngine::appendJournal(const QString& filePath, const QJsonObject& records, QString& errorMessage)
+{
+    QByteArray buffer;
+    int count = 0;
+    for (auto it = records.constBegin(); it != records.constEnd(); ++it) {
+        QJsonObject entry;
+        entry["key"] = it.key();
+        entry["value"] = it.value();
+        QByteArray payload = QJsonDocument(entry).toJson(QJsonDocument::Compact);
+
+        char length[4];
+        qToLittleEndian<quint32>(quint32(payload.size()), length);
+        buffer.append(length, 4);
+        buffer.append(checksum(payload));
+        buffer.append(payload);
+        ++count;
+    }
+
+    QFile journal(journalPath(filePath));
+    if (!journal.open(QIODevice::ReadWrite)) {
+        errorMessage = QString("无法写入项目日志: %1").arg(journal.errorString());
+        return false;
+    }
+
+    // 新日志写入文件头；截掉上次中断写入留下的不完整记录
+    if (m_journalSize < kJournalHeaderSize) {
+        journal.resize(0);
+        journal.write(journalHeader());
+        m_journalSize = kJournalHeaderSize;
+    } else if (journal.size() > m_journalSize) {
+        journal.resize(m_journalSize);
+    }
+    journal.seek(m_journalSize);
+
+    // 落盘后才报告保存成功
+    bool ok = journal.write(buffer) == buffer.size();
+    ok = ProjectDataStore::syncToDisk(journal) && ok;
+    journal.close();
+    if (!ok) {
+        errorMessage = QString("写入项目日志失败: %1").arg(journal.errorString());
+        return false;
+    }
+
+    m_journalSize += buffer.size();
+    m_journalRecords += count;
+    return true;
+}
+
+bool ProjectSaveEngine::compactJournal(const QString& filePath, const QJsonObject& snapshot, QString& errorMessage)
+{
+    // 写临时文件后原子替换：中途失败时项目文件与日志都保持原样
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        errorMessage = QString("无法写入项目文件: %1").arg(file.errorString());
+        return false;
+    }
+    file.write(QJsonDocument(snapshot).toJson());
+    if (!file.commit()) {
+        errorMessage = QString("写入项目文件失败: %1").arg(file.errorString());
+        return false;
+    }
+
+    // 项目文件已含全部修改；删除前崩溃也无妨，回放的是相同内容
+    QFile::remove(journalPath(filePath));
+    m_journalSize = 0;
+    m_journalRecords = 0;
+    return true;
+}
@@ -0,0 +1,93 @@
+#ifndef PROJECTSAVEENGINE_H
+#define PROJECTSAVEENGINE_H
+
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QThreadPool>
+
+class ProjectDataStore;
+
+/**
+ * @brief 项目文件的增量保存（日志 + 后台合并）
+ *
+ * 项目 JSON 按节跟踪修改。节名为顶层键（reservoir、pvt 等），也可以是以 "/" 分隔的
+ * 路径（如 "fitting/analyses/2"，数字段为数组下标），这样只有改动过的分析页进入日志；
+ * 上级节与下级节同时修改时只记录上级节。save() 只在界面线程
+ * 取修改节与完整文档的快照（QJsonObject 隐式共享，复制代价为常数），写盘由单线程
+ * 写入池按提交顺序在后台完成：
+ *   1. 边车容器中新登记的数组先落盘并同步到磁盘（日志中不会出现尚未写入的引用）；
+ *   2. 修改节作为记录追加到日志文件 <项目名>.wtjournal，同步到磁盘后才报告成功；
+ *   3. 日志超过阈值（或关闭项目）时，把完整快照经 QSaveFile 写入项目文件
+ *      （临时文件 + 原子重命名），随后删除日志；
+ *   4. 按快照中的引用整理边车容器（取快照后重新登记的数组不删除）。
+ *
+ * 日志格式：8 字节文件头（"WTJL" + 版本），之后每条记录为 4 字节负载长度、
+ * 4 字节校验（负载 SHA-1 前 4 字节）和紧凑 JSON {"key": 节名或路径, "value": 节内容}。
+ * 打开项目时在项目文件之上按顺序回放日志（路径记录写回所在的数组元素），遇到不完整或校验失败的记录即停止
+ * （写入中断只丢失最后一次保存），下次追加时截掉损坏的尾部。
+ */
+class ProjectSaveEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ProjectSaveEngine(QObject* parent = nullptr);
+    ~ProjectSaveEngine();
+
+    /**
+     * @brief 读取项目文件并回放日志
+     * @param document 输出：合并后的完整项目文档
+     */
+    bool open(const QString& filePath, ProjectDataStore* dataStore,
+              QJsonObject& document, QString& errorMessage);
+
+    // 关联新建的项目文件（项目文件已写好，残留的旧日志作废）
+    void create(const QString& filePath, ProjectDataStore* dataStore, const QJsonObject& document);
+
+    // 提交剩余修改并把日志合并进项目文件（阻塞到写入完成）
+    void close();
+
+    bool isOpen() const { return !m_filePath.isEmpty(); }
+
+    // 更新一节内容（key 可为 "节/子键/数组下标" 路径）；与当前内容相同时不标记修改
+    void setSection(const QString& key, const QJsonValue& value);
+
+    bool hasPendingChanges() const { return !m_dirty.isEmpty(); }
+
+    // 提交修改节到后台写入（没有修改时不做任何事）
+    void save();
+
+    // 等待已提交的写入全部完成
+    void waitForFinished();
+
+    // 项目文件对应的日志文件路径
+    static QString journalPath(const QString& projectFilePath);
+
+signals:
+    // 每次后台写入结束时发出（在写入线程发出，跨线程连接自动排队）
+    void saveFinished(bool success, const QString& message);
+
+private:
+    // 界面线程状态
+    QString m_filePath;
+    ProjectDataStore* m_dataStore;
+    QJsonObject m_document;
+    QSet<QString> m_dirty;
+    QThreadPool m_writer;
+
+    // 写入线程状态（open/create 只在写入池空闲时修改）
+    qint64 m_journalSize;       // 最后一条完整记录的结束位置
+    int m_journalRecords;
+
+    QJsonObject takeDirtyRecords();
+    void submit(const QJsonObject& records, bool mergeJournal);
+    void writeChanges(const QString& filePath, ProjectDataStore* dataStore, quint64 generation,
+                      const QJsonObject& records, const QJsonObject& snapshot, bool mergeJournal);
+    bool appendJournal(const QString& filePath, const QJsonObject& records, QString& errorMessage);
+    bool compactJournal(const QString& filePath, const QJsonObject& snapshot, QString& errorMessage);
+};
+
+#endif // PROJECTSAVEENGINE_H
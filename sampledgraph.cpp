@@ -0,0 +1,155 @@
+#include "sampledgraph.h"
+#include "plotlayercache.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const int kMinSampledPoints = 1000;     // 点数较少时按 QCPGraph 原方式处理
+const int kMinSpritePoints = 64;        // 散点较少时直接绘制形状
+
+} // namespace
+
+SampledGraph::SampledGraph(QCPAxis* keyAxis, QCPAxis* valueAxis)
+    : QCPGraph(keyAxis, valueAxis),
+      m_spriteKey(0)
+{
+}
+
+// ============================================================================
+// 折线：按像素列保留首、最小、最大、末点
+// ============================================================================
+
+void SampledGraph::getOptimizedLineData(QVector<QCPGraphData>* lineData,
+                                        const QCPGraphDataContainer::const_iterator& begin,
+                                        const QCPGraphDataContainer::const_iterator& end) const
+{
+    QCPAxis* keyAxis = mKeyAxis.data();
+    QCPAxis* valueAxis = mValueAxis.data();
+    if (!lineData || !keyAxis || !valueAxis || !mAdaptiveSampling || mLineStyle != lsLine
+        || end - begin < kMinSampledPoints) {
+        QCPGraph::getOptimizedLineData(lineData, begin, end);
+        return;
+    }
+
+    // 键值增大时像素是否增大（决定列边界取哪一侧）
+    const bool increasing = keyAxis->pixelOrientation() > 0;
+    const bool logKey = keyAxis->scaleType() == QCPAxis::stLogarithmic;
+
+    auto it = begin;
+    while (it != end) {
+        // 对数轴上的非正键值无法定位，NaN 值原样保留（折线在此断开）
+        if (logKey && it->key <= 0) {
+            ++it;
+            continue;
+        }
+        if (qIsNaN(it->value)) {
+            lineData->append(*it);
+            ++it;
+            continue;
+        }
+
+        const double column = std::floor(keyAxis->coordToPixel(it->key));
+        const double limit = keyAxis->pixelToCoord(increasing ? column + 1 : column);
+
+        auto first = it, last = it, minIt = it, maxIt = it;
+        for (++it; it != end && (increasing ? it->key < limit : it->key <= limit) && !qIsNaN(it->value); ++it) {
+            if (it->value < minIt->value) minIt = it;
+            if (it->value > maxIt->value) maxIt = it;
+            last = it;
+        }
+
+        // 按原顺序输出，包络与逐点绘制一致
+        QCPGraphDataContainer::const_iterator order[4] = {first, minIt, maxIt, last};
+        std::sort(order, order + 4);
+        for (int k = 0; k < 4; ++k) {
+            if (k > 0 && order[k] == order[k - 1]) continue;
+            lineData->append(*order[k]);
+        }
+    }
+}
+
+// ============================================================================
+// 散点：像素网格占用抽稀
+// ============================================================================
+
+void SampledGraph::getOptimizedScatterData(QVector<QCPGraphData>* scatterData,
+                                           QCPGraphDataContainer::const_iterator begin,
+                                           QCPGraphDataContainer::const_iterator end) const
+{
+    QCPAxis* keyAxis = mKeyAxis.data();
+    QCPAxis* valueAxis = mValueAxis.data();
+    if (!scatterData || !keyAxis || !valueAxis || !mAdaptiveSampling || mScatterSkip > 0
+        || end - begin < kMinSampledPoints) {
+        QCPGraph::getOptimizedScatterData(scatterData, begin, end);
+        return;
+    }
+
+    // 网格覆盖坐标轴矩形外扩一个点径，边缘处半露的散点也保留
+    const double size = mScatterStyle.size();
+    const double cell = qMax(1.0, size / 2.0);
+    const QRectF area = QRectF(keyAxis->axisRect()->rect()).adjusted(-size, -size, size, size);
+    const int gridWidth = int(area.width() / cell) + 1;
+    const int gridHeight = int(area.height() / cell) + 1;
+    QVector<char> occupied(gridWidth * gridHeight, 0);
+
+    for (auto it = begin; it != end; ++it) {
+        const QPointF pixel = coordsToPixels(it->key, it->value);
+        if (!qIsFinite(pixel.x()) || !qIsFinite(pixel.y()) || !area.contains(pixel)) continue;
+
+        const int gx = qBound(0, int((pixel.x() - area.left()) / cell), gridWidth - 1);
+        const int gy = qBound(0, int((pixel.y() - area.top()) / cell), gridHeight - 1);
+        char& slot = occupied[gy * gridWidth + gx];
+        if (slot) continue;
+        slot = 1;
+
+        scatterData->append(*it);
+    }
+}
+
+// ============================================================================
+// 散点精灵
+// ============================================================================
+
+void SampledGraph::drawScatterPlot(QCPPainter* painter, const QVector<QPointF>& scatters,
+                                   const QCPScatterStyle& style) const
+{
+    // 矢量输出、位图/自定义形状或点数很少时逐个绘制
+    if (painter->modes().testFlag(QCPPainter::pmVectorized) || scatters.size() < kMinSpritePoints
+        || style.shape() == QCPScatterStyle::ssPixmap || style.shape() == QCPScatterStyle::ssCustom) {
+        QCPGraph::drawScatterPlot(painter, scatters, style);
+        return;
+    }
+
+    const qreal devicePixelRatio = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+    const QPixmap& sprite = scatterSprite(style, devicePixelRatio);
+    const QPointF offset(sprite.width() / devicePixelRatio / 2.0, sprite.height() / devicePixelRatio / 2.0);
+    for (const QPointF& scatter : scatters) {
+        painter->drawPixmap(scatter - offset, sprite);
+    }
+}
+
+const QPixmap& SampledGraph::scatterSprite(const QCPScatterStyle& style, qreal devicePixelRatio) const
+{
+    const QPen pen = style.isPenDefined() ? style.pen() : mPen;
+    PlotLayerKey key;
+    key.add(int(style.shape())).add(style.size());
+    key.add(pen.color()).add(pen.widthF()).add(int(pen.style()));
+    key.add(style.brush().color()).add(int(style.brush().style()));
+    key.add(double(devicePixelRatio)).add(mAntialiasedScatters);
+    if (!m_sprite.isNull() && m_spriteKey == key.value()) return m_sprite;
+
+    const int extent = int(std::ceil(style.size() + pen.widthF())) + 2;
+    m_sprite = QPixmap(QSize(extent, extent) * devicePixelRatio);
+    m_sprite.setDevicePixelRatio(devicePixelRatio);
+    m_sprite.fill(Qt::transparent);
+
+    QCPPainter painter(&m_sprite);
+    painter.setRenderHint(QPainter::Antialiasing, mAntialiasedScatters);
+    style.applyTo(&painter, mPen);
+    style.drawShape(&painter, extent / 2.0, extent / 2.0);
+    painter.end();
+
+    m_spriteKey = key.value();
+    return m_sprite;
+}
@@ -0,0 +1,39 @@
+#ifndef SAMPLEDGRAPH_H
+#define SAMPLEDGRAPH_H
+
+#include "qcustomplot.h"
+#include <QPixmap>
+
+/**
+ * @brief 按像素抽稀的 QCustomPlot 曲线
+ *
+ * QCPGraph 自带的自适应采样按线性键值间隔估算像素宽度，双对数图上数据集中在右侧
+ * 几个数量级时效果很差；散点则几乎逐点绘制。本类在开启自适应采样时：
+ *  - 折线：按键轴像素列分桶（边界由 pixelToCoord 求出，对数轴同样准确），
+ *    每列保留首点、最小点、最大点、末点（按原顺序，均为真实数据点）；
+ *  - 散点：按半个点径划分像素网格，每格只保留一个点；
+ *  - 散点形状预先渲染成精灵位图，逐点只做位图合成（矢量导出时仍逐个绘制形状）。
+ */
+class SampledGraph : public QCPGraph
+{
+    Q_OBJECT
+
+public:
+    explicit SampledGraph(QCPAxis* keyAxis, QCPAxis* valueAxis);
+
+protected:
+    void drawScatterPlot(QCPPainter* painter, const QVector<QPointF>& scatters,
+                         const QCPScatterStyle& style) const override;
+    void getOptimizedLineData(QVector<QCPGraphData>* lineData, const QCPGraphDataContainer::const_iterator& begin,
+                              const QCPGraphDataContainer::const_iterator& end) const override;
+    void getOptimizedScatterData(QVector<QCPGraphData>* scatterData, QCPGraphDataContainer::const_iterator begin,
+                                 QCPGraphDataContainer::const_iterator end) const override;
+
+private:
+    mutable QPixmap m_sprite;           // 散点精灵
+    mutable quint64 m_spriteKey;
+
+    const QPixmap& scatterSprite(const QCPScatterStyle& style, qreal devicePixelRatio) const;
+};
+
+#endif // SAMPLEDGRAPH_H
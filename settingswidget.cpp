@@ -447,3 +447,8 @@ bool SettingsWidget::isBackupEnabled() const
 {
     return ui->backupEnabledCheckBox->isChecked();
 }
+
+int SettingsWidget::getMaxBackups() const
+{
+    return ui->maxBackupsSpinBox->value();
+}
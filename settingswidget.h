@@ -32,6 +32,7 @@ public:
     QString getCurrentBackupPath() const;
     int getAutoSaveInterval() const;
     bool isBackupEnabled() const;
+    int getMaxBackups() const;
 
 signals:
     /**
@@ -23,6 +23,14 @@
 #include <QBuffer>
 #include <Eigen/Dense>
 
+// 理论曲线的时间点：有观测数据时取观测时间，否则取 10^-4 ~ 10^4 的对数网格
+static QVector<double> curveTimeSteps(const QVector<double>& obsTime)
+{
+    QVector<double> targetT = obsTime;
+    if(targetT.isEmpty()) { for(double e = -4; e <= 4; e += 0.1) targetT.append(pow(10, e)); }
+    return targetT;
+}
+
 // ===========================================================================
 // FittingWidget 实现
 // ===========================================================================
@@ -55,14 +63,21 @@ FittingWidget::FittingWidget(QWidget *parent) :
     qRegisterMetaType<QVector<double>>("QVector<double>");
 
     // --- 信号连接 ---
-    connect(this, &FittingWidget::sigIterationUpdated, this, &FittingWidget::onIterationUpdate, Qt::QueuedConnection);
+    connect(&m_liveChannel, &FitLiveChannel::snapshotReady, this, &FittingWidget::onFitSnapshot);
     connect(this, &FittingWidget::sigProgress, ui->progressBar, &QProgressBar::setValue);
     connect(&m_watcher, &QFutureWatcher<void>::finished, this, &FittingWidget::onFitFinished);
+    connect(&m_restoreWatcher, &QFutureWatcher<FittingRestoreJob>::finished, this, &FittingWidget::onRestoreFinished);
 
     // --- 权重滑块逻辑 ---
     // 连接滑块信号到更新槽
     connect(ui->sliderWeight, &QSlider::valueChanged, this, &FittingWidget::onSliderWeightChanged);
 
+    // --- 保存状态变化通知 ---
+    connect(ui->sliderWeight, &QSlider::valueChanged, this, &FittingWidget::sigStateChanged);
+    connect(ui->tableParams, &QTableWidget::itemChanged, this, &FittingWidget::sigStateChanged);
+    connect(m_plot->xAxis, qOverload<const QCPRange&>(&QCPAxis::rangeChanged), this, &FittingWidget::sigStateChanged);
+    connect(m_plot->yAxis, qOverload<const QCPRange&>(&QCPAxis::rangeChanged), this, &FittingWidget::sigStateChanged);
+
     // 初始化滑块位置和标签文本 (默认 50%)
     ui->sliderWeight->setRange(0, 100);
     ui->sliderWeight->setValue(50);
@@ -129,16 +144,24 @@ QJsonObject FittingWidget::getJsonState() const
     }
     root["parameters"] = paramsArray;
 
-    QJsonArray timeArr, pressArr, derivArr;
-    for(double v : m_obsTime) timeArr.append(v);
-    for(double v : m_obsPressure) pressArr.append(v);
-    for(double v : m_obsDerivative) derivArr.append(v);
+    // 后台恢复尚未完成时，观测数据与视图沿用载入时的内容
+    if (!m_pendingRestore.isEmpty()) {
+        root["observedData"] = m_pendingRestore["observedData"];
+        root["plotView"] = m_pendingRestore["plotView"];
+        return root;
+    }
 
-    QJsonObject obsData;
-    obsData["time"] = timeArr;
-    obsData["pressure"] = pressArr;
-    obsData["derivative"] = derivArr;
-    root["observedData"] = obsData;
+    // 观测数据存入项目的二进制容器，JSON 中只保留按内容哈希的引用
+    // （数据未变且引用仍在容器中时直接复用）
+    ProjectDataStore* store = ModelParameter::instance()->dataStore();
+    if (!store->contains(m_obsDataRefs["time"]) || !store->contains(m_obsDataRefs["pressure"])
+        || !store->contains(m_obsDataRefs["derivative"])) {
+        m_obsDataRefs = QJsonObject();
+        m_obsDataRefs["time"] = store->putArray(m_obsTime);
+        m_obsDataRefs["pressure"] = store->putArray(m_obsPressure);
+        m_obsDataRefs["derivative"] = store->putArray(m_obsDerivative);
+    }
+    root["observedData"] = m_obsDataRefs;
 
     return root;
 }
@@ -191,37 +214,85 @@ void FittingWidget::loadFittingState(const QJsonObject& root)
         ui->sliderWeight->setValue((int)(w * 100));
     }
 
-    if (root.contains("observedData")) {
-        QJsonObject obs = root["observedData"].toObject();
-        QJsonArray tArr = obs["time"].toArray();
-        QJsonArray pArr = obs["pressure"].toArray();
-        QJsonArray dArr = obs["derivative"].toArray();
+    // 观测数据解码与理论曲线计算放到后台，界面先显示模型与参数
+    FittingRestoreJob job;
+    job.observedData = root["observedData"].toObject();
+    job.plotView = root["plotView"].toObject();
+    job.params = modelCurveParams();
+    m_pendingRestore = QJsonObject();
+    m_pendingRestore["observedData"] = job.observedData;
+    m_pendingRestore["plotView"] = job.plotView;
+
+    ModelManager* manager = m_modelManager;
+    ModelManager::ModelType type = m_currentModelType;
+    const ProjectDataStore* store = ModelParameter::instance()->dataStore();
+
+    // 后台按当前模型与参数计算曲线，完成前锁定参数表与模型选择，避免结果覆盖新的修改
+    ui->label_Error->setText("正在加载观测数据与理论曲线...");
+    ui->btnRunFit->setEnabled(false);
+    setParamEditingEnabled(false);
+    m_restoreWatcher.setFuture(QtConcurrent::run([job, manager, type, store]() mutable {
+        // 兼容旧格式的 JSON 数字数组
+        job.time = store->getArray(job.observedData["time"]);
+        job.pressure = store->getArray(job.observedData["pressure"]);
+        job.derivative = store->getArray(job.observedData["derivative"]);
+        if (manager) {
+            job.curve = manager->calculateTheoreticalCurve(type, job.params, curveTimeSteps(job.time));
+        }
+        return job;
+    }));
+}
 
-        QVector<double> t, p, d;
-        for(auto v : tArr) t.append(v.toDouble());
-        for(auto v : pArr) p.append(v.toDouble());
-        for(auto v : dArr) d.append(v.toDouble());
+void FittingWidget::onRestoreFinished()
+{
+    ui->btnRunFit->setEnabled(!m_isFitting);
+    setParamEditingEnabled(true);
+    ui->label_Error->clear();
+
+    // 恢复期间已载入新数据时放弃本次结果
+    if (m_restoreWatcher.isCanceled()) return;
+    m_pendingRestore = QJsonObject();
+    FittingRestoreJob job = m_restoreWatcher.result();
+
+    if (!job.observedData.isEmpty()) {
+        setObservedData(job.time, job.pressure, job.derivative);
+
+        // 数据取自容器引用时保留引用，保存时无需重新编码
+        ProjectDataStore* store = ModelParameter::instance()->dataStore();
+        if (store->contains(job.observedData["time"]) && store->contains(job.observedData["pressure"])
+            && store->contains(job.observedData["derivative"])) {
+            m_obsDataRefs = job.observedData;
+        }
+    }
 
-        setObservedData(t, p, d);
+    if (m_modelManager) {
+        onIterationUpdate(0, job.params, std::get<0>(job.curve), std::get<1>(job.curve), std::get<2>(job.curve));
     }
+    applyPlotView(job.plotView);
+}
 
-    updateModelCurve();
-
-    if (root.contains("plotView")) {
-        QJsonObject range = root["plotView"].toObject();
-        if (range.contains("xMin") && range.contains("xMax") &&
-            range.contains("yMin") && range.contains("yMax")) {
-            double xMin = range["xMin"].toDouble();
-            double xMax = range["xMax"].toDouble();
-            double yMin = range["yMin"].toDouble();
-            double yMax = range["yMax"].toDouble();
-            if (xMax > xMin && yMax > yMin && xMin > 0 && yMin > 0) {
-                m_plot->xAxis->setRange(xMin, xMax);
-                m_plot->yAxis->setRange(yMin, yMax);
-                m_plot->xAxis2->setRange(xMin, xMax);
-                m_plot->yAxis2->setRange(yMin, yMax);
-                m_plot->replot();
-            }
+void FittingWidget::setParamEditingEnabled(bool enabled)
+{
+    ui->tableParams->setEnabled(enabled);
+    ui->btn_modelSelect->setEnabled(enabled);
+    ui->btnResetParams->setEnabled(enabled);
+    ui->btnImportModel->setEnabled(enabled);
+}
+
+void FittingWidget::applyPlotView(const QJsonObject& range)
+{
+    if (range.contains("xMin") && range.contains("xMax") &&
+        range.contains("yMin") && range.contains("yMax")) {
+        double xMin = range["xMin"].toDouble();
+        double xMax = range["xMax"].toDouble();
+        double yMin = range["yMin"].toDouble();
+        double yMax = range["yMax"].toDouble();
+        if (xMax > xMin && yMax > yMin && xMin > 0 && yMin > 0) {
+            m_plot->xAxis->setRange(xMin, xMax);
+            m_plot->yAxis->setRange(yMin, yMax);
+            m_plot->xAxis2->setRange(xMin, xMax);
+            m_plot->yAxis2->setRange(yMin, yMax);
+            m_plot->replot();
         }
     }
 }
@@ -346,6 +417,7 @@ void FittingWidget::on_btn_modelSelect_clicked() {
             m_currentModelType = newType;
             ui->btn_modelSelect->setText("当前: " + name);
             updateModelCurve();
+            emit sigStateChanged();
         } else {
             QMessageBox::warning(this, "提示", "所选组合暂无对应的模型。\nCode: " + code);
         }
@@ -403,7 +475,11 @@ void FittingWidget::setupPlot() {
 }
 
 void FittingWidget::setObservedData(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d) {
+    // 外部载入新数据时作废尚未完成的后台恢复
+    if(m_restoreWatcher.isRunning()) m_restoreWatcher.cancel();
     m_obsTime = t; m_obsPressure = p; m_obsDerivative = d;
+    m_obsDataRefs = QJsonObject();
+    m_pendingRestore = QJsonObject();
 
     QVector<double> vt, vp, vd;
     for(int i=0; i<t.size(); ++i) {
@@ -418,6 +494,7 @@ void FittingWidget::setObservedData(const QVector<double>& t, const QVector<doub
     if(m_plot->xAxis->range().lower<=0) m_plot->xAxis->setRangeLower(1e-3);
     if(m_plot->yAxis->range().lower<=0) m_plot->yAxis->setRangeLower(1e-3);
     m_plot->replot();
+    emit sigStateChanged();
 }
 
 void FittingWidget::on_btnResetView_clicked() {
@@ -439,6 +516,7 @@ void FittingWidget::on_btnResetParams_clicked() {
         m_plot->graph(3)->data()->clear();
         m_plot->replot();
     }
+    emit sigStateChanged();
 }
 
 void FittingWidget::on_btnLoadData_clicked() {
@@ -455,6 +533,7 @@ void FittingWidget::on_btnRunFit_clicked() {
 
     m_paramChart->updateParamsFromTable();
     m_isFitting = true; m_stopRequested = false; ui->btnRunFit->setEnabled(false);
+    m_liveChannel.clear();
 
     ModelManager::ModelType modelType = m_currentModelType;
     QList<FitParameter> paramsCopy = m_paramChart->getParameters();
@@ -529,6 +608,12 @@ void FittingWidget::on_btnChartSettings_clicked() {
 void FittingWidget::updateModelCurve() {
     if(!m_modelManager) { QMessageBox::critical(this, "错误", "ModelManager 未初始化！"); return; }
     ui->tableParams->clearFocus();
+    QMap<QString,double> currentParams = modelCurveParams();
+    ModelCurveData res = m_modelManager->calculateTheoreticalCurve(m_currentModelType, currentParams, curveTimeSteps(m_obsTime));
+    onIterationUpdate(0, currentParams, std::get<0>(res), std::get<1>(res), std::get<2>(res));
+}
+
+QMap<QString, double> FittingWidget::modelCurveParams() {
     m_paramChart->updateParamsFromTable();
     QList<FitParameter> params = m_paramChart->getParameters();
 
@@ -538,12 +623,7 @@ void FittingWidget::updateModelCurve() {
     if(currentParams.contains("L") && currentParams.contains("Lf") && currentParams["L"] > 1e-9)
         currentParams["LfD"] = currentParams["Lf"] / currentParams["L"];
     else currentParams["LfD"] = 0.0;
-
-    ModelManager::ModelType type = m_currentModelType;
-    QVector<double> targetT = m_obsTime;
-    if(targetT.isEmpty()) { for(double e = -4; e <= 4; e += 0.1) targetT.append(pow(10, e)); }
-    ModelCurveData res = m_modelManager->calculateTheoreticalCurve(type, currentParams, targetT);
-    onIterationUpdate(0, currentParams, std::get<0>(res), std::get<1>(res), std::get<2>(res));
+    return currentParams;
 }
 
 void FittingWidget::runLevenbergMarquardtOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight) {
@@ -557,10 +637,10 @@ void FittingWidget::runLevenbergMarquardtOptimization(ModelManager::ModelType mo
     for(const auto& p : params) currentParamMap.insert(p.name, p.value);
     if(currentParamMap.contains("L") && currentParamMap.contains("Lf") && currentParamMap["L"] > 1e-9)
         currentParamMap["LfD"] = currentParamMap["Lf"] / currentParamMap["L"];
-    QVector<double> residuals = calculateResiduals(currentParamMap, modelType, weight);
+    ModelCurveData curve;
+    QVector<double> residuals = calculateResiduals(currentParamMap, modelType, weight, &curve);
     currentSSE = calculateSumSquaredError(residuals);
-    ModelCurveData curve = m_modelManager->calculateTheoreticalCurve(modelType, currentParamMap);
-    emit sigIterationUpdated(currentSSE/residuals.size(), currentParamMap, std::get<0>(curve), std::get<1>(curve), std::get<2>(curve));
+    publishFitSnapshot(currentSSE/residuals.size(), currentParamMap, curve, false);
     for(int iter = 0; iter < maxIter; ++iter) {
         if(m_stopRequested) break;
         if (!residuals.isEmpty() && (currentSSE / residuals.size()) < 3e-3) break;
@@ -592,12 +672,13 @@ void FittingWidget::runLevenbergMarquardtOptimization(ModelManager::ModelType mo
                 trialMap[pName] = newVal;
             }
             if(trialMap.contains("L") && trialMap.contains("Lf") && trialMap["L"] > 1e-9) trialMap["LfD"] = trialMap["Lf"] / trialMap["L"];
-            QVector<double> newRes = calculateResiduals(trialMap, modelType, weight);
+            ModelCurveData trialCurve;
+            QVector<double> newRes = calculateResiduals(trialMap, modelType, weight, &trialCurve);
             double newSSE = calculateSumSquaredError(newRes);
             if(newSSE < currentSSE) {
                 currentSSE = newSSE; currentParamMap = trialMap; residuals = newRes; lambda /= 10.0; stepAccepted = true;
-                ModelCurveData iterCurve = m_modelManager->calculateTheoreticalCurve(modelType, currentParamMap);
-                emit sigIterationUpdated(currentSSE/nRes, currentParamMap, std::get<0>(iterCurve), std::get<1>(iterCurve), std::get<2>(iterCurve));
+                // 直接显示残差计算时的理论曲线，不再额外计算
+                publishFitSnapshot(currentSSE/nRes, currentParamMap, trialCurve, false);
                 break;
             } else { lambda *= 10.0; }
         }
@@ -607,13 +688,15 @@ void FittingWidget::runLevenbergMarquardtOptimization(ModelManager::ModelType mo
     if(currentParamMap.contains("L") && currentParamMap.contains("Lf") && currentParamMap["L"] > 1e-9)
         currentParamMap["LfD"] = currentParamMap["Lf"] / currentParamMap["L"];
     ModelCurveData finalCurve = m_modelManager->calculateTheoreticalCurve(modelType, currentParamMap);
-    emit sigIterationUpdated(currentSSE/residuals.size(), currentParamMap, std::get<0>(finalCurve), std::get<1>(finalCurve), std::get<2>(finalCurve));
+    publishFitSnapshot(currentSSE/residuals.size(), currentParamMap, finalCurve, true);
     QMetaObject::invokeMethod(this, "onFitFinished");
 }
 
-QVector<double> FittingWidget::calculateResiduals(const QMap<QString, double>& params, ModelManager::ModelType modelType, double weight) {
+QVector<double> FittingWidget::calculateResiduals(const QMap<QString, double>& params, ModelManager::ModelType modelType, double weight,
+                                                  ModelCurveData* curve) {
     if(!m_modelManager || m_obsTime.isEmpty()) return QVector<double>();
     ModelCurveData res = m_modelManager->calculateTheoreticalCurve(modelType, params, m_obsTime);
+    if(curve) *curve = res;
     const QVector<double>& pCal = std::get<1>(res); const QVector<double>& dpCal = std::get<2>(res);
     QVector<double> r; double wp = weight; double wd = 1.0 - weight;
     int count = qMin(m_obsPressure.size(), pCal.size());
@@ -627,6 +710,17 @@ QVector<double> FittingWidget::calculateResiduals(const QMap<QString, double>& p
     return r;
 }
 
+void FittingWidget::publishFitSnapshot(double error, const QMap<QString, double>& params, const ModelCurveData& curve, bool isFinal) {
+    QSharedPointer<FitSnapshot> snapshot(new FitSnapshot);
+    snapshot->error = error;
+    snapshot->params = params;
+    snapshot->time = std::get<0>(curve);
+    snapshot->pressure = std::get<1>(curve);
+    snapshot->derivative = std::get<2>(curve);
+    snapshot->isFinal = isFinal;
+    m_liveChannel.publish(snapshot);
+}
+
 QVector<QVector<double>> FittingWidget::computeJacobian(const QMap<QString, double>& params, const QVector<double>& baseResiduals, const QVector<int>& fitIndices, ModelManager::ModelType modelType, const QList<FitParameter>& currentFitParams, double weight) {
     int nRes = baseResiduals.size(); int nParams = fitIndices.size();
     QVector<QVector<double>> J(nRes, QVector<double>(nParams));
@@ -664,17 +758,24 @@ void FittingWidget::onIterationUpdate(double err, const QMap<QString,double>& p,
                                       const QVector<double>& t, const QVector<double>& p_curve, const QVector<double>& d_curve) {
     ui->label_Error->setText(QString("误差(MSE): %1").arg(err, 0, 'e', 3));
 
+    // 只改写显示值有变化的单元格
     ui->tableParams->blockSignals(true);
     for(int i=0; i<ui->tableParams->rowCount(); ++i) {
         QString key = ui->tableParams->item(i, 0)->data(Qt::UserRole).toString();
-        if(p.contains(key)) {
-            double val = p[key];
-            ui->tableParams->item(i, 1)->setText(QString::number(val, 'g', 5));
-        }
+        auto it = p.constFind(key);
+        if(it == p.constEnd()) continue;
+        QTableWidgetItem* item = ui->tableParams->item(i, 1);
+        const QString text = QString::number(it.value(), 'g', 5);
+        if(item->text() != text) item->setText(text);
     }
     ui->tableParams->blockSignals(false);
 
     plotCurves(t, p_curve, d_curve, true);
+    emit sigStateChanged();
+}
+
+void FittingWidget::onFitSnapshot(const QSharedPointer<const FitSnapshot>& snapshot) {
+    onIterationUpdate(snapshot->error, snapshot->params, snapshot->time, snapshot->pressure, snapshot->derivative);
 }
 
 void FittingWidget::onFitFinished() { m_isFitting = false; ui->btnRunFit->setEnabled(true); QMessageBox::information(this, "完成", "拟合完成。"); }
@@ -13,9 +13,21 @@
 // 引入新拆分的模块头文件
 #include "fittingparameterchart.h"
 #include "fittingobserveddata.h"
+#include "fitlivechannel.h"
 
 namespace Ui { class FittingWidget; }
 
+// 拟合页状态的后台恢复任务（观测数据解码 + 理论曲线计算）
+struct FittingRestoreJob {
+    QJsonObject observedData;           // 观测数据引用（或旧格式数组）
+    QJsonObject plotView;               // 保存的视图范围
+    QMap<QString, double> params;       // 理论曲线参数
+    QVector<double> time;
+    QVector<double> pressure;
+    QVector<double> derivative;
+    ModelCurveData curve;
+};
+
 class FittingWidget : public QWidget
 {
     Q_OBJECT
@@ -31,17 +43,23 @@ public:
     void updateBasicParameters();
 
     // 从 JSON 数据加载拟合状态
+    // 模型与参数立即恢复；观测数据与理论曲线在后台准备，完成后再刷新绘图
     void loadFittingState(const QJsonObject& data = QJsonObject());
 
+    // 是否仍在后台恢复状态
+    bool isRestoring() const { return m_restoreWatcher.isRunning(); }
+
     // 获取当前拟合状态的 JSON 对象（用于保存）
     QJsonObject getJsonState() const;
 
 signals:
     void fittingCompleted(ModelManager::ModelType modelType, const QMap<QString, double>& parameters);
-    void sigIterationUpdated(double error, QMap<QString, double> currentParams, QVector<double> t, QVector<double> p, QVector<double> d);
     void sigProgress(int progress);
     void sigRequestSave();
 
+    // 保存相关的状态（模型、参数、权重、视图范围、观测数据）发生变化
+    void sigStateChanged();
+
 private slots:
     void on_btnLoadData_clicked();
     void on_btnRunFit_clicked();
@@ -58,11 +76,15 @@ private slots:
     void on_btnExportReport_clicked();
 
     void onIterationUpdate(double err, const QMap<QString,double>& p, const QVector<double>& t, const QVector<double>& p_curve, const QVector<double>& d_curve);
+    void onFitSnapshot(const QSharedPointer<const FitSnapshot>& snapshot);
     void onFitFinished();
 
     // 滑块值改变槽函数
     void onSliderWeightChanged(int value);
 
+    // 后台恢复完成
+    void onRestoreFinished();
+
 private:
     Ui::FittingWidget *ui;
     ModelManager* m_modelManager;
@@ -79,19 +101,33 @@ private:
     QVector<double> m_obsPressure;
     QVector<double> m_obsDerivative;
 
+    // 观测数据在项目容器中的引用（数据不变时保存不再重新编码、计算哈希）
+    mutable QJsonObject m_obsDataRefs;
+
     bool m_isFitting;
     bool m_stopRequested;
     QFutureWatcher<void> m_watcher;
+    FitLiveChannel m_liveChannel;       // 拟合线程 → 界面的节流更新
+    QFutureWatcher<FittingRestoreJob> m_restoreWatcher;
+    QJsonObject m_pendingRestore;       // 恢复完成前保存时沿用的观测数据与视图范围
 
     void setupPlot();
     void initializeDefaultModel();
     void updateModelCurve();
+    QMap<QString, double> modelCurveParams();
+    void applyPlotView(const QJsonObject& range);
+
+    // 后台恢复期间锁定参数表、模型选择等会改变模型参数的控件
+    void setParamEditingEnabled(bool enabled);
 
     // 优化算法相关函数
     void runOptimizationTask(ModelManager::ModelType modelType, QList<FitParameter> fitParams, double weight);
     void runLevenbergMarquardtOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight);
 
-    QVector<double> calculateResiduals(const QMap<QString, double>& params, ModelManager::ModelType modelType, double weight);
+    // curve 非空时同时返回观测时间点上的理论曲线（供实时显示复用）
+    QVector<double> calculateResiduals(const QMap<QString, double>& params, ModelManager::ModelType modelType, double weight,
+                                       ModelCurveData* curve = nullptr);
+    void publishFitSnapshot(double error, const QMap<QString, double>& params, const ModelCurveData& curve, bool isFinal);
     QVector<QVector<double>> computeJacobian(const QMap<QString, double>& params, const QVector<double>& residuals, const QVector<int>& fitIndices, ModelManager::ModelType modelType, const QList<FitParameter>& currentFitParams, double weight);
     QVector<double> solveLinearSystem(const QVector<QVector<double>>& A, const QVector<double>& b);
     double calculateSumSquaredError(const QVector<double>& residuals);
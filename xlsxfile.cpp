@@ -0,0 +1,1083 @@
+#include "xlsxfile.h"
+#include "csvfastloader.h"
+#include "ziparchive.h"
+#include <QFile>
+#include <QDate>
+#include <QDateTime>
+#include <QHash>
+#include <QTime>
+#include <QXmlStreamReader>
+#include <QDebug>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+// ============================================================================
+// 内部辅助函数
+// ============================================================================
+
+namespace {
+
+const double kNaN = std::numeric_limits<double>::quiet_NaN();
+const double kExcelEpochOffset = 25569.0;   // 1970-01-01 对应的 Excel 序列值
+const double kMsecsPerDay = 86400000.0;
+const int kMaxColumns = 16384;              // Excel 最大列数（XFD）
+const int kWriteFlushBytes = 1 << 20;       // 写出时工作表 XML 缓冲阈值
+
+const char* const kContentTypesXml =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+    "<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/content-types\">"
+    "<Default Extension=\"rels\" ContentType=\"application/vnd.openxmlformats-package.relationships+xml\"/>"
+    "<Default Extension=\"xml\" ContentType=\"application/xml\"/>"
+    "<Override PartName=\"/xl/workbook.xml\" "
+    "ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.sheet.main+xml\"/>"
+    "<Override PartName=\"/xl/worksheets/sheet1.xml\" "
+    "ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.worksheet+xml\"/>"
+    "<Override PartName=\"/xl/styles.xml\" "
+    "ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.styles+xml\"/>"
+    "</Types>";
+
+const char* const kRootRelsXml =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+    "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+    "<Relationship Id=\"rId1\" "
+    "Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/officeDocument\" "
+    "Target=\"xl/workbook.xml\"/>"
+    "</Relationships>";
+
+const char* const kWorkbookRelsXml =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+    "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+    "<Relationship Id=\"rId1\" "
+    "Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/worksheet\" "
+    "Target=\"worksheets/sheet1.xml\"/>"
+    "<Relationship Id=\"rId2\" "
+    "Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/styles\" "
+    "Target=\"styles.xml\"/>"
+    "</Relationships>";
+
+// 样式 1：日期时间；2：日期（内置 14）；3：时间
+const char* const kStylesXml =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+    "<styleSheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\">"
+    "<numFmts count=\"2\">"
+    "<numFmt numFmtId=\"164\" formatCode=\"yyyy-mm-dd hh:mm:ss\"/>"
+    "<numFmt numFmtId=\"165\" formatCode=\"hh:mm:ss\"/>"
+    "</numFmts>"
+    "<fonts count=\"1\"><font><sz val=\"11\"/><name val=\"Calibri\"/></font></fonts>"
+    "<fills count=\"2\"><fill><patternFill patternType=\"none\"/></fill>"
+    "<fill><patternFill patternType=\"gray125\"/></fill></fills>"
+    "<borders count=\"1\"><border><left/><right/><top/><bottom/><diagonal/></border></borders>"
+    "<cellStyleXfs count=\"1\"><xf numFmtId=\"0\" fontId=\"0\" fillId=\"0\" borderId=\"0\"/></cellStyleXfs>"
+    "<cellXfs count=\"4\">"
+    "<xf numFmtId=\"0\" fontId=\"0\" fillId=\"0\" borderId=\"0\" xfId=\"0\"/>"
+    "<xf numFmtId=\"164\" fontId=\"0\" fillId=\"0\" borderId=\"0\" xfId=\"0\" applyNumberFormat=\"1\"/>"
+    "<xf numFmtId=\"14\" fontId=\"0\" fillId=\"0\" borderId=\"0\" xfId=\"0\" applyNumberFormat=\"1\"/>"
+    "<xf numFmtId=\"165\" fontId=\"0\" fillId=\"0\" borderId=\"0\" xfId=\"0\" applyNumberFormat=\"1\"/>"
+    "</cellXfs>"
+    "<cellStyles count=\"1\"><cellStyle name=\"Normal\" xfId=\"0\" builtinId=\"0\"/></cellStyles>"
+    "</styleSheet>";
+
+inline bool isXmlSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+inline bool nameIs(const char* name, int length, const char* expected)
+{
+    return int(std::strlen(expected)) == length && std::memcmp(name, expected, size_t(length)) == 0;
+}
+
+// 解码 XML 文本中的实体引用（&amp; &lt; &#NN; &#xHH; 等）
+QString decodeXmlText(const char* data, int size)
+{
+    if (!std::memchr(data, '&', size_t(size))) {
+        return QString::fromUtf8(data, size);
+    }
+
+    QByteArray out;
+    out.reserve(size);
+    int i = 0;
+    while (i < size) {
+        if (data[i] != '&') {
+            out.append(data[i++]);
+            continue;
+        }
+        const char* semi = static_cast<const char*>(std::memchr(data + i, ';', size_t(size - i)));
+        if (!semi) {
+            out.append(data[i++]);
+            continue;
+        }
+
+        QByteArray entity(data + i + 1, int(semi - (data + i + 1)));
+        if (entity == "amp") {
+            out.append('&');
+        } else if (entity == "lt") {
+            out.append('<');
+        } else if (entity == "gt") {
+            out.append('>');
+        } else if (entity == "quot") {
+            out.append('"');
+        } else if (entity == "apos") {
+            out.append('\'');
+        } else if (entity.startsWith('#')) {
+            bool ok = false;
+            uint code = (entity.size() > 1 && (entity[1] == 'x' || entity[1] == 'X'))
+                            ? entity.mid(2).toUInt(&ok, 16)
+                            : entity.mid(1).toUInt(&ok, 10);
+            if (ok && code < 0x10000) {
+                out.append(QString(QChar(ushort(code))).toUtf8());
+            } else if (ok && code <= 0x10FFFF) {
+                QString pair;
+                pair.append(QChar(QChar::highSurrogate(code)));
+                pair.append(QChar(QChar::lowSurrogate(code)));
+                out.append(pair.toUtf8());
+            } else {
+                out.append(data + i, int(semi - (data + i)) + 1);
+            }
+        } else {
+            out.append(data + i, int(semi - (data + i)) + 1);
+        }
+        i = int(semi - data) + 1;
+    }
+    return QString::fromUtf8(out);
+}
+
+// 写出 XML 文本（转义特殊字符，去除 XML 1.0 不允许的控制字符）
+void appendEscaped(QByteArray& out, const QString& text)
+{
+    QByteArray utf8 = text.toUtf8();
+    for (char c : utf8) {
+        switch (c) {
+        case '&': out.append("&amp;"); break;
+        case '<': out.append("&lt;"); break;
+        case '>': out.append("&gt;"); break;
+        case '"': out.append("&quot;"); break;
+        default:
+            if (static_cast<uchar>(c) >= 0x20 || c == '\t' || c == '\n' || c == '\r') {
+                out.append(c);
+            }
+            break;
+        }
+    }
+}
+
+// 最短往返精度写出数值
+void appendNumber(QByteArray& out, double value)
+{
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    char buffer[32];
+    std::to_chars_result written = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, int(written.ptr - buffer));
+#else
+    out.append(QByteArray::number(value, 'g', 17));
+#endif
+}
+
+// 列号（从0开始）→ Excel 列字母
+QByteArray columnLetters(int column)
+{
+    QByteArray letters;
+    for (int n = column + 1; n > 0; n = (n - 1) / 26) {
+        letters.prepend(char('A' + (n - 1) % 26));
+    }
+    return letters;
+}
+
+// 在属性区中查找属性（忽略命名空间前缀）
+bool findAttribute(const char* attrs, const char* end, const char* name,
+                   const char*& valueBegin, const char*& valueEnd)
+{
+    int nameLength = int(std::strlen(name));
+    const char* p = attrs;
+    while (p < end) {
+        while (p < end && isXmlSpace(*p)) ++p;
+        const char* nameBegin = p;
+        while (p < end && *p != '=' && !isXmlSpace(*p)) ++p;
+        const char* nameEnd = p;
+        while (p < end && *p != '"' && *p != '\'') ++p;
+        if (p >= end || nameBegin == nameEnd) return false;
+
+        char quote = *p++;
+        const char* value = p;
+        while (p < end && *p != quote) ++p;
+        if (p >= end) return false;
+
+        const char* local = nameBegin;
+        for (const char* q = nameBegin; q < nameEnd; ++q) {
+            if (*q == ':') local = q + 1;
+        }
+        if (nameEnd - local == nameLength && std::memcmp(local, name, size_t(nameLength)) == 0) {
+            valueBegin = value;
+            valueEnd = p;
+            return true;
+        }
+        ++p;
+    }
+    return false;
+}
+
+int parseUnsigned(const char* begin, const char* end, bool* ok = nullptr)
+{
+    qint64 value = 0;
+    bool valid = begin < end;
+    for (const char* p = begin; p < end; ++p) {
+        if (*p < '0' || *p > '9' || value > std::numeric_limits<int>::max() / 10) {
+            valid = false;
+            break;
+        }
+        value = value * 10 + (*p - '0');
+    }
+    if (ok) *ok = valid;
+    return valid ? int(value) : 0;
+}
+
+// ---------------------------------------------------------------------------
+// SAX 式 XML 扫描器：按块喂入数据，只回调完整的标签与文本，
+// 块尾不完整的部分保留到下一块
+// ---------------------------------------------------------------------------
+
+class XmlScanner
+{
+public:
+    virtual ~XmlScanner() {}
+
+    void feed(const char* data, int size)
+    {
+        m_buffer.append(data, size);
+        const char* begin = m_buffer.constData();
+        int consumed = int(scan(begin, begin + m_buffer.size()) - begin);
+        m_buffer.remove(0, consumed);
+    }
+
+protected:
+    virtual void startElement(const char* name, int length, const char* attrs, const char* attrsEnd) = 0;
+    virtual void endElement(const char* name, int length) = 0;
+    virtual void characters(const char* text, int length, bool cdata) = 0;
+
+private:
+    QByteArray m_buffer;
+
+    static const char* findSequence(const char* p, const char* end, const char* sequence)
+    {
+        const char* sequenceEnd = sequence + std::strlen(sequence);
+        const char* found = std::search(p, end, sequence, sequenceEnd);
+        return found == end ? nullptr : found;
+    }
+
+    static const char* localName(const char* begin, const char* end)
+    {
+        const char* local = begin;
+        for (const char* q = begin; q < end; ++q) {
+            if (*q == ':') local = q + 1;
+        }
+        return local;
+    }
+
+    const char* scan(const char* p, const char* end)
+    {
+        while (p < end) {
+            if (*p != '<') {
+                const char* lt = static_cast<const char*>(std::memchr(p, '<', size_t(end - p)));
+                if (!lt) break;
+                characters(p, int(lt - p), false);
+                p = lt;
+                continue;
+            }
+            if (end - p < 2) break;
+
+            // 处理指令、注释、CDATA、DOCTYPE
+            if (p[1] == '?') {
+                const char* close = findSequence(p + 2, end, "?>");
+                if (!close) break;
+                p = close + 2;
+                continue;
+            }
+            if (p[1] == '!') {
+                if (end - p < 9) break;
+                if (std::memcmp(p, "<!--", 4) == 0) {
+                    const char* close = findSequence(p + 4, end, "-->");
+                    if (!close) break;
+                    p = close + 3;
+                } else if (std::memcmp(p, "<![CDATA[", 9) == 0) {
+                    const char* close = findSequence(p + 9, end, "]]>");
+                    if (!close) break;
+                    characters(p + 9, int(close - (p + 9)), true);
+                    p = close + 3;
+                } else {
+                    const char* close = static_cast<const char*>(std::memchr(p, '>', size_t(end - p)));
+                    if (!close) break;
+                    p = close + 1;
+                }
+                continue;
+            }
+
+            // 普通标签：查找不在引号内的 '>'
+            const char* q = p + 1;
+            char quote = 0;
+            for (; q < end; ++q) {
+                char c = *q;
+                if (quote) {
+                    if (c == quote) quote = 0;
+                } else if (c == '"' || c == '\'') {
+                    quote = c;
+                } else if (c == '>') {
+                    break;
+                }
+            }
+            if (q >= end) break;
+
+            if (p[1] == '/') {
+                const char* nameEnd = p + 2;
+                while (nameEnd < q && !isXmlSpace(*nameEnd)) ++nameEnd;
+                const char* local = localName(p + 2, nameEnd);
+                endElement(local, int(nameEnd - local));
+            } else {
+                bool selfClosing = q[-1] == '/';
+                const char* attrsEnd = selfClosing ? q - 1 : q;
+                const char* nameEnd = p + 1;
+                while (nameEnd < attrsEnd && !isXmlSpace(*nameEnd)) ++nameEnd;
+                const char* local = localName(p + 1, nameEnd);
+                startElement(local, int(nameEnd - local), nameEnd, attrsEnd);
+                if (selfClosing) {
+                    endElement(local, int(nameEnd - local));
+                }
+            }
+            p = q + 1;
+        }
+        return p;
+    }
+};
+
+// 共享字符串表（xl/sharedStrings.xml）
+class SharedStringsHandler : public XmlScanner
+{
+public:
+    SharedStringsHandler() : m_inItem(false), m_inText(false), m_inPhonetic(false) {}
+
+    QVector<QString> strings;
+
+protected:
+    void startElement(const char* name, int length, const char*, const char*) override
+    {
+        if (nameIs(name, length, "si")) {
+            m_inItem = true;
+            m_text.clear();
+        } else if (nameIs(name, length, "rPh")) {
+            m_inPhonetic = true;    // 拼音/注音不计入文本
+        } else if (nameIs(name, length, "t")) {
+            m_inText = m_inItem && !m_inPhonetic;
+        }
+    }
+
+    void endElement(const char* name, int length) override
+    {
+        if (nameIs(name, length, "t")) {
+            m_inText = false;
+        } else if (nameIs(name, length, "rPh")) {
+            m_inPhonetic = false;
+        } else if (nameIs(name, length, "si")) {
+            strings.append(m_text);
+            m_inItem = false;
+        }
+    }
+
+    void characters(const char* text, int length, bool cdata) override
+    {
+        if (!m_inText) return;
+        m_text += cdata ? QString::fromUtf8(text, length) : decodeXmlText(text, length);
+    }
+
+private:
+    QString m_text;
+    bool m_inItem;
+    bool m_inText;
+    bool m_inPhonetic;
+};
+
+// 工作表中一列的累积数据
+struct SheetColumn {
+    QVector<double> numbers;    // 每个数据行一项；空单元格与文本单元格为 NaN
+    QVector<QString> texts;     // 出现文本单元格后才分配，与 numbers 等长
+    bool hasText;
+    int numberCells;
+    int dateCells;
+    bool hasDatePart;           // 日期单元格中存在 >= 1 的序列值
+    bool hasTimePart;           // 日期单元格中存在小数部分
+
+    SheetColumn() :
+        hasText(false),
+        numberCells(0),
+        dateCells(0),
+        hasDatePart(false),
+        hasTimePart(false) {}
+
+    // 补齐到 row 行（不含），返回该行是否尚未写入
+    bool padTo(int row)
+    {
+        if (numbers.size() > row) return false;
+        while (numbers.size() < row) numbers.append(kNaN);
+        if (hasText) {
+            while (texts.size() < row) texts.append(QString());
+        }
+        return true;
+    }
+
+    void setNumber(int row, double value, bool date)
+    {
+        if (!padTo(row)) return;
+        numbers.append(value);
+        if (hasText) texts.append(QString());
+        ++numberCells;
+        if (date) {
+            ++dateCells;
+            if (value >= 1.0) hasDatePart = true;
+            if (value != std::floor(value)) hasTimePart = true;
+        }
+    }
+
+    void setText(int row, const QString& text)
+    {
+        if (text.isEmpty() || !padTo(row)) return;
+        if (!hasText) {
+            texts = QVector<QString>(numbers.size());
+            hasText = true;
+        }
+        numbers.append(kNaN);
+        texts.append(text);
+    }
+
+    bool allDates() const
+    {
+        return numberCells > 0 && dateCells == numberCells;
+    }
+
+    QString dateFormat() const
+    {
+        if (hasDatePart && hasTimePart) return "yyyy-MM-dd hh:mm:ss";
+        if (hasDatePart) return "yyyy-MM-dd";
+        return "hh:mm:ss";
+    }
+};
+
+// 工作表数据（xl/worksheets/sheetN.xml）
+class SheetHandler : public XmlScanner
+{
+public:
+    SheetHandler(const XlsxImportConfig& config, const QVector<QString>& sharedStrings,
+                 const QVector<bool>& dateStyles) :
+        m_config(config),
+        m_sharedStrings(sharedStrings),
+        m_dateStyles(dateStyles),
+        m_lastRow(-1),
+        m_lastColumn(-1),
+        m_rowKind(SkipRow),
+        m_dataRow(0),
+        m_dataStart(qMax(0, config.startRow - 1)),
+        m_headerSeen(false),
+        m_rowCount(0),
+        m_cellColumn(0),
+        m_cellType(NumberCell),
+        m_cellStyle(0),
+        m_inValue(false),
+        m_inInline(false),
+        m_inText(false),
+        m_hasValue(false) {}
+
+    QStringList headers;
+    QVector<SheetColumn> columns;
+
+    int rowCount() const { return m_rowCount; }
+
+protected:
+    void startElement(const char* name, int length, const char* attrs, const char* attrsEnd) override
+    {
+        const char* valueBegin = nullptr;
+        const char* valueEnd = nullptr;
+
+        if (nameIs(name, length, "c")) {
+            m_cellColumn = m_lastColumn + 1;
+            if (findAttribute(attrs, attrsEnd, "r", valueBegin, valueEnd)) {
+                int column = 0;
+                for (const char* p = valueBegin; p < valueEnd && *p >= 'A' && *p <= 'Z'; ++p) {
+                    column = column * 26 + (*p - 'A' + 1);
+                }
+                if (column > 0) m_cellColumn = column - 1;
+            }
+            m_lastColumn = m_cellColumn;
+
+            m_cellType = NumberCell;
+            if (findAttribute(attrs, attrsEnd, "t", valueBegin, valueEnd)) {
+                int n = int(valueEnd - valueBegin);
+                if (nameIs(valueBegin, n, "s")) m_cellType = SharedStringCell;
+                else if (nameIs(valueBegin, n, "inlineStr")) m_cellType = InlineStringCell;
+                else if (nameIs(valueBegin, n, "b")) m_cellType = BooleanCell;
+                else if (nameIs(valueBegin, n, "n")) m_cellType = NumberCell;
+                else m_cellType = TextCell;     // str / e / d
+            }
+            m_cellStyle = findAttribute(attrs, attrsEnd, "s", valueBegin, valueEnd)
+                              ? parseUnsigned(valueBegin, valueEnd) : 0;
+
+            m_raw.clear();
+            m_text.clear();
+            m_hasValue = false;
+        } else if (nameIs(name, length, "v")) {
+            m_inValue = true;
+        } else if (nameIs(name, length, "is")) {
+            m_inInline = true;
+        } else if (nameIs(name, length, "t")) {
+            m_inText = m_inInline;
+        } else if (nameIs(name, length, "row")) {
+            int row = m_lastRow + 1;
+            if (findAttribute(attrs, attrsEnd, "r", valueBegin, valueEnd)) {
+                bool ok = false;
+                int r = parseUnsigned(valueBegin, valueEnd, &ok);
+                if (ok && r > 0) row = r - 1;
+            }
+            beginRow(row);
+        }
+    }
+
+    void endElement(const char* name, int length) override
+    {
+        if (nameIs(name, length, "c")) {
+            commitCell();
+        } else if (nameIs(name, length, "v")) {
+            m_inValue = false;
+            m_hasValue = true;
+        } else if (nameIs(name, length, "t")) {
+            if (m_inText) m_hasValue = true;
+            m_inText = false;
+        } else if (nameIs(name, length, "is")) {
+            m_inInline = false;
+        }
+    }
+
+    void characters(const char* text, int length, bool cdata) override
+    {
+        if (m_inValue) {
+            if (m_cellType == NumberCell || m_cellType == SharedStringCell || m_cellType == BooleanCell) {
+                m_raw.append(text, length);
+            } else {
+                m_text += cdata ? QString::fromUtf8(text, length) : decodeXmlText(text, length);
+            }
+        } else if (m_inText) {
+            m_text += cdata ? QString::fromUtf8(text, length) : decodeXmlText(text, length);
+        }
+    }
+
+private:
+    enum RowKind { SkipRow, HeaderRow, DataRow };
+    enum CellType { NumberCell, SharedStringCell, InlineStringCell, BooleanCell, TextCell };
+
+    const XlsxImportConfig& m_config;
+    const QVector<QString>& m_sharedStrings;
+    const QVector<bool>& m_dateStyles;
+
+    int m_lastRow;
+    int m_lastColumn;
+    RowKind m_rowKind;
+    int m_dataRow;
+    int m_dataStart;
+    bool m_headerSeen;
+    int m_rowCount;
+
+    int m_cellColumn;
+    CellType m_cellType;
+    int m_cellStyle;
+    QByteArray m_raw;
+    QString m_text;
+    bool m_inValue;
+    bool m_inInline;
+    bool m_inText;
+    bool m_hasValue;
+
+    void beginRow(int row)
+    {
+        m_lastRow = row;
+        m_lastColumn = -1;
+
+        if (row < m_config.startRow - 1) {
+            m_rowKind = SkipRow;
+        } else if (m_config.hasHeader && !m_headerSeen) {
+            m_rowKind = HeaderRow;
+            m_headerSeen = true;
+            m_dataStart = row + 1;
+        } else {
+            m_rowKind = DataRow;
+            m_dataRow = row - m_dataStart;
+        }
+    }
+
+    // 当前单元格的文本表示（表头或文本单元格）
+    QString cellText() const
+    {
+        switch (m_cellType) {
+        case SharedStringCell: {
+            bool ok = false;
+            int index = parseUnsigned(m_raw.constData(), m_raw.constData() + m_raw.size(), &ok);
+            return (ok && index < m_sharedStrings.size()) ? m_sharedStrings[index] : QString();
+        }
+        case BooleanCell:
+            return m_raw == "1" ? QStringLiteral("TRUE") : QStringLiteral("FALSE");
+        case NumberCell:
+            return QString::fromUtf8(m_raw).trimmed();
+        default:
+            return m_text;
+        }
+    }
+
+    void commitCell()
+    {
+        if (!m_hasValue || m_rowKind == SkipRow || m_cellColumn >= kMaxColumns) return;
+
+        if (m_rowKind == HeaderRow) {
+            while (headers.size() <= m_cellColumn) headers.append(QString());
+            headers[m_cellColumn] = cellText().trimmed();
+            return;
+        }
+        if (m_dataRow < 0) return;
+
+        if (columns.size() <= m_cellColumn) columns.resize(m_cellColumn + 1);
+        SheetColumn& column = columns[m_cellColumn];
+
+        double value = 0.0;
+        if (m_cellType == NumberCell
+            && CsvFastLoader::parseNumber(m_raw.constData(), m_raw.constData() + m_raw.size(), value)) {
+            bool date = m_cellStyle < m_dateStyles.size() && m_dateStyles[m_cellStyle];
+            column.setNumber(m_dataRow, value, date);
+        } else {
+            column.setText(m_dataRow, cellText());
+        }
+        m_rowCount = qMax(m_rowCount, m_dataRow + 1);
+    }
+};
+
+// 读取工作簿中第 sheetIndex 个工作表的名称与 ZIP 内路径
+bool resolveSheet(ZipReader& zip, int sheetIndex, QString& sheetName, QString& sheetPath, QString& errorMessage)
+{
+    QByteArray workbook;
+    if (!zip.readAll("xl/workbook.xml", workbook, errorMessage)) return false;
+
+    QStringList names;
+    QStringList relationIds;
+    QXmlStreamReader reader(workbook);
+    while (!reader.atEnd()) {
+        if (reader.readNext() != QXmlStreamReader::StartElement || reader.name() != QLatin1String("sheet")) {
+            continue;
+        }
+        QString relationId;
+        for (const QXmlStreamAttribute& attribute : reader.attributes()) {
+            if (attribute.name() == QLatin1String("id")) relationId = attribute.value().toString();
+        }
+        names.append(reader.attributes().value("name").toString());
+        relationIds.append(relationId);
+    }
+    if (sheetIndex < 0 || sheetIndex >= names.size()) {
+        errorMessage = QString("工作簿中不存在第 %1 个工作表").arg(sheetIndex + 1);
+        return false;
+    }
+    sheetName = names[sheetIndex];
+
+    QHash<QString, QString> targets;
+    QByteArray rels;
+    QString relsError;
+    if (zip.readAll("xl/_rels/workbook.xml.rels", rels, relsError)) {
+        QXmlStreamReader relsReader(rels);
+        while (!relsReader.atEnd()) {
+            if (relsReader.readNext() == QXmlStreamReader::StartElement
+                && relsReader.name() == QLatin1String("Relationship")) {
+                targets.insert(relsReader.attributes().value("Id").toString(),
+                               relsReader.attributes().value("Target").toString());
+            }
+        }
+    }
+
+    QString target = targets.value(relationIds[sheetIndex]);
+    if (target.startsWith('/')) {
+        sheetPath = target.mid(1);
+    } else if (!target.isEmpty()) {
+        sheetPath = "xl/" + target;
+    } else {
+        sheetPath = QString("xl/worksheets/sheet%1.xml").arg(sheetIndex + 1);
+    }
+
+    if (!zip.contains(sheetPath)) {
+        errorMessage = QString("找不到工作表数据: %1").arg(sheetPath);
+        return false;
+    }
+    return true;
+}
+
+// 读取样式表，返回每个单元格样式（cellXfs 序号）是否为日期格式
+QVector<bool> readDateStyles(ZipReader& zip)
+{
+    QVector<bool> dateStyles;
+    QByteArray styles;
+    QString errorMessage;
+    if (!zip.contains("xl/styles.xml") || !zip.readAll("xl/styles.xml", styles, errorMessage)) {
+        return dateStyles;
+    }
+
+    QHash<int, QString> customFormats;
+    bool inCellXfs = false;
+    QXmlStreamReader reader(styles);
+    while (!reader.atEnd()) {
+        QXmlStreamReader::TokenType token = reader.readNext();
+        if (token == QXmlStreamReader::StartElement) {
+            if (reader.name() == QLatin1String("numFmt")) {
+                customFormats.insert(reader.attributes().value("numFmtId").toInt(),
+                                     reader.attributes().value("formatCode").toString());
+            } else if (reader.name() == QLatin1String("cellXfs")) {
+                inCellXfs = true;
+            } else if (inCellXfs && reader.name() == QLatin1String("xf")) {
+                int id = reader.attributes().value("numFmtId").toInt();
+                dateStyles.append(XlsxFile::isDateFormat(id, customFormats.value(id)));
+            }
+        } else if (token == QXmlStreamReader::EndElement && reader.name() == QLatin1String("cellXfs")) {
+            inCellXfs = false;
+        }
+    }
+    return dateStyles;
+}
+
+// 按"日历日 + 当日毫秒"格式化时间戳（与 DataTableModel 的时间戳编码一致）
+QString formatMsecs(qint64 msecs, const QString& format)
+{
+    qint64 days = msecs / qint64(kMsecsPerDay);
+    qint64 rest = msecs % qint64(kMsecsPerDay);
+    if (rest < 0) {
+        rest += qint64(kMsecsPerDay);
+        --days;
+    }
+    QDateTime dt(QDate(1970, 1, 1).addDays(days), QTime::fromMSecsSinceStartOfDay(static_cast<int>(rest)));
+    return dt.toString(format);
+}
+
+// 把累积的工作表列转换为模型列
+DataColumn finishColumn(SheetColumn& sheetColumn, const QString& header, int rowCount)
+{
+    sheetColumn.padTo(rowCount);
+    sheetColumn.numbers.resize(rowCount);
+    if (sheetColumn.hasText) sheetColumn.texts.resize(rowCount);
+
+    QVector<double> numbers;
+    numbers.swap(sheetColumn.numbers);
+
+    if (!sheetColumn.hasText && sheetColumn.allDates()) {
+        DataColumn column;
+        column.header = header;
+        column.storage = ColumnStorage::Timestamp;
+        column.timestampFormat = sheetColumn.dateFormat();
+        column.timestamps.resize(rowCount);
+        for (int i = 0; i < rowCount; ++i) {
+            if (std::isnan(numbers[i])) {
+                column.timestamps[i] = 0;
+                column.setValid(i, false);
+            } else {
+                column.timestamps[i] = XlsxFile::serialToMsecs(numbers[i]);
+            }
+        }
+        return column;
+    }
+
+    if (!sheetColumn.hasText) {
+        return DataTableModel::makeNumericColumn(header, numbers);
+    }
+
+    // 混合列：数值单元格补成文本后按文本列推断（可能识别为时间戳或文本）
+    QVector<QString> texts;
+    texts.swap(sheetColumn.texts);
+    bool dates = sheetColumn.allDates();
+    QString format = sheetColumn.dateFormat();
+    for (int i = 0; i < rowCount; ++i) {
+        if (!texts[i].isEmpty() || std::isnan(numbers[i])) continue;
+        if (dates) {
+            texts[i] = formatMsecs(XlsxFile::serialToMsecs(numbers[i]), format);
+        } else {
+            texts[i] = QString::number(numbers[i], 'g', 15);
+        }
+    }
+    return DataTableModel::buildColumn(header, texts);
+}
+
+} // namespace
+
+// ============================================================================
+// XlsxFile
+// ============================================================================
+
+XlsxFile::XlsxFile(QObject *parent) :
+    QObject(parent),
+    m_cancelRequested(false)
+{
+}
+
+XlsxFile::~XlsxFile()
+{
+}
+
+void XlsxFile::cancel()
+{
+    m_cancelRequested = true;
+}
+
+void XlsxFile::resetCancel()
+{
+    m_cancelRequested = false;
+}
+
+XlsxImportResult XlsxFile::load(const QString& filePath, const XlsxImportConfig& config)
+{
+    XlsxImportResult result;
+    if (m_cancelRequested) {
+        result.errorMessage = "加载已取消";
+        return result;
+    }
+
+    ZipReader zip(filePath);
+    if (!zip.open(result.errorMessage)) {
+        return result;
+    }
+
+    emit progressUpdated(10, "正在读取工作簿结构...");
+
+    QString sheetPath;
+    if (!resolveSheet(zip, config.sheetIndex, result.sheetName, sheetPath, result.errorMessage)) {
+        return result;
+    }
+
+    // 共享字符串表也按块流式解析
+    SharedStringsHandler sharedStrings;
+    if (zip.contains("xl/sharedStrings.xml")) {
+        emit progressUpdated(15, "正在读取共享字符串...");
+        bool ok = zip.readChunked("xl/sharedStrings.xml", config.chunkSize, [&](const char* data, int size) {
+            sharedStrings.feed(data, size);
+            return !m_cancelRequested;
+        }, result.errorMessage);
+        if (!ok) {
+            if (m_cancelRequested) result.errorMessage = "加载已取消";
+            return result;
+        }
+    }
+    result.sharedStringCount = sharedStrings.strings.size();
+
+    QVector<bool> dateStyles = readDateStyles(zip);
+
+    emit progressUpdated(20, QString("正在流式解析工作表 %1...").arg(result.sheetName));
+
+    SheetHandler sheet(config, sharedStrings.strings, dateStyles);
+    auto columnHeader = [&sheet](int col) {
+        QString header = col < sheet.headers.size() ? sheet.headers[col] : QString();
+        return header.isEmpty() ? QString("列%1").arg(col + 1) : header;
+    };
+
+    qint64 totalBytes = qMax<qint64>(1, zip.entry(sheetPath).uncompressedSize);
+    bool previewSent = (config.previewRows <= 0);
+    bool ok = zip.readChunked(sheetPath, config.chunkSize, [&](const char* data, int size) {
+        sheet.feed(data, size);
+        result.bytesParsed += size;
+        emit progressUpdated(20 + static_cast<int>(70 * result.bytesParsed / totalBytes),
+                             QString("已解析 %1 MB").arg(result.bytesParsed / (1024.0 * 1024.0), 0, 'f', 1));
+
+        // 前 previewRows 行已完整（后面还有数据）时先交出一份预览
+        if (!previewSent && sheet.rowCount() > config.previewRows && result.bytesParsed < totalBytes) {
+            previewSent = true;
+            QVector<DataColumn> preview;
+            int previewColumns = qMax(sheet.columns.size(), sheet.headers.size());
+            for (int col = 0; col < previewColumns; ++col) {
+                SheetColumn head = col < sheet.columns.size() ? sheet.columns[col] : SheetColumn();
+                preview.append(finishColumn(head, columnHeader(col), config.previewRows));
+            }
+            emit previewReady(preview, config.previewRows);
+        }
+        return !m_cancelRequested;
+    }, result.errorMessage);
+    if (!ok) {
+        if (m_cancelRequested) result.errorMessage = "加载已取消";
+        return result;
+    }
+
+    int columnCount = qMax(sheet.columns.size(), sheet.headers.size());
+    if (columnCount == 0) {
+        result.errorMessage = "工作表中没有数据";
+        return result;
+    }
+
+    emit progressUpdated(92, "正在生成数据列...");
+
+    sheet.columns.resize(columnCount);
+    result.rowCount = sheet.rowCount();
+    result.columns.reserve(columnCount);
+    for (int col = 0; col < columnCount; ++col) {
+        QString header = columnHeader(col);
+        result.headers.append(header);
+        result.columns.append(finishColumn(sheet.columns[col], header, result.rowCount));
+        sheet.columns[col] = SheetColumn();
+    }
+
+    result.success = true;
+    return result;
+}
+
+bool XlsxFile::save(const QString& filePath, const DataTableModel* model, QString& errorMessage,
+                    const QString& sheetName)
+{
+    if (!model) {
+        errorMessage = "没有可保存的数据";
+        return false;
+    }
+
+    ZipWriter zip(filePath);
+    if (!zip.open(errorMessage)) {
+        return false;
+    }
+
+    QByteArray workbook =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<workbook xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\" "
+        "xmlns:r=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships\">"
+        "<sheets><sheet name=\"";
+    appendEscaped(workbook, sheetName);
+    workbook.append("\" sheetId=\"1\" r:id=\"rId1\"/></sheets></workbook>");
+
+    bool ok = zip.addFile("[Content_Types].xml", kContentTypesXml)
+              && zip.addFile("_rels/.rels", kRootRelsXml)
+              && zip.addFile("xl/workbook.xml", workbook)
+              && zip.addFile("xl/_rels/workbook.xml.rels", kWorkbookRelsXml)
+              && zip.addFile("xl/styles.xml", kStylesXml)
+              && zip.beginFile("xl/worksheets/sheet1.xml");
+
+    int rows = model->rowCount();
+    int columns = model->columnCount();
+
+    // 每列的单元格引用前缀与时间戳样式
+    QVector<QByteArray> letters(columns);
+    QVector<QByteArray> timestampStyles(columns);
+    for (int col = 0; col < columns; ++col) {
+        letters[col] = columnLetters(col);
+        const DataColumn& column = model->column(col);
+        if (column.storage == ColumnStorage::Timestamp) {
+            bool hasDate = column.timestampFormat.contains('y') || column.timestampFormat.contains('d');
+            bool hasTime = column.timestampFormat.contains('h') || column.timestampFormat.contains('H');
+            timestampStyles[col] = (hasDate && hasTime) ? "1" : (hasDate ? "2" : "3");
+        }
+    }
+
+    QByteArray xml;
+    xml.reserve(kWriteFlushBytes + 4096);
+    xml.append("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+               "<worksheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\"><sheetData>");
+
+    // 表头行
+    xml.append("<row r=\"1\">");
+    for (int col = 0; col < columns; ++col) {
+        xml.append("<c r=\"").append(letters[col]).append("1\" t=\"inlineStr\"><is><t>");
+        appendEscaped(xml, model->headerText(col));
+        xml.append("</t></is></c>");
+    }
+    xml.append("</row>");
+
+    for (int row = 0; row < rows && ok; ++row) {
+        QByteArray rowNumber = QByteArray::number(row + 2);
+        xml.append("<row r=\"").append(rowNumber).append("\">");
+
+        for (int col = 0; col < columns; ++col) {
+            const DataColumn& column = model->column(col);
+            if (!column.isValid(row)) continue;
+            if (column.storage == ColumnStorage::Numeric && !std::isfinite(column.numbers[row])) continue;
+
+            xml.append("<c r=\"").append(letters[col]).append(rowNumber);
+            switch (column.storage) {
+            case ColumnStorage::Numeric:
+                xml.append("\"><v>");
+                appendNumber(xml, column.numbers[row]);
+                xml.append("</v></c>");
+                break;
+            case ColumnStorage::Timestamp:
+                xml.append("\" s=\"").append(timestampStyles[col]).append("\"><v>");
+                appendNumber(xml, msecsToSerial(column.timestamps[row]));
+                xml.append("</v></c>");
+                break;
+            case ColumnStorage::Text:
+                xml.append("\" t=\"inlineStr\"><is><t xml:space=\"preserve\">");
+                appendEscaped(xml, column.texts[row]);
+                xml.append("</t></is></c>");
+                break;
+            }
+        }
+        xml.append("</row>");
+
+        if (xml.size() >= kWriteFlushBytes) {
+            ok = zip.writeData(xml.constData(), xml.size());
+            xml.clear();
+            emit progressUpdated(static_cast<int>(100LL * (row + 1) / qMax(1, rows)),
+                                 QString("已写出 %1/%2 行").arg(row + 1).arg(rows));
+        }
+    }
+
+    xml.append("</sheetData></worksheet>");
+    ok = ok && zip.writeData(xml.constData(), xml.size()) && zip.endFile();
+
+    QString closeError;
+    if (!zip.close(closeError) || !ok) {
+        errorMessage = closeError.isEmpty() ? "写入 xlsx 文件失败" : closeError;
+        return false;
+    }
+    return true;
+}
+
+bool XlsxFile::isXlsxFile(const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    return file.read(4) == QByteArray("PK\x03\x04", 4);
+}
+
+bool XlsxFile::isDateFormat(int numFmtId, const QString& formatCode)
+{
+    // 内置日期/时间格式（含中日韩区域的 27-36、50-58）
+    if ((numFmtId >= 14 && numFmtId <= 22) || (numFmtId >= 27 && numFmtId <= 36)
+        || (numFmtId >= 45 && numFmtId <= 47) || (numFmtId >= 50 && numFmtId <= 58)) {
+        return true;
+    }
+    if (formatCode.isEmpty()) return false;
+
+    // 去掉引号内文字、方括号（颜色/条件/[h]）与转义字符后查找日期占位符
+    bool inQuote = false;
+    int bracketDepth = 0;
+    for (int i = 0; i < formatCode.size(); ++i) {
+        QChar c = formatCode[i];
+        if (c == '"') {
+            inQuote = !inQuote;
+        } else if (inQuote) {
+            continue;
+        } else if (c == '[') {
+            ++bracketDepth;
+        } else if (c == ']') {
+            bracketDepth = qMax(0, bracketDepth - 1);
+        } else if (bracketDepth > 0) {
+            continue;
+        } else if (c == '\\' || c == '_' || c == '*') {
+            ++i;  // 跳过被转义/占位的下一个字符
+        } else {
+            char lower = c.toLower().toLatin1();
+            if (lower == 'y' || lower == 'm' || lower == 'd' || lower == 'h' || lower == 's') {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+qint64 XlsxFile::serialToMsecs(double serial)
+{
+    return qRound64((serial - kExcelEpochOffset) * kMsecsPerDay);
+}
+
+double XlsxFile::msecsToSerial(qint64 msecs)
+{
+    return msecs / kMsecsPerDay + kExcelEpochOffset;
+}
@@ -0,0 +1,115 @@
+#ifndef XLSXFILE_H
+#define XLSXFILE_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+#include "datatablemodel.h"
+
+// XLSX 导入配置
+struct XlsxImportConfig {
+    int sheetIndex;     // 工作表序号（从0开始，按工作簿中的顺序）
+    int startRow;       // 开始读取的行号（从1开始）
+    bool hasHeader;     // 起始行是否为表头
+    int chunkSize;      // 流式解压/解析的块大小（字节）
+    int previewRows;    // >0 时解析到该行数后发出 previewReady（0 表示不预览）
+
+    XlsxImportConfig() :
+        sheetIndex(0),
+        startRow(1),
+        hasHeader(true),
+        chunkSize(1 << 20),
+        previewRows(0) {}
+};
+
+// XLSX 导入结果
+struct XlsxImportResult {
+    bool success;
+    QString errorMessage;
+    QString sheetName;
+    QStringList headers;
+    QVector<DataColumn> columns;
+    int rowCount;
+    int sharedStringCount;
+    qint64 bytesParsed;     // 解压后的工作表 XML 字节数
+
+    XlsxImportResult() :
+        success(false),
+        rowCount(0),
+        sharedStringCount(0),
+        bytesParsed(0) {}
+};
+
+/**
+ * @brief 内置 XLSX 读写器（不依赖 Excel COM，可在任意平台使用）
+ *
+ * 读取：ZIP 容器由 ZipReader 内存映射，工作表 XML 按块解压后交给 SAX 式扫描器逐个
+ * 元素处理，单元格直接写入按列累积的 double 数组；只有出现文本的列才分配字符串。
+ * 解析内存为"一个块 + 共享字符串表"，与工作表大小无关（结果列本身除外）。
+ * 日期样式的数值单元格（内置日期格式或含 y/m/d/h/s 的自定义格式）转换为时间戳列。
+ *
+ * 写出：表头与文本使用内联字符串，数值按最短往返精度写出，时间戳列写为带日期样式
+ * 的 Excel 序列值；工作表 XML 边生成边压缩写入。
+ */
+class XlsxFile : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit XlsxFile(QObject *parent = nullptr);
+    ~XlsxFile();
+
+    /**
+     * @brief 读取工作表到类型化列
+     */
+    XlsxImportResult load(const QString& filePath, const XlsxImportConfig& config);
+
+    /**
+     * @brief 请求中止 load()（可从任意线程调用，在下一个解压块处生效）
+     *
+     * 取消状态保持到 resetCancel()：在 load() 开始前到达的取消同样有效。
+     */
+    void cancel();
+
+    // 清除取消请求（由调用方在启动新的加载任务前调用）
+    void resetCancel();
+
+    /**
+     * @brief 把模型写出为单工作表 xlsx
+     */
+    bool save(const QString& filePath, const DataTableModel* model, QString& errorMessage,
+              const QString& sheetName = "Sheet1");
+
+    // =========================================================================
+    // 静态工具接口
+    // =========================================================================
+
+    /**
+     * @brief 按文件头判断是否为 ZIP 容器（xlsx）
+     */
+    static bool isXlsxFile(const QString& filePath);
+
+    /**
+     * @brief 判断数字格式是否为日期/时间格式
+     * @param numFmtId 数字格式编号（内置或自定义）
+     * @param formatCode 自定义格式代码（内置格式为空）
+     */
+    static bool isDateFormat(int numFmtId, const QString& formatCode);
+
+    // Excel 序列日期（1900 日期系统）与模型时间戳（毫秒）互转
+    static qint64 serialToMsecs(double serial);
+    static double msecsToSerial(qint64 msecs);
+
+signals:
+    void progressUpdated(int progress, const QString& message);
+
+    // 预览数据（前 previewRows 行）已解析，流式解析仍在进行
+    void previewReady(const QVector<DataColumn>& columns, int rowCount);
+
+private:
+    std::atomic<bool> m_cancelRequested;
+};
+
+#endif // XLSXFILE_H
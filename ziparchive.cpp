@@ -0,0 +1,1001 @@
+#include "ziparchive.h"
+#include <QDateTime>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+// ============================================================================
+// 内部辅助函数
+// ============================================================================
+
+namespace {
+
+const quint32 kLocalHeaderSignature = 0x04034b50;
+const quint32 kCentralHeaderSignature = 0x02014b50;
+const quint32 kEndOfCentralDirSignature = 0x06054b50;
+const quint16 kUtf8NameFlag = 0x0800;
+const int kWindowSize = 32768;          // deflate 回溯窗口
+const int kFastBits = 10;               // Huffman 快速查表位数
+const int kWriterBlockSize = 1 << 20;   // 写出时每个 deflate 块的原始字节数
+
+const quint16 kLengthBase[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+const quint8 kLengthExtra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+const quint16 kDistBase[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+const quint8 kDistExtra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+const quint8 kCodeLengthOrder[19] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+inline quint16 readU16(const uchar* p)
+{
+    return quint16(p[0] | (p[1] << 8));
+}
+
+inline quint32 readU32(const uchar* p)
+{
+    return quint32(p[0]) | (quint32(p[1]) << 8) | (quint32(p[2]) << 16) | (quint32(p[3]) << 24);
+}
+
+inline void appendU16(QByteArray& out, quint16 v)
+{
+    out.append(char(v & 0xFF));
+    out.append(char(v >> 8));
+}
+
+inline void appendU32(QByteArray& out, quint32 v)
+{
+    appendU16(out, quint16(v & 0xFFFF));
+    appendU16(out, quint16(v >> 16));
+}
+
+inline quint32 reverseBits(quint32 code, int length)
+{
+    quint32 result = 0;
+    for (int i = 0; i < length; ++i) {
+        result = (result << 1) | (code & 1);
+        code >>= 1;
+    }
+    return result;
+}
+
+// 固定 Huffman 码长（RFC 1951 3.2.6）
+void fixedLengths(quint8* literal, quint8* distance)
+{
+    for (int s = 0; s < 144; ++s) literal[s] = 8;
+    for (int s = 144; s < 256; ++s) literal[s] = 9;
+    for (int s = 256; s < 280; ++s) literal[s] = 7;
+    for (int s = 280; s < 288; ++s) literal[s] = 8;
+    for (int s = 0; s < 30; ++s) distance[s] = 5;
+}
+
+// 由码长生成规范 Huffman 码（已按 LSB 先行的位序反转）
+void canonicalCodes(const quint8* lengths, int n, quint16* codes)
+{
+    quint16 counts[16] = {0};
+    for (int s = 0; s < n; ++s) counts[lengths[s]]++;
+    counts[0] = 0;
+
+    quint32 nextCode[16] = {0};
+    quint32 code = 0;
+    for (int len = 1; len < 16; ++len) {
+        code = (code + counts[len - 1]) << 1;
+        nextCode[len] = code;
+    }
+    for (int s = 0; s < n; ++s) {
+        int len = lengths[s];
+        codes[s] = len ? quint16(reverseBits(nextCode[len]++, len)) : 0;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Huffman 解码表：10 位快速查表，更长的码按规范码逐位解码
+// ---------------------------------------------------------------------------
+
+struct Huffman {
+    quint16 counts[16];
+    quint16 symbols[288];
+    quint16 fast[1 << kFastBits];   // (码长 << 9) | 符号，0 表示需要慢速解码
+
+    bool build(const quint8* lengths, int n)
+    {
+        std::memset(counts, 0, sizeof(counts));
+        std::memset(fast, 0, sizeof(fast));
+        for (int s = 0; s < n; ++s) counts[lengths[s]]++;
+        counts[0] = 0;
+
+        // 码长过度分配即为非法；不完整码（如只有一个距离码）允许
+        int left = 1;
+        for (int len = 1; len < 16; ++len) {
+            left <<= 1;
+            left -= counts[len];
+            if (left < 0) return false;
+        }
+
+        quint16 offsets[16];
+        offsets[1] = 0;
+        for (int len = 1; len < 15; ++len) {
+            offsets[len + 1] = quint16(offsets[len] + counts[len]);
+        }
+        for (int s = 0; s < n; ++s) {
+            if (lengths[s]) symbols[offsets[lengths[s]]++] = quint16(s);
+        }
+
+        quint16 codes[288];
+        canonicalCodes(lengths, n, codes);
+        for (int s = 0; s < n; ++s) {
+            int len = lengths[s];
+            if (len == 0 || len > kFastBits) continue;
+            for (int j = codes[s]; j < (1 << kFastBits); j += (1 << len)) {
+                fast[j] = quint16((len << 9) | s);
+            }
+        }
+        return true;
+    }
+};
+
+// 固定 Huffman 解码表（局部静态对象，首次使用时线程安全地初始化）
+struct FixedDecoder {
+    Huffman literal;
+    Huffman distance;
+
+    FixedDecoder()
+    {
+        quint8 literalLengths[288];
+        quint8 distanceLengths[30];
+        fixedLengths(literalLengths, distanceLengths);
+        literal.build(literalLengths, 288);
+        distance.build(distanceLengths, 30);
+    }
+
+    static const FixedDecoder& instance()
+    {
+        static const FixedDecoder decoder;
+        return decoder;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// 流式 inflate（RFC 1951），输出按块回调
+// ---------------------------------------------------------------------------
+
+class Inflater
+{
+public:
+    Inflater(const uchar* input, qint64 inputSize, int chunkSize, const ZipReader::ChunkSink& sink) :
+        m_in(input),
+        m_inSize(inputSize),
+        m_inPos(0),
+        m_padBytes(0),
+        m_bitBuf(0),
+        m_bitCount(0),
+        m_out(size_t(kWindowSize) + chunkSize + 2 * 258),
+        m_outPos(0),
+        m_flushPos(0),
+        m_chunkSize(chunkSize),
+        m_total(0),
+        m_sink(sink),
+        m_aborted(false) {}
+
+    bool run(QString& errorMessage);
+    qint64 totalOut() const { return m_total; }
+    bool aborted() const { return m_aborted; }
+
+private:
+    const uchar* m_in;
+    qint64 m_inSize;
+    qint64 m_inPos;
+    int m_padBytes;
+    quint64 m_bitBuf;
+    int m_bitCount;
+    std::vector<uchar> m_out;
+    int m_outPos;
+    int m_flushPos;
+    int m_chunkSize;
+    qint64 m_total;
+    const ZipReader::ChunkSink& m_sink;
+    bool m_aborted;
+    Huffman m_literal;
+    Huffman m_distance;
+
+    inline void refill()
+    {
+        while (m_bitCount <= 56) {
+            if (m_inPos < m_inSize) {
+                m_bitBuf |= quint64(m_in[m_inPos++]) << m_bitCount;
+            } else {
+                ++m_padBytes;  // 输入耗尽后补零，超出过多视为数据截断
+            }
+            m_bitCount += 8;
+        }
+    }
+
+    inline quint32 bits(int n)
+    {
+        if (m_bitCount < n) refill();
+        quint32 v = quint32(m_bitBuf & ((quint64(1) << n) - 1));
+        m_bitBuf >>= n;
+        m_bitCount -= n;
+        return v;
+    }
+
+    inline int decode(const Huffman& h)
+    {
+        if (m_bitCount < 15) refill();
+        quint16 e = h.fast[m_bitBuf & ((1u << kFastBits) - 1)];
+        if (e) {
+            int len = e >> 9;
+            m_bitBuf >>= len;
+            m_bitCount -= len;
+            return e & 511;
+        }
+
+        int code = 0;
+        int first = 0;
+        int index = 0;
+        for (int len = 1; len < 16; ++len) {
+            code |= int(m_bitBuf & 1);
+            m_bitBuf >>= 1;
+            --m_bitCount;
+            int count = h.counts[len];
+            if (code - count < first) {
+                return h.symbols[index + (code - first)];
+            }
+            index += count;
+            first += count;
+            first <<= 1;
+            code <<= 1;
+        }
+        return -1;
+    }
+
+    bool flush();
+    bool storedBlock(QString& errorMessage);
+    bool dynamicTables(QString& errorMessage);
+    bool codes(QString& errorMessage);
+};
+
+bool Inflater::flush()
+{
+    if (m_outPos > m_flushPos) {
+        if (!m_sink(reinterpret_cast<const char*>(m_out.data() + m_flushPos), m_outPos - m_flushPos)) {
+            m_aborted = true;
+            return false;
+        }
+    }
+
+    // 只保留最近 32 KB 作为回溯窗口
+    if (m_outPos > kWindowSize) {
+        std::memmove(m_out.data(), m_out.data() + m_outPos - kWindowSize, kWindowSize);
+        m_outPos = kWindowSize;
+    }
+    m_flushPos = m_outPos;
+    return true;
+}
+
+bool Inflater::storedBlock(QString& errorMessage)
+{
+    // 丢弃到字节边界
+    bits(m_bitCount & 7);
+    quint32 len = bits(16);
+    quint32 nlen = bits(16);
+    if (len != (~nlen & 0xFFFF)) {
+        errorMessage = "deflate 存储块长度校验失败";
+        return false;
+    }
+
+    // 位缓冲中剩余的整字节先输出，其余直接从输入复制
+    while (len > 0 && m_bitCount >= 8) {
+        m_out[m_outPos++] = uchar(bits(8));
+        ++m_total;
+        --len;
+        if (m_outPos - m_flushPos >= m_chunkSize && !flush()) return false;
+    }
+    if (m_padBytes > 0 && len > 0) {
+        errorMessage = "deflate 数据被截断";
+        return false;
+    }
+    while (len > 0) {
+        if (m_inPos >= m_inSize) {
+            errorMessage = "deflate 数据被截断";
+            return false;
+        }
+        int room = static_cast<int>(m_out.size()) - m_outPos;
+        int n = static_cast<int>(qMin<qint64>(qMin<qint64>(len, room), m_inSize - m_inPos));
+        std::memcpy(m_out.data() + m_outPos, m_in + m_inPos, size_t(n));
+        m_outPos += n;
+        m_inPos += n;
+        m_total += n;
+        len -= quint32(n);
+        if (m_outPos - m_flushPos >= m_chunkSize && !flush()) return false;
+    }
+    return true;
+}
+
+bool Inflater::dynamicTables(QString& errorMessage)
+{
+    int nlen = int(bits(5)) + 257;
+    int ndist = int(bits(5)) + 1;
+    int ncode = int(bits(4)) + 4;
+    if (nlen > 286 || ndist > 30) {
+        errorMessage = "deflate 动态码表长度非法";
+        return false;
+    }
+
+    quint8 lengths[320] = {0};
+    for (int i = 0; i < ncode; ++i) {
+        lengths[kCodeLengthOrder[i]] = quint8(bits(3));
+    }
+
+    Huffman lengthCode;
+    if (!lengthCode.build(lengths, 19)) {
+        errorMessage = "deflate 码长编码非法";
+        return false;
+    }
+
+    std::memset(lengths, 0, sizeof(lengths));
+    int index = 0;
+    while (index < nlen + ndist) {
+        int sym = decode(lengthCode);
+        if (sym < 0) {
+            errorMessage = "deflate 码长解码失败";
+            return false;
+        }
+        if (sym < 16) {
+            lengths[index++] = quint8(sym);
+            continue;
+        }
+
+        quint8 repeatLength = 0;
+        int repeat = 0;
+        if (sym == 16) {
+            if (index == 0) {
+                errorMessage = "deflate 码长重复无前值";
+                return false;
+            }
+            repeatLength = lengths[index - 1];
+            repeat = 3 + int(bits(2));
+        } else if (sym == 17) {
+            repeat = 3 + int(bits(3));
+        } else {
+            repeat = 11 + int(bits(7));
+        }
+        if (index + repeat > nlen + ndist) {
+            errorMessage = "deflate 码长重复越界";
+            return false;
+        }
+        while (repeat--) lengths[index++] = repeatLength;
+    }
+
+    if (lengths[256] == 0) {
+        errorMessage = "deflate 缺少块结束码";
+        return false;
+    }
+    if (!m_literal.build(lengths, nlen) || !m_distance.build(lengths + nlen, ndist)) {
+        errorMessage = "deflate Huffman 码表非法";
+        return false;
+    }
+    return true;
+}
+
+bool Inflater::codes(QString& errorMessage)
+{
+    for (;;) {
+        int sym = decode(m_literal);
+        if (sym < 0) {
+            errorMessage = "deflate 字面量解码失败";
+            return false;
+        }
+
+        if (sym < 256) {
+            m_out[m_outPos++] = uchar(sym);
+            ++m_total;
+        } else if (sym == 256) {
+            return true;
+        } else {
+            sym -= 257;
+            if (sym >= 29) {
+                errorMessage = "deflate 长度码非法";
+                return false;
+            }
+            int len = kLengthBase[sym] + int(bits(kLengthExtra[sym]));
+
+            int ds = decode(m_distance);
+            if (ds < 0 || ds >= 30) {
+                errorMessage = "deflate 距离码非法";
+                return false;
+            }
+            int dist = kDistBase[ds] + int(bits(kDistExtra[ds]));
+            if (dist > m_outPos) {
+                errorMessage = "deflate 回溯距离超出已解压数据";
+                return false;
+            }
+
+            uchar* dst = m_out.data() + m_outPos;
+            const uchar* src = dst - dist;
+            if (dist >= len) {
+                std::memcpy(dst, src, size_t(len));
+            } else {
+                for (int i = 0; i < len; ++i) dst[i] = src[i];
+            }
+            m_outPos += len;
+            m_total += len;
+        }
+
+        if (m_outPos - m_flushPos >= m_chunkSize && !flush()) return false;
+        if (m_padBytes > 16) {
+            errorMessage = "deflate 数据被截断";
+            return false;
+        }
+    }
+}
+
+bool Inflater::run(QString& errorMessage)
+{
+    bool final = false;
+    while (!final) {
+        final = bits(1) != 0;
+        int type = int(bits(2));
+
+        bool ok = false;
+        if (type == 0) {
+            ok = storedBlock(errorMessage);
+        } else if (type == 1) {
+            const FixedDecoder& fixed = FixedDecoder::instance();
+            m_literal = fixed.literal;
+            m_distance = fixed.distance;
+            ok = codes(errorMessage);
+        } else if (type == 2) {
+            ok = dynamicTables(errorMessage) && codes(errorMessage);
+        } else {
+            errorMessage = "deflate 块类型非法";
+        }
+
+        if (!ok) {
+            if (m_aborted) errorMessage = "解压被中止";
+            return false;
+        }
+    }
+    return flush();
+}
+
+// 固定 Huffman 编码表（写出用）
+struct FixedEncoder {
+    quint16 literalCode[288];
+    quint8 literalLength[288];
+    quint16 distanceCode[30];
+    quint8 lengthSymbol[259];       // 匹配长度 → 长度码序号
+    quint8 distanceSymbol[32769];   // 回溯距离 → 距离码序号
+
+    FixedEncoder()
+    {
+        quint8 distanceLength[30];
+        fixedLengths(literalLength, distanceLength);
+        canonicalCodes(literalLength, 288, literalCode);
+        canonicalCodes(distanceLength, 30, distanceCode);
+
+        for (int sym = 0; sym < 28; ++sym) {
+            for (int l = kLengthBase[sym]; l < kLengthBase[sym] + (1 << kLengthExtra[sym]); ++l) {
+                lengthSymbol[l] = quint8(sym);
+            }
+        }
+        lengthSymbol[258] = 28;
+
+        for (int sym = 0; sym < 30; ++sym) {
+            int end = qMin(32769, kDistBase[sym] + (1 << kDistExtra[sym]));
+            for (int d = kDistBase[sym]; d < end; ++d) {
+                distanceSymbol[d] = quint8(sym);
+            }
+        }
+    }
+
+    static const FixedEncoder& instance()
+    {
+        static const FixedEncoder encoder;
+        return encoder;
+    }
+};
+
+} // namespace
+
+// ============================================================================
+// ZipReader
+// ============================================================================
+
+ZipReader::ZipReader(const QString& filePath) :
+    m_file(filePath),
+    m_mapped(nullptr),
+    m_data(nullptr),
+    m_size(0)
+{
+}
+
+ZipReader::~ZipReader()
+{
+    close();
+}
+
+bool ZipReader::open(QString& errorMessage)
+{
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        errorMessage = QString("无法打开文件: %1").arg(m_file.errorString());
+        return false;
+    }
+
+    m_size = m_file.size();
+    m_mapped = m_file.map(0, m_size);
+    if (m_mapped) {
+        m_data = m_mapped;
+    } else {
+        m_buffer = m_file.readAll();
+        m_data = reinterpret_cast<const uchar*>(m_buffer.constData());
+        m_size = m_buffer.size();
+    }
+
+    return readCentralDirectory(errorMessage);
+}
+
+void ZipReader::close()
+{
+    if (m_mapped) {
+        m_file.unmap(m_mapped);
+        m_mapped = nullptr;
+    }
+    m_buffer.clear();
+    m_data = nullptr;
+    m_size = 0;
+    m_entries.clear();
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+}
+
+bool ZipReader::readCentralDirectory(QString& errorMessage)
+{
+    if (m_size < 22) {
+        errorMessage = "文件不是有效的 ZIP/XLSX 文件";
+        return false;
+    }
+
+    // 从文件尾向前查找中央目录结束记录（其后最多跟 65535 字节注释）
+    qint64 eocd = -1;
+    qint64 lowest = qMax<qint64>(0, m_size - 22 - 65535);
+    for (qint64 pos = m_size - 22; pos >= lowest; --pos) {
+        if (readU32(m_data + pos) == kEndOfCentralDirSignature) {
+            eocd = pos;
+            break;
+        }
+    }
+    if (eocd < 0) {
+        errorMessage = "未找到 ZIP 中央目录";
+        return false;
+    }
+
+    int entryCount = readU16(m_data + eocd + 10);
+    quint32 directoryOffset = readU32(m_data + eocd + 16);
+    if (directoryOffset == 0xFFFFFFFFu || entryCount == 0xFFFF) {
+        errorMessage = "不支持 ZIP64 格式";
+        return false;
+    }
+
+    qint64 p = directoryOffset;
+    for (int i = 0; i < entryCount; ++i) {
+        if (p + 46 > m_size || readU32(m_data + p) != kCentralHeaderSignature) {
+            errorMessage = "ZIP 中央目录已损坏";
+            return false;
+        }
+
+        ZipEntry entry;
+        entry.method = readU16(m_data + p + 10);
+        entry.crc32 = readU32(m_data + p + 16);
+        entry.compressedSize = readU32(m_data + p + 20);
+        entry.uncompressedSize = readU32(m_data + p + 24);
+        int nameLength = readU16(m_data + p + 28);
+        int extraLength = readU16(m_data + p + 30);
+        int commentLength = readU16(m_data + p + 32);
+        entry.localHeaderOffset = readU32(m_data + p + 42);
+        if (p + 46 + nameLength > m_size) {
+            errorMessage = "ZIP 中央目录已损坏";
+            return false;
+        }
+        entry.name = QString::fromUtf8(reinterpret_cast<const char*>(m_data + p + 46), nameLength);
+
+        m_entries.insert(entry.name, entry);
+        p += 46 + nameLength + extraLength + commentLength;
+    }
+    return true;
+}
+
+bool ZipReader::contains(const QString& name) const
+{
+    return m_entries.contains(name);
+}
+
+ZipEntry ZipReader::entry(const QString& name) const
+{
+    return m_entries.value(name);
+}
+
+QStringList ZipReader::entryNames() const
+{
+    return m_entries.keys();
+}
+
+bool ZipReader::readAll(const QString& name, QByteArray& data, QString& errorMessage)
+{
+    data.clear();
+    data.reserve(static_cast<int>(qMin<quint32>(entry(name).uncompressedSize, 64u << 20)));
+    return readChunked(name, 1 << 20, [&data](const char* chunk, int size) {
+        data.append(chunk, size);
+        return true;
+    }, errorMessage);
+}
+
+bool ZipReader::readChunked(const QString& name, int chunkSize, const ChunkSink& sink, QString& errorMessage)
+{
+    auto it = m_entries.constFind(name);
+    if (it == m_entries.constEnd()) {
+        errorMessage = QString("ZIP 中缺少条目: %1").arg(name);
+        return false;
+    }
+    const ZipEntry& entry = it.value();
+
+    qint64 local = entry.localHeaderOffset;
+    if (local + 30 > m_size || readU32(m_data + local) != kLocalHeaderSignature) {
+        errorMessage = QString("条目 %1 的本地文件头已损坏").arg(name);
+        return false;
+    }
+    qint64 dataOffset = local + 30 + readU16(m_data + local + 26) + readU16(m_data + local + 28);
+    if (dataOffset + entry.compressedSize > m_size) {
+        errorMessage = QString("条目 %1 的数据超出文件范围").arg(name);
+        return false;
+    }
+    const uchar* compressed = m_data + dataOffset;
+    chunkSize = qMax(4096, chunkSize);
+
+    // 输出块边回调边累计 CRC-32，结束时与中央目录中的值比较
+    quint32 crc = 0;
+    const ChunkSink checkedSink = [&sink, &crc](const char* data, int size) {
+        crc = ZipWriter::crc32(crc, reinterpret_cast<const uchar*>(data), size);
+        return sink(data, size);
+    };
+    auto verifyCrc = [&entry, &crc, &name, &errorMessage]() {
+        if (crc == entry.crc32) return true;
+        errorMessage = QString("条目 %1 的 CRC 校验失败，文件可能已损坏").arg(name);
+        return false;
+    };
+
+    if (entry.method == 0) {
+        for (quint32 pos = 0; pos < entry.compressedSize; pos += quint32(chunkSize)) {
+            int n = static_cast<int>(qMin<quint32>(quint32(chunkSize), entry.compressedSize - pos));
+            if (!checkedSink(reinterpret_cast<const char*>(compressed + pos), n)) {
+                errorMessage = "读取被中止";
+                return false;
+            }
+        }
+        return verifyCrc();
+    }
+
+    if (entry.method != 8) {
+        errorMessage = QString("条目 %1 使用了不支持的压缩方式 %2").arg(name).arg(entry.method);
+        return false;
+    }
+
+    Inflater inflater(compressed, entry.compressedSize, chunkSize, checkedSink);
+    if (!inflater.run(errorMessage)) {
+        return false;
+    }
+    if (inflater.totalOut() != qint64(entry.uncompressedSize)) {
+        errorMessage = QString("条目 %1 解压后大小不符").arg(name);
+        return false;
+    }
+    return verifyCrc();
+}
+
+// ============================================================================
+// ZipWriter
+// ============================================================================
+
+// 固定 Huffman 块 + 单探测哈希 LZ77；每个块独立匹配，块间不共享窗口
+struct ZipWriter::Deflater {
+    quint64 bitBuf;
+    int bitCount;
+    QByteArray out;
+    std::vector<int> head;
+
+    Deflater() : bitBuf(0), bitCount(0), head(1 << 15) {}
+
+    inline void putBits(quint32 value, int n)
+    {
+        bitBuf |= quint64(value) << bitCount;
+        bitCount += n;
+        while (bitCount >= 8) {
+            out.append(char(bitBuf & 0xFF));
+            bitBuf >>= 8;
+            bitCount -= 8;
+        }
+    }
+
+    void compress(const uchar* data, int size, bool final)
+    {
+        const FixedEncoder& enc = FixedEncoder::instance();
+        out.reserve(out.size() + size / 2 + 64);
+
+        putBits(final ? 1 : 0, 1);
+        putBits(1, 2);  // BTYPE = 01 固定 Huffman
+        std::fill(head.begin(), head.end(), -1);
+
+        auto hashAt = [data](int i) {
+            return ((data[i] << 10) ^ (data[i + 1] << 5) ^ data[i + 2]) & 0x7FFF;
+        };
+
+        int i = 0;
+        while (i < size) {
+            int bestLength = 0;
+            int bestDistance = 0;
+            if (i + 3 <= size) {
+                int h = hashAt(i);
+                int candidate = head[h];
+                head[h] = i;
+                if (candidate >= 0 && i - candidate <= kWindowSize) {
+                    int maxLength = qMin(258, size - i);
+                    int len = 0;
+                    while (len < maxLength && data[candidate + len] == data[i + len]) ++len;
+                    if (len >= 3) {
+                        bestLength = len;
+                        bestDistance = i - candidate;
+                    }
+                }
+            }
+
+            if (bestLength == 0) {
+                putBits(enc.literalCode[data[i]], enc.literalLength[data[i]]);
+                ++i;
+                continue;
+            }
+
+            int lsym = enc.lengthSymbol[bestLength];
+            putBits(enc.literalCode[257 + lsym], enc.literalLength[257 + lsym]);
+            putBits(quint32(bestLength - kLengthBase[lsym]), kLengthExtra[lsym]);
+            int dsym = enc.distanceSymbol[bestDistance];
+            putBits(enc.distanceCode[dsym], 5);
+            putBits(quint32(bestDistance - kDistBase[dsym]), kDistExtra[dsym]);
+
+            for (int k = i + 1; k < i + bestLength && k + 3 <= size; ++k) {
+                head[hashAt(k)] = k;
+            }
+            i += bestLength;
+        }
+
+        putBits(enc.literalCode[256], enc.literalLength[256]);
+        if (final && bitCount > 0) {
+            out.append(char(bitBuf & 0xFF));
+            bitBuf = 0;
+            bitCount = 0;
+        }
+    }
+};
+
+ZipWriter::ZipWriter(const QString& filePath) :
+    m_file(filePath),
+    m_deflater(nullptr),
+    m_dosTime(0),
+    m_dosDate(0),
+    m_failed(false)
+{
+}
+
+ZipWriter::~ZipWriter()
+{
+    delete m_deflater;
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+}
+
+bool ZipWriter::open(QString& errorMessage)
+{
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        errorMessage = QString("无法写入文件: %1").arg(m_file.errorString());
+        return false;
+    }
+
+    QDateTime now = QDateTime::currentDateTime();
+    m_dosTime = quint16((now.time().hour() << 11) | (now.time().minute() << 5) | (now.time().second() / 2));
+    m_dosDate = quint16(((qMax(1980, now.date().year()) - 1980) << 9) | (now.date().month() << 5) | now.date().day());
+    return true;
+}
+
+void ZipWriter::fail(const QString& message)
+{
+    // 只保留第一个原因，后续失败多为其连带结果
+    if (!m_failed) m_errorString = message;
+    m_failed = true;
+}
+
+bool ZipWriter::writeRaw(const QByteArray& data)
+{
+    if (m_failed) return false;
+    if (m_file.write(data) != data.size()) {
+        fail(m_file.errorString());
+    }
+    return !m_failed;
+}
+
+bool ZipWriter::addFile(const QString& name, const QByteArray& data)
+{
+    return beginFile(name) && writeData(data.constData(), data.size()) && endFile();
+}
+
+bool ZipWriter::beginFile(const QString& name)
+{
+    if (m_failed) return false;
+
+    m_current = ZipEntry();
+    m_current.name = name;
+    m_current.method = 8;
+    m_current.localHeaderOffset = quint32(m_file.pos());
+    m_pending.clear();
+    delete m_deflater;
+    m_deflater = new Deflater;
+
+    // CRC 与大小在 endFile() 中回填
+    QByteArray nameBytes = name.toUtf8();
+    QByteArray header;
+    appendU32(header, kLocalHeaderSignature);
+    appendU16(header, 20);
+    appendU16(header, kUtf8NameFlag);
+    appendU16(header, m_current.method);
+    appendU16(header, m_dosTime);
+    appendU16(header, m_dosDate);
+    appendU32(header, 0);
+    appendU32(header, 0);
+    appendU32(header, 0);
+    appendU16(header, quint16(nameBytes.size()));
+    appendU16(header, 0);
+    header.append(nameBytes);
+    return writeRaw(header);
+}
+
+bool ZipWriter::writeData(const char* data, int size)
+{
+    if (m_failed || !m_deflater) return false;
+    if (qint64(m_current.uncompressedSize) + size > 0xFFFFFFFFLL) {
+        fail(QString("条目 %1 超过 4 GB，不支持 ZIP64").arg(m_current.name));
+        return false;
+    }
+
+    m_current.crc32 = crc32(m_current.crc32, reinterpret_cast<const uchar*>(data), size);
+    m_current.uncompressedSize += quint32(size);
+    m_pending.append(data, size);
+    if (m_pending.size() >= kWriterBlockSize) {
+        return compressPending(false);
+    }
+    return true;
+}
+
+bool ZipWriter::compressPending(bool final)
+{
+    m_deflater->compress(reinterpret_cast<const uchar*>(m_pending.constData()), m_pending.size(), final);
+    m_pending.clear();
+
+    if (qint64(m_current.compressedSize) + m_deflater->out.size() > 0xFFFFFFFFLL) {
+        fail(QString("条目 %1 压缩后超过 4 GB，不支持 ZIP64").arg(m_current.name));
+        return false;
+    }
+    m_current.compressedSize += quint32(m_deflater->out.size());
+    bool ok = writeRaw(m_deflater->out);
+    m_deflater->out.clear();
+    return ok;
+}
+
+bool ZipWriter::endFile()
+{
+    if (m_failed || !m_deflater) return false;
+    if (!compressPending(true)) return false;
+
+    delete m_deflater;
+    m_deflater = nullptr;
+
+    QByteArray sizes;
+    appendU32(sizes, m_current.crc32);
+    appendU32(sizes, m_current.compressedSize);
+    appendU32(sizes, m_current.uncompressedSize);
+
+    qint64 end = m_file.pos();
+    if (!m_file.seek(qint64(m_current.localHeaderOffset) + 14) || !writeRaw(sizes) || !m_file.seek(end)) {
+        fail(m_file.errorString());
+        return false;
+    }
+
+    m_entries.append(m_current);
+    return true;
+}
+
+bool ZipWriter::close(QString& errorMessage)
+{
+    if (!m_failed) {
+        qint64 directoryOffset = m_file.pos();
+        QByteArray directory;
+        for (const ZipEntry& entry : m_entries) {
+            QByteArray nameBytes = entry.name.toUtf8();
+            appendU32(directory, kCentralHeaderSignature);
+            appendU16(directory, 20);
+            appendU16(directory, 20);
+            appendU16(directory, kUtf8NameFlag);
+            appendU16(directory, entry.method);
+            appendU16(directory, m_dosTime);
+            appendU16(directory, m_dosDate);
+            appendU32(directory, entry.crc32);
+            appendU32(directory, entry.compressedSize);
+            appendU32(directory, entry.uncompressedSize);
+            appendU16(directory, quint16(nameBytes.size()));
+            appendU16(directory, 0);
+            appendU16(directory, 0);
+            appendU16(directory, 0);
+            appendU16(directory, 0);
+            appendU32(directory, 0);
+            appendU32(directory, entry.localHeaderOffset);
+            directory.append(nameBytes);
+        }
+
+        QByteArray trailer;
+        appendU32(trailer, kEndOfCentralDirSignature);
+        appendU16(trailer, 0);
+        appendU16(trailer, 0);
+        appendU16(trailer, quint16(m_entries.size()));
+        appendU16(trailer, quint16(m_entries.size()));
+        appendU32(trailer, quint32(directory.size()));
+        appendU32(trailer, quint32(directoryOffset));
+        appendU16(trailer, 0);
+
+        if (directoryOffset > 0xFFFFFFFFLL) {
+            fail("文件超过 4 GB，不支持 ZIP64");
+        } else {
+            writeRaw(directory);
+            writeRaw(trailer);
+        }
+    }
+
+    m_file.close();
+    if (m_failed) {
+        errorMessage = QString("写入 ZIP 文件失败: %1").arg(m_errorString);
+        return false;
+    }
+    return true;
+}
+
+quint32 ZipWriter::crc32(quint32 crc, const uchar* data, qint64 size)
+{
+    struct Table {
+        quint32 entries[256];
+        Table()
+        {
+            for (quint32 i = 0; i < 256; ++i) {
+                quint32 c = i;
+                for (int k = 0; k < 8; ++k) {
+                    c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+                }
+                entries[i] = c;
+            }
+        }
+    };
+    static const Table table;
+
+    crc = ~crc;
+    for (qint64 i = 0; i < size; ++i) {
+        crc = table.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
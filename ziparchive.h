@@ -0,0 +1,119 @@
+#ifndef ZIPARCHIVE_H
+#define ZIPARCHIVE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <functional>
+
+// ZIP 条目信息（取自中央目录）
+struct ZipEntry {
+    QString name;
+    quint16 method;             // 0 存储 / 8 deflate
+    quint32 crc32;
+    quint32 compressedSize;
+    quint32 uncompressedSize;
+    quint32 localHeaderOffset;
+
+    ZipEntry() :
+        method(0),
+        crc32(0),
+        compressedSize(0),
+        uncompressedSize(0),
+        localHeaderOffset(0) {}
+};
+
+/**
+ * @brief 只读 ZIP 容器（xlsx 等 OOXML 文件）
+ *
+ * 文件整体内存映射，条目按需解压。readChunked() 以固定大小的块回调输出，
+ * 解压内存只占 32 KB 回溯窗口 + 一个块，与条目大小无关。输出按中央目录中的
+ * CRC-32 校验，不符时读取失败（块已回调给调用方，调用方应丢弃结果）。
+ * 仅支持存储与 deflate 两种压缩方式，不支持 ZIP64 与加密。
+ */
+class ZipReader
+{
+public:
+    // 块回调：返回 false 时中止解压
+    typedef std::function<bool(const char* data, int size)> ChunkSink;
+
+    explicit ZipReader(const QString& filePath);
+    ~ZipReader();
+
+    bool open(QString& errorMessage);
+    void close();
+
+    bool contains(const QString& name) const;
+    ZipEntry entry(const QString& name) const;
+    QStringList entryNames() const;
+
+    // 读取整个条目（用于 workbook.xml、styles.xml 等小条目）
+    bool readAll(const QString& name, QByteArray& data, QString& errorMessage);
+
+    // 流式读取：每解压出 chunkSize 字节回调一次 sink
+    bool readChunked(const QString& name, int chunkSize, const ChunkSink& sink, QString& errorMessage);
+
+private:
+    QFile m_file;
+    uchar* m_mapped;
+    QByteArray m_buffer;
+    const uchar* m_data;
+    qint64 m_size;
+    QHash<QString, ZipEntry> m_entries;
+
+    bool readCentralDirectory(QString& errorMessage);
+};
+
+/**
+ * @brief 只写 ZIP 容器
+ *
+ * 条目以 deflate（固定 Huffman + 单探测 LZ77）流式压缩写出，写完后回填本地文件头
+ * 中的 CRC 与大小，因此不需要在内存中保留整个条目。
+ */
+class ZipWriter
+{
+public:
+    explicit ZipWriter(const QString& filePath);
+    ~ZipWriter();
+
+    bool open(QString& errorMessage);
+
+    // 写入完整条目
+    bool addFile(const QString& name, const QByteArray& data);
+
+    // 流式条目：beginFile → writeData × N → endFile
+    bool beginFile(const QString& name);
+    bool writeData(const char* data, int size);
+    bool endFile();
+
+    // 写出中央目录并关闭文件
+    bool close(QString& errorMessage);
+
+    // 首个导致写入失败的原因（未失败时为空）
+    QString errorString() const { return m_errorString; }
+
+    // CRC-32（IEEE 802.3）
+    static quint32 crc32(quint32 crc, const uchar* data, qint64 size);
+
+private:
+    struct Deflater;
+
+    QFile m_file;
+    QVector<ZipEntry> m_entries;
+    ZipEntry m_current;
+    Deflater* m_deflater;
+    QByteArray m_pending;
+    quint16 m_dosTime;
+    quint16 m_dosDate;
+    bool m_failed;
+    QString m_errorString;
+
+    void fail(const QString& message);
+    bool compressPending(bool final);
+    bool writeRaw(const QByteArray& data);
+};
+
+#endif // ZIPARCHIVE_H